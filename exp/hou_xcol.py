@@ -172,7 +172,7 @@ class ColExporter(xcore.BaseExporter, xhou.PolModel):
 		bw.writeU32(ngrp) # +40
 		bw.writeU32(ntri) # +44
 		bw.writeU32(self.maxVtxPerPol) # +48
-		bw.writeU32(0) # +4C reserved
+		bw.writeU32(0) # +4C -> compact BVH (see sxQBVH)
 		self.patchPos = bw.getPos()
 		bw.writeU32(0) # +50 -> pnts
 		bw.writeU32(0) # +54 -> pol idx org
@@ -15,8 +15,68 @@ import xhou
 try: xrange
 except: xrange = range
 
+def rdcHermite(v0, m0, v1, m1, h, t):
+	tt = t*t
+	ttt = tt*t
+	h00 = 2.0*ttt - 3.0*tt + 1.0
+	h10 = ttt - 2.0*tt + t
+	h01 = -2.0*ttt + 3.0*tt
+	h11 = ttt - tt
+	return h00*v0 + h10*h*m0 + h01*v1 + h11*h*m1
+
+# reduced channel: keys with (value, tangent) pairs, see sxMotionData::reduce() for the layout
+def rdcEncodeChan(smps, tol):
+	nfrm = len(smps)
+	nbits = 16
+	for b in xrange(1, 16):
+		if 1.0 / float((1 << b) - 1) <= tol:
+			nbits = b
+			break
+	qmax = (1 << nbits) - 1
+	tans = []
+	for i in xrange(nfrm):
+		m = (smps[min(i + 1, nfrm - 1)] - smps[max(i - 1, 0)]) * 0.5
+		if i == 0 or i == nfrm - 1: m *= 2.0
+		tans.append(m)
+	tscl = max([abs(m) for m in tans])
+	tscl = struct.unpack("<f", struct.pack("<f", tscl))[0]
+	tquant = 0.5 / tscl if tscl > 0.0 else 0.0
+	qv = [int(round(max(min(v, 1.0), 0.0) * qmax)) for v in smps]
+	dv = [float(q) / qmax for q in qv]
+	qm = [int(round(max(min(m * tquant + 0.5, 1.0), 0.0) * qmax)) for m in tans]
+	dm = [(float(q) / qmax * 2.0 - 1.0) * tscl for q in qm]
+	def segCk(k0, k1):
+		h = float(k1 - k0)
+		for i in xrange(k0 + 1, k1):
+			v = rdcHermite(dv[k0], dm[k0], dv[k1], dm[k1], h, float(i - k0) / h)
+			if abs(v - smps[i]) > tol: return False
+		return True
+	keys = [0]
+	ik = 0
+	while ik < nfrm - 1:
+		inext = ik + 1
+		while inext < nfrm - 1 and segCk(ik, inext + 1):
+			inext += 1
+		keys.append(inext)
+		ik = inext
+	nkeys = len(keys)
+	nvalWords = (nkeys * nbits * 2 + 15) // 16
+	tbits = struct.unpack("<I", struct.pack("<f", tscl))[0]
+	words = [nkeys, nbits, tbits & 0xFFFF, (tbits >> 16) & 0xFFFF]
+	words += keys
+	vals = [0 for i in xrange(nvalWords + 1)]
+	bitOrg = 0
+	for k in keys:
+		for q in (qv[k], qm[k]):
+			for i in xrange(nbits):
+				if q & (1 << i):
+					ib = bitOrg + i
+					vals[ib >> 4] |= 1 << (ib & 0xF)
+			bitOrg += nbits
+	return words + vals
+
 class MotTrk:
-	def __init__(self, data):
+	def __init__(self, data, tol = None):
 		self.mask = 0
 		self.bboxMin = [0.0 for i in xrange(3)]
 		self.bboxMax = [0.0 for i in xrange(3)]
@@ -43,13 +103,35 @@ class MotTrk:
 			for i in xrange(3):
 				if self.mask & (1 << i):
 					self.data.append(max(min(int(round(rel[i])), qscl), 0))
+		self.rdcData = None
+		if tol and tol > 0.0 and self.mask and n >= 2 and n <= 0xFFFF:
+			self.reduce(n, tol)
+
+	def reduce(self, nfrm, tol):
+		stride = 0
+		for i in xrange(3):
+			if self.mask & (1 << i): stride += 1
+		words = [0, 0, 0, 0]
+		ich = 0
+		for i in xrange(3):
+			if self.mask & (1 << i):
+				smps = [float(self.data[ifrm*stride + ich]) / 0xFFFF for ifrm in xrange(nfrm)]
+				size = self.bboxMax[i] - self.bboxMin[i]
+				words[i] = len(words)
+				words += rdcEncodeChan(smps, tol / size)
+				ich += 1
+		words[3] = len(words)
+		if len(words) <= 0xFFFF and len(words) < len(self.data):
+			self.rdcData = words
 
 	def write(self, bw):
 		bw.writeFV(self.bboxMin)
 		bw.writeFV(self.bboxMax)
 		attr = self.mask & 7
+		if self.rdcData:
+			attr |= 1 << 4
 		bw.writeU32(attr)
-		for qval in self.data:
+		for qval in (self.rdcData if self.rdcData else self.data):
 			bw.writeU16(qval)
 
 class MotNode:
@@ -74,12 +156,12 @@ class MotNode:
 				q = xhou.qrot((rx, ry, rz), self.rotOrd)
 				v = xcore.quatGetSV(q, False)
 				qdata.append(v)
-			self.trkQ = MotTrk(qdata)
+			self.trkQ = MotTrk(qdata, self.mot.tolQ)
 		if self.hasT:
 			tdata = []
 			for i in xrange(self.nfrm):
 				tdata.append([self.tx[i], self.ty[i], self.tz[i]])
-			self.trkT = MotTrk(tdata)
+			self.trkT = MotTrk(tdata, self.mot.tolT)
 
 	def write(self, bw):
 		attr = xcore.rotOrdFromStr(self.rotOrd)
@@ -93,9 +175,14 @@ class MotExporter(xcore.BaseExporter):
 	def __init__(self):
 		xcore.BaseExporter.__init__(self)
 		self.sig = "XMOT"
+		self.tolQ = None
+		self.tolT = None
 
-	def build(self, chop):
+	# tolQ/tolT: key reduction tolerances for rotation (log-quat) and position tracks, None to store every frame
+	def build(self, chop, tolQ = None, tolT = None):
 		self.chop = chop
+		self.tolQ = tolQ
+		self.tolT = tolT
 		if not chop: return
 		self.fps = chop.sampleRate()
 		self.srange = chop.sampleRange()
@@ -692,6 +692,7 @@ static DWORD APIENTRY wnd_wrk_entry(void* pSelf) {
 			signal_set(pWrk->mpSigDone);
 		}
 	}
+	signal_set(pWrk->mpSigDone);
 	return 0;
 }
 
@@ -706,6 +707,7 @@ sxWorker* worker_create(xt_worker_func func, void* pData) {
 		pWrk->mhThread = ::CreateThread(NULL, 0, wnd_wrk_entry, pWrk, CREATE_SUSPENDED, &pWrk->mTID);
 		if (pWrk->mhThread) {
 			::ResumeThread(pWrk->mhThread);
+			worker_wait(pWrk);
 		}
 	}
 	return pWrk;
@@ -852,6 +854,7 @@ static void* pthread_wrk_func(void* pSelf) {
 			signal_set(pWrk->mpSigDone);
 		}
 	}
+	signal_set(pWrk->mpSigDone);
 	return (void*)0;
 }
 
@@ -867,6 +870,7 @@ sxWorker* worker_create(xt_worker_func func, void* pData) {
 #if defined(XD_SYS_LINUX)
 		pthread_setname_np(pWrk->mThread, s_pXWorkerTag);
 #endif
+		worker_wait(pWrk);
 	}
 	return pWrk;
 }
@@ -1011,6 +1015,7 @@ static void std_wrk_func(sxWorker* pWrk) {
 			signal_set(pWrk->mpSigDone);
 		}
 	}
+	signal_set(pWrk->mpSigDone);
 }
 
 sxWorker* worker_create(xt_worker_func func, void* pData) {
@@ -1023,6 +1028,7 @@ sxWorker* worker_create(xt_worker_func func, void* pData) {
 		pWrk->mpSigDone = signal_create();
 		pWrk->mEndFlg = false;
 		::new ((void*)&pWrk->mThread) std::thread(std_wrk_func, pWrk);
+		worker_wait(pWrk);
 	}
 	return pWrk;
 }
@@ -3308,6 +3314,14 @@ cxVec decode_octa(const uint16_t oct[2]) {
 	return decode_octa(o);
 }
 
+void encode_octa(const cxVec& v, uint16_t oct[2]) {
+	xt_float2 o = v.encode_octa();
+	for (int i = 0; i < 2; ++i) {
+		float x = nxCalc::saturate((o[i] + 1.0f) * 0.5f);
+		oct[i] = uint16_t(::mth_roundf(x * float(0xFFFF)));
+	}
+}
+
 cxVec rot_sc_x(const cxVec& v, const float s, const float c) {
 	float y = v.y;
 	float z = v.z;
@@ -5175,6 +5189,81 @@ bool seg_tri_intersect_ccw(const cxVec& p0, const cxVec& p1, const cxVec& v0, co
 	return seg_quad_intersect_ccw(p0, p1, v0, v1, v2, v0, pHitPos, pHitNrm);
 }
 
+#ifndef XD_SEGS_TRI_LANES
+#	define XD_SEGS_TRI_LANES 8
+#endif
+
+/* seg_tri_intersect_cw for up to 32 segments, XD_SEGS_TRI_LANES at a time; returns hit mask */
+uint32_t segs_tri_intersect_cw(const cxVec* pP0, const cxVec* pP1, const int nsegs, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pHitPos, cxVec* pHitNrm) {
+	const int N = XD_SEGS_TRI_LANES;
+	/* same ops as seg_quad_intersect_ccw(v0, v2, v1, v0), the degenerate 4th edge test always passes */
+	cxVec e0 = v2 - v0;
+	cxVec e1 = v1 - v2;
+	cxVec e2 = v0 - v1;
+	cxVec n = nxVec::cross(e0, v1 - v0).get_normalized();
+	if (pHitNrm) {
+		*pHitNrm = n;
+	}
+	uint32_t mask = 0;
+	int nall = nxCalc::min(nsegs, 32);
+	for (int org = 0; org < nall; org += N) {
+		int nlanes = nxCalc::min(N, nall - org);
+		float px[N], py[N], pz[N];
+		float dx[N], dy[N], dz[N];
+		float tl[N];
+		int hl[N];
+		for (int i = 0; i < N; ++i) {
+			int iseg = org + (i < nlanes ? i : 0);
+			px[i] = pP0[iseg].x;
+			py[i] = pP0[iseg].y;
+			pz[i] = pP0[iseg].z;
+			dx[i] = pP1[iseg].x;
+			dy[i] = pP1[iseg].y;
+			dz[i] = pP1[iseg].z;
+		}
+		for (int i = 0; i < N; ++i) {
+			float ax = px[i] - v0.x;
+			float ay = py[i] - v0.y;
+			float az = pz[i] - v0.z;
+			float d0 = ax*n.x + ay*n.y + az*n.z;
+			float d1 = (dx[i] - v0.x)*n.x + (dy[i] - v0.y)*n.y + (dz[i] - v0.z)*n.z;
+			float sx = dx[i] - px[i];
+			float sy = dy[i] - py[i];
+			float sz = dz[i] - pz[i];
+			float bx = px[i] - v2.x;
+			float by = py[i] - v2.y;
+			float bz = pz[i] - v2.z;
+			float cx = px[i] - v1.x;
+			float cy = py[i] - v1.y;
+			float cz = pz[i] - v1.z;
+			float tp0 = (e0.y*sz - e0.z*sy)*ax + (e0.z*sx - e0.x*sz)*ay + (e0.x*sy - e0.y*sx)*az;
+			float tp1 = (e1.y*sz - e1.z*sy)*bx + (e1.z*sx - e1.x*sz)*by + (e1.x*sy - e1.y*sx)*bz;
+			float tp2 = (e2.y*sz - e2.z*sy)*cx + (e2.z*sx - e2.x*sz)*cy + (e2.x*sy - e2.y*sx)*cz;
+			float d = sx*n.x + sy*n.y + sz*n.z;
+			int flat = (d == 0.0f ? 1 : 0) | (d0 == 0.0f ? 1 : 0);
+			float dd = flat ? 1.0f : d;
+			float t = -d0 / dd;
+			t = flat ? 0.0f : t;
+			int cross = (d0*d1 > 0.0f ? 0 : 1) & (((d0 == 0.0f ? 1 : 0) & (d1 == 0.0f ? 1 : 0)) ^ 1);
+			int inside = (tp0 >= 0.0f ? 1 : 0) & (tp1 >= 0.0f ? 1 : 0) & (tp2 >= 0.0f ? 1 : 0);
+			hl[i] = cross & inside & (t <= 1.0f ? 1 : 0) & (t >= 0.0f ? 1 : 0);
+			tl[i] = t;
+			dx[i] = sx;
+			dy[i] = sy;
+			dz[i] = sz;
+		}
+		for (int i = 0; i < nlanes; ++i) {
+			if (hl[i]) {
+				mask |= 1U << (org + i);
+				if (pHitPos) {
+					pHitPos[org + i].set(px[i] + dx[i]*tl[i], py[i] + dy[i]*tl[i], pz[i] + dz[i]*tl[i]);
+				}
+			}
+		}
+	}
+	return mask;
+}
+
 xt_float4 seg_tri_intersect_bc_cw(const cxVec& p0, const cxVec& p1, const cxVec& v0, const cxVec& v1, const cxVec& v2) {
 	xt_float4 uvwt;
 	uvwt.fill(-1.0f);
@@ -5455,6 +5544,148 @@ float seg_seg_dist2(const cxVec& s0p0, const cxVec& s0p1, const cxVec& s1p0, con
 	return (bp1 - bp0).mag2();
 }
 
+float seg_tri_dist2(const cxVec& sp0, const cxVec& sp1, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pSegPnt, cxVec* pTriPnt) {
+	cxVec segPnt = sp0;
+	cxVec triPnt = tri_pnt_closest(v0, v1, v2, sp0);
+	float dist2 = nxVec::dist2(segPnt, triPnt);
+	cxVec dir = sp1 - sp0;
+	if (dir.mag2() > 1e-12f) {
+		cxVec nrm = nxVec::cross(v1 - v0, v2 - v0);
+		float d0 = nrm.dot(sp0 - v0);
+		float d1 = nrm.dot(sp1 - v0);
+		bool crossFlg = false;
+		if ((d0 <= 0.0f && d1 >= 0.0f) || (d0 >= 0.0f && d1 <= 0.0f)) {
+			float dd = d0 - d1;
+			if (dd != 0.0f) {
+				cxVec ipos = sp0 + dir*(d0 / dd);
+				if (pnt_in_tri(ipos, v0, v1, v2)) {
+					segPnt = ipos;
+					triPnt = ipos;
+					dist2 = 0.0f;
+					crossFlg = true;
+				}
+			}
+		}
+		if (!crossFlg) {
+			cxVec tpos = tri_pnt_closest(v0, v1, v2, sp1);
+			float d2 = nxVec::dist2(sp1, tpos);
+			if (d2 < dist2) {
+				segPnt = sp1;
+				triPnt = tpos;
+				dist2 = d2;
+			}
+			const cxVec* pVtx[] = { &v0, &v1, &v2 };
+			for (int i = 0; i < 3; ++i) {
+				cxVec bp0, bp1;
+				d2 = seg_seg_dist2(sp0, sp1, *pVtx[i], *pVtx[(i + 1) % 3], &bp0, &bp1);
+				if (d2 < dist2) {
+					segPnt = bp0;
+					triPnt = bp1;
+					dist2 = d2;
+				}
+			}
+		}
+	}
+	if (pSegPnt) {
+		*pSegPnt = segPnt;
+	}
+	if (pTriPnt) {
+		*pTriPnt = triPnt;
+	}
+	return dist2;
+}
+
+static float cap_tri_sweep_dist(const cxVec& cp0, const cxVec& cp1, const cxVec& mov, const float t, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pNrm, cxVec* pTriPnt) {
+	cxVec offs = mov * t;
+	cxVec segPnt;
+	float dist = ::mth_sqrtf(seg_tri_dist2(cp0 + offs, cp1 + offs, v0, v1, v2, &segPnt, pTriPnt));
+	if (dist > 1e-6f) {
+		*pNrm = (segPnt - *pTriPnt) * (1.0f / dist);
+	} else {
+		*pNrm = tri_normal_cw(v0, v1, v2);
+		if (pNrm->dot(mov) > 0.0f) {
+			pNrm->neg();
+		}
+	}
+	return dist;
+}
+
+/* capsule-triangle distance is convex along a translation, so Newton steps on it never step past the time of impact */
+bool cap_tri_sweep(const cxVec& cp0, const cxVec& cp1, const float cr, const cxVec& mov, const cxVec& v0, const cxVec& v1, const cxVec& v2, float* pT, cxVec* pNrm, cxVec* pPos, float* pDist) {
+	const int itrMax = 16;
+	const int bisMax = 24;
+	float tol = nxCalc::max(cr * 1e-3f, 1e-5f);
+	float t = 0.0f;
+	float dist = 0.0f;
+	cxVec nrm(0.0f);
+	cxVec triPnt;
+	bool res = false;
+	bool conv = false;
+	for (int i = 0; i < itrMax; ++i) {
+		dist = cap_tri_sweep_dist(cp0, cp1, mov, t, v0, v1, v2, &nrm, &triPnt);
+		float vn = mov.dot(nrm);
+		if (dist - cr <= tol) {
+			res = vn < 0.0f;
+			if (res) {
+				t = nxCalc::max(t + (dist - cr) / -vn, 0.0f);
+			}
+			conv = true;
+			break;
+		}
+		if (vn >= -1e-8f) {
+			conv = true;
+			break;
+		}
+		t += (dist - cr) / -vn;
+		if (t > 1.0f) {
+			conv = true;
+			break;
+		}
+	}
+	if (!conv) {
+		/* grazing approach, Newton steps still closing in: bisect the rest of the move on the distance slope */
+		float t0 = t;
+		float t1 = 1.0f;
+		bool touch = false;
+		for (int i = 0; i < bisMax; ++i) {
+			float tm = (t0 + t1) * 0.5f;
+			cxVec mnrm;
+			cxVec mpnt;
+			float mdist = cap_tri_sweep_dist(cp0, cp1, mov, tm, v0, v1, v2, &mnrm, &mpnt);
+			if (mdist - cr <= tol) {
+				touch = true;
+				t1 = tm;
+				dist = mdist;
+				nrm = mnrm;
+				triPnt = mpnt;
+			} else if (touch || mov.dot(mnrm) < 0.0f) {
+				t0 = tm;
+			} else {
+				t1 = tm;
+			}
+		}
+		if (touch) {
+			res = mov.dot(nrm) < 0.0f;
+			t = t1;
+		}
+	}
+	if (res) {
+		if (pT) {
+			*pT = t;
+		}
+		if (pNrm) {
+			*pNrm = nrm;
+		}
+		if (pPos) {
+			*pPos = triPnt;
+		}
+		if (pDist) {
+			*pDist = dist;
+		}
+	}
+	return res;
+}
+
 bool cap_aabb_overlap(const cxVec& cp0, const cxVec& cp1, const float cr, const cxVec& bmin, const cxVec& bmax) {
 	cxVec brad = (bmax - bmin) * 0.5f;
 	cxVec bcen = (bmin + bmax) * 0.5f;
@@ -5925,7 +6156,202 @@ static void build_aabb_tree_node(sxAABBTreeBuildWk* pWk, int inode, int idx, int
 	}
 }
 
-void build_aabb_tree(const cxAABB* pSrcBoxes, const int32_t nsrc, cxAABB* pNodeBoxes, int32_t* pNodeInfos, int32_t* pIdxWk) {
+#ifndef XD_AABB_TREE_SAH_BINS
+#	define XD_AABB_TREE_SAH_BINS 16
+#endif
+
+#ifndef XD_AABB_TREE_PAR_MIN
+#	define XD_AABB_TREE_PAR_MIN 2048
+#endif
+
+static inline float aabb_half_area(const cxAABB& bb) {
+	cxVec v = bb.get_size_vec();
+	return v.x*v.y + v.y*v.z + v.z*v.x;
+}
+
+struct sxAABBTreeSAHTask {
+	sxAABBTreeBuildWk* pWk;
+	int inode;
+	int nodeBase;
+	int idx;
+	int cnt;
+};
+
+static int build_aabb_tree_sah_split(sxAABBTreeBuildWk* pWk, int inode, int idx, int cnt) {
+	const int nbins = XD_AABB_TREE_SAH_BINS;
+	int32_t* pIdx = &pWk->pIdxWk[idx];
+	const cxAABB* pBoxes = pWk->pSrcBoxes;
+	cxAABB bb = pBoxes[pIdx[0]];
+	cxVec c = bb.get_center();
+	cxAABB cbb(c, c);
+	for (int i = 1; i < cnt; ++i) {
+		const cxAABB& sbb = pBoxes[pIdx[i]];
+		bb.merge(sbb);
+		cbb.add_pnt(sbb.get_center());
+	}
+	pWk->pNodeBoxes[inode] = bb;
+	if (cnt == 2) return 1;
+	cxVec cmin = cbb.get_min_pos();
+	cxVec csize = cbb.get_size_vec();
+	cxAABB binBoxes[3][XD_AABB_TREE_SAH_BINS];
+	int binCnts[3][XD_AABB_TREE_SAH_BINS];
+	float scl[3];
+	for (int j = 0; j < 3; ++j) {
+		scl[j] = csize[j] > 0.0f ? float(nbins) * (1.0f - 1e-5f) / csize[j] : 0.0f;
+		for (int k = 0; k < nbins; ++k) {
+			binCnts[j][k] = 0;
+		}
+	}
+	for (int i = 0; i < cnt; ++i) {
+		const cxAABB& sbb = pBoxes[pIdx[i]];
+		c = sbb.get_center();
+		for (int j = 0; j < 3; ++j) {
+			if (scl[j] == 0.0f) continue;
+			int ibin = nxCalc::clamp(int((c[j] - cmin[j]) * scl[j]), 0, nbins - 1);
+			if (binCnts[j][ibin] == 0) {
+				binBoxes[j][ibin] = sbb;
+			} else {
+				binBoxes[j][ibin].merge(sbb);
+			}
+			++binCnts[j][ibin];
+		}
+	}
+	float bestCost = FLT_MAX;
+	int bestAxis = -1;
+	int bestBin = 0;
+	float rarea[XD_AABB_TREE_SAH_BINS];
+	for (int j = 0; j < 3; ++j) {
+		if (scl[j] == 0.0f) continue;
+		cxAABB acc;
+		acc.init();
+		bool accInit = false;
+		for (int k = nbins - 1; k > 0; --k) {
+			if (binCnts[j][k]) {
+				if (accInit) {
+					acc.merge(binBoxes[j][k]);
+				} else {
+					acc = binBoxes[j][k];
+					accInit = true;
+				}
+			}
+			rarea[k] = accInit ? aabb_half_area(acc) : 0.0f;
+		}
+		accInit = false;
+		int lcnt = 0;
+		for (int k = 0; k < nbins - 1; ++k) {
+			if (binCnts[j][k]) {
+				if (accInit) {
+					acc.merge(binBoxes[j][k]);
+				} else {
+					acc = binBoxes[j][k];
+					accInit = true;
+				}
+				lcnt += binCnts[j][k];
+			}
+			int rcnt = cnt - lcnt;
+			if (lcnt == 0 || rcnt == 0) continue;
+			float cost = aabb_half_area(acc)*float(lcnt) + rarea[k + 1]*float(rcnt);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = j;
+				bestBin = k;
+			}
+		}
+	}
+	int mid = 0;
+	if (bestAxis >= 0) {
+		for (int i = 0; i < cnt; ++i) {
+			int ibox = pIdx[i];
+			float cval = pBoxes[ibox].get_center()[bestAxis];
+			int ibin = nxCalc::clamp(int((cval - cmin[bestAxis]) * scl[bestAxis]), 0, nbins - 1);
+			if (ibin <= bestBin) {
+				pIdx[i] = pIdx[mid];
+				pIdx[mid] = ibox;
+				++mid;
+			}
+		}
+	}
+	if (mid == 0 || mid == cnt) {
+		mid = cnt >> 1;
+	}
+	return mid;
+}
+
+static void build_aabb_tree_sah_node(sxAABBTreeBuildWk* pWk, int inode, int nodeBase, int idx, int cnt) {
+	if (cnt == 1) {
+		build_aabb_tree_leaf(pWk, inode, idx);
+		return;
+	}
+	int mid = build_aabb_tree_sah_split(pWk, inode, idx, cnt);
+	int32_t* pInfo = &pWk->pNodeInfos[inode * 2];
+	pInfo[0] = nodeBase;
+	pInfo[1] = nodeBase + 1;
+	/* a subtree over n boxes always takes 2n - 1 nodes, so child ranges are known in advance */
+	int leftBase = nodeBase + 2;
+	int rightBase = leftBase + (mid - 1)*2;
+	build_aabb_tree_sah_node(pWk, pInfo[0], leftBase, idx, mid);
+	build_aabb_tree_sah_node(pWk, pInfo[1], rightBase, idx + mid, cnt - mid);
+}
+
+static void build_aabb_tree_sah_job(const sxJobContext* pCtx) {
+	sxAABBTreeSAHTask* pTask = (sxAABBTreeSAHTask*)pCtx->mpJob->mpData;
+	build_aabb_tree_sah_node(pTask->pWk, pTask->inode, pTask->nodeBase, pTask->idx, pTask->cnt);
+}
+
+static void build_aabb_tree_sah_top(sxAABBTreeBuildWk* pWk, int inode, int nodeBase, int idx, int cnt, int depth, sxAABBTreeSAHTask* pTasks, int* pTaskCnt) {
+	if (depth <= 0 || cnt < XD_AABB_TREE_PAR_MIN) {
+		sxAABBTreeSAHTask* pTask = &pTasks[(*pTaskCnt)++];
+		pTask->pWk = pWk;
+		pTask->inode = inode;
+		pTask->nodeBase = nodeBase;
+		pTask->idx = idx;
+		pTask->cnt = cnt;
+		return;
+	}
+	int mid = build_aabb_tree_sah_split(pWk, inode, idx, cnt);
+	int32_t* pInfo = &pWk->pNodeInfos[inode * 2];
+	pInfo[0] = nodeBase;
+	pInfo[1] = nodeBase + 1;
+	int leftBase = nodeBase + 2;
+	int rightBase = leftBase + (mid - 1)*2;
+	build_aabb_tree_sah_top(pWk, pInfo[0], leftBase, idx, mid, depth - 1, pTasks, pTaskCnt);
+	build_aabb_tree_sah_top(pWk, pInfo[1], rightBase, idx + mid, cnt - mid, depth - 1, pTasks, pTaskCnt);
+}
+
+static void build_aabb_tree_sah(sxAABBTreeBuildWk* pWk, cxBrigade* pBgd) {
+	int nsrc = pWk->nsrc;
+	int nwrk = pBgd ? pBgd->get_active_workers_num() : 0;
+	if (nwrk < 2 || nsrc < XD_AABB_TREE_PAR_MIN*2) {
+		build_aabb_tree_sah_node(pWk, 0, 1, 0, nsrc);
+		return;
+	}
+	int depth = 0;
+	while ((1 << depth) < nwrk*4 && depth < 6) {
+		++depth;
+	}
+	sxAABBTreeSAHTask tasks[1 << 6];
+	int ntask = 0;
+	build_aabb_tree_sah_top(pWk, 0, 1, 0, nsrc, depth, tasks, &ntask);
+	sxJobQueue* pQue = nxTask::queue_create(ntask);
+	if (pQue) {
+		sxJob jobs[1 << 6];
+		for (int i = 0; i < ntask; ++i) {
+			jobs[i].mFunc = build_aabb_tree_sah_job;
+			jobs[i].mpData = &tasks[i];
+			jobs[i].mParam = 0;
+			nxTask::queue_add(pQue, &jobs[i]);
+		}
+		nxTask::queue_exec(pQue, pBgd);
+		nxTask::queue_destroy(pQue);
+	} else {
+		for (int i = 0; i < ntask; ++i) {
+			build_aabb_tree_sah_node(pWk, tasks[i].inode, tasks[i].nodeBase, tasks[i].idx, tasks[i].cnt);
+		}
+	}
+}
+
+void build_aabb_tree(const cxAABB* pSrcBoxes, const int32_t nsrc, cxAABB* pNodeBoxes, int32_t* pNodeInfos, int32_t* pIdxWk, const bool sah, cxBrigade* pBgd) {
+	if (!pSrcBoxes || nsrc < 1 || !pNodeBoxes || !pNodeInfos || !pIdxWk) return;
 	sxAABBTreeBuildWk wk;
 	wk.pSrcBoxes = pSrcBoxes;
 	wk.nsrc = nsrc;
@@ -5936,6 +6362,10 @@ void build_aabb_tree(const cxAABB* pSrcBoxes, const int32_t nsrc, cxAABB* pNodeB
 	for (int32_t i = 0; i < nsrc; ++i) {
 		pIdxWk[i] = i;
 	}
+	if (sah) {
+		build_aabb_tree_sah(&wk, pBgd);
+		return;
+	}
 	cxAABB rootBB = pSrcBoxes[0];
 	for (int32_t i = 1; i < nsrc; ++i) {
 		rootBB.merge(pSrcBoxes[i]);
@@ -5952,6 +6382,186 @@ void build_aabb_tree(const cxAABB* pSrcBoxes, const int32_t nsrc, cxAABB* pNodeB
 	build_aabb_tree_node(&wk, 0, 0, nsrc, axis);
 }
 
+float aabb_tree_sah_cost(const cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const int32_t nnodes, const float travCost, const float isectCost) {
+	if (!pNodeBoxes || !pNodeInfos || nnodes < 1) return 0.0f;
+	float rootArea = aabb_half_area(pNodeBoxes[0]);
+	if (rootArea <= 0.0f) return 0.0f;
+	double cost = 0.0;
+	for (int32_t i = 0; i < nnodes; ++i) {
+		bool leaf = pNodeInfos[i*2 + 1] < 0;
+		cost += double(aabb_half_area(pNodeBoxes[i]) * (leaf ? isectCost : travCost));
+	}
+	return float(cost / double(rootArea));
+}
+
+struct sxAABBTreeRefitWk {
+	const cxAABB* pSrcBoxes;
+	cxAABB* pNodeBoxes;
+	const int32_t* pNodeInfos;
+};
+
+struct sxAABBTreeRefitTask {
+	const sxAABBTreeRefitWk* pWk;
+	int inode;
+};
+
+static void refit_aabb_tree_node(const sxAABBTreeRefitWk* pWk, int inode) {
+	const int32_t* pInfo = &pWk->pNodeInfos[inode * 2];
+	if (pInfo[1] < 0) {
+		pWk->pNodeBoxes[inode] = pWk->pSrcBoxes[pInfo[0]];
+		return;
+	}
+	refit_aabb_tree_node(pWk, pInfo[0]);
+	refit_aabb_tree_node(pWk, pInfo[1]);
+	cxAABB bb = pWk->pNodeBoxes[pInfo[0]];
+	bb.merge(pWk->pNodeBoxes[pInfo[1]]);
+	pWk->pNodeBoxes[inode] = bb;
+}
+
+static void refit_aabb_tree_job(const sxJobContext* pCtx) {
+	sxAABBTreeRefitTask* pTask = (sxAABBTreeRefitTask*)pCtx->mpJob->mpData;
+	refit_aabb_tree_node(pTask->pWk, pTask->inode);
+}
+
+static void refit_aabb_tree_top(const sxAABBTreeRefitWk* pWk, int inode, int depth, sxAABBTreeRefitTask* pTasks, int* pTaskCnt) {
+	const int32_t* pInfo = &pWk->pNodeInfos[inode * 2];
+	if (depth <= 0 || pInfo[1] < 0) {
+		sxAABBTreeRefitTask* pTask = &pTasks[(*pTaskCnt)++];
+		pTask->pWk = pWk;
+		pTask->inode = inode;
+		return;
+	}
+	refit_aabb_tree_top(pWk, pInfo[0], depth - 1, pTasks, pTaskCnt);
+	refit_aabb_tree_top(pWk, pInfo[1], depth - 1, pTasks, pTaskCnt);
+}
+
+static void refit_aabb_tree_merge(const sxAABBTreeRefitWk* pWk, int inode, int depth) {
+	const int32_t* pInfo = &pWk->pNodeInfos[inode * 2];
+	if (depth <= 0 || pInfo[1] < 0) return;
+	refit_aabb_tree_merge(pWk, pInfo[0], depth - 1);
+	refit_aabb_tree_merge(pWk, pInfo[1], depth - 1);
+	cxAABB bb = pWk->pNodeBoxes[pInfo[0]];
+	bb.merge(pWk->pNodeBoxes[pInfo[1]]);
+	pWk->pNodeBoxes[inode] = bb;
+}
+
+/* keeps the topology, subtrees below the top levels are refitted as separate jobs */
+void refit_aabb_tree(const cxAABB* pSrcBoxes, cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const int32_t nnodes, cxBrigade* pBgd) {
+	if (!pSrcBoxes || !pNodeBoxes || !pNodeInfos || nnodes < 1) return;
+	sxAABBTreeRefitWk wk;
+	wk.pSrcBoxes = pSrcBoxes;
+	wk.pNodeBoxes = pNodeBoxes;
+	wk.pNodeInfos = pNodeInfos;
+	int nwrk = pBgd ? pBgd->get_active_workers_num() : 0;
+	if (nwrk < 2 || nnodes < XD_AABB_TREE_PAR_MIN*4) {
+		refit_aabb_tree_node(&wk, 0);
+		return;
+	}
+	int depth = 0;
+	while ((1 << depth) < nwrk*4 && depth < 6) {
+		++depth;
+	}
+	sxAABBTreeRefitTask tasks[1 << 6];
+	int ntask = 0;
+	refit_aabb_tree_top(&wk, 0, depth, tasks, &ntask);
+	sxJobQueue* pQue = nxTask::queue_create(ntask);
+	if (pQue) {
+		sxJob jobs[1 << 6];
+		for (int i = 0; i < ntask; ++i) {
+			jobs[i].mFunc = refit_aabb_tree_job;
+			jobs[i].mpData = &tasks[i];
+			jobs[i].mParam = 0;
+			nxTask::queue_add(pQue, &jobs[i]);
+		}
+		nxTask::queue_exec(pQue, pBgd);
+		nxTask::queue_destroy(pQue);
+	} else {
+		for (int i = 0; i < ntask; ++i) {
+			refit_aabb_tree_node(&wk, tasks[i].inode);
+		}
+	}
+	refit_aabb_tree_merge(&wk, 0, depth);
+}
+
+/* blocks of 32 boxes per mask word, branchless so that the plane loop vectorizes */
+int cull_aabb_batch(const xt_float4* pPlanes, const int nplanes, const float* pCX, const float* pCY, const float* pCZ, const float* pEX, const float* pEY, const float* pEZ, const int n, uint32_t* pBits) {
+	if (!pPlanes || !pBits || n < 1) return 0;
+	int ncull = 0;
+	for (int org = 0; org < n; org += 32) {
+		int cnt = nxCalc::min(n - org, 32);
+		float dist[32];
+		for (int i = 0; i < 32; ++i) {
+			dist[i] = FLT_MAX;
+		}
+		const float* pCXB = pCX + org;
+		const float* pCYB = pCY + org;
+		const float* pCZB = pCZ + org;
+		const float* pEXB = pEX + org;
+		const float* pEYB = pEY + org;
+		const float* pEZB = pEZ + org;
+		for (int ipl = 0; ipl < nplanes; ++ipl) {
+			float a = pPlanes[ipl].x;
+			float b = pPlanes[ipl].y;
+			float c = pPlanes[ipl].z;
+			float d = pPlanes[ipl].w;
+			float aa = ::mth_fabsf(a);
+			float ab = ::mth_fabsf(b);
+			float ac = ::mth_fabsf(c);
+			for (int i = 0; i < cnt; ++i) {
+				float sd = a*pCXB[i] + b*pCYB[i] + c*pCZB[i] + d;
+				float r = aa*pEXB[i] + ab*pEYB[i] + ac*pEZB[i];
+				dist[i] = nxCalc::min(dist[i], sd + r);
+			}
+		}
+		uint32_t mask = 0;
+		for (int i = 0; i < cnt; ++i) {
+			mask |= uint32_t(dist[i] < 0.0f) << i;
+		}
+		pBits[org >> 5] = mask;
+		for (uint32_t m = mask; m; m &= m - 1) {
+			++ncull;
+		}
+	}
+	return ncull;
+}
+
+int cull_aabbs(const xt_float4* pPlanes, const int nplanes, const cxAABB* pBoxes, const int n, uint32_t* pBits) {
+	if (!pPlanes || !pBoxes || !pBits || n < 1) return 0;
+	int ncull = 0;
+	float soa[6][32];
+	for (int org = 0; org < n; org += 32) {
+		int cnt = nxCalc::min(n - org, 32);
+		const cxAABB* pBlk = pBoxes + org;
+		for (int i = 0; i < cnt; ++i) {
+			cxVec bbmin = pBlk[i].get_min_pos();
+			cxVec bbmax = pBlk[i].get_max_pos();
+			soa[0][i] = (bbmin.x + bbmax.x) * 0.5f;
+			soa[1][i] = (bbmin.y + bbmax.y) * 0.5f;
+			soa[2][i] = (bbmin.z + bbmax.z) * 0.5f;
+			soa[3][i] = (bbmax.x - bbmin.x) * 0.5f;
+			soa[4][i] = (bbmax.y - bbmin.y) * 0.5f;
+			soa[5][i] = (bbmax.z - bbmin.z) * 0.5f;
+		}
+		ncull += cull_aabb_batch(pPlanes, nplanes, soa[0], soa[1], soa[2], soa[3], soa[4], soa[5], cnt, pBits + (org >> 5));
+	}
+	return ncull;
+}
+
+/* -k*w <= x <= k*w, -k*w <= y <= k*w for clip = pos * mtx */
+void clip_xy_planes(const cxMtx& mtx, xt_float4* pPlanes, const float k) {
+	if (!pPlanes) return;
+	for (int i = 0; i < 4; ++i) {
+		int axis = i >> 1;
+		float s = (i & 1) ? -1.0f : 1.0f;
+		pPlanes[i].set(
+			mtx.m[0][3]*k + mtx.m[0][axis]*s,
+			mtx.m[1][3]*k + mtx.m[1][axis]*s,
+			mtx.m[2][3]*k + mtx.m[2][axis]*s,
+			mtx.m[3][3]*k + mtx.m[3][axis]*s
+		);
+	}
+}
+
 } // nxGeom
 
 
@@ -6190,6 +6800,20 @@ bool cxFrustum::overlaps(const cxSphere& sph) const {
 	return false;
 }
 
+void cxFrustum::get_cull_planes(xt_float4* pPlanes) const {
+	if (!pPlanes) return;
+	for (int i = 0; i < 6; ++i) {
+		cxVec n = mNrm[i];
+		pPlanes[i].set(-n.x, -n.y, -n.z, n.dot(i < 3 ? mPnt[0] : mPnt[6]));
+	}
+}
+
+int cxFrustum::cull(const cxAABB* pBoxes, const int nboxes, uint32_t* pBits) const {
+	xt_float4 planes[6];
+	get_cull_planes(planes);
+	return nxGeom::cull_aabbs(planes, 6, pBoxes, nboxes, pBits);
+}
+
 bool cxFrustum::cull(const cxAABB& box) const {
 	cxVec c = box.get_center();
 	cxVec r = box.get_max_pos() - c;
@@ -6287,6 +6911,316 @@ void cxFrustum::dump_geo(const char* pOutPath) const {
 }
 
 
+cxOcclusionBuffer* cxOcclusionBuffer::create(const int w, const int h, const int maxTris) {
+	cxOcclusionBuffer* pBuf = nullptr;
+	if (w > 0 && h > 0 && w <= 0x7FFF && h <= 0x7FFF && maxTris > 0) {
+		const int tileW = 32;
+		const int tileH = 32;
+		int ntx = (w + tileW - 1) / tileW;
+		int nty = (h + tileH - 1) / tileH;
+		size_t size = XD_ALIGN(sizeof(cxOcclusionBuffer), 0x10);
+		size_t depthOffs = size;
+		size += XD_ALIGN(w * h * sizeof(float), 0x10);
+		size_t trisOffs = size;
+		size += XD_ALIGN(maxTris * sizeof(Tri), 0x10);
+		size_t jobsOffs = size;
+		size += ntx * nty * sizeof(sxJob);
+		pBuf = (cxOcclusionBuffer*)nxCore::mem_alloc(size, "xOcclBuf");
+		if (pBuf) {
+			nxCore::mem_zero((void*)pBuf, size);
+			pBuf->mpDepth = (float*)XD_INCR_PTR(pBuf, depthOffs);
+			pBuf->mpTris = (Tri*)XD_INCR_PTR(pBuf, trisOffs);
+			pBuf->mpJobs = (sxJob*)XD_INCR_PTR(pBuf, jobsOffs);
+			pBuf->mW = w;
+			pBuf->mH = h;
+			pBuf->mTileW = tileW;
+			pBuf->mTileH = tileH;
+			pBuf->mTilesX = ntx;
+			pBuf->mTilesY = nty;
+			pBuf->mTrisMax = maxTris;
+			pBuf->mViewProj.identity();
+			pBuf->mNear = 1e-3f;
+			for (int i = 0; i < ntx * nty; ++i) {
+				pBuf->mpJobs[i].mFunc = raster_job;
+				pBuf->mpJobs[i].mpData = pBuf;
+				pBuf->mpJobs[i].mParam = i;
+			}
+		}
+	}
+	return pBuf;
+}
+
+void cxOcclusionBuffer::destroy(cxOcclusionBuffer* pBuf) {
+	if (pBuf) {
+		nxCore::mem_free(pBuf);
+	}
+}
+
+/* znear: the clip-space w that triangles are clipped at, the view near distance for perspective projections */
+void cxOcclusionBuffer::begin(const cxMtx& viewProj, const float znear) {
+	mViewProj = viewProj;
+	mNear = nxCalc::max(znear, 1e-6f);
+	mTrisNum = 0;
+	nxCore::mem_zero(&mStats, sizeof(mStats));
+}
+
+void cxOcclusionBuffer::add_clipped_tri(const xt_float4& v0, const xt_float4& v1, const xt_float4& v2) {
+	if (mTrisNum >= mTrisMax) return;
+	const xt_float4* pVtx[3] = { &v0, &v1, &v2 };
+	float sx[3];
+	float sy[3];
+	float sz[3];
+	for (int i = 0; i < 3; ++i) {
+		float rw = nxCalc::rcp0(pVtx[i]->w);
+		sx[i] = (pVtx[i]->x*rw*0.5f + 0.5f) * float(mW);
+		sy[i] = (pVtx[i]->y*rw*0.5f + 0.5f) * float(mH);
+		sz[i] = rw;
+	}
+	float area = (sx[1] - sx[0])*(sy[2] - sy[0]) - (sy[1] - sy[0])*(sx[2] - sx[0]);
+	if (::mth_fabsf(area) < 1e-6f) return;
+	if (area < 0.0f) {
+		float tx = sx[1];
+		float ty = sy[1];
+		float tz = sz[1];
+		sx[1] = sx[2];
+		sy[1] = sy[2];
+		sz[1] = sz[2];
+		sx[2] = tx;
+		sy[2] = ty;
+		sz[2] = tz;
+		area = -area;
+	}
+	float xmin = nxCalc::min(sx[0], sx[1], sx[2]);
+	float ymin = nxCalc::min(sy[0], sy[1], sy[2]);
+	float xmax = nxCalc::max(sx[0], sx[1], sx[2]);
+	float ymax = nxCalc::max(sy[0], sy[1], sy[2]);
+	if (xmax < 0.0f || ymax < 0.0f || xmin >= float(mW) || ymin >= float(mH)) return;
+	Tri* pTri = &mpTris[mTrisNum];
+	pTri->xmin = int16_t(nxCalc::max(xmin, 0.0f));
+	pTri->ymin = int16_t(nxCalc::max(ymin, 0.0f));
+	pTri->xmax = int16_t(nxCalc::min(xmax, float(mW - 1)));
+	pTri->ymax = int16_t(nxCalc::min(ymax, float(mH - 1)));
+	for (int i = 0; i < 3; ++i) {
+		int j = i < 2 ? i + 1 : 0;
+		float a = sy[i] - sy[j];
+		float b = sx[j] - sx[i];
+		pTri->ea[i] = a;
+		pTri->eb[i] = b;
+		pTri->ec[i] = sx[i]*sy[j] - sy[i]*sx[j];
+	}
+	float ra = 1.0f / area;
+	float dz1 = sz[1] - sz[0];
+	float dz2 = sz[2] - sz[0];
+	pTri->zx = (dz1*(sy[2] - sy[0]) - dz2*(sy[1] - sy[0])) * ra;
+	pTri->zy = (dz2*(sx[1] - sx[0]) - dz1*(sx[2] - sx[0])) * ra;
+	/* farthest value within the pixel */
+	pTri->zc = sz[0] - pTri->zx*sx[0] - pTri->zy*sy[0] - (::mth_fabsf(pTri->zx) + ::mth_fabsf(pTri->zy))*0.5f;
+	++mTrisNum;
+}
+
+bool cxOcclusionBuffer::add_tri(const cxVec& v0, const cxVec& v1, const cxVec& v2) {
+	xt_float4 cv[3];
+	cv[0].set(v0.x, v0.y, v0.z, 1.0f);
+	cv[1].set(v1.x, v1.y, v1.z, 1.0f);
+	cv[2].set(v2.x, v2.y, v2.z, 1.0f);
+	int nin = 0;
+	for (int i = 0; i < 3; ++i) {
+		cv[i] = mViewProj.apply(cv[i]);
+		if (cv[i].w >= mNear) ++nin;
+	}
+	if (nin == 0) return false;
+	int ntris = mTrisNum;
+	if (nin == 3) {
+		add_clipped_tri(cv[0], cv[1], cv[2]);
+	} else {
+		xt_float4 poly[4];
+		int npol = 0;
+		for (int i = 0; i < 3; ++i) {
+			const xt_float4& va = cv[i];
+			const xt_float4& vb = cv[i < 2 ? i + 1 : 0];
+			bool ina = va.w >= mNear;
+			bool inb = vb.w >= mNear;
+			if (ina) {
+				poly[npol++] = va;
+			}
+			if (ina != inb) {
+				float t = (mNear - va.w) / (vb.w - va.w);
+				xt_float4 vc;
+				vc.x = nxCalc::lerp(va.x, vb.x, t);
+				vc.y = nxCalc::lerp(va.y, vb.y, t);
+				vc.z = nxCalc::lerp(va.z, vb.z, t);
+				vc.w = mNear;
+				poly[npol++] = vc;
+			}
+		}
+		for (int i = 2; i < npol; ++i) {
+			add_clipped_tri(poly[0], poly[i - 1], poly[i]);
+		}
+	}
+	return mTrisNum > ntris;
+}
+
+/* pIdx: 3 point indices per triangle, or nullptr for consecutive points */
+int cxOcclusionBuffer::add_tris(const cxVec* pPnts, const int32_t* pIdx, const int ntris, const cxMtx* pXform) {
+	if (!pPnts) return 0;
+	int n = 0;
+	for (int i = 0; i < ntris; ++i) {
+		cxVec v[3];
+		for (int j = 0; j < 3; ++j) {
+			v[j] = pPnts[pIdx ? pIdx[i*3 + j] : i*3 + j];
+			if (pXform) {
+				v[j] = pXform->calc_pnt(v[j]);
+			}
+		}
+		if (add_tri(v[0], v[1], v[2])) {
+			++n;
+		}
+	}
+	return n;
+}
+
+int cxOcclusionBuffer::add_collision(const sxCollisionData& col, const cxMtx* pXform) {
+	int n = 0;
+	for (uint32_t ipol = 0; ipol < col.mPolNum; ++ipol) {
+		int ntri = col.get_pol_num_tris(ipol);
+		for (int itri = 0; itri < ntri; ++itri) {
+			cxVec v[3];
+			for (int j = 0; j < 3; ++j) {
+				v[j] = col.get_pnt(col.get_pol_tri_pnt_idx(ipol, itri, j));
+				if (pXform) {
+					v[j] = pXform->calc_pnt(v[j]);
+				}
+			}
+			if (add_tri(v[0], v[1], v[2])) {
+				++n;
+			}
+		}
+	}
+	return n;
+}
+
+/* fixed-width branchless spans, so that GCC and Clang vectorize the pixel loop */
+void cxOcclusionBuffer::raster_tile(const int itile) {
+	int tx0 = (itile % mTilesX) * mTileW;
+	int ty0 = (itile / mTilesX) * mTileH;
+	int tx1 = nxCalc::min(tx0 + mTileW, mW) - 1;
+	int ty1 = nxCalc::min(ty0 + mTileH, mH) - 1;
+	for (int y = ty0; y <= ty1; ++y) {
+		nxCore::mem_zero(&mpDepth[y*mW + tx0], (tx1 - tx0 + 1) * sizeof(float));
+	}
+	for (int itri = 0; itri < mTrisNum; ++itri) {
+		const Tri* pTri = &mpTris[itri];
+		if (pTri->xmax < tx0 || pTri->xmin > tx1 || pTri->ymax < ty0 || pTri->ymin > ty1) continue;
+		int x0 = nxCalc::max(int(pTri->xmin), tx0);
+		int x1 = nxCalc::min(int(pTri->xmax), tx1);
+		int y0 = nxCalc::max(int(pTri->ymin), ty0);
+		int y1 = nxCalc::min(int(pTri->ymax), ty1);
+		float a0 = pTri->ea[0];
+		float a1 = pTri->ea[1];
+		float a2 = pTri->ea[2];
+		float zx = pTri->zx;
+		for (int y = y0; y <= y1; ++y) {
+			float fy = float(y) + 0.5f;
+			float r0 = pTri->eb[0]*fy + pTri->ec[0];
+			float r1 = pTri->eb[1]*fy + pTri->ec[1];
+			float r2 = pTri->eb[2]*fy + pTri->ec[2];
+			float rz = pTri->zy*fy + pTri->zc;
+			float* pRow = &mpDepth[y*mW];
+			for (int x = x0; x <= x1; ++x) {
+				float fx = float(x) + 0.5f;
+				float e0 = a0*fx + r0;
+				float e1 = a1*fx + r1;
+				float e2 = a2*fx + r2;
+				float z = zx*fx + rz;
+				float d = pRow[x];
+				bool in = (e0 >= 0.0f) & (e1 >= 0.0f) & (e2 >= 0.0f) & (z > d);
+				pRow[x] = in ? z : d;
+			}
+		}
+	}
+}
+
+void cxOcclusionBuffer::raster_job(const sxJobContext* pCtx) {
+	sxJob* pJob = pCtx->mpJob;
+	cxOcclusionBuffer* pBuf = (cxOcclusionBuffer*)pJob->mpData;
+	pBuf->raster_tile(pJob->mParam);
+}
+
+void cxOcclusionBuffer::rasterize(cxBrigade* pBgd) {
+	int ntiles = get_tiles_num();
+	mStats.tris = mTrisNum;
+	int nwrk = pBgd ? pBgd->get_active_workers_num() : 0;
+	sxJobQueue* pQue = nwrk > 1 ? nxTask::queue_create(ntiles) : nullptr;
+	if (pQue) {
+		for (int i = 0; i < ntiles; ++i) {
+			nxTask::queue_add(pQue, &mpJobs[i]);
+		}
+		nxTask::queue_exec(pQue, pBgd);
+		nxTask::queue_destroy(pQue);
+	} else {
+		for (int i = 0; i < ntiles; ++i) {
+			raster_tile(i);
+		}
+	}
+}
+
+/* the box's nearest point against every pixel its screen rect touches plus a one pixel border,
+   which covers occluder edges crossing pixels whose centers they cover; parts off screen don't count */
+bool cxOcclusionBuffer::occluded(const cxAABB& box) {
+	nxSys::atomic_inc(&mStats.tested);
+	cxVec bmin = box.get_min_pos();
+	cxVec bmax = box.get_max_pos();
+	float xmin = FLT_MAX;
+	float ymin = FLT_MAX;
+	float xmax = -FLT_MAX;
+	float ymax = -FLT_MAX;
+	float zmax = 0.0f;
+	for (int i = 0; i < 8; ++i) {
+		xt_float4 cv;
+		cv.set(i & 1 ? bmax.x : bmin.x, i & 2 ? bmax.y : bmin.y, i & 4 ? bmax.z : bmin.z, 1.0f);
+		cv = mViewProj.apply(cv);
+		if (cv.w < mNear) return false;
+		float rw = 1.0f / cv.w;
+		float sx = (cv.x*rw*0.5f + 0.5f) * float(mW);
+		float sy = (cv.y*rw*0.5f + 0.5f) * float(mH);
+		xmin = nxCalc::min(xmin, sx);
+		ymin = nxCalc::min(ymin, sy);
+		xmax = nxCalc::max(xmax, sx);
+		ymax = nxCalc::max(ymax, sy);
+		zmax = nxCalc::max(zmax, rw);
+	}
+	if (xmax < 0.0f || ymax < 0.0f || xmin >= float(mW) || ymin >= float(mH)) return false;
+	int x0 = int(nxCalc::max(xmin - 1.0f, 0.0f));
+	int y0 = int(nxCalc::max(ymin - 1.0f, 0.0f));
+	int x1 = int(nxCalc::min(xmax + 1.0f, float(mW - 1)));
+	int y1 = int(nxCalc::min(ymax + 1.0f, float(mH - 1)));
+	for (int y = y0; y <= y1; ++y) {
+		const float* pRow = &mpDepth[y*mW];
+		int nvis = 0;
+		for (int x = x0; x <= x1; ++x) {
+			nvis += pRow[x] <= zmax ? 1 : 0;
+		}
+		if (nvis) return false;
+	}
+	nxSys::atomic_inc(&mStats.occluded);
+	return true;
+}
+
+/* sets the bits of occluded boxes, boxes already marked are skipped; returns the number of newly culled boxes */
+int cxOcclusionBuffer::cull(const cxAABB* pBoxes, const int nboxes, uint32_t* pBits) {
+	if (!pBoxes || !pBits) return 0;
+	int ncull = 0;
+	for (int i = 0; i < nboxes; ++i) {
+		if (XD_BIT_ARY_CK(uint32_t, pBits, i)) continue;
+		if (occluded(pBoxes[i])) {
+			XD_BIT_ARY_ST(uint32_t, pBits, i);
+			++ncull;
+		}
+	}
+	return ncull;
+}
+
+
 namespace nxColor {
 
 void init_XYZ_transform(cxMtx* pRGB2XYZ, cxMtx* pXYZ2RGB, cxVec* pPrims, cxVec* pWhite) {
@@ -7582,6 +8516,87 @@ XD_NOINLINE void unload(sxData* pData) {
 	nxCore::bin_unload(pData);
 }
 
+/* copy of pData with pExt appended and the ext list rebuilt, replaces an existing ext of the same kind;
+   the new ext goes first in the list, so that the wide BVH that queries look up per call is found without a search */
+sxData* add_ext(const sxData* pData, const uint32_t kind, const void* pExt, const size_t extSize) {
+	if (!pData || !pExt || extSize < 1) return nullptr;
+	const sxData::ExtList* pSrcLst = pData->get_ext_list();
+	uint32_t nsrc = pSrcLst ? pSrcLst->num : 0;
+	size_t srcSize = XD_ALIGN(pData->mFileSize, 0x10);
+	size_t extOffs = srcSize;
+	size_t lstOffs = XD_ALIGN(extOffs + extSize, 0x10);
+	size_t size = lstOffs + sizeof(sxData::ExtList) + nsrc*sizeof(sxData::ExtExtry);
+	sxData* pNew = (sxData*)nxCore::mem_alloc(size, "xdata:ext");
+	if (!pNew) return nullptr;
+	nxCore::mem_zero(pNew, size);
+	nxCore::mem_copy(pNew, pData, pData->mFileSize);
+	nxCore::mem_copy(XD_INCR_PTR(pNew, extOffs), pExt, extSize);
+	sxData::ExtList* pLst = (sxData::ExtList*)XD_INCR_PTR(pNew, lstOffs);
+	pLst->lst[0].kind = kind;
+	pLst->lst[0].offs = uint32_t(extOffs);
+	uint32_t n = 1;
+	for (uint32_t i = 0; i < nsrc; ++i) {
+		if (pSrcLst->lst[i].kind != kind) {
+			pLst->lst[n++] = pSrcLst->lst[i];
+		}
+	}
+	pLst->num = n;
+	pNew->mOffsExt = uint32_t(lstOffs);
+	pNew->mFileSize = uint32_t(size);
+	pNew->mFilePathLen = 0;
+	return pNew;
+}
+
+/* ext blocks carry no size, each one runs up to the next block start or the end of the data */
+static size_t ext_block_size(const sxData* pData, const uint32_t offs) {
+	uint32_t end = pData->mFileSize;
+	if (pData->mOffsStr > offs) end = nxCalc::min(end, pData->mOffsStr);
+	if (pData->mOffsExt > offs) end = nxCalc::min(end, pData->mOffsExt);
+	const sxData::ExtList* pLst = pData->get_ext_list();
+	for (uint32_t i = 0; i < pLst->num; ++i) {
+		if (pLst->lst[i].offs > offs) end = nxCalc::min(end, pLst->lst[i].offs);
+	}
+	return end > offs ? end - offs : 0;
+}
+
+size_t get_ext_copy_size(const sxData* pData) {
+	const sxData::ExtList* pLst = pData ? pData->get_ext_list() : nullptr;
+	if (!pLst) return 0;
+	size_t size = 0;
+	for (uint32_t i = 0; i < pLst->num; ++i) {
+		size += XD_ALIGN(ext_block_size(pData, pLst->lst[i].offs), 0x10);
+	}
+	size += sizeof(sxData::ExtList) + (pLst->num > 0 ? pLst->num - 1 : 0)*sizeof(sxData::ExtExtry);
+	return size;
+}
+
+/* copies the ext blocks of pSrc to pDst at offs (aligned up), returns the end offset */
+size_t copy_ext(sxData* pDst, const size_t offs, const sxData* pSrc) {
+	if (!pDst) return offs;
+	const sxData::ExtList* pSrcLst = pSrc ? pSrc->get_ext_list() : nullptr;
+	if (!pSrcLst) {
+		pDst->mOffsExt = 0;
+		return offs;
+	}
+	size_t extOffs = XD_ALIGN(offs, 0x10);
+	size_t lstOffs = extOffs;
+	for (uint32_t i = 0; i < pSrcLst->num; ++i) {
+		lstOffs += XD_ALIGN(ext_block_size(pSrc, pSrcLst->lst[i].offs), 0x10);
+	}
+	sxData::ExtList* pLst = (sxData::ExtList*)XD_INCR_PTR(pDst, lstOffs);
+	pLst->num = pSrcLst->num;
+	pLst->reserved = pSrcLst->reserved;
+	for (uint32_t i = 0; i < pSrcLst->num; ++i) {
+		size_t extSize = ext_block_size(pSrc, pSrcLst->lst[i].offs);
+		nxCore::mem_copy(XD_INCR_PTR(pDst, extOffs), XD_INCR_PTR(pSrc, pSrcLst->lst[i].offs), extSize);
+		pLst->lst[i].kind = pSrcLst->lst[i].kind;
+		pLst->lst[i].offs = uint32_t(extOffs);
+		extOffs += XD_ALIGN(extSize, 0x10);
+	}
+	pDst->mOffsExt = uint32_t(lstOffs);
+	return lstOffs + sizeof(sxData::ExtList) + (pLst->num > 0 ? pLst->num - 1 : 0)*sizeof(sxData::ExtExtry);
+}
+
 static int pk_find_dict_idx(const uint32_t* pCnts, int n, uint32_t cnt) {
 	const uint32_t* p = pCnts;
 	uint32_t c = (uint32_t)n;
@@ -9727,44 +10742,516 @@ void sxGeometryData::hit_query_nobvh(const cxLineSeg& seg, HitFunc& fun) const {
 	}
 }
 
-struct sxBVHWork {
-	const sxGeometryData* mpGeo;
-	cxAABB mQryBBox;
-	cxLineSeg mQrySeg;
-	sxGeometryData::HitFunc* mpHitFunc;
-	sxGeometryData::RangeFunc* mpRangeFunc;
-	sxGeometryData::LeafFunc* mpLeafFunc;
-	bool mStopFlg;
+size_t sxQBVH::calc_size(const int nnodes, const int bits) {
+	size_t nodeSize = bits > 8 ? sizeof(Node16) : sizeof(Node8);
+	return XD_ALIGN(sizeof(sxQBVH) + nnodes*nodeSize, 0x10);
+}
 
-	sxBVHWork() : mpGeo(nullptr), mpHitFunc(nullptr), mpRangeFunc(nullptr), mStopFlg(false) {}
-};
+template<typename NODE_T> struct sxQBVHBuildWk {
+	NODE_T* mpNodes;
+	const cxAABB* mpSrcBoxes;
+	const int32_t* mpSrcInfos;
+	int mNodeCnt;
+	int mMaxDepth;
+	bool mErr;
 
-static void BVH_hit_sub(sxBVHWork& wk, int nodeId) {
-	if (wk.mStopFlg) return;
-	sxGeometryData::BVH::Node* pNode = wk.mpGeo->get_BVH_node(nodeId);
-	if (pNode->mBBox.overlaps(wk.mQryBBox) && pNode->mBBox.seg_ck(wk.mQrySeg)) {
-		if (pNode->is_leaf()) {
-			cxVec hitPos;
-			cxVec hitNrm;
-			sxGeometryData::Polygon pol = wk.mpGeo->get_pol(pNode->get_pol_id());
-			bool hitFlg = pol.intersect(wk.mQrySeg, &hitPos, &hitNrm);
-			if (hitFlg) {
-				float hitDist = nxVec::dist(wk.mQrySeg.get_pos0(), hitPos);
-				bool contFlg = (*wk.mpHitFunc)(pol, hitPos, hitNrm, hitDist);
-				if (!contFlg) {
-					wk.mStopFlg = true;
-				}
-			}
-		} else {
-			BVH_hit_sub(wk, pNode->mLeft);
-			BVH_hit_sub(wk, pNode->mRight);
+	static void decode(const NODE_T& node, const cxVec& pmin, const cxVec& pscl, cxVec* pMin, cxVec* pMax) {
+		for (int i = 0; i < 3; ++i) {
+			pMin->set_at(i, pmin[i] + float(node.mMin[i])*pscl[i]);
+			pMax->set_at(i, pmin[i] + float(node.mMax[i])*pscl[i]);
+		}
+	}
+
+	static cxVec calc_scale(const cxVec& bmin, const cxVec& bmax) {
+		return (bmax - bmin) * (1.0f / float(NODE_T::QMAX));
+	}
+
+	void emit(const int isrc, const int depth, const cxVec& pmin, const cxVec& pscl) {
+		if (depth >= XD_QBVH_MAX_DEPTH) {
+			mErr = true;
+			return;
+		}
+		int idst = mNodeCnt++;
+		NODE_T* pNode = &mpNodes[idst];
+		nxCore::mem_zero(pNode, sizeof(NODE_T));
+		cxAABB bb = mpSrcBoxes[isrc];
+		cxVec bmin = bb.get_min_pos();
+		cxVec bmax = bb.get_max_pos();
+		if (depth == 0) {
+			for (int i = 0; i < 3; ++i) {
+				pNode->mMin[i] = 0;
+				pNode->mMax[i] = NODE_T::QMAX;
+			}
+		} else {
+			for (int i = 0; i < 3; ++i) {
+				int qmin = 0;
+				int qmax = NODE_T::QMAX;
+				if (pscl[i] > 0.0f) {
+					qmin = nxCalc::clamp(int(::mth_floorf((bmin[i] - pmin[i]) / pscl[i])), 0, NODE_T::QMAX);
+					qmax = nxCalc::clamp(int(::mth_ceilf((bmax[i] - pmin[i]) / pscl[i])), 0, NODE_T::QMAX);
+					while (qmin > 0 && pmin[i] + float(qmin)*pscl[i] > bmin[i]) {
+						--qmin;
+					}
+					while (qmax < NODE_T::QMAX && pmin[i] + float(qmax)*pscl[i] < bmax[i]) {
+						++qmax;
+					}
+				}
+				pNode->mMin[i] = qmin;
+				pNode->mMax[i] = qmax;
+			}
+		}
+		pNode->mDepth = uint8_t(depth);
+		mMaxDepth = nxCalc::max(mMaxDepth, depth);
+		const int32_t* pInfo = &mpSrcInfos[isrc * 2];
+		if (pInfo[1] < 0) {
+			pNode->mLeaf = 1;
+			pNode->mIdx = pInfo[0];
+		} else {
+			cxVec qmin;
+			cxVec qmax;
+			if (depth == 0) {
+				qmin = bmin;
+				qmax = bmax;
+			} else {
+				decode(*pNode, pmin, pscl, &qmin, &qmax);
+			}
+			cxVec qscl = calc_scale(qmin, qmax);
+			emit(pInfo[0], depth + 1, qmin, qscl);
+			if (mErr) return;
+			emit(pInfo[1], depth + 1, qmin, qscl);
+			mpNodes[idst].mIdx = mNodeCnt;
+		}
+	}
+};
+
+bool sxQBVH::build(sxQBVH* pQBVH, const int bits, const cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const int nnodes) {
+	if (!pQBVH || !pNodeBoxes || !pNodeInfos || nnodes < 1) return false;
+	pQBVH->mBBox = pNodeBoxes[0];
+	pQBVH->mNodesNum = uint32_t(nnodes);
+	pQBVH->mBits = bits > 8 ? 16 : 8;
+	pQBVH->mReserved = 0;
+	bool res = false;
+	cxVec zero(0.0f);
+	if (pQBVH->mBits == 8) {
+		sxQBVHBuildWk<Node8> wk;
+		wk.mpNodes = (Node8*)(pQBVH + 1);
+		wk.mpSrcBoxes = pNodeBoxes;
+		wk.mpSrcInfos = pNodeInfos;
+		wk.mNodeCnt = 0;
+		wk.mMaxDepth = 0;
+		wk.mErr = false;
+		wk.emit(0, 0, zero, zero);
+		res = !wk.mErr && wk.mNodeCnt == nnodes;
+		pQBVH->mMaxDepth = uint8_t(wk.mMaxDepth);
+	} else {
+		sxQBVHBuildWk<Node16> wk;
+		wk.mpNodes = (Node16*)(pQBVH + 1);
+		wk.mpSrcBoxes = pNodeBoxes;
+		wk.mpSrcInfos = pNodeInfos;
+		wk.mNodeCnt = 0;
+		wk.mMaxDepth = 0;
+		wk.mErr = false;
+		wk.emit(0, 0, zero, zero);
+		res = !wk.mErr && wk.mNodeCnt == nnodes;
+		pQBVH->mMaxDepth = uint8_t(wk.mMaxDepth);
+	}
+	return res;
+}
+
+template<typename NODE_T> static void qbvh_get_tree_sub(const sxQBVH* pQBVH, int32_t* pNodeInfos) {
+	const NODE_T* pNodes = reinterpret_cast<const NODE_T*>(pQBVH->get_nodes_top());
+	int n = int(pQBVH->mNodesNum);
+	for (int i = 0; i < n; ++i) {
+		const NODE_T& node = pNodes[i];
+		if (node.mLeaf) {
+			pNodeInfos[i*2] = node.mIdx;
+			pNodeInfos[i*2 + 1] = -1;
+		} else {
+			int ileft = i + 1;
+			pNodeInfos[i*2] = ileft;
+			pNodeInfos[i*2 + 1] = pNodes[ileft].mLeaf ? ileft + 1 : pNodes[ileft].mIdx;
+		}
+	}
+}
+
+/* binary tree infos in QBVH node order: left child follows its parent, right child is the left child's skip target */
+void sxQBVH::get_tree(int32_t* pNodeInfos) const {
+	if (!pNodeInfos) return;
+	if (mBits == 8) {
+		qbvh_get_tree_sub<Node8>(this, pNodeInfos);
+	} else {
+		qbvh_get_tree_sub<Node16>(this, pNodeInfos);
+	}
+}
+
+/* CK_T: bool(const cxVec& bmin, const cxVec& bmax), LEAF_T: bool(const int iprim) -> continue */
+template<typename NODE_T, typename CK_T, typename LEAF_T>
+static void qbvh_walk_sub(const sxQBVH* pQBVH, CK_T& ck, LEAF_T& leaf) {
+	const NODE_T* pNodes = reinterpret_cast<const NODE_T*>(pQBVH->get_nodes_top());
+	cxVec lvlMin[XD_QBVH_MAX_DEPTH];
+	cxVec lvlScl[XD_QBVH_MAX_DEPTH];
+	int n = int(pQBVH->mNodesNum);
+	int i = 0;
+	while (i < n) {
+		const NODE_T& node = pNodes[i];
+		int depth = node.mDepth;
+		cxVec bmin;
+		cxVec bmax;
+		if (depth == 0) {
+			bmin = pQBVH->mBBox.get_min_pos();
+			bmax = pQBVH->mBBox.get_max_pos();
+		} else {
+			sxQBVHBuildWk<NODE_T>::decode(node, lvlMin[depth - 1], lvlScl[depth - 1], &bmin, &bmax);
+		}
+		if (!ck(bmin, bmax)) {
+			i = node.mLeaf ? i + 1 : node.mIdx;
+			continue;
+		}
+		if (node.mLeaf) {
+			if (!leaf(node.mIdx)) break;
+		} else {
+			lvlMin[depth] = bmin;
+			lvlScl[depth] = sxQBVHBuildWk<NODE_T>::calc_scale(bmin, bmax);
+		}
+		++i;
+	}
+}
+
+template<typename CK_T, typename LEAF_T>
+static void qbvh_walk(const sxQBVH* pQBVH, CK_T& ck, LEAF_T& leaf) {
+	if (!pQBVH) return;
+	if (pQBVH->mBits == 8) {
+		qbvh_walk_sub<sxQBVH::Node8>(pQBVH, ck, leaf);
+	} else {
+		qbvh_walk_sub<sxQBVH::Node16>(pQBVH, ck, leaf);
+	}
+}
+
+struct sxQBVHBoxCk {
+	cxAABB mBBox;
+
+	bool operator()(const cxVec& bmin, const cxVec& bmax) const {
+		return mBBox.overlaps(cxAABB(bmin, bmax));
+	}
+};
+
+struct sxQBVHSegCk {
+	cxAABB mBBox;
+	cxLineSeg mSeg;
+
+	bool operator()(const cxVec& bmin, const cxVec& bmax) const {
+		cxAABB bb(bmin, bmax);
+		return mBBox.overlaps(bb) && bb.seg_ck(mSeg);
+	}
+};
+
+const uint32_t sxWideBVH::KIND = XD_FOURCC('W', 'B', 'V', 'H');
+
+size_t sxWideBVH::calc_size(const int nnodes, const int width) {
+	size_t nodeSize = width > 4 ? sizeof(Node<8>) : sizeof(Node<4>);
+	return sizeof(sxWideBVH) + nnodes*nodeSize;
+}
+
+template<int N> struct sxWideBVHBuildWk {
+	sxWideBVH::Node<N>* mpNodes;
+	const cxAABB* mpSrcBoxes;
+	const int32_t* mpSrcInfos;
+	int mNodeCnt;
+
+	bool is_leaf(const int isrc) const { return mpSrcInfos[isrc*2 + 1] < 0; }
+
+	/* pull up grandchildren until the node is full, opening the largest box first */
+	int emit(const int isrc) {
+		int idst = mNodeCnt++;
+		int lst[N];
+		int n = 0;
+		if (is_leaf(isrc)) {
+			lst[n++] = isrc;
+		} else {
+			lst[n++] = mpSrcInfos[isrc*2];
+			lst[n++] = mpSrcInfos[isrc*2 + 1];
+		}
+		while (n < N) {
+			int iopen = -1;
+			float maxArea = -1.0f;
+			for (int i = 0; i < n; ++i) {
+				if (!is_leaf(lst[i])) {
+					float area = nxGeom::aabb_half_area(mpSrcBoxes[lst[i]]);
+					if (area > maxArea) {
+						maxArea = area;
+						iopen = i;
+					}
+				}
+			}
+			if (iopen < 0) break;
+			int isub = lst[iopen];
+			lst[iopen] = mpSrcInfos[isub*2];
+			lst[n++] = mpSrcInfos[isub*2 + 1];
+		}
+		for (int i = 0; i < N; ++i) {
+			int32_t ichild = -1;
+			cxAABB bb;
+			if (i < n) {
+				ichild = is_leaf(lst[i]) ? ~mpSrcInfos[lst[i]*2] : emit(lst[i]);
+				bb = mpSrcBoxes[lst[i]];
+			}
+			if (mpNodes) {
+				sxWideBVH::Node<N>* pNode = &mpNodes[idst];
+				for (int j = 0; j < 3; ++j) {
+					pNode->mMin[j][i] = i < n ? bb.get_min_pos()[j] : FLT_MAX;
+					pNode->mMax[j][i] = i < n ? bb.get_max_pos()[j] : -FLT_MAX;
+				}
+				pNode->mChild[i] = ichild;
+			}
+		}
+		return idst;
+	}
+};
+
+int sxWideBVH::build(sxWideBVH* pWBVH, const int width, const cxAABB* pNodeBoxes, const int32_t* pNodeInfos) {
+	if (!pNodeBoxes || !pNodeInfos) return 0;
+	int nnodes = 0;
+	if (width > 4) {
+		sxWideBVHBuildWk<8> wk;
+		wk.mpNodes = pWBVH ? (Node<8>*)(pWBVH + 1) : nullptr;
+		wk.mpSrcBoxes = pNodeBoxes;
+		wk.mpSrcInfos = pNodeInfos;
+		wk.mNodeCnt = 0;
+		wk.emit(0);
+		nnodes = wk.mNodeCnt;
+	} else {
+		sxWideBVHBuildWk<4> wk;
+		wk.mpNodes = pWBVH ? (Node<4>*)(pWBVH + 1) : nullptr;
+		wk.mpSrcBoxes = pNodeBoxes;
+		wk.mpSrcInfos = pNodeInfos;
+		wk.mNodeCnt = 0;
+		wk.emit(0);
+		nnodes = wk.mNodeCnt;
+	}
+	if (pWBVH) {
+		pWBVH->mNodesNum = uint32_t(nnodes);
+		pWBVH->mWidth = width > 4 ? 8 : 4;
+		pWBVH->mReserved0 = 0;
+		pWBVH->mReserved1 = 0;
+	}
+	return nnodes;
+}
+
+static sxWideBVH* wbvh_create(const int width, const cxAABB* pNodeBoxes, const int32_t* pNodeInfos, size_t* pSize) {
+	int nnodes = sxWideBVH::build(nullptr, width, pNodeBoxes, pNodeInfos);
+	if (nnodes < 1) return nullptr;
+	size_t size = sxWideBVH::calc_size(nnodes, width);
+	sxWideBVH* pWBVH = (sxWideBVH*)nxCore::mem_alloc(size, "WideBVH:tmp");
+	if (pWBVH) {
+		nxCore::mem_zero(pWBVH, size);
+		sxWideBVH::build(pWBVH, width, pNodeBoxes, pNodeInfos);
+		*pSize = size;
+	}
+	return pWBVH;
+}
+
+template<int N> static cxAABB wbvh_refit_node(sxWideBVH::Node<N>* pNodes, const int inode, const cxAABB* pPrimBoxes) {
+	sxWideBVH::Node<N>* pNode = &pNodes[inode];
+	cxAABB nodeBB;
+	nodeBB.init();
+	for (int i = 0; i < N; ++i) {
+		if (pNode->mMin[0][i] > pNode->mMax[0][i]) continue;
+		int32_t ichild = pNode->mChild[i];
+		cxAABB bb = ichild < 0 ? pPrimBoxes[~ichild] : wbvh_refit_node<N>(pNodes, ichild, pPrimBoxes);
+		for (int j = 0; j < 3; ++j) {
+			pNode->mMin[j][i] = bb.get_min_pos()[j];
+			pNode->mMax[j][i] = bb.get_max_pos()[j];
+		}
+		nodeBB.merge(bb);
+	}
+	return nodeBB;
+}
+
+/* rebuilt in place if the new tree fits, lanes refitted otherwise */
+/* returns false if a rebuild was requested but the new tree doesn't fit the block, the old topology is refitted then */
+static bool wbvh_update(sxWideBVH* pWBVH, const cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const cxAABB* pPrimBoxes, const bool rebuild) {
+	if (!pWBVH || pWBVH->mNodesNum < 1) return true;
+	if (rebuild && sxWideBVH::build(nullptr, int(pWBVH->mWidth), pNodeBoxes, pNodeInfos) <= int(pWBVH->mNodesNum)) {
+		sxWideBVH::build(pWBVH, int(pWBVH->mWidth), pNodeBoxes, pNodeInfos);
+		return true;
+	}
+	if (pWBVH->mWidth > 4) {
+		wbvh_refit_node<8>((sxWideBVH::Node<8>*)(pWBVH + 1), 0, pPrimBoxes);
+	} else {
+		wbvh_refit_node<4>((sxWideBVH::Node<4>*)(pWBVH + 1), 0, pPrimBoxes);
+	}
+	return !rebuild;
+}
+
+/* CK_T: void(const Node<N>&, bool* pMask), LEAF_T: bool(const int iprim) -> continue */
+template<int N, typename CK_T, typename LEAF_T>
+static bool wbvh_walk_sub(const sxWideBVH::Node<N>* pNodes, const int inode, CK_T& ck, LEAF_T& leaf) {
+	const sxWideBVH::Node<N>* pNode = &pNodes[inode];
+	bool mask[N];
+	ck(*pNode, mask);
+	for (int i = 0; i < N; ++i) {
+		if (mask[i]) {
+			int32_t ichild = pNode->mChild[i];
+			if (ichild < 0) {
+				if (!leaf(~ichild)) return false;
+			} else {
+				if (!wbvh_walk_sub<N>(pNodes, ichild, ck, leaf)) return false;
+			}
+		}
+	}
+	return true;
+}
+
+template<typename CK_T, typename LEAF_T>
+static void wbvh_walk(const sxWideBVH* pWBVH, CK_T& ck, LEAF_T& leaf) {
+	if (!pWBVH || pWBVH->mNodesNum < 1) return;
+	if (pWBVH->mWidth == 8) {
+		wbvh_walk_sub<8>(reinterpret_cast<const sxWideBVH::Node<8>*>(pWBVH->get_nodes_top()), 0, ck, leaf);
+	} else {
+		wbvh_walk_sub<4>(reinterpret_cast<const sxWideBVH::Node<4>*>(pWBVH->get_nodes_top()), 0, ck, leaf);
+	}
+}
+
+struct sxWideBVHBoxCk {
+	float mMin[3];
+	float mMax[3];
+
+	void init(const cxAABB& box) {
+		for (int i = 0; i < 3; ++i) {
+			mMin[i] = box.get_min_pos()[i];
+			mMax[i] = box.get_max_pos()[i];
+		}
+	}
+
+	template<int N> void operator()(const sxWideBVH::Node<N>& node, bool* pMask) const {
+		for (int i = 0; i < N; ++i) {
+			pMask[i] = (node.mMin[0][i] <= mMax[0]) & (node.mMax[0][i] >= mMin[0])
+			         & (node.mMin[1][i] <= mMax[1]) & (node.mMax[1][i] >= mMin[1])
+			         & (node.mMin[2][i] <= mMax[2]) & (node.mMax[2][i] >= mMin[2]);
+		}
+	}
+};
+
+/* segment bbox overlap + slab test over t in [0, 1]; the overlap part also rejects empty lanes */
+struct sxWideBVHSegCk {
+	float mMin[3];
+	float mMax[3];
+	float mOrg[3];
+	float mInvDir[3];
+
+	void init(const cxLineSeg& seg) {
+		cxAABB box;
+		box.from_seg(seg);
+		cxVec dir = seg.get_dir();
+		for (int i = 0; i < 3; ++i) {
+			mMin[i] = box.get_min_pos()[i];
+			mMax[i] = box.get_max_pos()[i];
+			mOrg[i] = seg.get_pos0()[i];
+			mInvDir[i] = dir[i] != 0.0f ? 1.0f / dir[i] : 1.0e30f;
+		}
+	}
+
+	template<int N> void operator()(const sxWideBVH::Node<N>& node, bool* pMask) const {
+		float t0[N];
+		float t1[N];
+		for (int i = 0; i < N; ++i) {
+			t0[i] = 0.0f;
+			t1[i] = 1.0f;
+		}
+		for (int j = 0; j < 3; ++j) {
+			for (int i = 0; i < N; ++i) {
+				float ta = (node.mMin[j][i] - mOrg[j]) * mInvDir[j];
+				float tb = (node.mMax[j][i] - mOrg[j]) * mInvDir[j];
+				t0[i] = nxCalc::max(t0[i], nxCalc::min(ta, tb));
+				t1[i] = nxCalc::min(t1[i], nxCalc::max(ta, tb));
+			}
+		}
+		for (int i = 0; i < N; ++i) {
+			pMask[i] = (node.mMin[0][i] <= mMax[0]) & (node.mMax[0][i] >= mMin[0])
+			         & (node.mMin[1][i] <= mMax[1]) & (node.mMax[1][i] >= mMin[1])
+			         & (node.mMin[2][i] <= mMax[2]) & (node.mMax[2][i] >= mMin[2])
+			         & (t0[i] <= t1[i]);
+		}
+	}
+};
+
+struct sxBVHWork {
+	const sxGeometryData* mpGeo;
+	cxAABB mQryBBox;
+	cxLineSeg mQrySeg;
+	sxGeometryData::HitFunc* mpHitFunc;
+	sxGeometryData::RangeFunc* mpRangeFunc;
+	sxGeometryData::LeafFunc* mpLeafFunc;
+	bool mStopFlg;
+
+	sxBVHWork() : mpGeo(nullptr), mpHitFunc(nullptr), mpRangeFunc(nullptr), mStopFlg(false) {}
+};
+
+static void BVH_hit_sub(sxBVHWork& wk, int nodeId) {
+	if (wk.mStopFlg) return;
+	sxGeometryData::BVH::Node* pNode = wk.mpGeo->get_BVH_node(nodeId);
+	if (pNode->mBBox.overlaps(wk.mQryBBox) && pNode->mBBox.seg_ck(wk.mQrySeg)) {
+		if (pNode->is_leaf()) {
+			cxVec hitPos;
+			cxVec hitNrm;
+			sxGeometryData::Polygon pol = wk.mpGeo->get_pol(pNode->get_pol_id());
+			bool hitFlg = pol.intersect(wk.mQrySeg, &hitPos, &hitNrm);
+			if (hitFlg) {
+				float hitDist = nxVec::dist(wk.mQrySeg.get_pos0(), hitPos);
+				bool contFlg = (*wk.mpHitFunc)(pol, hitPos, hitNrm, hitDist);
+				if (!contFlg) {
+					wk.mStopFlg = true;
+				}
+			}
+		} else {
+			BVH_hit_sub(wk, pNode->mLeft);
+			BVH_hit_sub(wk, pNode->mRight);
 		}
 	}
 }
 
+struct sxGeoPolHitLeaf {
+	sxBVHWork* mpWk;
+
+	bool operator()(const int ipol) {
+		cxVec hitPos;
+		cxVec hitNrm;
+		sxGeometryData::Polygon pol = mpWk->mpGeo->get_pol(ipol);
+		bool contFlg = true;
+		if (pol.intersect(mpWk->mQrySeg, &hitPos, &hitNrm)) {
+			float hitDist = nxVec::dist(mpWk->mQrySeg.get_pos0(), hitPos);
+			contFlg = (*mpWk->mpHitFunc)(pol, hitPos, hitNrm, hitDist);
+		}
+		return contFlg;
+	}
+};
+
 void sxGeometryData::hit_query(const cxLineSeg& seg, HitFunc& fun) const {
 	BVH* pBVH = get_BVH();
-	if (pBVH) {
+	const sxWideBVH* pWBVH = get_wide_BVH();
+	const sxQBVH* pQBVH = get_QBVH();
+	if (pWBVH) {
+		sxBVHWork wk;
+		wk.mpGeo = this;
+		wk.mQrySeg = seg;
+		wk.mpHitFunc = &fun;
+		sxWideBVHSegCk ck;
+		ck.init(seg);
+		sxGeoPolHitLeaf leaf;
+		leaf.mpWk = &wk;
+		wbvh_walk(pWBVH, ck, leaf);
+	} else if (pQBVH) {
+		sxBVHWork wk;
+		wk.mpGeo = this;
+		wk.mQrySeg = seg;
+		wk.mpHitFunc = &fun;
+		sxQBVHSegCk ck;
+		ck.mSeg = seg;
+		ck.mBBox.from_seg(seg);
+		sxGeoPolHitLeaf leaf;
+		leaf.mpWk = &wk;
+		qbvh_walk(pQBVH, ck, leaf);
+	} else if (pBVH) {
 		sxBVHWork wk;
 		wk.mpGeo = this;
 		wk.mQrySeg = seg;
@@ -9807,9 +11294,35 @@ static void BVH_range_sub(sxBVHWork& wk, int nodeId) {
 	}
 }
 
+struct sxGeoPolRangeLeaf {
+	const sxGeometryData* mpGeo;
+	sxGeometryData::RangeFunc* mpFunc;
+
+	bool operator()(const int ipol) {
+		sxGeometryData::Polygon pol = mpGeo->get_pol(ipol);
+		return (*mpFunc)(pol);
+	}
+};
+
 void sxGeometryData::range_query(const cxAABB& box, RangeFunc& fun) const {
 	BVH* pBVH = get_BVH();
-	if (pBVH) {
+	const sxWideBVH* pWBVH = get_wide_BVH();
+	const sxQBVH* pQBVH = get_QBVH();
+	if (pWBVH) {
+		sxWideBVHBoxCk ck;
+		ck.init(box);
+		sxGeoPolRangeLeaf leaf;
+		leaf.mpGeo = this;
+		leaf.mpFunc = &fun;
+		wbvh_walk(pWBVH, ck, leaf);
+	} else if (pQBVH) {
+		sxQBVHBoxCk ck;
+		ck.mBBox = box;
+		sxGeoPolRangeLeaf leaf;
+		leaf.mpGeo = this;
+		leaf.mpFunc = &fun;
+		qbvh_walk(pQBVH, ck, leaf);
+	} else if (pBVH) {
 		sxBVHWork wk;
 		wk.mpGeo = this;
 		wk.mQryBBox = box;
@@ -9820,6 +11333,204 @@ void sxGeometryData::range_query(const cxAABB& box, RangeFunc& fun) const {
 	}
 }
 
+/* the QBVH takes the place of the float nodes, data that ends with the BVH (as exported) is cut after it */
+sxGeometryData* sxGeometryData::make_QBVH(const int bits) const {
+	BVH* pBVH = get_BVH();
+	if (!pBVH || pBVH->mNodesNum < 1) return nullptr;
+	int nnodes = int(pBVH->mNodesNum);
+	size_t qbvhOffs = mBVHOffs + sizeof(BVH);
+	size_t qbvhSize = sxQBVH::calc_size(nnodes, bits);
+	size_t nodesSize = nnodes * sizeof(BVH::Node);
+	size_t dataEnd = mFileSize;
+	const ExtList* pExtLst = get_ext_list();
+	if (pExtLst) {
+		dataEnd = nxCalc::min(dataEnd, size_t(mOffsExt));
+		for (uint32_t i = 0; i < pExtLst->num; ++i) {
+			dataEnd = nxCalc::min(dataEnd, size_t(pExtLst->lst[i].offs));
+		}
+	}
+	bool cutFlg = mOffsStr < mBVHOffs && XD_ALIGN(qbvhOffs + nodesSize, 0x10) >= dataEnd;
+	if (!cutFlg && qbvhSize > nodesSize) return nullptr;
+	size_t size = mFileSize;
+	if (cutFlg) {
+		size = qbvhOffs + qbvhSize;
+		if (pExtLst) {
+			size = XD_ALIGN(size, 0x10) + nxData::get_ext_copy_size(this);
+		}
+	}
+	size_t tmpSize = nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2);
+	void* pTmp = nxCore::mem_alloc(tmpSize, "xgeo:QBVH:tmp");
+	if (!pTmp) return nullptr;
+	cxAABB* pBoxes = (cxAABB*)pTmp;
+	int32_t* pInfos = (int32_t*)XD_INCR_PTR(pTmp, nnodes * sizeof(cxAABB));
+	for (int i = 0; i < nnodes; ++i) {
+		const BVH::Node* pNode = get_BVH_node(i);
+		pBoxes[i] = pNode->mBBox;
+		pInfos[i*2] = pNode->mLeft;
+		pInfos[i*2 + 1] = pNode->mRight;
+	}
+	sxGeometryData* pGeo = (sxGeometryData*)nxCore::mem_alloc(size, "xgeo:QBVH");
+	if (pGeo) {
+		nxCore::mem_zero(pGeo, size);
+		if (cutFlg) {
+			nxCore::mem_copy(pGeo, this, qbvhOffs);
+		} else {
+			nxCore::mem_copy(pGeo, this, mFileSize);
+			nxCore::mem_zero(XD_INCR_PTR(pGeo, qbvhOffs), nodesSize);
+		}
+		sxQBVH* pQBVH = (sxQBVH*)XD_INCR_PTR(pGeo, qbvhOffs);
+		if (sxQBVH::build(pQBVH, bits, pBoxes, pInfos, nnodes)) {
+			/* no float nodes left, queries and refits go through the QBVH */
+			pGeo->get_BVH()->mNodesNum = 0;
+			pGeo->get_BVH()->mQBVHOffs = uint32_t(sizeof(BVH));
+			if (cutFlg) {
+				nxData::copy_ext(pGeo, qbvhOffs + qbvhSize, this);
+			}
+			pGeo->mFileSize = uint32_t(size);
+			pGeo->mFilePathLen = 0;
+		} else {
+			nxCore::mem_free(pGeo);
+			pGeo = nullptr;
+		}
+	}
+	nxCore::mem_free(pTmp);
+	return pGeo;
+}
+
+sxGeometryData* sxGeometryData::make_wide_BVH(const int width) const {
+	BVH* pBVH = get_BVH();
+	if (!pBVH || pBVH->mNodesNum < 1) return nullptr;
+	int nnodes = int(pBVH->mNodesNum);
+	size_t tmpSize = nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2);
+	void* pTmp = nxCore::mem_alloc(tmpSize, "xgeo:WideBVH:tmp");
+	if (!pTmp) return nullptr;
+	cxAABB* pBoxes = (cxAABB*)pTmp;
+	int32_t* pInfos = (int32_t*)XD_INCR_PTR(pTmp, nnodes * sizeof(cxAABB));
+	for (int i = 0; i < nnodes; ++i) {
+		const BVH::Node* pNode = get_BVH_node(i);
+		pBoxes[i] = pNode->mBBox;
+		pInfos[i*2] = pNode->mLeft;
+		pInfos[i*2 + 1] = pNode->mRight;
+	}
+	sxGeometryData* pGeo = nullptr;
+	size_t size = 0;
+	sxWideBVH* pWBVH = wbvh_create(width, pBoxes, pInfos, &size);
+	if (pWBVH) {
+		pGeo = (sxGeometryData*)nxData::add_ext(this, sxWideBVH::KIND, pWBVH, size);
+		nxCore::mem_free(pWBVH);
+	}
+	nxCore::mem_free(pTmp);
+	return pGeo;
+}
+
+float sxGeometryData::calc_BVH_cost() const {
+	BVH* pBVH = get_BVH();
+	const sxQBVH* pQBVH = get_QBVH();
+	int nnodes = pBVH ? int(pBVH->mNodesNum) : 0;
+	bool qbvhFlg = nnodes < 1 && pQBVH;
+	if (qbvhFlg) {
+		nnodes = int(pQBVH->mNodesNum);
+	}
+	if (nnodes < 1) return 0.0f;
+	int npol = qbvhFlg ? int(mPolNum) : 0;
+	size_t tmpSize = npol * sizeof(cxAABB) + nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2);
+	void* pTmp = nxCore::mem_alloc(tmpSize, "xgeo:BVH:cost");
+	if (!pTmp) return 0.0f;
+	cxAABB* pBoxes = (cxAABB*)pTmp;
+	int32_t* pInfos = (int32_t*)XD_INCR_PTR(pTmp, nnodes * sizeof(cxAABB));
+	if (qbvhFlg) {
+		cxAABB* pPolBoxes = (cxAABB*)XD_INCR_PTR(pInfos, nnodes * sizeof(int32_t) * 2);
+		for (int i = 0; i < npol; ++i) {
+			pPolBoxes[i] = get_pol(i).calc_bbox();
+		}
+		pQBVH->get_tree(pInfos);
+		nxGeom::refit_aabb_tree(pPolBoxes, pBoxes, pInfos, nnodes);
+	} else {
+		for (int i = 0; i < nnodes; ++i) {
+			const BVH::Node* pNode = get_BVH_node(i);
+			pBoxes[i] = pNode->mBBox;
+			pInfos[i*2] = pNode->mLeft;
+			pInfos[i*2 + 1] = pNode->mRight;
+		}
+	}
+	float cost = nxGeom::aabb_tree_sah_cost(pBoxes, pInfos, nnodes);
+	nxCore::mem_free(pTmp);
+	return cost;
+}
+
+/* full rebuild is only possible for trees with a leaf per polygon */
+bool sxGeometryData::refit_BVH(const cxVec* pPnts, const float rebuildCost, cxBrigade* pBgd) {
+	if (!mPntOffs || mPolNum < 1) return false;
+	cxVec* pDstPnts = get_pnt_top();
+	if (pPnts && pPnts != pDstPnts) {
+		nxCore::mem_copy(pDstPnts, pPnts, mPntNum * sizeof(cxVec));
+	}
+	int npol = int(mPolNum);
+	BVH* pBVH = get_BVH();
+	sxQBVH* pQBVH = const_cast<sxQBVH*>(get_QBVH());
+	int nfloat = pBVH ? int(pBVH->mNodesNum) : 0;
+	int nnodes = nfloat > 0 ? nfloat : (pQBVH ? int(pQBVH->mNodesNum) : 0);
+	size_t tmpSize = npol * sizeof(cxAABB) + nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2);
+	void* pTmp = nxCore::mem_alloc(tmpSize, "xgeo:refit:tmp");
+	if (!pTmp) return false;
+	cxAABB* pPolBoxes = (cxAABB*)pTmp;
+	for (int i = 0; i < npol; ++i) {
+		pPolBoxes[i] = get_pol(i).calc_bbox();
+	}
+	bool rebuild = false;
+	if (nnodes > 0) {
+		cxAABB* pBoxes = (cxAABB*)XD_INCR_PTR(pTmp, npol * sizeof(cxAABB));
+		int32_t* pInfos = (int32_t*)XD_INCR_PTR(pBoxes, nnodes * sizeof(cxAABB));
+		if (nfloat > 0) {
+			for (int i = 0; i < nnodes; ++i) {
+				const BVH::Node* pNode = get_BVH_node(i);
+				pInfos[i*2] = pNode->mLeft;
+				pInfos[i*2 + 1] = pNode->mRight;
+			}
+		} else {
+			pQBVH->get_tree(pInfos);
+		}
+		nxGeom::refit_aabb_tree(pPolBoxes, pBoxes, pInfos, nnodes, pBgd);
+		if (rebuildCost > 0.0f && nnodes == npol*2 - 1 && nxGeom::aabb_tree_sah_cost(pBoxes, pInfos, nnodes) > rebuildCost) {
+			size_t wkSize = nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2) + npol * sizeof(int32_t);
+			void* pWk = nxCore::mem_alloc(wkSize, "xgeo:refit:wk");
+			if (pWk) {
+				cxAABB* pNewBoxes = (cxAABB*)pWk;
+				int32_t* pNewInfos = (int32_t*)XD_INCR_PTR(pNewBoxes, nnodes * sizeof(cxAABB));
+				int32_t* pIdxWk = (int32_t*)XD_INCR_PTR(pNewInfos, nnodes * sizeof(int32_t) * 2);
+				nxGeom::build_aabb_tree(pPolBoxes, npol, pNewBoxes, pNewInfos, pIdxWk, true, pBgd);
+				/* an SAH tree can be deeper than the QBVH allows, keep the refit one then */
+				rebuild = !pQBVH || sxQBVH::build(pQBVH, pQBVH->mBits, pNewBoxes, pNewInfos, nnodes);
+				if (rebuild) {
+					nxCore::mem_copy(pBoxes, pNewBoxes, nnodes * sizeof(cxAABB));
+					nxCore::mem_copy(pInfos, pNewInfos, nnodes * sizeof(int32_t) * 2);
+				}
+				nxCore::mem_free(pWk);
+			}
+		}
+		for (int i = 0; i < nfloat; ++i) {
+			BVH::Node* pNode = get_BVH_node(i);
+			pNode->mBBox = pBoxes[i];
+			pNode->mLeft = pInfos[i*2];
+			pNode->mRight = pInfos[i*2 + 1];
+		}
+		mBBox = pBoxes[0];
+		if (pQBVH && !rebuild) {
+			sxQBVH::build(pQBVH, pQBVH->mBits, pBoxes, pInfos, nnodes);
+		}
+		if (!wbvh_update(const_cast<sxWideBVH*>(get_wide_BVH()), pBoxes, pInfos, pPolBoxes, rebuild)) {
+			rebuild = false;
+		}
+	} else {
+		mBBox = pPolBoxes[0];
+		for (int i = 1; i < npol; ++i) {
+			mBBox.merge(pPolBoxes[i]);
+		}
+	}
+	nxCore::mem_free(pTmp);
+	return rebuild;
+}
+
 static void BVH_leaf_hit_sub(sxBVHWork& wk, int nodeId) {
 	if (wk.mStopFlg) return;
 	sxGeometryData::BVH::Node* pNode = wk.mpGeo->get_BVH_node(nodeId);
@@ -13878,26 +15589,172 @@ struct XMOTFrameInfo {
 	}
 };
 
-static cxVec xmot_get_trk_vec(const sxMotionData::Track* pTrk, int idx) {
+/*
+ * Reduced (key-compressed) track payload, in 16-bit words from Track::mData:
+ *  [0..2] channel block offsets for x, y, z (0 if the channel is constant)
+ *  [3] total number of payload words
+ * channel block:
+ *  [0] number of keys, [1] bits per quantized value, [2..3] tangent scale (f32),
+ *  frame index for each key, (value, tangent) pairs packed LSB-first (+1 padding word).
+ * Keys always include the first and the last frame, values in between are Hermite-interpolated.
+ */
+
+#define XMOT_RDC_HEAD_WORDS 4
+#define XMOT_RDC_CHAN_HEAD_WORDS 4
+
+static inline uint32_t xmot_rdc_get_bits(const uint16_t* pBits, const uint32_t bitOrg, const uint32_t nbits) {
+	uint32_t iw = bitOrg >> 4;
+	uint32_t w = uint32_t(pBits[iw]) | (uint32_t(pBits[iw + 1]) << 16);
+	return (w >> (bitOrg & 0xF)) & ((1U << nbits) - 1);
+}
+
+static inline void xmot_rdc_put_bits(uint16_t* pBits, const uint32_t bitOrg, const uint32_t nbits, const uint32_t val) {
+	for (uint32_t i = 0; i < nbits; ++i) {
+		if (val & (1U << i)) {
+			uint32_t ib = bitOrg + i;
+			pBits[ib >> 4] |= uint16_t(1U << (ib & 0xF));
+		}
+	}
+}
+
+static inline float xmot_rdc_hermite(const float v0, const float m0, const float v1, const float m1, const float h, const float t) {
+	float tt = t * t;
+	float ttt = tt * t;
+	float h00 = 2.0f*ttt - 3.0f*tt + 1.0f;
+	float h10 = ttt - 2.0f*tt + t;
+	float h01 = -2.0f*ttt + 3.0f*tt;
+	float h11 = ttt - tt;
+	return h00*v0 + h10*h*m0 + h01*v1 + h11*h*m1;
+}
+
+struct XMOTRdcSeg {
+	float v0;
+	float m0;
+	float v1;
+	float m1;
+	uint32_t f0;
+	uint32_t f1;
+
+	void find(const uint16_t* pChan, const uint32_t frm) {
+		int nkeys = pChan[0];
+		uint32_t nbits = pChan[1];
+		float tscl = nxCore::f32_set_bits(uint32_t(pChan[2]) | (uint32_t(pChan[3]) << 16));
+		const uint16_t* pFrames = &pChan[XMOT_RDC_CHAN_HEAD_WORDS];
+		const uint16_t* pVals = &pFrames[nkeys];
+		float qscl = 1.0f / float((1U << nbits) - 1);
+		int lo = 0;
+		int hi = nkeys - 1;
+		while (hi - lo > 1) {
+			int mid = (lo + hi) >> 1;
+			if (pFrames[mid] <= frm) {
+				lo = mid;
+			} else {
+				hi = mid;
+			}
+		}
+		if (pFrames[hi] <= frm) {
+			lo = hi;
+		}
+		uint32_t bitOrg = uint32_t(lo) * nbits * 2;
+		v0 = float(xmot_rdc_get_bits(pVals, bitOrg, nbits)) * qscl;
+		f0 = pFrames[lo];
+		if (f0 >= frm || lo >= nkeys - 1) {
+			f1 = f0;
+			v1 = v0;
+			m0 = 0.0f;
+			m1 = 0.0f;
+		} else {
+			f1 = pFrames[lo + 1];
+			m0 = (float(xmot_rdc_get_bits(pVals, bitOrg + nbits, nbits)) * qscl * 2.0f - 1.0f) * tscl;
+			v1 = float(xmot_rdc_get_bits(pVals, bitOrg + nbits*2, nbits)) * qscl;
+			m1 = (float(xmot_rdc_get_bits(pVals, bitOrg + nbits*3, nbits)) * qscl * 2.0f - 1.0f) * tscl;
+		}
+	}
+
+	bool contains(const uint32_t frm) const { return frm >= f0 && frm <= f1; }
+
+	float eval(const uint32_t frm) const {
+		if (frm <= f0) return v0;
+		if (frm >= f1) return v1;
+		float h = float(f1 - f0);
+		return xmot_rdc_hermite(v0, m0, v1, m1, h, float(frm - f0) / h);
+	}
+};
+
+static cxVec xmot_rdc_get_trk_vec(const sxMotionData::Track* pTrk, const int idx) {
 	cxVec v;
+	v.zero();
 	int mask = pTrk->get_mask();
-	if (mask) {
-		v.zero();
-		const uint16_t* pSrc = &pTrk->mData[idx * pTrk->get_stride()];
-		for (int i = 0; i < 3; ++i) {
-			if (mask & (1 << i)) {
-				v.set_at(i, float(*pSrc++));
-			}
+	const uint16_t* pData = pTrk->mData;
+	for (int i = 0; i < 3; ++i) {
+		if (mask & (1 << i)) {
+			XMOTRdcSeg seg;
+			seg.find(&pData[pData[i]], uint32_t(idx));
+			v.set_at(i, seg.eval(uint32_t(idx)));
 		}
-		v.scl(1.0f / 0xFFFF);
-		v.mul(pTrk->mBBox.get_size_vec());
-		v.add(pTrk->mBBox.get_min_pos());
-	} else {
-		v = pTrk->mBBox.get_min_pos();
 	}
+	v.mul(pTrk->mBBox.get_size_vec());
+	v.add(pTrk->mBBox.get_min_pos());
 	return v;
 }
 
+/* neighbouring frames are usually within the same key segment, so the segment is decoded once for both */
+static void xmot_rdc_get_trk_vec2(const sxMotionData::Track* pTrk, const int idx0, const int idx1, cxVec* pV0, cxVec* pV1) {
+	cxVec v0;
+	cxVec v1;
+	v0.zero();
+	v1.zero();
+	int mask = pTrk->get_mask();
+	const uint16_t* pData = pTrk->mData;
+	for (int i = 0; i < 3; ++i) {
+		if (mask & (1 << i)) {
+			const uint16_t* pChan = &pData[pData[i]];
+			XMOTRdcSeg seg;
+			seg.find(pChan, uint32_t(idx0));
+			v0.set_at(i, seg.eval(uint32_t(idx0)));
+			if (!seg.contains(uint32_t(idx1))) {
+				seg.find(pChan, uint32_t(idx1));
+			}
+			v1.set_at(i, seg.eval(uint32_t(idx1)));
+		}
+	}
+	cxVec bbmin = pTrk->mBBox.get_min_pos();
+	cxVec bbsize = pTrk->mBBox.get_size_vec();
+	*pV0 = v0 * bbsize + bbmin;
+	*pV1 = v1 * bbsize + bbmin;
+}
+
+static cxVec xmot_get_trk_vec(const sxMotionData::Track* pTrk, int idx) {
+	cxVec v;
+	int mask = pTrk->get_mask();
+	if (mask && pTrk->is_reduced()) {
+		v = xmot_rdc_get_trk_vec(pTrk, idx);
+	} else if (mask) {
+		v.zero();
+		const uint16_t* pSrc = &pTrk->mData[idx * pTrk->get_stride()];
+		for (int i = 0; i < 3; ++i) {
+			if (mask & (1 << i)) {
+				v.set_at(i, float(*pSrc++));
+			}
+		}
+		v.scl(1.0f / 0xFFFF);
+		v.mul(pTrk->mBBox.get_size_vec());
+		v.add(pTrk->mBBox.get_min_pos());
+	} else {
+		v = pTrk->mBBox.get_min_pos();
+	}
+	return v;
+}
+
+static void xmot_get_trk_vec2(const sxMotionData::Track* pTrk, const int idx0, const int idx1, cxVec* pV0, cxVec* pV1) {
+	if (pTrk->get_mask() && pTrk->is_reduced()) {
+		xmot_rdc_get_trk_vec2(pTrk, idx0, idx1, pV0, pV1);
+	} else {
+		*pV0 = xmot_get_trk_vec(pTrk, idx0);
+		*pV1 = xmot_get_trk_vec(pTrk, idx1);
+	}
+}
+
 cxQuat sxMotionData::eval_quat(const int inode, const float frm) const {
 	cxQuat q;
 	const Track* pTrk = get_q_track(inode);
@@ -13905,8 +15762,9 @@ cxQuat sxMotionData::eval_quat(const int inode, const float frm) const {
 		XMOTFrameInfo fi;
 		fi.calc(frm, mFrameNum);
 		if (fi.need_interp()) {
-			cxVec v0 = xmot_get_trk_vec(pTrk, fi.i0);
-			cxVec v1 = xmot_get_trk_vec(pTrk, fi.i1);
+			cxVec v0;
+			cxVec v1;
+			xmot_get_trk_vec2(pTrk, fi.i0, fi.i1, &v0, &v1);
 			cxQuat q0 = nxQuat::from_log_vec(v0);
 			cxQuat q1 = nxQuat::from_log_vec(v1);
 			q.slerp(q0, q1, fi.t);
@@ -13926,8 +15784,9 @@ cxVec sxMotionData::eval_pos(const int inode, const float frm) const {
 		XMOTFrameInfo fi;
 		fi.calc(frm, mFrameNum);
 		if (fi.need_interp()) {
-			cxVec t0 = xmot_get_trk_vec(pTrk, fi.i0);
-			cxVec t1 = xmot_get_trk_vec(pTrk, fi.i1);
+			cxVec t0;
+			cxVec t1;
+			xmot_get_trk_vec2(pTrk, fi.i0, fi.i1, &t0, &t1);
 			pos = nxVec::lerp(t0, t1, fi.t);
 		} else {
 			pos = xmot_get_trk_vec(pTrk, fi.i0);
@@ -13938,6 +15797,242 @@ cxVec sxMotionData::eval_pos(const int inode, const float frm) const {
 	return pos;
 }
 
+size_t sxMotionData::get_track_size(const Track* pTrk) const {
+	size_t size = 0;
+	if (pTrk) {
+		size = sizeof(cxAABB) + sizeof(uint32_t);
+		if (pTrk->is_reduced()) {
+			size += pTrk->mData[3] * sizeof(uint16_t);
+		} else {
+			size += pTrk->get_stride() * mFrameNum * sizeof(uint16_t);
+		}
+	}
+	return size;
+}
+
+size_t sxMotionData::get_tracks_size() const {
+	size_t size = 0;
+	for (uint32_t i = 0; i < mNodeNum; ++i) {
+		size += get_track_size(get_q_track(i));
+		size += get_track_size(get_t_track(i));
+	}
+	return size;
+}
+
+struct XMOTReduceWk {
+	float* mpSmps;
+	float* mpDeqV;
+	float* mpDeqM;
+	uint32_t* mpQV;
+	uint32_t* mpQM;
+	uint16_t* mpKeys;
+	int mFrameNum;
+
+	void init(const int nfrm) {
+		mFrameNum = nfrm;
+		size_t size = nfrm * (sizeof(float) * 3 + sizeof(uint32_t) * 2 + sizeof(uint16_t));
+		mpSmps = (float*)nxCore::mem_alloc(size, "xmot:rdc:wk");
+		if (mpSmps) {
+			mpDeqV = mpSmps + nfrm;
+			mpDeqM = mpDeqV + nfrm;
+			mpQV = (uint32_t*)(mpDeqM + nfrm);
+			mpQM = mpQV + nfrm;
+			mpKeys = (uint16_t*)(mpQM + nfrm);
+		}
+	}
+
+	void reset() {
+		nxCore::mem_free(mpSmps);
+		mpSmps = nullptr;
+	}
+
+	bool seg_ck(const int ik0, const int ik1, const float tol) const {
+		float h = float(ik1 - ik0);
+		float s = 1.0f / h;
+		for (int i = ik0 + 1; i < ik1; ++i) {
+			float v = xmot_rdc_hermite(mpDeqV[ik0], mpDeqM[ik0], mpDeqV[ik1], mpDeqM[ik1], h, float(i - ik0) * s);
+			if (::mth_fabsf(v - mpSmps[i]) > tol) return false;
+		}
+		return true;
+	}
+
+	/* encodes normalized samples in mpSmps, returns number of words in the channel block */
+	int encode_chan(const float tol, uint16_t* pDst) {
+		int nfrm = mFrameNum;
+		int nbits = 16;
+		for (int b = 1; b < 16; ++b) {
+			if (1.0f / float((1 << b) - 1) <= tol) {
+				nbits = b;
+				break;
+			}
+		}
+		uint32_t qmax = (1U << nbits) - 1;
+		float tscl = 0.0f;
+		for (int i = 0; i < nfrm; ++i) {
+			float m = (mpSmps[nxCalc::min(i + 1, nfrm - 1)] - mpSmps[nxCalc::max(i - 1, 0)]) * 0.5f;
+			if (i == 0 || i == nfrm - 1) m *= 2.0f;
+			mpDeqM[i] = m;
+			tscl = nxCalc::max(tscl, ::mth_fabsf(m));
+		}
+		float tquant = tscl > 0.0f ? 0.5f / tscl : 0.0f;
+		for (int i = 0; i < nfrm; ++i) {
+			float v = nxCalc::saturate(mpSmps[i]);
+			mpQV[i] = uint32_t(::mth_roundf(v * float(qmax)));
+			mpDeqV[i] = float(mpQV[i]) / float(qmax);
+			float m = nxCalc::saturate(mpDeqM[i] * tquant + 0.5f);
+			mpQM[i] = uint32_t(::mth_roundf(m * float(qmax)));
+			mpDeqM[i] = (float(mpQM[i]) / float(qmax) * 2.0f - 1.0f) * tscl;
+		}
+		int nkeys = 0;
+		int ik = 0;
+		mpKeys[nkeys++] = 0;
+		while (ik < nfrm - 1) {
+			int inext = ik + 1;
+			while (inext < nfrm - 1 && seg_ck(ik, inext + 1, tol)) {
+				++inext;
+			}
+			mpKeys[nkeys++] = uint16_t(inext);
+			ik = inext;
+		}
+		int nvalWords = (nkeys * nbits * 2 + 15) / 16;
+		int nwords = XMOT_RDC_CHAN_HEAD_WORDS + nkeys + nvalWords + 1;
+		if (pDst) {
+			uint32_t tsclBits = nxCore::f32_get_bits(tscl);
+			pDst[0] = uint16_t(nkeys);
+			pDst[1] = uint16_t(nbits);
+			pDst[2] = uint16_t(tsclBits & 0xFFFF);
+			pDst[3] = uint16_t(tsclBits >> 16);
+			uint16_t* pFrames = &pDst[XMOT_RDC_CHAN_HEAD_WORDS];
+			uint16_t* pVals = &pFrames[nkeys];
+			for (int i = 0; i < nkeys; ++i) {
+				int ifrm = mpKeys[i];
+				pFrames[i] = uint16_t(ifrm);
+				xmot_rdc_put_bits(pVals, uint32_t(i * nbits * 2), uint32_t(nbits), mpQV[ifrm]);
+				xmot_rdc_put_bits(pVals, uint32_t(i * nbits * 2 + nbits), uint32_t(nbits), mpQM[ifrm]);
+			}
+		}
+		return nwords;
+	}
+
+	int encode_chans(const sxMotionData::Track* pTrk, const float tol, uint16_t* pData) {
+		int mask = pTrk->get_mask();
+		cxVec bbmin = pTrk->mBBox.get_min_pos();
+		cxVec bbsize = pTrk->mBBox.get_size_vec();
+		int nwords = XMOT_RDC_HEAD_WORDS;
+		for (int ich = 0; ich < 3; ++ich) {
+			if (!(mask & (1 << ich))) continue;
+			for (int i = 0; i < mFrameNum; ++i) {
+				cxVec v = xmot_get_trk_vec(pTrk, i);
+				mpSmps[i] = nxCalc::div0(v.get_at(ich) - bbmin.get_at(ich), bbsize.get_at(ich));
+			}
+			float tolN = nxCalc::div0(tol, bbsize.get_at(ich));
+			if (tolN <= 0.0f) tolN = 1.0f / float(0xFFFF);
+			if (pData) {
+				pData[ich] = uint16_t(nwords);
+			}
+			nwords += encode_chan(tolN, pData ? &pData[nwords] : nullptr);
+			if (nwords > 0xFFFF) break;
+		}
+		if (pData) {
+			pData[3] = uint16_t(nwords);
+		}
+		return nwords;
+	}
+
+	/* returns encoded track size, the source track is copied as is if reduction doesn't make it smaller */
+	size_t encode_trk(const sxMotionData* pMot, const sxMotionData::Track* pTrk, const float tol, sxMotionData::Track* pDst) {
+		size_t srcSize = pMot->get_track_size(pTrk);
+		bool reduceFlg = pTrk->get_mask() != 0 && mFrameNum >= 2;
+		size_t dstSize = srcSize;
+		if (reduceFlg) {
+			int nwords = encode_chans(pTrk, tol, nullptr);
+			dstSize = sizeof(cxAABB) + sizeof(uint32_t) + nwords * sizeof(uint16_t);
+			reduceFlg = nwords <= 0xFFFF && dstSize < srcSize;
+		}
+		if (pDst) {
+			if (reduceFlg) {
+				pDst->mBBox = pTrk->mBBox;
+				pDst->mAttr = uint32_t(pTrk->get_mask()) | (1 << 4);
+				encode_chans(pTrk, tol, pDst->mData);
+			} else {
+				nxCore::mem_copy(pDst, pTrk, srcSize);
+			}
+		}
+		return reduceFlg ? dstSize : srcSize;
+	}
+};
+
+sxMotionData* sxMotionData::reduce(const float tolQ, const float tolT) const {
+	if (!mNodeOffs || mNodeNum < 1) return nullptr;
+	if (mFrameNum < 1 || mFrameNum > 0xFFFF) return nullptr;
+	const Node* pNodes = get_nodes_top();
+	size_t headSize = mNodeOffs + mNodeNum * sizeof(Node);
+	for (uint32_t i = 0; i < mNodeNum; ++i) {
+		const Node* pNode = &pNodes[i];
+		if (pNode->mTrkOffsS) return nullptr;
+		if (pNode->mTrkOffsQ && pNode->mTrkOffsQ < headSize) return nullptr;
+		if (pNode->mTrkOffsT && pNode->mTrkOffsT < headSize) return nullptr;
+	}
+	XMOTReduceWk wk;
+	wk.init(mFrameNum);
+	if (!wk.mpSmps) return nullptr;
+	size_t size = XD_ALIGN(headSize, 4);
+	for (uint32_t i = 0; i < mNodeNum; ++i) {
+		const Track* pTrkQ = get_q_track(i);
+		if (pTrkQ) {
+			size += XD_ALIGN(wk.encode_trk(this, pTrkQ, tolQ, nullptr), 4);
+		}
+		const Track* pTrkT = get_t_track(i);
+		if (pTrkT) {
+			size += XD_ALIGN(wk.encode_trk(this, pTrkT, tolT, nullptr), 4);
+		}
+	}
+	/* the string table and ext blocks follow the tracks, so they move to the end of the new block */
+	const sxStrList* pStrLst = mOffsStr >= headSize ? get_str_list() : nullptr;
+	size_t strOffs = 0;
+	if (pStrLst) {
+		size = XD_ALIGN(size, 0x10);
+		strOffs = size;
+		size += pStrLst->mSize;
+	}
+	bool extFlg = mOffsExt >= headSize && get_ext_list();
+	size_t extTop = 0;
+	if (extFlg) {
+		extTop = XD_ALIGN(size, 0x10);
+		size = extTop + nxData::get_ext_copy_size(this);
+	}
+	sxMotionData* pMot = (sxMotionData*)nxCore::mem_alloc(size, "xmot:reduced");
+	if (pMot) {
+		nxCore::mem_zero(pMot, size);
+		nxCore::mem_copy(pMot, this, headSize);
+		pMot->mFileSize = uint32_t(size);
+		pMot->mFilePathLen = 0;
+		if (pStrLst) {
+			nxCore::mem_copy(XD_INCR_PTR(pMot, strOffs), pStrLst, pStrLst->mSize);
+			pMot->mOffsStr = uint32_t(strOffs);
+		}
+		if (extFlg) {
+			nxData::copy_ext(pMot, extTop, this);
+		}
+		Node* pDstNodes = reinterpret_cast<Node*>(XD_INCR_PTR(pMot, mNodeOffs));
+		size_t offs = XD_ALIGN(headSize, 4);
+		for (uint32_t i = 0; i < mNodeNum; ++i) {
+			const Track* pTrkQ = get_q_track(i);
+			if (pTrkQ) {
+				pDstNodes[i].mTrkOffsQ = uint32_t(offs);
+				offs += XD_ALIGN(wk.encode_trk(this, pTrkQ, tolQ, (Track*)XD_INCR_PTR(pMot, offs)), 4);
+			}
+			const Track* pTrkT = get_t_track(i);
+			if (pTrkT) {
+				pDstNodes[i].mTrkOffsT = uint32_t(offs);
+				offs += XD_ALIGN(wk.encode_trk(this, pTrkT, tolT, (Track*)XD_INCR_PTR(pMot, offs)), 4);
+			}
+		}
+	}
+	wk.reset();
+	return pMot;
+}
+
 void sxMotionData::dump_clip(FILE* pOut, const float fstep) const {
 #if XD_FILEFUNCS_ENABLED
 	if (!pOut) return;
@@ -14052,7 +16147,7 @@ cxAABB sxCollisionData::get_pol_bbox(const int ipol) const {
 cxVec sxCollisionData::get_pol_normal(const int ipol) const {
 	cxVec nrm;
 	if (ck_pol_id(ipol) && mPolNrmOffs) {
-		const uint16_t* pOct = reinterpret_cast<const uint16_t*>(XD_INCR_PTR(this, mPolNrmOffs)) + ipol;
+		const uint16_t* pOct = reinterpret_cast<const uint16_t*>(XD_INCR_PTR(this, mPolNrmOffs)) + ipol*2;
 		nrm = nxVec::decode_octa(pOct);
 	} else {
 		nrm = nxVec::get_axis(exAxis::PLUS_Y);
@@ -14231,6 +16326,15 @@ struct sxColRangeCtx {
 	}
 };
 
+template<typename CTX_T> struct sxColPolLeaf {
+	CTX_T* mpCtx;
+
+	bool operator()(const int ipol) {
+		mpCtx->for_pol_tris(ipol);
+		return mpCtx->mContinue;
+	}
+};
+
 XD_NOINLINE int sxCollisionData::for_tris_in_range(const TriFunc func, const cxAABB& bbox, void* pWk, const bool calcNormals) const {
 	sxColRangeCtx ctx;
 	ctx.mpCol = this;
@@ -14240,7 +16344,21 @@ XD_NOINLINE int sxCollisionData::for_tris_in_range(const TriFunc func, const cxA
 	ctx.mCalcNormals = calcNormals;
 	ctx.mContinue = true;
 	ctx.mTriCnt = 0;
-	if (mBVHBBoxOffs && mBVHInfoOffs) {
+	const sxWideBVH* pWBVH = get_wide_BVH();
+	const sxQBVH* pQBVH = get_QBVH();
+	if (pWBVH) {
+		sxWideBVHBoxCk ck;
+		ck.init(bbox);
+		sxColPolLeaf<sxColRangeCtx> leaf;
+		leaf.mpCtx = &ctx;
+		wbvh_walk(pWBVH, ck, leaf);
+	} else if (pQBVH) {
+		sxQBVHBoxCk ck;
+		ck.mBBox = bbox;
+		sxColPolLeaf<sxColRangeCtx> leaf;
+		leaf.mpCtx = &ctx;
+		qbvh_walk(pQBVH, ck, leaf);
+	} else if (mBVHBBoxOffs && mBVHInfoOffs) {
 		ctx.for_bvh_tris(0);
 	} else {
 		for (uint32_t i = 0; i < mPolNum; ++i) {
@@ -14313,7 +16431,22 @@ XD_NOINLINE int sxCollisionData::hit_check(const HitFunc func, const cxLineSeg&
 	ctx.mpFuncWk = pWk;
 	ctx.mContinue = true;
 	ctx.mHitCnt = 0;
-	if (mBVHBBoxOffs && mBVHInfoOffs) {
+	const sxWideBVH* pWBVH = get_wide_BVH();
+	const sxQBVH* pQBVH = get_QBVH();
+	if (pWBVH) {
+		sxWideBVHSegCk ck;
+		ck.init(seg);
+		sxColPolLeaf<sxColHitCtx> leaf;
+		leaf.mpCtx = &ctx;
+		wbvh_walk(pWBVH, ck, leaf);
+	} else if (pQBVH) {
+		sxQBVHSegCk ck;
+		ck.mSeg = seg;
+		ck.mBBox = ctx.mBBox;
+		sxColPolLeaf<sxColHitCtx> leaf;
+		leaf.mpCtx = &ctx;
+		qbvh_walk(pQBVH, ck, leaf);
+	} else if (mBVHBBoxOffs && mBVHInfoOffs) {
 		ctx.for_bvh_tris(0);
 	} else {
 		for (uint32_t i = 0; i < mPolNum; ++i) {
@@ -14342,15 +16475,686 @@ static bool xcol_nearest_hit_func(const sxCollisionData& col, const sxCollisionD
 	return true;
 }
 
+struct sxColNearestCtx {
+	cxVec mOrg;
+	cxVec mDir;
+	cxVec mInvDir;
+	float mLen;
+	float mInvLen;
+	float mBestT;
+	const sxCollisionData* mpCol;
+	const cxAABB* mpNodeBoxes;
+	const sxCollisionData::BVHNodeInfo* mpNodeInfos;
+	sxCollisionData::NearestHit* mpHit;
+
+	void init(const sxCollisionData* pCol, const cxLineSeg& seg, sxCollisionData::NearestHit* pHit) {
+		mpCol = pCol;
+		mpHit = pHit;
+		mpNodeBoxes = reinterpret_cast<const cxAABB*>(XD_INCR_PTR(pCol, pCol->mBVHBBoxOffs));
+		mpNodeInfos = reinterpret_cast<const sxCollisionData::BVHNodeInfo*>(XD_INCR_PTR(pCol, pCol->mBVHInfoOffs));
+		mOrg = seg.get_pos0();
+		mDir = seg.get_dir();
+		mLen = mDir.mag();
+		mInvLen = nxCalc::rcp0(mLen);
+		for (int i = 0; i < 3; ++i) {
+			mInvDir.set_at(i, nxCalc::rcp0(mDir[i]));
+		}
+		mBestT = 1.0f;
+	}
+
+	/* parametric entry into bbox along the segment clipped to the current best hit */
+	bool slab_ck(const cxAABB& bb, float* pEntry) const {
+		float t0 = 0.0f;
+		float t1 = mBestT;
+		cxVec bbmin = bb.get_min_pos();
+		cxVec bbmax = bb.get_max_pos();
+		for (int i = 0; i < 3; ++i) {
+			float o = mOrg[i];
+			if (mDir[i] == 0.0f) {
+				if (o < bbmin[i] || o > bbmax[i]) return false;
+			} else {
+				float ta = (bbmin[i] - o) * mInvDir[i];
+				float tb = (bbmax[i] - o) * mInvDir[i];
+				t0 = nxCalc::max(t0, nxCalc::min(ta, tb));
+				t1 = nxCalc::min(t1, nxCalc::max(ta, tb));
+				if (t0 > t1) return false;
+			}
+		}
+		*pEntry = t0;
+		return true;
+	}
+
+	void pol_tris(const int ipol) {
+		float entry;
+		if (!slab_ck(mpCol->get_pol_bbox(ipol), &entry)) return;
+		const cxVec* pPnts = reinterpret_cast<const cxVec*>(XD_INCR_PTR(mpCol, mpCol->mPntOffs));
+		int ntris = mpCol->get_pol_num_tris(ipol);
+		for (int i = 0; i < ntris; ++i) {
+			cxVec vtx[3];
+			for (int j = 0; j < 3; ++j) {
+				vtx[j] = pPnts[mpCol->get_pol_tri_pnt_idx(ipol, i, j)];
+			}
+			cxVec end = mOrg + mDir*mBestT;
+			cxVec hitPos;
+			cxVec nrm;
+			if (nxGeom::seg_tri_intersect_cw(mOrg, end, vtx[0], vtx[1], vtx[2], &hitPos, &nrm)) {
+				float dist = nxVec::dist(mOrg, hitPos);
+				if (mpHit->count == 0 || dist < mpHit->dist) {
+					mpHit->pos = hitPos;
+					mpHit->nrm = nrm;
+					mpHit->dist = dist;
+					mBestT = nxCalc::min(mBestT, dist * mInvLen);
+					++mpHit->count;
+				}
+			}
+		}
+	}
+
+	void trace(const int inode, const float entry) {
+		if (entry > mBestT) return;
+		const sxCollisionData::BVHNodeInfo* pInfo = &mpNodeInfos[inode];
+		if (pInfo->is_leaf()) {
+			pol_tris(pInfo->get_pol_id());
+			return;
+		}
+		int inear = pInfo->mLeft;
+		int ifar = pInfo->mRight;
+		float tnear;
+		float tfar;
+		bool hitNear = slab_ck(mpNodeBoxes[inear], &tnear);
+		bool hitFar = slab_ck(mpNodeBoxes[ifar], &tfar);
+		if (hitNear && hitFar) {
+			if (tfar < tnear) {
+				trace(ifar, tfar);
+				trace(inear, tnear);
+			} else {
+				trace(inear, tnear);
+				trace(ifar, tfar);
+			}
+		} else if (hitNear) {
+			trace(inear, tnear);
+		} else if (hitFar) {
+			trace(ifar, tfar);
+		}
+	}
+};
+
+/* compact layout has no child ordering: nodes are culled against the segment clipped to the best hit so far */
+struct sxColQBVHNearestCk {
+	sxColNearestCtx* mpCtx;
+
+	bool operator()(const cxVec& bmin, const cxVec& bmax) const {
+		float entry;
+		return mpCtx->slab_ck(cxAABB(bmin, bmax), &entry);
+	}
+
+	bool operator()(const int ipol) {
+		mpCtx->pol_tris(ipol);
+		return true;
+	}
+};
+
 sxCollisionData::NearestHit sxCollisionData::nearest_hit(const cxLineSeg& seg) {
 	NearestHit hit;
 	hit.pos = seg.get_pos0();
 	hit.dist = 0.0f;
 	hit.count = 0;
-	sxCollisionData::hit_check(xcol_nearest_hit_func, seg, &hit);
+	const sxQBVH* pQBVH = get_QBVH();
+	if (pQBVH && seg.len() > FLT_EPSILON) {
+		sxColNearestCtx ctx;
+		ctx.init(this, seg, &hit);
+		sxColQBVHNearestCk ck;
+		ck.mpCtx = &ctx;
+		qbvh_walk(pQBVH, ck, ck);
+	} else if (mBVHBBoxOffs && mBVHInfoOffs && seg.len() > FLT_EPSILON) {
+		sxColNearestCtx ctx;
+		ctx.init(this, seg, &hit);
+		float entry;
+		if (ctx.slab_ck(ctx.mpNodeBoxes[0], &entry)) {
+			ctx.trace(0, entry);
+		}
+	} else {
+		sxCollisionData::hit_check(xcol_nearest_hit_func, seg, &hit);
+	}
 	return hit;
 }
 
+#ifndef XD_XCOL_PACKET_SIZE
+#	define XD_XCOL_PACKET_SIZE 8
+#endif
+
+#ifndef XD_XCOL_PACKET_STACK
+#	define XD_XCOL_PACKET_STACK 128
+#endif
+
+/* nearby segments pointing the same way walk the binary BVH together, each node box is tested against all active segments */
+struct sxColPacketCtx {
+	float mOrgSoA[3][XD_XCOL_PACKET_SIZE];
+	float mInvDirSoA[3][XD_XCOL_PACKET_SIZE];
+	cxVec mOrg[XD_XCOL_PACKET_SIZE];
+	cxVec mDir[XD_XCOL_PACKET_SIZE];
+	cxVec mEnd[XD_XCOL_PACKET_SIZE];
+	cxVec mHitPos[XD_XCOL_PACKET_SIZE];
+	float mInvLen[XD_XCOL_PACKET_SIZE];
+	float mBestT[XD_XCOL_PACKET_SIZE];
+	sxCollisionData::NearestHit* mpHits[XD_XCOL_PACKET_SIZE];
+	int mNum;
+	const sxCollisionData* mpCol;
+	const cxAABB* mpNodeBoxes;
+	const sxCollisionData::BVHNodeInfo* mpNodeInfos;
+
+	void init(const sxCollisionData* pCol) {
+		mpCol = pCol;
+		mpNodeBoxes = reinterpret_cast<const cxAABB*>(XD_INCR_PTR(pCol, pCol->mBVHBBoxOffs));
+		mpNodeInfos = reinterpret_cast<const sxCollisionData::BVHNodeInfo*>(XD_INCR_PTR(pCol, pCol->mBVHInfoOffs));
+		mNum = 0;
+	}
+
+	void add(const cxLineSeg& seg, sxCollisionData::NearestHit* pHit) {
+		int i = mNum++;
+		mOrg[i] = seg.get_pos0();
+		mDir[i] = seg.get_dir();
+		mInvLen[i] = nxCalc::rcp0(mDir[i].mag());
+		for (int j = 0; j < 3; ++j) {
+			mOrgSoA[j][i] = mOrg[i][j];
+			mInvDirSoA[j][i] = mDir[i][j] != 0.0f ? 1.0f / mDir[i][j] : 1.0e30f;
+		}
+		mEnd[i] = seg.get_pos1();
+		mBestT[i] = 1.0f;
+		mpHits[i] = pHit;
+	}
+
+	bool is_coherent(const cxLineSeg& seg) const {
+		if (mNum < 1) return true;
+		cxVec dir = seg.get_dir();
+		float len = dir.mag();
+		float len0 = nxCalc::rcp0(mInvLen[0]);
+		if (dir.dot(mDir[0]) < 0.9f * len * len0) return false;
+		return nxVec::dist(seg.get_pos0(), mOrg[0]) < 0.25f * len0;
+	}
+
+	/* pEntry: nearest entry among the segments that hit the box; kept out of line so that the lane loop is vectorized */
+	XD_NOINLINE uint32_t box_ck(const cxAABB& bb, const uint32_t active, float* pEntry) const {
+		float t0[XD_XCOL_PACKET_SIZE];
+		float t1[XD_XCOL_PACKET_SIZE];
+		cxVec vmin = bb.get_min_pos();
+		cxVec vmax = bb.get_max_pos();
+		float minx = vmin.x;
+		float miny = vmin.y;
+		float minz = vmin.z;
+		float maxx = vmax.x;
+		float maxy = vmax.y;
+		float maxz = vmax.z;
+		for (int i = 0; i < XD_XCOL_PACKET_SIZE; ++i) {
+			float tax = (minx - mOrgSoA[0][i]) * mInvDirSoA[0][i];
+			float tbx = (maxx - mOrgSoA[0][i]) * mInvDirSoA[0][i];
+			float tay = (miny - mOrgSoA[1][i]) * mInvDirSoA[1][i];
+			float tby = (maxy - mOrgSoA[1][i]) * mInvDirSoA[1][i];
+			float taz = (minz - mOrgSoA[2][i]) * mInvDirSoA[2][i];
+			float tbz = (maxz - mOrgSoA[2][i]) * mInvDirSoA[2][i];
+			float tin = nxCalc::max(nxCalc::max(nxCalc::min(tax, tbx), nxCalc::min(tay, tby)), nxCalc::max(nxCalc::min(taz, tbz), 0.0f));
+			float tout = nxCalc::min(nxCalc::min(nxCalc::max(tax, tbx), nxCalc::max(tay, tby)), nxCalc::min(nxCalc::max(taz, tbz), mBestT[i]));
+			t0[i] = tin;
+			t1[i] = tout;
+		}
+		uint32_t mask = 0;
+		float entry = FLT_MAX;
+		for (int i = 0; i < XD_XCOL_PACKET_SIZE; ++i) {
+			if (t0[i] <= t1[i] && (active & (1U << i))) {
+				mask |= 1U << i;
+				entry = nxCalc::min(entry, t0[i]);
+			}
+		}
+		*pEntry = entry;
+		return mask;
+	}
+
+	void pol_tris(const int ipol, const uint32_t active) {
+		const cxVec* pPnts = reinterpret_cast<const cxVec*>(XD_INCR_PTR(mpCol, mpCol->mPntOffs));
+		int ntris = mpCol->get_pol_num_tris(ipol);
+		for (int i = 0; i < ntris; ++i) {
+			cxVec vtx[3];
+			for (int j = 0; j < 3; ++j) {
+				vtx[j] = pPnts[mpCol->get_pol_tri_pnt_idx(ipol, i, j)];
+			}
+			cxVec nrm;
+			uint32_t hits = nxGeom::segs_tri_intersect_cw(mOrg, mEnd, mNum, vtx[0], vtx[1], vtx[2], mHitPos, &nrm) & active;
+			for (int k = 0; k < mNum; ++k) {
+				if (hits & (1U << k)) {
+					sxCollisionData::NearestHit* pHit = mpHits[k];
+					float dist = nxVec::dist(mOrg[k], mHitPos[k]);
+					if (pHit->count == 0 || dist < pHit->dist) {
+						pHit->pos = mHitPos[k];
+						pHit->nrm = nrm;
+						pHit->dist = dist;
+						mBestT[k] = nxCalc::min(mBestT[k], dist * mInvLen[k]);
+						mEnd[k] = mOrg[k] + mDir[k]*mBestT[k];
+						++pHit->count;
+					}
+				}
+			}
+		}
+	}
+
+	/* returns false if the stack is exhausted */
+	bool trace() {
+		int stkNode[XD_XCOL_PACKET_STACK];
+		uint32_t stkMask[XD_XCOL_PACKET_STACK];
+		for (int i = mNum; i < XD_XCOL_PACKET_SIZE; ++i) {
+			for (int j = 0; j < 3; ++j) {
+				mOrgSoA[j][i] = mOrgSoA[j][0];
+				mInvDirSoA[j][i] = mInvDirSoA[j][0];
+			}
+			mBestT[i] = -1.0f;
+		}
+		float entry;
+		uint32_t active = box_ck(mpNodeBoxes[0], (1U << mNum) - 1, &entry);
+		if (!active) return true;
+		int sp = 0;
+		stkNode[sp] = 0;
+		stkMask[sp] = active;
+		++sp;
+		while (sp > 0) {
+			--sp;
+			int inode = stkNode[sp];
+			active = stkMask[sp];
+			const sxCollisionData::BVHNodeInfo* pInfo = &mpNodeInfos[inode];
+			if (pInfo->is_leaf()) {
+				pol_tris(pInfo->get_pol_id(), active);
+				continue;
+			}
+			if (sp + 2 > XD_XCOL_PACKET_STACK) return false;
+			int inear = pInfo->mLeft;
+			int ifar = pInfo->mRight;
+			float tnear;
+			float tfar;
+			uint32_t mnear = box_ck(mpNodeBoxes[inear], active, &tnear);
+			uint32_t mfar = box_ck(mpNodeBoxes[ifar], active, &tfar);
+			if (tfar < tnear) {
+				int itmp = inear;
+				inear = ifar;
+				ifar = itmp;
+				uint32_t mtmp = mnear;
+				mnear = mfar;
+				mfar = mtmp;
+			}
+			if (mfar) {
+				stkNode[sp] = ifar;
+				stkMask[sp] = mfar;
+				++sp;
+			}
+			if (mnear) {
+				stkNode[sp] = inear;
+				stkMask[sp] = mnear;
+				++sp;
+			}
+		}
+		return true;
+	}
+};
+
+int sxCollisionData::hit_check_batch(const cxLineSeg* pSegs, NearestHit* pHits, const int nsegs) {
+	if (!pSegs || !pHits || nsegs < 1) return 0;
+	for (int i = 0; i < nsegs; ++i) {
+		pHits[i].pos = pSegs[i].get_pos0();
+		pHits[i].nrm.fill(0.0f);
+		pHits[i].dist = 0.0f;
+		pHits[i].count = 0;
+	}
+	bool pktFlg = mBVHBBoxOffs && mBVHInfoOffs && !get_wide_BVH() && !get_QBVH();
+	if (pktFlg) {
+		int i = 0;
+		while (i < nsegs) {
+			sxColPacketCtx pkt;
+			pkt.init(this);
+			int ipkt = i;
+			while (i < nsegs && pkt.mNum < XD_XCOL_PACKET_SIZE) {
+				if (pSegs[i].len() <= FLT_EPSILON || !pkt.is_coherent(pSegs[i])) break;
+				pkt.add(pSegs[i], &pHits[i]);
+				++i;
+			}
+			if (pkt.mNum > 1 && pkt.trace()) continue;
+			/* incoherent or degenerate: single segment traversal */
+			if (i == ipkt) {
+				++i;
+			}
+			for (int j = ipkt; j < i; ++j) {
+				pHits[j] = nearest_hit(pSegs[j]);
+			}
+		}
+	} else {
+		for (int i = 0; i < nsegs; ++i) {
+			pHits[i] = nearest_hit(pSegs[i]);
+		}
+	}
+	int nhit = 0;
+	for (int i = 0; i < nsegs; ++i) {
+		if (pHits[i].count > 0) {
+			++nhit;
+		}
+	}
+	return nhit;
+}
+
+struct sxColSweepCtx {
+	cxVec mCapP0;
+	cxVec mCapP1;
+	cxVec mMov;
+	float mRadius;
+	sxCollisionData::TriFunc mFilter;
+	void* mpFilterWk;
+	sxCollisionData::SweepHit* mpHit;
+};
+
+static bool xcol_sweep_tri_func(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	sxColSweepCtx* pCtx = (sxColSweepCtx*)pWk;
+	if (pCtx->mFilter && !pCtx->mFilter(col, tri, pCtx->mpFilterWk)) return true;
+	float t = 0.0f;
+	float dist = 0.0f;
+	cxVec nrm;
+	cxVec pos;
+	if (nxGeom::cap_tri_sweep(pCtx->mCapP0, pCtx->mCapP1, pCtx->mRadius, pCtx->mMov, tri.vtx[0], tri.vtx[1], tri.vtx[2], &t, &nrm, &pos, &dist)) {
+		sxCollisionData::SweepHit* pHit = pCtx->mpHit;
+		if (pHit->count == 0 || t < pHit->t) {
+			pHit->pos = pos;
+			pHit->nrm = nrm;
+			pHit->t = t;
+			pHit->dist = dist;
+			pHit->ipol = tri.ipol;
+			pHit->itri = tri.itri;
+		}
+		++pHit->count;
+	}
+	return true;
+}
+
+sxCollisionData::SweepHit sxCollisionData::sweep_sph(const cxVec& p0, const cxVec& p1, const float radius, const TriFunc filter, void* pFilterWk) const {
+	return sweep_cap(p0, p0, radius, p1 - p0, filter, pFilterWk);
+}
+
+sxCollisionData::SweepHit sxCollisionData::sweep_cap(const cxVec& cp0, const cxVec& cp1, const float radius, const cxVec& mov, const TriFunc filter, void* pFilterWk) const {
+	SweepHit hit;
+	hit.pos = cp0;
+	hit.nrm.fill(0.0f);
+	hit.t = 1.0f;
+	hit.dist = 0.0f;
+	hit.ipol = -1;
+	hit.itri = -1;
+	hit.count = 0;
+	sxColSweepCtx ctx;
+	ctx.mCapP0 = cp0;
+	ctx.mCapP1 = cp1;
+	ctx.mMov = mov;
+	ctx.mRadius = radius;
+	ctx.mFilter = filter;
+	ctx.mpFilterWk = pFilterWk;
+	ctx.mpHit = &hit;
+	cxAABB range(cp0, cp1);
+	range.add_pnt(cp0 + mov);
+	range.add_pnt(cp1 + mov);
+	cxVec r(radius);
+	range.set(range.get_min_pos() - r, range.get_max_pos() + r);
+	for_tris_in_range(xcol_sweep_tri_func, range, &ctx, filter != nullptr);
+	return hit;
+}
+
+int sxCollisionData::slide_sph(const cxVec& p0, const cxVec& p1, const float radius, cxVec* pAdjPos, const int maxSweeps, const float margin, const TriFunc filter, void* pFilterWk) const {
+	cxVec adjMov;
+	int nhit = slide_cap(p0, p0, radius, p1 - p0, &adjMov, maxSweeps, margin, filter, pFilterWk);
+	if (pAdjPos) {
+		*pAdjPos = p0 + adjMov;
+	}
+	return nhit;
+}
+
+/* the remaining move slides along the hit plane, or along the crease of the last two planes */
+int sxCollisionData::slide_cap(const cxVec& cp0, const cxVec& cp1, const float radius, const cxVec& mov, cxVec* pAdjMov, const int maxSweeps, const float margin, const TriFunc filter, void* pFilterWk) const {
+	cxVec offs(0.0f);
+	cxVec rest = mov;
+	cxVec prevNrm(0.0f);
+	int nhit = 0;
+	int nsweeps = nxCalc::max(maxSweeps, 1);
+	for (int i = 0; i < nsweeps; ++i) {
+		if (rest.mag2() <= 1e-12f) break;
+		SweepHit hit = sweep_cap(cp0 + offs, cp1 + offs, radius, rest, filter, pFilterWk);
+		if (hit.count == 0) {
+			offs += rest;
+			break;
+		}
+		float vn = rest.dot(hit.nrm);
+		float t = nxCalc::max(hit.t - margin / -vn, 0.0f);
+		offs += rest * t;
+		if (hit.dist < radius - margin) {
+			offs += hit.nrm * (radius - hit.dist);
+		}
+		rest.scl(1.0f - t);
+		rest -= hit.nrm * rest.dot(hit.nrm);
+		if (nhit > 0) {
+			cxVec crs = nxVec::cross(prevNrm, hit.nrm);
+			float cl2 = crs.mag2();
+			if (cl2 > 1e-6f && rest.dot(prevNrm) < 0.0f) {
+				rest = crs * (rest.dot(crs) / cl2);
+			}
+		}
+		prevNrm = hit.nrm;
+		++nhit;
+	}
+	if (pAdjMov) {
+		*pAdjMov = offs;
+	}
+	return nhit;
+}
+
+static uint32_t xcol_sect_end(const sxCollisionData* pCol, const uint32_t* pOffs, const int n, const uint32_t offs) {
+	uint32_t end = pCol->mFileSize;
+	for (int i = 0; i < n; ++i) {
+		if (pOffs[i] > offs) end = nxCalc::min(end, pOffs[i]);
+	}
+	if (pCol->mOffsExt > offs) end = nxCalc::min(end, pCol->mOffsExt);
+	const sxData::ExtList* pLst = pCol->get_ext_list();
+	if (pLst) {
+		for (uint32_t i = 0; i < pLst->num; ++i) {
+			if (pLst->lst[i].offs > offs) end = nxCalc::min(end, pLst->lst[i].offs);
+		}
+	}
+	return end;
+}
+
+static size_t xcol_sect_align(const uint32_t offs) {
+	return (offs & 0xF) == 0 ? 0x10 : (offs & 3) == 0 ? 4 : 1;
+}
+
+/* the QBVH replaces the float BVH arrays, the other sections are packed in their original order */
+sxCollisionData* sxCollisionData::make_QBVH(const int bits) const {
+	if (!mBVHBBoxOffs || !mBVHInfoOffs || mPolNum < 1) return nullptr;
+	int nnodes = int(mPolNum) * 2 - 1;
+	const uint32_t srcOffs[] = {
+		mPntOffs, mPolIdxOrgOffs, mPolVtxNumOffs, mPolTriOrgOffs, mPolIdxOffs, mPolGrpOffs, mPolTriIdxOffs,
+		mPolBBoxOffs, mPolNrmOffs, mGrpInfoOffs, mOffsStr,
+		mBVHBBoxOffs, mBVHInfoOffs, mQBVHOffs
+	};
+	const int nsect = int(XD_ARY_LEN(srcOffs));
+	const int nkeep = nsect - 3;
+	uint32_t sectSize[XD_ARY_LEN(srcOffs)];
+	int sectOrder[XD_ARY_LEN(srcOffs)];
+	uint32_t top = mFileSize;
+	int nsort = 0;
+	for (int i = 0; i < nsect; ++i) {
+		sectSize[i] = srcOffs[i] ? xcol_sect_end(this, srcOffs, nsect, srcOffs[i]) - srcOffs[i] : 0;
+		if (srcOffs[i]) {
+			top = nxCalc::min(top, srcOffs[i]);
+		}
+		if (i < nkeep && sectSize[i]) {
+			int j = nsort++;
+			while (j > 0 && srcOffs[sectOrder[j - 1]] > srcOffs[i]) {
+				sectOrder[j] = sectOrder[j - 1];
+				--j;
+			}
+			sectOrder[j] = i;
+		}
+	}
+	size_t size = top;
+	for (int i = 0; i < nsort; ++i) {
+		int isect = sectOrder[i];
+		size = XD_ALIGN(size, xcol_sect_align(srcOffs[isect])) + sectSize[isect];
+	}
+	size_t qbvhOffs = XD_ALIGN(size, 0x10);
+	size_t qbvhSize = sxQBVH::calc_size(nnodes, bits);
+	size = qbvhOffs + qbvhSize;
+	if (get_ext_list()) {
+		size = XD_ALIGN(size, 0x10) + nxData::get_ext_copy_size(this);
+	}
+	sxCollisionData* pCol = (sxCollisionData*)nxCore::mem_alloc(size, "xcol:QBVH");
+	if (!pCol) return nullptr;
+	nxCore::mem_zero(pCol, size);
+	nxCore::mem_copy(pCol, this, top);
+	uint32_t* pDstOffs[] = {
+		&pCol->mPntOffs, &pCol->mPolIdxOrgOffs, &pCol->mPolVtxNumOffs, &pCol->mPolTriOrgOffs, &pCol->mPolIdxOffs, &pCol->mPolGrpOffs, &pCol->mPolTriIdxOffs,
+		&pCol->mPolBBoxOffs, &pCol->mPolNrmOffs, &pCol->mGrpInfoOffs, &pCol->mOffsStr,
+		&pCol->mBVHBBoxOffs, &pCol->mBVHInfoOffs, &pCol->mQBVHOffs
+	};
+	for (int i = 0; i < nsect; ++i) {
+		*pDstOffs[i] = 0;
+	}
+	size_t offs = top;
+	for (int i = 0; i < nsort; ++i) {
+		int isect = sectOrder[i];
+		offs = XD_ALIGN(offs, xcol_sect_align(srcOffs[isect]));
+		nxCore::mem_copy(XD_INCR_PTR(pCol, offs), XD_INCR_PTR(this, srcOffs[isect]), sectSize[isect]);
+		*pDstOffs[isect] = uint32_t(offs);
+		offs += sectSize[isect];
+	}
+	sxQBVH* pQBVH = (sxQBVH*)XD_INCR_PTR(pCol, qbvhOffs);
+	const cxAABB* pBoxes = reinterpret_cast<const cxAABB*>(XD_INCR_PTR(this, mBVHBBoxOffs));
+	const int32_t* pInfos = reinterpret_cast<const int32_t*>(XD_INCR_PTR(this, mBVHInfoOffs));
+	if (!sxQBVH::build(pQBVH, bits, pBoxes, pInfos, nnodes)) {
+		nxCore::mem_free(pCol);
+		return nullptr;
+	}
+	pCol->mQBVHOffs = uint32_t(qbvhOffs);
+	nxData::copy_ext(pCol, qbvhOffs + qbvhSize, this);
+	pCol->mFileSize = uint32_t(size);
+	pCol->mFilePathLen = 0;
+	return pCol;
+}
+
+sxCollisionData* sxCollisionData::make_wide_BVH(const int width) const {
+	if (!mBVHBBoxOffs || !mBVHInfoOffs || mPolNum < 1) return nullptr;
+	const cxAABB* pBoxes = reinterpret_cast<const cxAABB*>(XD_INCR_PTR(this, mBVHBBoxOffs));
+	const int32_t* pInfos = reinterpret_cast<const int32_t*>(XD_INCR_PTR(this, mBVHInfoOffs));
+	size_t size = 0;
+	sxWideBVH* pWBVH = wbvh_create(width, pBoxes, pInfos, &size);
+	if (!pWBVH) return nullptr;
+	sxCollisionData* pCol = (sxCollisionData*)nxData::add_ext(this, sxWideBVH::KIND, pWBVH, size);
+	nxCore::mem_free(pWBVH);
+	return pCol;
+}
+
+float sxCollisionData::calc_BVH_cost() const {
+	if (mPolNum < 1) return 0.0f;
+	int nnodes = int(mPolNum) * 2 - 1;
+	if (mBVHBBoxOffs && mBVHInfoOffs) {
+		const cxAABB* pBoxes = reinterpret_cast<const cxAABB*>(XD_INCR_PTR(this, mBVHBBoxOffs));
+		const int32_t* pInfos = reinterpret_cast<const int32_t*>(XD_INCR_PTR(this, mBVHInfoOffs));
+		return nxGeom::aabb_tree_sah_cost(pBoxes, pInfos, nnodes);
+	}
+	const sxQBVH* pQBVH = get_QBVH();
+	if (!pQBVH || !mPolBBoxOffs) return 0.0f;
+	void* pTmp = nxCore::mem_alloc(nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2), "xcol:BVH:cost");
+	if (!pTmp) return 0.0f;
+	cxAABB* pBoxes = (cxAABB*)pTmp;
+	int32_t* pInfos = (int32_t*)XD_INCR_PTR(pTmp, nnodes * sizeof(cxAABB));
+	pQBVH->get_tree(pInfos);
+	nxGeom::refit_aabb_tree(reinterpret_cast<const cxAABB*>(XD_INCR_PTR(this, mPolBBoxOffs)), pBoxes, pInfos, nnodes);
+	float cost = nxGeom::aabb_tree_sah_cost(pBoxes, pInfos, nnodes);
+	nxCore::mem_free(pTmp);
+	return cost;
+}
+
+bool sxCollisionData::refit_BVH(const cxVec* pPnts, const float rebuildCost, cxBrigade* pBgd) {
+	if (!mPntOffs || !mPolBBoxOffs || mPolNum < 1) return false;
+	cxVec* pDstPnts = reinterpret_cast<cxVec*>(XD_INCR_PTR(this, mPntOffs));
+	if (pPnts && pPnts != pDstPnts) {
+		nxCore::mem_copy(pDstPnts, pPnts, mPntNum * sizeof(cxVec));
+	}
+	int npol = int(mPolNum);
+	cxAABB* pPolBoxes = reinterpret_cast<cxAABB*>(XD_INCR_PTR(this, mPolBBoxOffs));
+	uint16_t* pPolNrms = mPolNrmOffs ? reinterpret_cast<uint16_t*>(XD_INCR_PTR(this, mPolNrmOffs)) : nullptr;
+	for (int i = 0; i < npol; ++i) {
+		cxAABB bb;
+		bb.init();
+		cxVec nrm;
+		nrm.zero();
+		int nvtx = get_pol_num_vtx(i);
+		for (int j = 0; j < nvtx; ++j) {
+			int k = j - 1;
+			if (k < 0) k = nvtx - 1;
+			cxVec* pPntJ = &pDstPnts[get_pol_pnt_idx(i, j)];
+			bb.add_pnt(*pPntJ);
+			nxGeom::update_nrm_newell(&nrm, pPntJ, &pDstPnts[get_pol_pnt_idx(i, k)]);
+		}
+		pPolBoxes[i] = bb;
+		if (pPolNrms) {
+			nrm.normalize();
+			nxVec::encode_octa(nrm, &pPolNrms[i*2]);
+		}
+	}
+	int nnodes = npol*2 - 1;
+	sxQBVH* pQBVH = mQBVHOffs ? reinterpret_cast<sxQBVH*>(XD_INCR_PTR(this, mQBVHOffs)) : nullptr;
+	cxAABB* pNodeBoxes = nullptr;
+	int32_t* pNodeInfos = nullptr;
+	void* pTmp = nullptr;
+	if (mBVHBBoxOffs && mBVHInfoOffs) {
+		pNodeBoxes = reinterpret_cast<cxAABB*>(XD_INCR_PTR(this, mBVHBBoxOffs));
+		pNodeInfos = reinterpret_cast<int32_t*>(XD_INCR_PTR(this, mBVHInfoOffs));
+	} else if (pQBVH) {
+		/* QBVH-only data: the float tree is recovered from the QBVH for the refit */
+		pTmp = nxCore::mem_alloc(nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2), "xcol:refit:tree");
+		if (pTmp) {
+			pNodeBoxes = (cxAABB*)pTmp;
+			pNodeInfos = (int32_t*)XD_INCR_PTR(pTmp, nnodes * sizeof(cxAABB));
+			pQBVH->get_tree(pNodeInfos);
+		}
+	}
+	if (!pNodeBoxes) {
+		mBBox = pPolBoxes[0];
+		for (int i = 1; i < npol; ++i) {
+			mBBox.merge(pPolBoxes[i]);
+		}
+		return false;
+	}
+	nxGeom::refit_aabb_tree(pPolBoxes, pNodeBoxes, pNodeInfos, nnodes, pBgd);
+	bool rebuild = false;
+	if (rebuildCost > 0.0f && nxGeom::aabb_tree_sah_cost(pNodeBoxes, pNodeInfos, nnodes) > rebuildCost) {
+		size_t wkSize = nnodes * (sizeof(cxAABB) + sizeof(int32_t) * 2) + npol * sizeof(int32_t);
+		void* pWk = nxCore::mem_alloc(wkSize, "xcol:refit:wk");
+		if (pWk) {
+			cxAABB* pNewBoxes = (cxAABB*)pWk;
+			int32_t* pNewInfos = (int32_t*)XD_INCR_PTR(pNewBoxes, nnodes * sizeof(cxAABB));
+			int32_t* pIdxWk = (int32_t*)XD_INCR_PTR(pNewInfos, nnodes * sizeof(int32_t) * 2);
+			nxGeom::build_aabb_tree(pPolBoxes, npol, pNewBoxes, pNewInfos, pIdxWk, true, pBgd);
+			/* an SAH tree can be deeper than the QBVH allows, keep the refit one then */
+			rebuild = !pQBVH || sxQBVH::build(pQBVH, pQBVH->mBits, pNewBoxes, pNewInfos, nnodes);
+			if (rebuild) {
+				nxCore::mem_copy(pNodeBoxes, pNewBoxes, nnodes * sizeof(cxAABB));
+				nxCore::mem_copy(pNodeInfos, pNewInfos, nnodes * sizeof(int32_t) * 2);
+			}
+			nxCore::mem_free(pWk);
+		}
+	}
+	mBBox = pNodeBoxes[0];
+	if (pQBVH && !rebuild) {
+		sxQBVH::build(pQBVH, pQBVH->mBits, pNodeBoxes, pNodeInfos, nnodes);
+	}
+	if (!wbvh_update(const_cast<sxWideBVH*>(get_wide_BVH()), pNodeBoxes, pNodeInfos, pPolBoxes, rebuild)) {
+		rebuild = false;
+	}
+	if (pTmp) {
+		nxCore::mem_free(pTmp);
+	}
+	return rebuild;
+}
+
 void sxCollisionData::dump_pol_geo(FILE* pOut) const {
 #if XD_FILEFUNCS_ENABLED
 	if (!pOut) return;
@@ -14474,20 +17278,208 @@ int sxFileCatalogue::find_item_name_idx(const char* pName) const {
 }
 
 
-void cxMotionWork::apply_motion(const sxMotionData* pMotData, const float frameAdd, float* pLoopFlg) {
-	mpCurrentMotData = pMotData;
-	mEvalFrame = mFrame;
-	if (!pMotData) return;
-	if (!mpMdlData) return;
+cxMotionEvalCache* cxMotionEvalCache::create(const int slotsNum, const int maxNodes, const bool useLock) {
+	cxMotionEvalCache* pCache = nullptr;
+	if (slotsNum > 0 && maxNodes > 0) {
+		int nslots = 1;
+		while (nslots < slotsNum) {
+			nslots <<= 1;
+		}
+		int nnodes = nxCalc::min(maxNodes, XD_MOTEVAL_CACHE_MAX_NODES);
+		size_t size = XD_ALIGN(sizeof(cxMotionEvalCache), 0x10);
+		size_t slotsOffs = size;
+		size += XD_ALIGN(nslots * sizeof(Slot), 0x10);
+		size_t valsOffs = size;
+		size += nslots * nnodes * sizeof(NodeVal);
+		pCache = (cxMotionEvalCache*)nxCore::mem_alloc(size, "xMotEvalCache");
+		if (pCache) {
+			nxCore::mem_zero((void*)pCache, size);
+			pCache->mpSlots = (Slot*)XD_INCR_PTR(pCache, slotsOffs);
+			pCache->mpVals = (NodeVal*)XD_INCR_PTR(pCache, valsOffs);
+			pCache->mpLock = useLock ? nxSys::lock_create() : nullptr;
+			pCache->mSlotsNum = nslots;
+			pCache->mMaxNodes = nnodes;
+			pCache->mStamp = 1;
+		}
+	}
+	return pCache;
+}
+
+void cxMotionEvalCache::destroy(cxMotionEvalCache* pCache) {
+	if (pCache) {
+		if (pCache->mpLock) {
+			nxSys::lock_destroy(pCache->mpLock);
+		}
+		nxCore::mem_free(pCache);
+	}
+}
+
+void cxMotionEvalCache::frame_begin() {
+	++mStamp;
+	if (mStamp == 0) {
+		invalidate();
+	}
+	nxCore::mem_zero(&mStats, sizeof(mStats));
+}
+
+void cxMotionEvalCache::invalidate() {
+	for (int i = 0; i < mSlotsNum; ++i) {
+		mpSlots[i].mpMot = nullptr;
+		mpSlots[i].mStamp = 0;
+	}
+	mStamp = 1;
+}
+
+float cxMotionEvalCache::quantize_frame(const float frame, const float step) {
+	float f = frame;
+	if (step > 0.0f) {
+		f = ::mth_floorf(f / step + 0.5f) * step;
+	}
+	return f;
+}
+
+int cxMotionEvalCache::get_slot_idx(const sxMotionData* pMot, const float frame) const {
+	uint64_t addr = (uint64_t)(uintptr_t)pMot;
+	uint32_t h = uint32_t(addr >> 4) ^ uint32_t(addr >> 36);
+	h ^= nxCore::f32_get_bits(frame) * 0x9E3779B1;
+	h ^= h >> 15;
+	h *= 0x2C1B3C6D;
+	h ^= h >> 12;
+	return int(h & uint32_t(mSlotsNum - 1));
+}
+
+void cxMotionEvalCache::eval_direct(const sxMotionData* pMot, const float frame, NodeVal* pVals) {
+	if (!pMot || !pVals) return;
+	int nnodes = int(pMot->mNodeNum);
+	for (int i = 0; i < nnodes; ++i) {
+		cxQuat q = pMot->eval_quat(i, frame);
+		cxVec t = pMot->eval_pos(i, frame);
+		pVals[i].q = q;
+		pVals[i].t = t;
+	}
+}
+
+bool cxMotionEvalCache::eval(const sxMotionData* pMot, const float frame, NodeVal* pVals) {
+	if (!pVals) return false;
+	if (!ck_motion(pMot)) {
+		eval_direct(pMot, frame, pVals);
+		return false;
+	}
+	int nnodes = int(pMot->mNodeNum);
+	size_t valsSize = nnodes * sizeof(NodeVal);
+	int islot = get_slot_idx(pMot, frame);
+	Slot* pSlot = &mpSlots[islot];
+	NodeVal* pSlotVals = &mpVals[islot * mMaxNodes];
+	bool hit = false;
+	if (mpLock) nxSys::lock_acquire(mpLock);
+	if (pSlot->mStamp == mStamp && pSlot->mpMot == pMot && pSlot->mFrame == frame) {
+		nxCore::mem_copy(pVals, pSlotVals, valsSize);
+		hit = true;
+	}
+	if (mpLock) nxSys::lock_release(mpLock);
+	if (hit) {
+		nxSys::atomic_inc(&mStats.hits);
+	} else {
+		nxSys::atomic_inc(&mStats.misses);
+		eval_direct(pMot, frame, pVals);
+		bool stored = false;
+		if (mpLock) nxSys::lock_acquire(mpLock);
+		if (pSlot->mStamp != mStamp) {
+			pSlot->mpMot = pMot;
+			pSlot->mFrame = frame;
+			pSlot->mNodeNum = uint32_t(nnodes);
+			nxCore::mem_copy(pSlotVals, pVals, valsSize);
+			pSlot->mStamp = mStamp;
+			stored = true;
+		}
+		if (mpLock) nxSys::lock_release(mpLock);
+		if (stored) {
+			nxSys::atomic_inc(&mStats.stores);
+		}
+	}
+	return hit;
+}
+
+
+float cxMotionWork::calc_next_frame(const sxMotionData* pMotData, const float frame, const float frameAdd, bool* pLoopFlg) const {
+	float maxFrame = float(pMotData->mFrameNum - 1);
+	float nextFrame = frame + frameAdd;
+	bool loop = mPlayLastFrame ? nextFrame > maxFrame : nextFrame >= maxFrame;
+	if (loop) {
+		nextFrame = ::mth_fmodf(nextFrame, maxFrame);
+	} else if (nextFrame < 0.0f) {
+		nextFrame = maxFrame - ::mth_fmodf(-nextFrame, maxFrame);
+	}
+	if (pLoopFlg) {
+		*pLoopFlg = loop;
+	}
+	return nextFrame;
+}
+
+void cxMotionWork::apply_move_node(const sxMotionData* pMotData, const int imot, const cxQuat& quat, const cxVec& pos, const float frameAdd) {
+	const sxMotionData::Node* pMotNode = pMotData->get_node(imot);
+	if (pMotNode->mTrkOffsT) {
+		cxVec vmove = pos;
+		if (mEvalFrame > 0.0f) {
+			float prevFrame = nxCalc::max(mEvalFrame - frameAdd, 0.0f);
+			cxVec prevPos = pMotData->eval_pos(imot, prevFrame);
+			vmove.sub(prevPos);
+		} else {
+			vmove.scl(frameAdd);
+		}
+		mMoveRelPos = vmove * mUniformScale;
+	} else {
+		mMoveRelPos.zero();
+	}
+	if (pMotNode->mTrkOffsQ) {
+		cxQuat qmove = quat;
+		if (mEvalFrame > 0.0f) {
+			float prevFrame = nxCalc::max(mEvalFrame - frameAdd, 0.0f);
+			cxQuat prevQuat = pMotData->eval_quat(imot, prevFrame);
+			qmove = prevQuat.get_inverted() * quat;
+		} else {
+			qmove = pMotData->eval_quat(imot, frameAdd);
+		}
+		mMoveRelQuat = qmove;
+	} else {
+		mMoveRelQuat.identity();
+	}
+	if (mpMdlData->ck_skel_id(mRootId)) {
+		xt_xmtx moveXform = nxMtx::xmtx_from_quat_pos(mMoveRelQuat, mMoveRelPos);
+		mpXformsL[mRootId] = nxMtx::xmtx_concat(moveXform, mpXformsL[mRootId]);
+		mpXformsL[mMoveId].identity();
+	}
+}
+
+void cxMotionWork::eval_nodes(const sxMotionData* pMotData, const float frameAdd, const bool moveOnly) {
+	cxMotionEvalCache::NodeVal cacheVals[XD_MOTEVAL_CACHE_MAX_NODES];
+	bool cacheFlg = false;
+	if (!moveOnly && mpEvalCache && mpEvalCache->ck_motion(pMotData)) {
+		float cacheFrame = cxMotionEvalCache::quantize_frame(mEvalFrame, mEvalCacheStep);
+		mpEvalCache->eval(pMotData, cacheFrame, cacheVals);
+		cacheFlg = true;
+	}
 	for (uint32_t i = 0; i < pMotData->mNodeNum; ++i) {
 		const char* pMotNodeName = pMotData->get_node_name(i);
 		int iskel = mpMdlData->find_skel_node_id(pMotNodeName);
 		if (mpMdlData->ck_skel_id(iskel)) {
+			bool baseFlg = iskel == mMoveId || iskel == mRootId;
+			if (moveOnly) {
+				if (!baseFlg) continue;
+			} else if (mpLODSkipBits && !baseFlg) {
+				if (XD_BIT_ARY_CK(uint32_t, mpLODSkipBits, iskel)) continue;
+			}
 			const sxMotionData::Node* pMotNode = pMotData->get_node(i);
 			xt_xmtx xform = mpXformsL[iskel];
 			cxVec pos = nxMtx::xmtx_get_pos(xform);
+			/* root motion is always evaluated exactly, so that quantized frames don't affect character movement */
+			bool useCache = cacheFlg && iskel != mMoveId;
 			if (pMotNode->mTrkOffsT) {
-				pos = pMotData->eval_pos(i, mEvalFrame);
+				if (useCache) {
+					pos.from_mem(cacheVals[i].t);
+				} else {
+					pos = pMotData->eval_pos(i, mEvalFrame);
+				}
 				if (iskel == mCenterId) {
 					pos.y += mHeightOffs;
 				}
@@ -14495,64 +17487,75 @@ void cxMotionWork::apply_motion(const sxMotionData* pMotData, const float frameA
 			}
 			cxQuat quat;
 			if (pMotNode->mTrkOffsQ) {
-				quat = pMotData->eval_quat(i, mEvalFrame);
+				if (useCache) {
+					quat.from_mem(cacheVals[i].q);
+				} else {
+					quat = pMotData->eval_quat(i, mEvalFrame);
+				}
 				xform = nxMtx::xmtx_from_quat_pos(quat, pos);
 			}
 			mpXformsL[iskel] = xform;
 
 			if (iskel == mMoveId) {
-				if (pMotNode->mTrkOffsT) {
-					cxVec vmove = pos;
-					if (mEvalFrame > 0.0f) {
-						float prevFrame = nxCalc::max(mEvalFrame - frameAdd, 0.0f);
-						cxVec prevPos = pMotData->eval_pos(i, prevFrame);
-						vmove.sub(prevPos);
-					} else {
-						vmove.scl(frameAdd);
-					}
-					mMoveRelPos = vmove * mUniformScale;
-				} else {
-					mMoveRelPos.zero();
-				}
-				if (pMotNode->mTrkOffsQ) {
-					cxQuat qmove = quat;
-					if (mEvalFrame > 0.0f) {
-						float prevFrame = nxCalc::max(mEvalFrame - frameAdd, 0.0f);
-						cxQuat prevQuat = pMotData->eval_quat(i, prevFrame);
-						qmove = prevQuat.get_inverted() * quat;
-					} else {
-						qmove = pMotData->eval_quat(i, frameAdd);
-					}
-					mMoveRelQuat = qmove;
-				} else {
-					mMoveRelQuat.identity();
-				}
-				if (mpMdlData->ck_skel_id(mRootId)) {
-					xt_xmtx moveXform = nxMtx::xmtx_from_quat_pos(mMoveRelQuat, mMoveRelPos);
-					mpXformsL[mRootId] = nxMtx::xmtx_concat(moveXform, mpXformsL[mRootId]);
-					mpXformsL[mMoveId].identity();
-				}
+				apply_move_node(pMotData, i, quat, pos, frameAdd);
 			}
 		}
 	}
-	float maxFrame = float(pMotData->mFrameNum - 1);
-	mFrame += frameAdd;
-	bool loop = mPlayLastFrame ? mFrame > maxFrame : mFrame >= maxFrame;
-	if (loop) {
-		mFrame = ::mth_fmodf(mFrame, maxFrame);
-	} else if (mFrame < 0.0f) {
-		mFrame = maxFrame - ::mth_fmodf(-mFrame, maxFrame);
-	}
+}
+
+void cxMotionWork::apply_motion(const sxMotionData* pMotData, const float frameAdd, float* pLoopFlg) {
+	mpCurrentMotData = pMotData;
+	mLODHold = false;
+	mEvalFrame = mFrame;
+	if (!pMotData) return;
+	if (!mpMdlData) return;
+	eval_nodes(pMotData, frameAdd, false);
+	bool loop = false;
+	mFrame = calc_next_frame(pMotData, mFrame, frameAdd, &loop);
 	if (pLoopFlg) {
 		*pLoopFlg = loop;
 	}
 }
 
+/* off-frames hold the pose of the last key and only advance the root motion, see calc_world_hold */
+bool cxMotionWork::apply_motion_lod(const sxMotionData* pMotData, const float frameAdd, const int interval, const int phase, float* pLoopFlg) {
+	if (interval <= 1 || !pMotData || !mpMdlData || mBlendCount > 0.0f) {
+		reset_lod();
+		apply_motion(pMotData, frameAdd, pLoopFlg);
+		return true;
+	}
+	bool keyFlg = ck_lod_key() || pMotData != mpCurrentMotData || mFrame != mLODFrame;
+	if (keyFlg) {
+		int span = interval;
+		if (mLODSpan <= 0) {
+			/* first span after entering LOD is shortened by phase, so that keys of different objects are staggered */
+			span = 1 + int(uint32_t(phase) % uint32_t(interval));
+		}
+		mLODSpan = span;
+		mLODStep = 0;
+		apply_motion(pMotData, frameAdd, pLoopFlg);
+	} else {
+		mpCurrentMotData = pMotData;
+		mEvalFrame = mFrame;
+		eval_nodes(pMotData, frameAdd, true);
+		bool loop = false;
+		mFrame = calc_next_frame(pMotData, mFrame, frameAdd, &loop);
+		if (pLoopFlg) {
+			*pLoopFlg = loop;
+		}
+		mLODHold = true;
+	}
+	++mLODStep;
+	mLODFrame = mFrame;
+	return keyFlg;
+}
+
 void cxMotionWork::copy_local(const cxMotionWork* pSrcWk, const sxMotionData* pSrcMotData) {
 	if (!pSrcWk) return;
 	if (!pSrcMotData) return;
 	if (!mpMdlData) return;
 	if (mpMdlData != pSrcWk->mpMdlData) return;
+	mLODHold = false;
 	for (uint32_t i = 0; i < pSrcMotData->mNodeNum; ++i) {
 		const char* pMotNodeName = pSrcMotData->get_node_name(i);
 		int iskel = mpMdlData->find_skel_node_id(pMotNodeName);
@@ -14659,33 +17662,228 @@ void cxMotionWork::copy_prev_world() {
 	nxCore::mem_copy(mpPrevXformsW, mpXformsW, mpMdlData->mSklNum * sizeof(xt_xmtx));
 }
 
-void cxMotionWork::calc_world() {
-	if (!mpMdlData) return;
+#ifndef XD_MOTWK_SOA_LANES
+#	define XD_MOTWK_SOA_LANES 4
+#endif
+
+struct XMTXSoA {
+	float e[12][XD_MOTWK_SOA_LANES];
+
+	void load(const int lane, const xt_xmtx& xm) {
+		const float* p = xm;
+		for (int i = 0; i < 12; ++i) { e[i][lane] = p[i]; }
+	}
+
+	void store(const int lane, xt_xmtx* pDst) const {
+		float* p = *pDst;
+		for (int i = 0; i < 12; ++i) { p[i] = e[i][lane]; }
+	}
+
+	void concat(const XMTXSoA& a, const XMTXSoA& b) {
+		for (int r = 0; r < 3; ++r) {
+			const float* pb0 = b.e[r*4 + 0];
+			const float* pb1 = b.e[r*4 + 1];
+			const float* pb2 = b.e[r*4 + 2];
+			for (int c = 0; c < 4; ++c) {
+				const float* pa0 = a.e[c];
+				const float* pa1 = a.e[4 + c];
+				const float* pa2 = a.e[8 + c];
+				float* pr = e[r*4 + c];
+				for (int k = 0; k < XD_MOTWK_SOA_LANES; ++k) {
+					pr[k] = pa0[k]*pb0[k] + pa1[k]*pb1[k] + pa2[k]*pb2[k];
+				}
+			}
+			const float* pb3 = b.e[r*4 + 3];
+			float* pr = e[r*4 + 3];
+			for (int k = 0; k < XD_MOTWK_SOA_LANES; ++k) {
+				pr[k] += pb3[k];
+			}
+		}
+	}
+};
+
+void cxMotionWork::init_levels() {
+	mLvlNum = 0;
+	if (!mpMdlData || !mpLvlNodes || !mpLvlStarts) return;
 	int nskel = mpMdlData->mSklNum;
 	const int32_t* pParents = mpMdlData->get_skel_parents_ptr();
+	if (!pParents) return;
+	int16_t* pDepth = (int16_t*)nxCore::mem_alloc(nskel * sizeof(int16_t), "xMotWk:tmp");
+	if (!pDepth) return;
+	int maxDepth = 0;
+	bool sorted = true;
 	for (int i = 0; i < nskel; ++i) {
 		int iparent = pParents[i];
+		int depth = 0;
 		if (iparent >= 0 && iparent < nskel) {
-			mpXformsW[i] = nxMtx::xmtx_concat(mpXformsL[i], mpXformsW[iparent]);
+			if (iparent >= i) {
+				sorted = false;
+				break;
+			}
+			depth = pDepth[iparent] + 1;
+		}
+		pDepth[i] = int16_t(depth);
+		maxDepth = nxCalc::max(maxDepth, depth);
+	}
+	if (sorted && nskel < 0x7FFF) {
+		int nlvl = maxDepth + 1;
+		for (int i = 0; i <= nlvl; ++i) {
+			mpLvlStarts[i] = 0;
+		}
+		for (int i = 0; i < nskel; ++i) {
+			++mpLvlStarts[pDepth[i] + 1];
+		}
+		for (int i = 0; i < nlvl; ++i) {
+			mpLvlStarts[i + 1] += mpLvlStarts[i];
+		}
+		for (int i = 0; i < nskel; ++i) {
+			int idx = mpLvlStarts[pDepth[i]]++;
+			mpLvlNodes[idx] = int16_t(i);
+		}
+		for (int i = nlvl; i > 0; --i) {
+			mpLvlStarts[i] = mpLvlStarts[i - 1];
+		}
+		mpLvlStarts[0] = 0;
+		mLvlNum = nlvl;
+	}
+	nxCore::mem_free(pDepth);
+
+	if (mpSkelToSkin) {
+		for (int i = 0; i < nskel; ++i) {
+			mpSkelToSkin[i] = -1;
+		}
+		const int32_t* pSkinToSkelMap = mpMdlData->get_skin_to_skel_map();
+		if (pSkinToSkelMap) {
+			int nskin = mpMdlData->mSknNum;
+			for (int i = 0; i < nskin; ++i) {
+				int iskel = pSkinToSkelMap[i];
+				if (iskel < 0 || iskel >= nskel || mpSkelToSkin[iskel] >= 0) {
+					/* not one-to-one: skin xforms are computed separately */
+					mpSkelToSkin = nullptr;
+					break;
+				}
+				mpSkelToSkin[iskel] = int16_t(i);
+			}
 		} else {
-			mpXformsW[i] = mpXformsL[i];
-			if (mUniformScale != 1.0f) {
-				cxMtx sm;
-				sm.mk_scl(mUniformScale);
-				mpXformsW[i] = nxMtx::xmtx_from_mtx(sm * nxMtx::mtx_from_xmtx(mpXformsW[i]));
+			mpSkelToSkin = nullptr;
+		}
+	}
+}
+
+void cxMotionWork::calc_root_node_world(const int inode) {
+	mpXformsW[inode] = mpXformsL[inode];
+	if (mUniformScale != 1.0f) {
+		cxMtx sm;
+		sm.mk_scl(mUniformScale);
+		mpXformsW[inode] = nxMtx::xmtx_from_mtx(sm * nxMtx::mtx_from_xmtx(mpXformsW[inode]));
+	}
+}
+
+void cxMotionWork::calc_world(xt_xmtx* pSkinXforms) {
+	if (!mpMdlData) return;
+	int nskel = mpMdlData->mSklNum;
+	const int32_t* pParents = mpMdlData->get_skel_parents_ptr();
+	const xt_xmtx* pInvW = mpMdlData->get_skel_xforms_ptr();
+	if (pInvW) {
+		pInvW += nskel;
+	}
+	const int16_t* pSkinMap = pSkinXforms && pInvW ? mpSkelToSkin : nullptr;
+	if (mLvlNum < 1) {
+		for (int i = 0; i < nskel; ++i) {
+			int iparent = pParents[i];
+			if (iparent >= 0 && iparent < nskel) {
+				mpXformsW[i] = nxMtx::xmtx_concat(mpXformsL[i], mpXformsW[iparent]);
+			} else {
+				calc_root_node_world(i);
+			}
+			if (pSkinMap && pSkinMap[i] >= 0) {
+				pSkinXforms[pSkinMap[i]] = nxMtx::xmtx_concat(pInvW[i], mpXformsW[i]);
+			}
+		}
+	} else {
+		for (int i = mpLvlStarts[0]; i < mpLvlStarts[1]; ++i) {
+			int inode = mpLvlNodes[i];
+			calc_root_node_world(inode);
+			if (pSkinMap && pSkinMap[inode] >= 0) {
+				pSkinXforms[pSkinMap[inode]] = nxMtx::xmtx_concat(pInvW[inode], mpXformsW[inode]);
+			}
+		}
+		XMTXSoA lm;
+		XMTXSoA pm;
+		XMTXSoA wm;
+		XMTXSoA im;
+		XMTXSoA sm;
+		const int nlanes = XD_MOTWK_SOA_LANES;
+		for (int ilvl = 1; ilvl < mLvlNum; ++ilvl) {
+			int iend = mpLvlStarts[ilvl + 1];
+			for (int i = mpLvlStarts[ilvl]; i < iend; i += nlanes) {
+				int n = nxCalc::min(nlanes, iend - i);
+				const int16_t* pNodes = &mpLvlNodes[i];
+				for (int j = 0; j < nlanes; ++j) {
+					int inode = pNodes[j < n ? j : 0];
+					lm.load(j, mpXformsL[inode]);
+					pm.load(j, mpXformsW[pParents[inode]]);
+				}
+				wm.concat(lm, pm);
+				for (int j = 0; j < n; ++j) {
+					wm.store(j, &mpXformsW[pNodes[j]]);
+				}
+				if (pSkinMap) {
+					for (int j = 0; j < nlanes; ++j) {
+						im.load(j, pInvW[pNodes[j < n ? j : 0]]);
+					}
+					sm.concat(im, wm);
+					for (int j = 0; j < n; ++j) {
+						int iskin = pSkinMap[pNodes[j]];
+						if (iskin >= 0) {
+							sm.store(j, &pSkinXforms[iskin]);
+						}
+					}
+				}
+			}
+		}
+	}
+	if (pSkinXforms && !pSkinMap && pInvW) {
+		const int32_t* pSkinToSkelMap = mpMdlData->get_skin_to_skel_map();
+		if (pSkinToSkelMap) {
+			int nskin = mpMdlData->mSknNum;
+			for (int i = 0; i < nskin; ++i) {
+				int iskel = pSkinToSkelMap[i];
+				pSkinXforms[i] = nxMtx::xmtx_concat(pInvW[iskel], mpXformsW[iskel]);
 			}
 		}
 	}
 }
 
+/* on LOD off-frames the held pose moves rigidly with the root: the world and skin xforms of the last frame are
+   carried by the root delta instead of being recomputed from the local pose */
+bool cxMotionWork::calc_world_hold(xt_xmtx* pSkinXforms) {
+	if (!mLODHold || !mpMdlData || mLvlNum < 1 || mRootId < 0) return false;
+	if (mpLvlStarts[1] - mpLvlStarts[0] != 1 || mpLvlNodes[mpLvlStarts[0]] != mRootId) return false;
+	xt_xmtx rootW = mpXformsW[mRootId];
+	calc_root_node_world(mRootId);
+	if (nxCore::mem_eq(&rootW, &mpXformsW[mRootId], sizeof(xt_xmtx))) return true;
+	cxMtx dm = nxMtx::mtx_from_xmtx(rootW).get_inverted();
+	dm.mul(nxMtx::mtx_from_xmtx(mpXformsW[mRootId]));
+	xt_xmtx delta = nxMtx::xmtx_from_mtx(dm);
+	int nskel = mpMdlData->mSklNum;
+	for (int i = 0; i < nskel; ++i) {
+		if (i != mRootId) {
+			mpXformsW[i] = nxMtx::xmtx_concat(mpXformsW[i], delta);
+		}
+	}
+	if (pSkinXforms) {
+		int nskin = mpMdlData->mSknNum;
+		for (int i = 0; i < nskin; ++i) {
+			pSkinXforms[i] = nxMtx::xmtx_concat(pSkinXforms[i], delta);
+		}
+	}
+	return true;
+}
+
 void cxMotionWork::calc_root_world() {
 	if (mRootId >= 0) {
-		mpXformsW[mRootId] = mpXformsL[mRootId];
-		if (mUniformScale != 1.0f) {
-			cxMtx sm;
-			sm.mk_scl(mUniformScale);
-			mpXformsW[mRootId] = nxMtx::xmtx_from_mtx(sm * nxMtx::mtx_from_xmtx(mpXformsW[mRootId]));
-		}
+		calc_root_node_world(mRootId);
 	}
 }
 
@@ -14810,6 +18008,7 @@ void cxMotionWork::blend_init(const int duration) {
 	}
 	mBlendDuration = float(duration);
 	mBlendCount = mBlendDuration;
+	mLODHold = false;
 }
 
 void cxMotionWork::blend_exec() {
@@ -14819,6 +18018,10 @@ void cxMotionWork::blend_exec() {
 		int nskel = mpMdlData->mSklNum;
 		for (int i = 0; i < nskel; ++i) {
 			bool blendFlg = !XD_BIT_ARY_CK(uint32_t, mpBlendDisableBits, i);
+			if (blendFlg && mpLODSkipBits) {
+				/* LOD-masked nodes are not evaluated, so there is nothing to blend towards */
+				blendFlg = !XD_BIT_ARY_CK(uint32_t, mpLODSkipBits, i);
+			}
 			if (blendFlg) {
 				cxMtx msrc = nxMtx::mtx_from_xmtx(mpBlendXformsL[i]);
 				cxVec tsrc = msrc.get_translation();
@@ -14862,6 +18065,13 @@ cxMotionWork* cxMotionWork::create(sxModelData* pMdlData) {
 		size += nskel * sizeof(xt_xmtx);
 		size_t blendBitsOffs = size;
 		size += XD_BIT_ARY_SIZE(uint8_t, nskel);
+		size = XD_ALIGN(size, 4);
+		size_t lvlNodesOffs = size;
+		size += nskel * sizeof(int16_t);
+		size_t skelToSkinOffs = size;
+		size += nskel * sizeof(int16_t);
+		size_t lvlStartsOffs = size;
+		size += (nskel + 1) * sizeof(uint16_t);
 		pWk = (cxMotionWork*)nxCore::mem_alloc(size, "xMotWk");
 		if (pWk) {
 			nxCore::mem_zero((void*)pWk, size);
@@ -14872,6 +18082,10 @@ cxMotionWork* cxMotionWork::create(sxModelData* pMdlData) {
 			pWk->mpPrevXformsW = (xt_xmtx*)XD_INCR_PTR(pWk, xformOffsPrevW);
 			pWk->mpBlendXformsL = (xt_xmtx*)XD_INCR_PTR(pWk, xformOffsBlendL);
 			pWk->mpBlendDisableBits = (uint8_t*)XD_INCR_PTR(pWk, blendBitsOffs);
+			pWk->mpLvlNodes = (int16_t*)XD_INCR_PTR(pWk, lvlNodesOffs);
+			pWk->mpSkelToSkin = (int16_t*)XD_INCR_PTR(pWk, skelToSkinOffs);
+			pWk->mpLvlStarts = (uint16_t*)XD_INCR_PTR(pWk, lvlStartsOffs);
+			pWk->init_levels();
 			for (int i = 0; i < nskel; ++i) {
 				pWk->mpXformsL[i] = pMdlData->get_skel_local_xform(i);
 			}
@@ -14958,44 +18172,125 @@ bool cxModelWork::is_bat_mtl_hidden(const int ibat) const {
 	return hidden;
 }
 
-void cxModelWork::update_bounds() {
+void cxModelWork::update_skin_bounds(const cxMotionWork* pMot) {
 	if (!mpData) return;
-	if (mpData->has_skin()) {
-		if (mpSkinXforms) {
-			const cxSphere* pSph = mpData->get_mdl_spheres();
-			int nskin = mpData->mSknNum;
-			for (int i = 0; i < nskin; ++i) {
-				cxSphere sph = pSph[i];
-				cxVec spos = nxMtx::xmtx_calc_pnt(mpSkinXforms[i], sph.get_center());
-				cxVec rvec(sph.get_radius());
-				cxAABB sbb(spos - rvec, spos + rvec);
-				if (i == 0) {
-					mWorldBBox = sbb;
-				} else {
-					mWorldBBox.merge(sbb);
-				}
+	if (!mpSkinXforms || !mpSkinSpheres) return;
+	const cxSphere* pSph = mpData->get_mdl_spheres();
+	if (!pSph) return;
+	int nskin = mpData->mSknNum;
+	const int32_t* pSkinToSkelMap = nullptr;
+	const xt_xmtx* pInvW = nullptr;
+	if (pMot && pMot->mpXformsW) {
+		pSkinToSkelMap = mpData->get_skin_to_skel_map();
+		pInvW = mpData->get_skel_xforms_ptr();
+		if (pInvW) {
+			pInvW += mpData->mSklNum;
+		}
+	}
+	const bool calcSkin = pSkinToSkelMap && pInvW;
+	const int nlanes = XD_MOTWK_SOA_LANES;
+	XMTXSoA im;
+	XMTXSoA wm;
+	XMTXSoA sm;
+	float cx[XD_MOTWK_SOA_LANES];
+	float cy[XD_MOTWK_SOA_LANES];
+	float cz[XD_MOTWK_SOA_LANES];
+	float cr[XD_MOTWK_SOA_LANES];
+	float wx[XD_MOTWK_SOA_LANES];
+	float wy[XD_MOTWK_SOA_LANES];
+	float wz[XD_MOTWK_SOA_LANES];
+	float minx[XD_MOTWK_SOA_LANES];
+	float miny[XD_MOTWK_SOA_LANES];
+	float minz[XD_MOTWK_SOA_LANES];
+	float maxx[XD_MOTWK_SOA_LANES];
+	float maxy[XD_MOTWK_SOA_LANES];
+	float maxz[XD_MOTWK_SOA_LANES];
+	for (int k = 0; k < nlanes; ++k) {
+		minx[k] = FLT_MAX;
+		miny[k] = FLT_MAX;
+		minz[k] = FLT_MAX;
+		maxx[k] = -FLT_MAX;
+		maxy[k] = -FLT_MAX;
+		maxz[k] = -FLT_MAX;
+	}
+	for (int i = 0; i < nskin; i += nlanes) {
+		int n = nxCalc::min(nlanes, nskin - i);
+		if (calcSkin) {
+			for (int j = 0; j < nlanes; ++j) {
+				int iskel = pSkinToSkelMap[i + (j < n ? j : 0)];
+				im.load(j, pInvW[iskel]);
+				wm.load(j, pMot->mpXformsW[iskel]);
+			}
+			sm.concat(im, wm);
+			for (int j = 0; j < n; ++j) {
+				sm.store(j, &mpSkinXforms[i + j]);
 			}
-			if (mpBatBBoxes) {
-				int nbat = mpData->mBatNum;
-				for (int i = 0; i < nbat; ++i) {
-					const int32_t* pLst = mpData->get_batch_jnt_list(i);
-					int njnt = mpData->get_batch_jnt_num(i);
-					pSph = mpData->get_batch_spheres(i);
-					for (int j = 0; j < njnt; ++j) {
-						cxSphere sph = pSph[j];
-						cxVec spos = nxMtx::xmtx_calc_pnt(mpSkinXforms[pLst[j]], sph.get_center());
-						cxVec rvec(sph.get_radius());
-						cxAABB sbb(spos - rvec, spos + rvec);
-						if (j == 0) {
-							mpBatBBoxes[i] = sbb;
-						} else {
-							mpBatBBoxes[i].merge(sbb);
-						}
-					}
-				}
+		} else {
+			for (int j = 0; j < nlanes; ++j) {
+				sm.load(j, mpSkinXforms[i + (j < n ? j : 0)]);
+			}
+		}
+		for (int j = 0; j < nlanes; ++j) {
+			const cxSphere& sph = pSph[i + (j < n ? j : 0)];
+			cxVec c = sph.get_center();
+			cx[j] = c.x;
+			cy[j] = c.y;
+			cz[j] = c.z;
+			cr[j] = sph.get_radius();
+		}
+		for (int k = 0; k < nlanes; ++k) {
+			wx[k] = cx[k]*sm.e[0][k] + cy[k]*sm.e[1][k] + cz[k]*sm.e[2][k] + sm.e[3][k];
+			wy[k] = cx[k]*sm.e[4][k] + cy[k]*sm.e[5][k] + cz[k]*sm.e[6][k] + sm.e[7][k];
+			wz[k] = cx[k]*sm.e[8][k] + cy[k]*sm.e[9][k] + cz[k]*sm.e[10][k] + sm.e[11][k];
+		}
+		for (int k = 0; k < nlanes; ++k) {
+			minx[k] = nxCalc::min(minx[k], wx[k] - cr[k]);
+			miny[k] = nxCalc::min(miny[k], wy[k] - cr[k]);
+			minz[k] = nxCalc::min(minz[k], wz[k] - cr[k]);
+			maxx[k] = nxCalc::max(maxx[k], wx[k] + cr[k]);
+			maxy[k] = nxCalc::max(maxy[k], wy[k] + cr[k]);
+			maxz[k] = nxCalc::max(maxz[k], wz[k] + cr[k]);
+		}
+		for (int j = 0; j < n; ++j) {
+			mpSkinSpheres[i + j].set(wx[j], wy[j], wz[j], cr[j]);
+		}
+	}
+	if (nskin > 0) {
+		cxVec bbmin(minx[0], miny[0], minz[0]);
+		cxVec bbmax(maxx[0], maxy[0], maxz[0]);
+		for (int k = 1; k < nlanes; ++k) {
+			bbmin = nxVec::min(bbmin, cxVec(minx[k], miny[k], minz[k]));
+			bbmax = nxVec::max(bbmax, cxVec(maxx[k], maxy[k], maxz[k]));
+		}
+		mWorldBBox.set(bbmin, bbmax);
+	}
+	if (mpBatBBoxes) {
+		/* batch boxes are merged from the model-level joint spheres, which enclose the per-batch ones */
+		int nbat = mpData->mBatNum;
+		for (int i = 0; i < nbat; ++i) {
+			const int32_t* pLst = mpData->get_batch_jnt_list(i);
+			int njnt = mpData->get_batch_jnt_num(i);
+			if (!pLst || njnt < 1) continue;
+			const xt_float4* pWSph = &mpSkinSpheres[pLst[0]];
+			cxVec rvec(pWSph->w);
+			cxVec bbmin = cxVec(pWSph->x, pWSph->y, pWSph->z) - rvec;
+			cxVec bbmax = cxVec(pWSph->x, pWSph->y, pWSph->z) + rvec;
+			for (int j = 1; j < njnt; ++j) {
+				pWSph = &mpSkinSpheres[pLst[j]];
+				rvec.fill(pWSph->w);
+				bbmin = nxVec::min(bbmin, cxVec(pWSph->x, pWSph->y, pWSph->z) - rvec);
+				bbmax = nxVec::max(bbmax, cxVec(pWSph->x, pWSph->y, pWSph->z) + rvec);
 			}
-			mBoundsValid = true;
+			mpBatBBoxes[i].set(bbmin, bbmax);
 		}
+	}
+	mBoundsValid = true;
+}
+
+void cxModelWork::update_bounds() {
+	if (!mpData) return;
+	if (mpData->has_skin()) {
+		update_skin_bounds();
 	} else if (mpWorldXform) {
 		if (mpData) {
 			mWorldBBox = mpData->mBBox;
@@ -15022,18 +18317,13 @@ void cxModelWork::frustum_cull(const cxFrustum* pFst, const bool precise) {
 	nxCore::mem_zero(mpCullBits, XD_BIT_ARY_SIZE(uint8_t, nbat));
 	if (!pFst) return;
 	if (!mBoundsValid) return;
-	for (int i = 0; i < nbat; ++i) {
-		cxAABB batBB = mpBatBBoxes[i];
-		bool cull = pFst->cull(batBB);
-		if (precise) {
-			if (!cull) {
-				bool vis = pFst->overlaps(batBB);
-				cull = !vis;
+	int ncull = pFst->cull(mpBatBBoxes, nbat, mpCullBits);
+	if (precise && ncull < nbat) {
+		for (int i = 0; i < nbat; ++i) {
+			if (!XD_BIT_ARY_CK(uint32_t, mpCullBits, i) && !pFst->overlaps(mpBatBBoxes[i])) {
+				XD_BIT_ARY_ST(uint32_t, mpCullBits, i);
 			}
 		}
-		if (cull) {
-			XD_BIT_ARY_ST(uint32_t, mpCullBits, i);
-		}
 	}
 }
 
@@ -15077,10 +18367,13 @@ cxModelWork* cxModelWork::create(sxModelData* pMdl, const size_t paramMemSize, c
 	size_t size = XD_ALIGN(sizeof(cxModelWork), 0x10);
 	size_t offsWM = 0;
 	size_t offsJM = 0;
+	size_t offsSph = 0;
 	int nskin = pMdl->mSknNum;
 	if (nskin > 0) {
 		offsJM = size;
 		size += nskin * sizeof(xt_xmtx);
+		offsSph = size;
+		size += nskin * sizeof(xt_float4);
 	} else {
 		if (!pMdl->is_static()) {
 			offsWM = size;
@@ -15120,6 +18413,7 @@ cxModelWork* cxModelWork::create(sxModelData* pMdl, const size_t paramMemSize, c
 				pWk->mpSkinXforms[i].identity();
 			}
 		}
+		pWk->mpSkinSpheres = offsSph ? (xt_float4*)XD_INCR_PTR(pWk, offsSph) : nullptr;
 		pWk->mWorldBBox = pMdl->mBBox;
 		pWk->copy_prev_world_bbox();
 		if (offsBatBBs) {
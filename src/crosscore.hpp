@@ -2487,6 +2487,7 @@ cxVec decode_octa(const xt_float2& oct);
 cxVec decode_octa(const xt_half2& oct);
 cxVec decode_octa(const int16_t oct[2]);
 cxVec decode_octa(const uint16_t oct[2]);
+void encode_octa(const cxVec& v, uint16_t oct[2]);
 
 cxVec rot_sc_x(const cxVec& v, const float s, const float c);
 cxVec rot_sc_y(const cxVec& v, const float s, const float c);
@@ -3166,6 +3167,7 @@ bool seg_tri_intersect_cw_n(const cxVec& p0, const cxVec& p1, const cxVec& v0, c
 bool seg_tri_intersect_cw(const cxVec& p0, const cxVec& p1, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pHitPos = nullptr, cxVec* pHitNrm = nullptr);
 bool seg_tri_intersect_ccw_n(const cxVec& p0, const cxVec& p1, const cxVec& v0, const cxVec& v1, const cxVec& v2, const cxVec& nrm, cxVec* pHitPos = nullptr);
 bool seg_tri_intersect_ccw(const cxVec& p0, const cxVec& p1, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pHitPos = nullptr, cxVec* pHitNrm = nullptr);
+uint32_t segs_tri_intersect_cw(const cxVec* pP0, const cxVec* pP1, const int nsegs, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pHitPos, cxVec* pHitNrm = nullptr);
 xt_float4 seg_tri_intersect_bc_cw(const cxVec& p0, const cxVec& p1, const cxVec& v0, const cxVec& v1, const cxVec& v2);
 xt_float4 seg_tri_intersect_bc_ccw(const cxVec& p0, const cxVec& p1, const cxVec& v0, const cxVec& v1, const cxVec& v2);
 cxVec barycentric(const cxVec& pos, const cxVec& v0, const cxVec& v1, const cxVec& v2);
@@ -3207,6 +3209,12 @@ inline cxVec seg_pnt_closest(const cxVec& sp0, const cxVec& sp1, const cxVec& pn
 cxVec tri_pnt_closest(const cxVec& v0, const cxVec& v1, const cxVec& v2, const cxVec& pnt);
 
 float seg_seg_dist2(const cxVec& s0p0, const cxVec& s0p1, const cxVec& s1p0, const cxVec& s1p1, cxVec* pBridgeP0 = nullptr, cxVec* pBridgeP1 = nullptr);
+float seg_tri_dist2(const cxVec& sp0, const cxVec& sp1, const cxVec& v0, const cxVec& v1, const cxVec& v2, cxVec* pSegPnt = nullptr, cxVec* pTriPnt = nullptr);
+bool cap_tri_sweep(const cxVec& cp0, const cxVec& cp1, const float cr, const cxVec& mov, const cxVec& v0, const cxVec& v1, const cxVec& v2, float* pT = nullptr, cxVec* pNrm = nullptr, cxVec* pPos = nullptr, float* pDist = nullptr);
+
+inline bool sph_tri_sweep(const cxVec& p0, const cxVec& p1, const float r, const cxVec& v0, const cxVec& v1, const cxVec& v2, float* pT = nullptr, cxVec* pNrm = nullptr, cxVec* pPos = nullptr, float* pDist = nullptr) {
+	return cap_tri_sweep(p0, p0, r, p1 - p0, v0, v1, v2, pT, pNrm, pPos, pDist);
+}
 
 inline bool pnt_in_tri(const cxVec& pos, const cxVec& v0, const cxVec& v1, const cxVec& v2) {
 	cxVec a = v0 - pos;
@@ -3296,7 +3304,14 @@ float sph_convex_dist(
 	const int xformMode = 0, const bool cw = false
 );
 
-void build_aabb_tree(const cxAABB* pSrcBoxes, const int32_t nsrc, cxAABB* pNodeBoxes, int32_t* pNodeInfos, int32_t* pIdxWk);
+void build_aabb_tree(const cxAABB* pSrcBoxes, const int32_t nsrc, cxAABB* pNodeBoxes, int32_t* pNodeInfos, int32_t* pIdxWk, const bool sah = false, cxBrigade* pBgd = nullptr);
+float aabb_tree_sah_cost(const cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const int32_t nnodes, const float travCost = 1.0f, const float isectCost = 1.0f);
+void refit_aabb_tree(const cxAABB* pSrcBoxes, cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const int32_t nnodes, cxBrigade* pBgd = nullptr);
+
+/* planes (a, b, c, d): a*x + b*y + c*z + d >= 0 inside; bit i is set for boxes entirely outside a plane, returns the number of culled boxes */
+int cull_aabb_batch(const xt_float4* pPlanes, const int nplanes, const float* pCX, const float* pCY, const float* pCZ, const float* pEX, const float* pEY, const float* pEZ, const int n, uint32_t* pBits);
+int cull_aabbs(const xt_float4* pPlanes, const int nplanes, const cxAABB* pBoxes, const int n, uint32_t* pBits);
+void clip_xy_planes(const cxMtx& mtx, xt_float4* pPlanes, const float k = 1.0f);
 
 } // nxGeom
 
@@ -3514,11 +3529,85 @@ public:
 	bool cull(const cxAABB& box) const;
 	bool overlaps(const cxAABB& box) const;
 
+	void get_cull_planes(xt_float4* pPlanes) const;
+	int cull(const cxAABB* pBoxes, const int nboxes, uint32_t* pBits) const;
+
 	void dump_geo(FILE* pOut) const;
 	void dump_geo(const char* pOutPath) const;
 };
 
 
+struct sxCollisionData;
+
+/* low-res 1/w buffer (0: nothing), occluders are written with the farthest value within each covered pixel */
+class cxOcclusionBuffer {
+public:
+	struct Stats {
+		int32_t tris;
+		int32_t tested;
+		int32_t occluded;
+	};
+
+protected:
+	struct Tri {
+		float ea[3];
+		float eb[3];
+		float ec[3];
+		float zx;
+		float zy;
+		float zc;
+		int16_t xmin;
+		int16_t ymin;
+		int16_t xmax;
+		int16_t ymax;
+	};
+
+	cxMtx mViewProj;
+	float* mpDepth;
+	Tri* mpTris;
+	sxJob* mpJobs;
+	int mW;
+	int mH;
+	int mTileW;
+	int mTileH;
+	int mTilesX;
+	int mTilesY;
+	int mTrisMax;
+	int mTrisNum;
+	float mNear;
+	Stats mStats;
+
+	cxOcclusionBuffer() {}
+
+	void add_clipped_tri(const xt_float4& v0, const xt_float4& v1, const xt_float4& v2);
+	void raster_tile(const int itile);
+
+	static void raster_job(const sxJobContext* pCtx);
+
+public:
+	int get_width() const { return mW; }
+	int get_height() const { return mH; }
+	int get_tiles_num() const { return mTilesX * mTilesY; }
+	int get_tris_num() const { return mTrisNum; }
+	int get_tris_max() const { return mTrisMax; }
+	const float* get_depth() const { return mpDepth; }
+	float get_depth(const int x, const int y) const { return (uint32_t(x) < uint32_t(mW) && uint32_t(y) < uint32_t(mH)) ? mpDepth[y*mW + x] : 0.0f; }
+	Stats get_stats() const { return mStats; }
+
+	void begin(const cxMtx& viewProj, const float znear);
+	bool add_tri(const cxVec& v0, const cxVec& v1, const cxVec& v2);
+	int add_tris(const cxVec* pPnts, const int32_t* pIdx, const int ntris, const cxMtx* pXform = nullptr);
+	int add_collision(const sxCollisionData& col, const cxMtx* pXform = nullptr);
+	void rasterize(cxBrigade* pBgd = nullptr);
+
+	bool occluded(const cxAABB& box);
+	int cull(const cxAABB* pBoxes, const int nboxes, uint32_t* pBits);
+
+	static cxOcclusionBuffer* create(const int w, const int h, const int maxTris);
+	static void destroy(cxOcclusionBuffer* pBuf);
+};
+
+
 class cxColor : public xt_rgba {
 public:
 	cxColor() {}
@@ -4192,6 +4281,70 @@ struct sxRigData : public sxData {
 	static const uint32_t KIND;
 };
 
+#ifndef XD_QBVH_MAX_DEPTH
+#	define XD_QBVH_MAX_DEPTH 64
+#endif
+
+/* depth-first BVH with skip links, node boxes quantized relative to the parent box */
+struct sxQBVH {
+	cxAABB mBBox;
+	uint32_t mNodesNum;
+	uint8_t mBits;
+	uint8_t mMaxDepth;
+	uint16_t mReserved;
+
+	struct Node8 {
+		uint8_t mMin[3];
+		uint8_t mMax[3];
+		uint8_t mDepth;
+		uint8_t mLeaf;
+		int32_t mIdx; /* leaf: primitive id, node: skip index */
+
+		static const int QMAX = 0xFF;
+	};
+
+	struct Node16 {
+		uint16_t mMin[3];
+		uint16_t mMax[3];
+		uint8_t mDepth;
+		uint8_t mLeaf;
+		uint16_t mReserved;
+		int32_t mIdx;
+
+		static const int QMAX = 0xFFFF;
+	};
+
+	const void* get_nodes_top() const { return this + 1; }
+	size_t get_size() const { return calc_size(mNodesNum, mBits); }
+	void get_tree(int32_t* pNodeInfos) const;
+
+	static size_t calc_size(const int nnodes, const int bits);
+	static bool build(sxQBVH* pQBVH, const int bits, const cxAABB* pNodeBoxes, const int32_t* pNodeInfos, const int nnodes);
+};
+
+/* 4/8-way BVH collapsed from the binary tree, child boxes stored per axis to be tested together; kept in the data ext list */
+struct sxWideBVH {
+	uint32_t mNodesNum;
+	uint32_t mWidth;
+	uint32_t mReserved0;
+	uint32_t mReserved1;
+
+	template<int N> struct Node {
+		float mMin[3][N];
+		float mMax[3][N];
+		int32_t mChild[N]; /* >= 0: node, < 0: ~primitive id; unused lanes have empty boxes */
+	};
+
+	const void* get_nodes_top() const { return this + 1; }
+	size_t get_size() const { return calc_size(mNodesNum, mWidth); }
+
+	static size_t calc_size(const int nnodes, const int width);
+	/* returns the number of wide nodes, pWBVH == nullptr only counts them */
+	static int build(sxWideBVH* pWBVH, const int width, const cxAABB* pNodeBoxes, const int32_t* pNodeInfos);
+
+	static const uint32_t KIND;
+};
+
 struct sxGeometryData : public sxData {
 	cxAABB mBBox;
 	uint32_t mPntNum;
@@ -4348,7 +4501,7 @@ struct sxGeometryData : public sxData {
 		};
 
 		uint32_t mNodesNum;
-		uint32_t mReserved0;
+		uint32_t mQBVHOffs; /* from BVH top */
 		uint32_t mReserved1;
 		uint32_t mReserved2;
 	};
@@ -4505,6 +4658,12 @@ struct sxGeometryData : public sxData {
 	int find_max_leaf_level() const;
 	BVH* get_BVH() const { return has_BVH() ? reinterpret_cast<BVH*>(XD_INCR_PTR(this, mBVHOffs)) : nullptr; }
 	BVH::Node* get_BVH_node(int nodeId) const { return ck_BVH_node_idx(nodeId) ? &reinterpret_cast<BVH::Node*>(get_BVH() + 1)[nodeId] : nullptr; }
+	const sxQBVH* get_QBVH() const { BVH* pBVH = get_BVH(); return pBVH && pBVH->mQBVHOffs ? reinterpret_cast<const sxQBVH*>(XD_INCR_PTR(pBVH, pBVH->mQBVHOffs)) : nullptr; }
+	sxGeometryData* make_QBVH(const int bits = 16) const;
+	const sxWideBVH* get_wide_BVH() const { uint32_t offs = find_ext_offs(sxWideBVH::KIND); return offs ? reinterpret_cast<const sxWideBVH*>(XD_INCR_PTR(this, offs)) : nullptr; }
+	sxGeometryData* make_wide_BVH(const int width = 4) const;
+	float calc_BVH_cost() const;
+	bool refit_BVH(const cxVec* pPnts = nullptr, const float rebuildCost = 0.0f, cxBrigade* pBgd = nullptr);
 	cxAABB calc_world_bbox(cxMtx* pMtxW, int* pIdxMap = nullptr) const;
 	void calc_tangents(cxVec* pTng, bool flip = false, const char* pAttrName = nullptr) const;
 	cxVec* calc_tangents(bool flip = false, const char* pAttrName = nullptr) const;
@@ -5333,6 +5492,7 @@ struct sxMotionData : public sxData {
 		uint16_t mData[1];
 
 		int get_mask() const { return mAttr & 7; }
+		bool is_reduced() const { return (mAttr & (1 << 4)) != 0; }
 
 		int get_stride() const {
 			int s = 0;
@@ -5355,6 +5515,10 @@ struct sxMotionData : public sxData {
 	cxQuat eval_quat(const int inode, const float frm) const;
 	cxVec eval_pos(const int inode, const float frm) const;
 
+	size_t get_track_size(const Track* pTrk) const;
+	size_t get_tracks_size() const;
+	sxMotionData* reduce(const float tolQ = 1.0e-4f, const float tolT = 1.0e-4f) const;
+
 	void dump_clip(FILE* pOut, const float fstep = 1.0f) const;
 	void dump_clip(const char* pOutPath, const float fstep = 1.0f) const;
 
@@ -5368,7 +5532,7 @@ struct sxCollisionData : public sxData {
 	uint32_t mGrpNum;
 	uint32_t mTriNum;
 	uint32_t mMaxVtxPerPol;
-	uint32_t mReserved;
+	uint32_t mQBVHOffs;
 	uint32_t mPntOffs;
 	uint32_t mPolIdxOrgOffs;
 	uint32_t mPolVtxNumOffs;
@@ -5409,6 +5573,16 @@ struct sxCollisionData : public sxData {
 		int count;
 	};
 
+	struct SweepHit {
+		cxVec pos;
+		cxVec nrm;
+		float t;
+		float dist;
+		int ipol;
+		int itri;
+		int count;
+	};
+
 	typedef bool (*TriFunc)(const sxCollisionData& col, const Tri& tri, void* pWk);
 	typedef bool (*HitFunc)(const sxCollisionData& col, const Tri& tri, const cxVec& pos, const float dist, void* pWk);
 
@@ -5437,6 +5611,22 @@ struct sxCollisionData : public sxData {
 
 	int hit_check(const HitFunc func, const cxLineSeg& seg, void* pWk);
 	NearestHit nearest_hit(const cxLineSeg& seg);
+	int hit_check_batch(const cxLineSeg* pSegs, NearestHit* pHits, const int nsegs);
+
+	SweepHit sweep_sph(const cxVec& p0, const cxVec& p1, const float radius, const TriFunc filter = nullptr, void* pFilterWk = nullptr) const;
+	SweepHit sweep_cap(const cxVec& cp0, const cxVec& cp1, const float radius, const cxVec& mov, const TriFunc filter = nullptr, void* pFilterWk = nullptr) const;
+	int slide_sph(const cxVec& p0, const cxVec& p1, const float radius, cxVec* pAdjPos, const int maxSweeps = 3, const float margin = 0.005f, const TriFunc filter = nullptr, void* pFilterWk = nullptr) const;
+	int slide_cap(const cxVec& cp0, const cxVec& cp1, const float radius, const cxVec& mov, cxVec* pAdjMov, const int maxSweeps = 3, const float margin = 0.005f, const TriFunc filter = nullptr, void* pFilterWk = nullptr) const;
+
+	const sxQBVH* get_QBVH() const { return mQBVHOffs ? reinterpret_cast<const sxQBVH*>(XD_INCR_PTR(this, mQBVHOffs)) : nullptr; }
+	sxCollisionData* make_QBVH(const int bits = 16) const;
+	const sxWideBVH* get_wide_BVH() const { uint32_t offs = find_ext_offs(sxWideBVH::KIND); return offs ? reinterpret_cast<const sxWideBVH*>(XD_INCR_PTR(this, offs)) : nullptr; }
+	sxCollisionData* make_wide_BVH(const int width = 4) const;
+	float calc_BVH_cost() const;
+	/* moves the points (if given) and refits the trees, rebuilds when the cost exceeds rebuildCost > 0;
+	   returns true if rebuilt, calc_BVH_cost() then gives the new baseline;
+	   returns false if a rebuilt wide BVH didn't fit its block and was only refitted */
+	bool refit_BVH(const cxVec* pPnts = nullptr, const float rebuildCost = 0.0f, cxBrigade* pBgd = nullptr);
 
 	void dump_pol_geo(FILE* pOut) const;
 	void dump_pol_geo(const char* pOutPath) const;
@@ -6357,6 +6547,9 @@ namespace nxData {
 
 sxData* load(const char* pPath);
 void unload(sxData* pData);
+sxData* add_ext(const sxData* pData, const uint32_t kind, const void* pExt, const size_t extSize);
+size_t get_ext_copy_size(const sxData* pData);
+size_t copy_ext(sxData* pDst, const size_t offs, const sxData* pSrc);
 
 sxPackedData* pack(const uint8_t* pSrc, const uint32_t srcSize, const uint32_t mode = 0);
 uint8_t* unpack(sxPackedData* pPkd, const char* pTemTag = "xTmpMem", uint8_t* pDstMem = nullptr, const uint32_t dstMemSize = 0, size_t* pSize = nullptr, const bool recursive = true);
@@ -6548,6 +6741,63 @@ public:
 };
 
 
+#ifndef XD_MOTEVAL_CACHE_MAX_NODES
+#	define XD_MOTEVAL_CACHE_MAX_NODES 256
+#endif
+
+class cxMotionEvalCache {
+public:
+	struct NodeVal {
+		xt_float4 q;
+		xt_float3 t;
+	};
+
+	struct Stats {
+		int32_t hits;
+		int32_t misses;
+		int32_t stores;
+
+		int get_lookups() const { return hits + misses; }
+		float get_hit_rate() const { return nxCalc::div0(float(hits), float(hits + misses)); }
+	};
+
+protected:
+	struct Slot {
+		const sxMotionData* mpMot;
+		float mFrame;
+		uint32_t mStamp;
+		uint32_t mNodeNum;
+	};
+
+	Slot* mpSlots;
+	NodeVal* mpVals;
+	sxLock* mpLock;
+	int mSlotsNum;
+	int mMaxNodes;
+	uint32_t mStamp;
+	Stats mStats;
+
+	cxMotionEvalCache() {}
+
+	int get_slot_idx(const sxMotionData* pMot, const float frame) const;
+
+public:
+	int get_slots_num() const { return mSlotsNum; }
+	int get_max_nodes() const { return mMaxNodes; }
+	bool ck_motion(const sxMotionData* pMot) const { return pMot && pMot->mNodeNum <= uint32_t(mMaxNodes); }
+	Stats get_stats() const { return mStats; }
+	void frame_begin();
+	void invalidate();
+	bool eval(const sxMotionData* pMot, const float frame, NodeVal* pVals);
+
+	static float quantize_frame(const float frame, const float step);
+	static void eval_direct(const sxMotionData* pMot, const float frame, NodeVal* pVals);
+
+	static cxMotionEvalCache* create(const int slotsNum, const int maxNodes = XD_MOTEVAL_CACHE_MAX_NODES, const bool useLock = true);
+	static void destroy(cxMotionEvalCache* pCache);
+};
+
+
 class cxMotionWork {
 private:
 	cxMotionWork() {}
@@ -6555,12 +6805,17 @@ private:
 public:
 	sxModelData* mpMdlData;
 	const sxMotionData* mpCurrentMotData;
+	cxMotionEvalCache* mpEvalCache;
 
 	xt_xmtx* mpXformsL;
 	xt_xmtx* mpXformsW;
 	xt_xmtx* mpPrevXformsW;
 	xt_xmtx* mpBlendXformsL;
 	uint8_t* mpBlendDisableBits;
+	const uint32_t* mpLODSkipBits;
+	int16_t* mpLvlNodes;
+	uint16_t* mpLvlStarts;
+	int16_t* mpSkelToSkin;
 	cxVec mMoveRelPos;
 	cxQuat mMoveRelQuat;
 	float mEvalFrame;
@@ -6569,15 +6824,24 @@ public:
 	float mBlendCount;
 	float mUniformScale;
 	float mHeightOffs;
+	float mEvalCacheStep;
+	float mLODFrame;
+	int mLODSpan;
+	int mLODStep;
+	int mLvlNum;
 	int mRootId;
 	int mMoveId;
 	int mCenterId;
 	bool mPlayLastFrame;
+	bool mLODHold;
 
 	bool ck_node_id(const int inode) const { return mpMdlData ? mpMdlData->ck_skel_id(inode) : false; }
 	int find_node_id(const char* pName) const { return mpMdlData ? mpMdlData->find_skel_node_id(pName) : -1; }
 
 	void apply_motion(const sxMotionData* pMotData, const float frameAdd, float* pLoopFlg = nullptr);
+	bool apply_motion_lod(const sxMotionData* pMotData, const float frameAdd, const int interval, const int phase = 0, float* pLoopFlg = nullptr);
+	void reset_lod() { mLODSpan = 0; mLODStep = 0; mLODHold = false; }
+	bool ck_lod_key() const { return mLODSpan <= 0 || mLODStep >= mLODSpan; }
 	void copy_local(const cxMotionWork* pSrcWk, const sxMotionData* pSrcMotData);
 
 	xt_xmtx eval_skel_node_chain_xform(const sxMotionData* pMotData, const int inode, const int itop, const float frame);
@@ -6585,7 +6849,8 @@ public:
 	void adjust_leg(const cxVec& effPos, const int inodeTop, const int inodeRot, const int inodeEnd, const int inodeExt);
 
 	void copy_prev_world();
-	void calc_world();
+	void calc_world(xt_xmtx* pSkinXforms = nullptr);
+	bool calc_world_hold(xt_xmtx* pSkinXforms = nullptr);
 	void calc_root_world();
 
 	xt_xmtx get_node_local_xform(const int inode) const;
@@ -6611,6 +6876,14 @@ public:
 
 	void set_base_node_ids(const char* pRootName = "root", const char* pMoveName = "n_Move", const char* pCenterName = "n_Center");
 
+protected:
+	float calc_next_frame(const sxMotionData* pMotData, const float frame, const float frameAdd, bool* pLoopFlg = nullptr) const;
+	void eval_nodes(const sxMotionData* pMotData, const float frameAdd, const bool moveOnly);
+	void apply_move_node(const sxMotionData* pMotData, const int imot, const cxQuat& quat, const cxVec& pos, const float frameAdd);
+	void init_levels();
+	void calc_root_node_world(const int inode);
+
+public:
 	static cxMotionWork* create(sxModelData* pMdlData);
 	static void destroy(cxMotionWork* pWk);
 };
@@ -6626,6 +6899,7 @@ public:
 	sxModelData* mpData;
 	xt_xmtx* mpWorldXform;
 	xt_xmtx* mpSkinXforms;
+	xt_float4* mpSkinSpheres;
 	cxAABB* mpBatBBoxes;
 	uint32_t* mpCullBits;
 	uint32_t* mpHideBits;
@@ -6662,6 +6936,7 @@ public:
 	cxMtx get_prev_world_xform() const;
 
 	void set_pose(const cxMotionWork* pMot);
+	void update_skin_bounds(const cxMotionWork* pMot = nullptr);
 	void update_bounds();
 	void frustum_cull(const cxFrustum* pFst, const bool precise = true);
 	bool calc_batch_visibility(const cxFrustum* pFst, const int ibat, const bool precise = true);
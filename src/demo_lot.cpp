@@ -5,6 +5,8 @@
 #include "smprig.hpp"
 #include "smpchar.hpp"
 
+void drwogl_state_stats(int32_t* pCalls, int32_t* pSkips);
+
 DEMO_PROG_BEGIN
 
 static cxStopWatch s_execStopWatch;
@@ -79,6 +81,11 @@ static void init_stage() {
 		Scene::for_all_pkg_models(pPkg, add_stg_obj, &s_stage);
 		s_stage.pCol = pPkg->find_collision("col");
 		SmpCharSys::set_collision(s_stage.pCol);
+		if (nxApp::get_bool_opt("occl", false)) {
+			if (!Scene::add_pkg_occluder(pPkg)) {
+				nxCore::dbg_msg("no occluder geometry in stage package\n");
+			}
+		}
 	}
 }
 
@@ -163,6 +170,12 @@ static void char_roam_ctrl(SmpChar* pChar) {
 	}
 }
 
+static void set_char_anim_lod_mask(ScnObj* pObj) {
+	if (!pObj) return;
+	static const char* s_maskNodes[] = { "f_*" };
+	Scene::set_anim_lod_mask(pObj->get_model_data(), s_maskNodes, XD_ARY_LEN(s_maskNodes));
+}
+
 static void init_chars() {
 	SmpChar::Descr descr;
 	descr.reset();
@@ -182,6 +195,7 @@ static void init_chars() {
 		}
 		ScnObj* pObj = SmpCharSys::add_f(descr, char_roam_ctrl);
 		pObj->set_world_quat_pos(nxQuat::from_degrees(0.0f, 0.0f, 0.0f), cxVec(x, 0.0f, 0.0f));
+		set_char_anim_lod_mask(pObj);
 		x += 0.7f;
 	}
 
@@ -203,6 +217,7 @@ static void init_chars() {
 		if (pObj) {
 			pObj->set_world_quat_pos(q, pos);
 		}
+		set_char_anim_lod_mask(pObj);
 		pos += add;
 	}
 
@@ -241,6 +256,10 @@ static void init() {
 	s_execStopWatch.alloc(120);
 	Scene::enable_split_move(nxApp::get_bool_opt("split_move", false));
 	nxCore::dbg_msg("Scene::split_move: %s\n", Scene::is_split_move_enabled() ? "Yes" : "No");
+	Scene::enable_draw_sort(nxApp::get_bool_opt("draw_sort", true));
+	nxCore::dbg_msg("Scene::draw_sort: %s\n", Scene::is_draw_sort_enabled() ? "Yes" : "No");
+	Scene::enable_draw_inst(nxApp::get_bool_opt("draw_inst", true));
+	nxCore::dbg_msg("Scene::draw_inst: %s\n", Scene::is_draw_inst_enabled() ? "Yes" : "No");
 	s_exerep = nxCalc::clamp(nxApp::get_int_opt("exerep", 1), 1, 100);
 	nxCore::dbg_msg("exerep: %d\n", s_exerep);
 	nxCore::dbg_msg("Scene::speed: %.2f\n", Scene::speed());
@@ -254,6 +273,7 @@ static void init() {
 	s_moodPeriod = nxApp::get_float_opt("mood_period", -1.0f);
 	nxCore::dbg_msg("mood period: %f\n", s_moodPeriod);
 	s_moodVis = nxApp::get_bool_opt("mood_vis", false);
+	Scene::set_mot_cache_quant(nxApp::get_float_opt("mot_cache_dist", -1.0f), nxApp::get_float_opt("mot_cache_step", 0.0f));
 }
 
 static struct ViewWk {
@@ -463,6 +483,33 @@ static void profile_end() {
 		s_medianExecMillis = float(millis);
 		s_avgEXE.add_smp(millis);
 		s_avgFPS.add_smp(SmpCharSys::get_fps());
+		if (Scene::get_mot_cache()) {
+			ScnStats stats = Scene::get_stats();
+			nxCore::dbg_msg("mot cache: %d hits, %d misses (%.1f%%)\n", stats.motCacheHits, stats.motCacheMisses, stats.get_mot_cache_hit_rate() * 100.0f);
+		}
+		if (SmpCharSys::get_collision()) {
+			ScnStats stats = Scene::get_stats();
+			nxCore::dbg_msg("col cache: %d hits, %d misses (%.1f%%)\n", stats.colCacheHits, stats.colCacheMisses, stats.get_col_cache_hit_rate() * 100.0f);
+		}
+		if (Scene::get_occlusion_buffer() && Scene::is_occlusion_cull_enabled()) {
+			ScnStats stats = Scene::get_stats();
+			if (stats.occlTris > 0) {
+				nxCore::dbg_msg("occlusion: %d tris, %d batches culled\n", stats.occlTris, stats.occlCulled);
+			}
+		}
+		if (Scene::is_draw_sort_enabled()) {
+			ScnStats stats = Scene::get_stats();
+			nxCore::dbg_msg("draw queue: %d items, %d state changes (%d avoided)\n", stats.drawItems, stats.drawStateChanges, stats.drawStateChangesAvoided);
+			if (Scene::is_draw_inst_enabled()) {
+				nxCore::dbg_msg("draw inst: %d groups, %d items\n", stats.drawInstGroups, stats.drawInstItems);
+			}
+		}
+		if (OGLSys::is_dummy() && nxCore::str_eq(Scene::get_draw_ifc_name(), "ogl")) {
+			int32_t calls = 0;
+			int32_t skips = 0;
+			drwogl_state_stats(&calls, &skips);
+			nxCore::dbg_msg("gl state: %d calls, %d skipped\n", calls, skips);
+		}
 		Scene::thermal_info();
 		Scene::battery_info();
 	}
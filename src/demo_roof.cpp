@@ -53,6 +53,8 @@ static float s_viewDist = 0.0f;
 
 static int s_primTestMode = 0;
 
+static bool s_wallSweep = false;
+
 static void* s_pCaptMem = nullptr;
 
 #if 0
@@ -583,7 +585,7 @@ static void chr_walls_adj(ScnObj* pObj, const float yoffs = 1.0f) {
 	} else {
 		pWk->wallTouchCnt = 0;
 	}
-	bool adjFlg = Scene::wall_adj_base(pJobCtx, pCol, npos, opos, r, &apos);
+	bool adjFlg = s_wallSweep ? Scene::wall_adj_sweep(pCol, npos, opos, r, &apos) : Scene::wall_adj_base(pJobCtx, pCol, npos, opos, r, &apos);
 	if (adjFlg) {
 		float wy = wpos.y + yoffs;
 		cxLineSeg aseg(cxVec(opos.x, wy, opos.z), cxVec(apos.x, wy, apos.z));
@@ -628,15 +630,20 @@ static bool obj_obj_for_each_func(ScnObj* pObj, void* pWkMem) {
 		pSelf->set_skel_root_local_tx(adjPos.x);
 		pSelf->set_skel_root_local_tz(adjPos.z);
 		++pSelfWk->objHitCnt;
-	} else {
-		pSelfWk->objHitCnt = 0;
 	}
 	return true;
 }
 
 static void chr_objs_adj(ScnObj* pObj) {
 	if (!pObj) return;
-	Scene::for_each_obj(obj_obj_for_each_func, pObj);
+	cxVec npos = pObj->get_world_pos();
+	npos.y += pObj->mObjAdjYOffs;
+	/* only neighbours are visited, so the hit count is restarted here rather than by non-hits */
+	ChrWk* pWk = pObj->get_ptr_wk<ChrWk>(CHR_WK_IDX);
+	if (pWk) {
+		pWk->objHitCnt = 0;
+	}
+	Scene::for_each_obj_in_sph(npos, pObj->mObjAdjRadius, obj_obj_for_each_func, pObj);
 }
 
 static void chr_before_blend(ScnObj* pObj) {
@@ -1401,6 +1408,7 @@ static void init() {
 	s_adapt = nxApp::get_int_opt("adapt", 0);
 	s_viewDist = nxApp::get_float_opt("view_dist", 0.0f);
 	s_primTestMode = nxApp::get_int_opt("prim_test", 0);
+	s_wallSweep = nxApp::get_bool_opt("wall_sweep", false);
 	Scene::alloc_local_heaps(1024 * 1024 * 2);
 	Scene::init_prims(1000, 1000);
 
@@ -1434,6 +1442,12 @@ static void init() {
 			pStgObj->set_shadow_weight_bias(100.0f);
 		}
 	}
+	if (nxApp::get_bool_opt("occl", false)) {
+		Pkg* pStgPkg = Scene::find_pkg(STG_NAME);
+		if (pStgPkg && !Scene::add_pkg_occluder(pStgPkg)) {
+			nxCore::dbg_msg("no occluder geometry in stage package\n");
+		}
+	}
 
 	cxResourceManager* pRsrcMgr = Scene::get_rsrc_mgr();
 	if (pRsrcMgr) {
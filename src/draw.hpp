@@ -31,6 +31,10 @@ namespace Draw {
 		PRIMTYPE_SPRITE = 1
 	};
 
+	enum {
+		SHADOW_CASCADES_MAX = 4
+	};
+
 	struct Font {
 		struct SymInfo {
 			xt_float2 size;
@@ -146,6 +150,11 @@ namespace Draw {
 			float mWghtBias;
 			float mFadeStart;
 			float mFadeEnd;
+			cxMtx mCascadeViewProj[SHADOW_CASCADES_MAX];
+			xt_float4 mCascadeXform[SHADOW_CASCADES_MAX]; /* mMtx xy -> cascade uv: scale xy, offs zw */
+			float mCascadeGuard; /* cascade uv border kept clear for filtering */
+			int mCascadeNum; /* < 2: single map, mViewProjMtx only */
+			int mCascade; /* cascade being cast */
 
 			void set_dir(const cxVec& v) {
 				mDir = v.get_normalized();
@@ -159,6 +168,10 @@ namespace Draw {
 				return nxCalc::max(mDens + mDensBias, 0.0f);
 			}
 
+			const cxMtx& get_cast_view_proj() const {
+				return mCascadeNum > 1 ? mCascadeViewProj[mCascade] : mViewProjMtx;
+			}
+
 			void reset() {
 				set_dir_degrees(70, 140);
 				mDens = 1.0f;
@@ -169,6 +182,9 @@ namespace Draw {
 				mFadeEnd = 0.0f;
 				mViewProjMtx.identity();
 				mMtx.identity();
+				mCascadeGuard = 0.0f;
+				mCascadeNum = 1;
+				mCascade = 0;
 			}
 		} shadow;
 
@@ -246,6 +262,23 @@ namespace Draw {
 		}
 	};
 
+	/* one model batch resolved for drawing: recorded off the render thread, replayed at submit */
+	struct BatchPacket {
+		cxModelWork* pWk;
+		const sxModelData::Material* pMtl; /* after variation swap */
+		MdlParam::ExtIfc* pExtIfc; /* external draw_batch instead of prog */
+		uintptr_t prog;
+		sxTextureData* pBaseTex; /* null: the backend looks the texture up at replay */
+		sxTextureData* pBumpTex;
+		sxTextureData* pSurfTex;
+		xt_float4 shadowCtrl; /* offset, weight, density */
+		xt_float3 baseColor;
+		float alphaLim;
+		uint32_t key; /* program/texture state for draw sorting */
+		int32_t ibat;
+		Mode mode;
+	};
+
 	struct PrimGeom {
 		struct {
 			uint32_t org;
@@ -300,6 +333,7 @@ namespace Draw {
 	struct Symbol {
 		cxColor clr;
 		xt_float2 rot[2];
+		xt_float4 clip; /* min xy, max xy; same units as ox/oy */
 		int sym;
 		float ox;
 		float oy;
@@ -320,6 +354,7 @@ namespace Draw {
 		int (*get_screen_height)();
 
 		cxMtx (*get_shadow_bias_mtx)();
+		int (*init_shadow_cascades)(const int num); /* optional: shadow atlas for up to num cascades, returns how many the backend can cast */
 
 		void (*init_prims)(const uint32_t maxVtx, const uint32_t maxIdx);
 		void (*prim_geom)(const PrimGeom* pGeom);
@@ -328,6 +363,9 @@ namespace Draw {
 		void (*end)();
 
 		void (*batch)(cxModelWork* pWk, const int ibat, const Mode mode, const Context* pCtx);
+		bool (*batch_record)(cxModelWork* pWk, const int ibat, const Mode mode, const Context* pCtx, BatchPacket* pPkt); /* optional: batch() without the render API, called from record workers; false if nothing would be drawn */
+		void (*batch_replay)(const BatchPacket* pPkt, const Context* pCtx); /* required with batch_record */
+		bool (*batch_inst)(const BatchPacket* const* ppPkts, const int npkt, const Context* pCtx); /* optional: packets of the same model batch, false if it fell back to batch_replay() per packet */
 		void (*prim)(const Prim* pPrim, const Context* pCtx);
 		void (*quad)(const Quad* pQuad);
 		void (*symbol)(const Symbol* pSym);
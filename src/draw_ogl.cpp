@@ -23,6 +23,18 @@
 #	define DRW_CACHE_DSIDED 1
 #endif
 
+#ifndef DRW_CACHE_TEXS
+#	define DRW_CACHE_TEXS 1
+#endif
+
+#ifndef DRW_CACHE_SKIN
+#	define DRW_CACHE_SKIN 1
+#endif
+
+#ifndef DRW_CACHE_MISC
+#	define DRW_CACHE_MISC 1
+#endif
+
 #ifndef DRW_LIMIT_JMAP
 #	define DRW_LIMIT_JMAP 1
 #endif
@@ -35,6 +47,27 @@
 #	define DRW_USE_MEMCMP 1
 #endif
 
+#ifndef DRW_USE_INST
+#	define DRW_USE_INST 1
+#endif
+
+#ifndef DRW_USE_UBO
+#	if OGLSYS_ES || defined(OGLSYS_WEB)
+#		define DRW_USE_UBO 0
+#	else
+#		define DRW_USE_UBO 1
+#	endif
+#endif
+
+#define DRW_UBO_RING_SIZE (256 * 1024)
+#define DRW_UBO_CACHE_SIZE 1024
+
+#define DRW_INST_MAX 256
+
+#define DRW_TEXT_MAX_VTX (16 * 1024)
+
+#define GPU_INST_PROG(_vert, _frag) GPU_PROG(_vert##_inst, _frag)
+
 DRW_IMPL_BEGIN
 
 static bool s_drwInitFlg = false;
@@ -48,7 +81,11 @@ static cxResourceManager* s_pRsrcMgr = nullptr;
 struct GPUProg;
 static const GPUProg* s_pNowProg = nullptr;
 
-static int s_shadowSize = 0;
+static int s_shadowSize = 0; // one cascade
+static int s_shadowW = 0; // atlas
+static int s_shadowH = 0;
+static int s_shadowCascadesMax = 1;
+static int s_shadowViewport = -1; // -1: whole atlas, otherwise cascade tile
 static GLuint s_shadowFBO = 0;
 static GLuint s_shadowTex = 0;
 static GLuint s_shadowDepthBuf = 0;
@@ -58,10 +95,189 @@ static int s_frameBufMode = 0; // 0: def, 1: shadow, 2: screen
 static int s_batDrwCnt = 0;
 static int s_shadowCastCnt = 0;
 
-static GLuint s_primVBO = 0;
+/* state/uniform calls issued vs skipped by the caches, latched per frame */
+static int32_t s_stateCalls = 0;
+static int32_t s_stateSkips = 0;
+static int32_t s_frameStateCalls = 0;
+static int32_t s_frameStateSkips = 0;
+
+static inline void state_call() { ++s_stateCalls; }
+static inline void state_skip() { ++s_stateSkips; }
+
+static int s_nowTexUnit = -1;
+static GLuint s_nowTex[Draw::TEXUNIT_COUNT];
+static bool s_nowTexValid[Draw::TEXUNIT_COUNT];
+
+static void reset_tex_cache() {
+	s_nowTexUnit = -1;
+	for (int i = 0; i < Draw::TEXUNIT_COUNT; ++i) {
+		s_nowTexValid[i] = false;
+	}
+}
+
+static uint64_t param_hash(const void* pData, const size_t size) {
+	const uint32_t* p = reinterpret_cast<const uint32_t*>(pData);
+	size_t n = size / sizeof(uint32_t);
+	uint64_t h = 0xCBF29CE484222325ULL;
+	for (size_t i = 0; i < n; ++i) {
+		h ^= p[i];
+		h *= 0x100000001B3ULL;
+	}
+	return h;
+}
+
+static uint64_t data_hash(const void* pData, const size_t size, uint64_t h = 0xCBF29CE484222325ULL) {
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(pData);
+	if (p) {
+		for (size_t i = 0; i < size; ++i) {
+			h ^= p[i];
+			h *= 0x100000001B3ULL;
+		}
+	}
+	return h;
+}
+
+enum DrwUBOSlot {
+	DRW_UBO_FRAME = 0,
+	DRW_UBO_MTL,
+	DRW_UBO_NUM
+};
+
+/* std140 images of GPUFrame and GPUMtl from ogl/gpu_blocks.h */
+struct GPUFrameBlk {
+	xt_mtx viewProj;
+	xt_mtx shadowMtx;
+	xt_float4 viewPos;
+	xt_float4 hemiUp;
+	xt_float4 hemiUpper;
+	xt_float4 hemiLower;
+	xt_float4 hemiParam;
+	xt_float4 specLightDir;
+	xt_float4 specLightColor;
+	xt_float4 vtxHemiUp;
+	xt_float4 vtxHemiUpper;
+	xt_float4 vtxHemiLower;
+	xt_float4 vtxHemiParam;
+	xt_float4 shadowSize;
+	xt_float4 shadowFade;
+	xt_float4 fogColor;
+	xt_float4 fogParam;
+	xt_float4 invWhite;
+	xt_float4 lclrGain;
+	xt_float4 lclrBias;
+	xt_float4 exposure;
+	xt_float4 invGamma;
+	xt_float4 shadowCascade[Draw::SHADOW_CASCADES_MAX];
+	xt_float4 shadowCascadeCtrl;
+};
+
+struct GPUMtlBlk {
+	xt_float4 baseColor;
+	xt_float4 specColor;
+	xt_float4 surfParam;
+	xt_float4 bumpParam;
+	xt_float4 alphaCtrl;
+	xt_float4 shadowCtrl;
+};
+
+static GLuint s_uboRing = 0;
+static bool s_uboShaders = false;
+static bool s_uboNowValid[DRW_UBO_NUM];
+static GPUFrameBlk s_frameBlk[2];
+static uint32_t s_frameBlkOffs[2];
+static bool s_frameBlkValid[2];
+
+static void ubo_f3(xt_float4& dst, const xt_float3& src) {
+	dst.set(src.x, src.y, src.z, 0.0f);
+}
+
+static void reset_ubo_cache() {
+	for (int i = 0; i < DRW_UBO_NUM; ++i) {
+		s_uboNowValid[i] = false;
+	}
+}
+
+#if DRW_USE_UBO
+struct UBOCacheEntry {
+	uint64_t hash;
+	uint32_t offs;
+	uint32_t size;
+};
+
+static uint32_t s_uboAlign = 256;
+static uint32_t s_uboTop = 0;
+static UBOCacheEntry s_uboCache[DRW_UBO_CACHE_SIZE];
+static int32_t s_uboCacheNum = 0;
+static uint32_t s_uboNowOffs[DRW_UBO_NUM];
+
+static void ubo_orphan() {
+	glBindBuffer(GL_UNIFORM_BUFFER, s_uboRing);
+	glBufferData(GL_UNIFORM_BUFFER, DRW_UBO_RING_SIZE, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	s_uboTop = 0;
+	nxCore::mem_zero(s_uboCache, sizeof(s_uboCache));
+	s_uboCacheNum = 0;
+	s_frameBlkValid[0] = false;
+	s_frameBlkValid[1] = false;
+	reset_ubo_cache();
+}
+
+/* content-addressed: identical block data is written once and reused at the same offset until the ring wraps */
+static uint32_t ubo_put(const void* pData, const uint32_t size) {
+	uint64_t h = param_hash(pData, size) | 1;
+	uint32_t mask = DRW_UBO_CACHE_SIZE - 1;
+	uint32_t idx = uint32_t(h) & mask;
+	while (s_uboCache[idx].hash != 0) {
+		if (s_uboCache[idx].hash == h && s_uboCache[idx].size == size) {
+			return s_uboCache[idx].offs;
+		}
+		idx = (idx + 1) & mask;
+	}
+	if (s_uboCacheNum >= DRW_UBO_CACHE_SIZE / 2 || s_uboTop + size > DRW_UBO_RING_SIZE) {
+		ubo_orphan();
+		idx = uint32_t(h) & mask;
+	}
+	uint32_t offs = s_uboTop;
+	glBindBuffer(GL_UNIFORM_BUFFER, s_uboRing);
+	glBufferSubData(GL_UNIFORM_BUFFER, offs, size, pData);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	state_call();
+	s_uboCache[idx].hash = h;
+	s_uboCache[idx].offs = offs;
+	s_uboCache[idx].size = size;
+	++s_uboCacheNum;
+	s_uboTop = ((offs + size + s_uboAlign - 1) / s_uboAlign) * s_uboAlign;
+	return offs;
+}
+
+static void ubo_bind(const int slot, const uint32_t offs, const uint32_t size) {
+#if DRW_CACHE_MISC
+	if (s_uboNowValid[slot] && s_uboNowOffs[slot] == offs) {
+		state_skip();
+		return;
+	}
+#endif
+	glBindBufferRange(GL_UNIFORM_BUFFER, slot, s_uboRing, offs, size);
+	s_uboNowOffs[slot] = offs;
+	s_uboNowValid[slot] = true;
+	state_call();
+}
+#else
+static uint32_t ubo_put(const void* pData, const uint32_t size) { return 0; }
+static void ubo_bind(const int slot, const uint32_t offs, const uint32_t size) {}
+#endif
+
+static bool ubo_shader_ck(const char* pName) {
+	return !(nxCore::str_starts_with(pName, "quad") || nxCore::str_starts_with(pName, "font") || nxCore::str_starts_with(pName, "text") || nxCore::str_starts_with(pName, "prim"));
+}
+
+static sxPrimVtx* s_pPrimVtx = nullptr;
 static uint32_t s_maxPrimVtx = 0;
-static GLuint s_primIBO = 0;
+static uint16_t* s_pPrimIdx = nullptr;
+static uint16_t* s_pPrimIdxTmp = nullptr;
 static uint32_t s_maxPrimIdx = 0;
+static OGLSysStreamBuf s_primVtxStrm;
+static OGLSysStreamBuf s_primIdxStrm;
 
 static GLuint s_quadVBO = 0;
 static GLuint s_quadIBO = 0;
@@ -70,9 +286,31 @@ static Draw::Font* s_pFont = nullptr;
 static GLuint s_fontVBO = 0;
 static GLuint s_fontIBO = 0;
 
+struct TextVtx {
+	xt_float2 pos;
+	xt_float2 loc;
+	xt_float4 clip;
+	xt_float4 clr;
+};
+
+static TextVtx* s_pTextVtx = nullptr;
+static uint32_t s_textVtxNum = 0;
+static uint32_t s_textVtxMax = 0;
+static OGLSysStreamBuf s_textStrm;
+
+static void text_flush();
+
+static GLuint s_instVBO = 0;
+static xt_xmtx s_instXforms[DRW_INST_MAX];
+
 static bool s_glslEcho = false;
 static const char* s_pGLSLBinSavePath = nullptr;
 static const char* s_pGLSLBinLoadPath = nullptr;
+static const char* s_pGLSLCachePath = nullptr;
+static const char* s_pGLSLManifestPath = nullptr;
+static bool s_glslAsync = false;
+static bool s_glslLazy = false;
+static uint64_t s_glslDrvHash = 0;
 
 static const char* s_pAltGLSL = nullptr;
 static const char* s_pExtGLSL = nullptr;
@@ -109,8 +347,52 @@ static void def_tex_params(const bool mipmapEnabled, const bool biasEnabled) {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
 
-static GLuint load_shader(const char* pName) {
-	GLuint sid = 0;
+struct GPUShader {
+	const char* mpName;
+	char* mpSrc;
+	size_t mSrcSize;
+	uint64_t mHash;
+	GLenum mKind;
+	GLuint mSID;
+
+	/* compiled on first use by a program link, asynchronously when the driver can */
+	GLuint get() {
+		if (!mSID && mpSrc) {
+			if (s_glslAsync) {
+				mSID = OGLSys::compile_shader_str_nock(mpSrc, mSrcSize, mKind);
+			} else {
+				mSID = OGLSys::compile_shader_str(mpSrc, mSrcSize, mKind);
+			}
+			nxCore::mem_free(mpSrc);
+			mpSrc = nullptr;
+		}
+		return mSID;
+	}
+
+	void ck_status() const {
+		if (mSID && !OGLSys::ck_compile_status(mSID)) {
+			nxCore::dbg_msg("GPUShader compile error: %s\n", mpName ? mpName : "<unknown>");
+		}
+	}
+
+	void reset() {
+		if (mSID) {
+			glDeleteShader(mSID);
+			mSID = 0;
+		}
+		if (mpSrc) {
+			nxCore::mem_free(mpSrc);
+			mpSrc = nullptr;
+		}
+		mSrcSize = 0;
+		mHash = 0;
+	}
+};
+
+static void load_shader(GPUShader* pSdr, const char* pName) {
+	if (!pSdr) return;
+	pSdr->reset();
+	pSdr->mpName = pName;
 	const char* pDataPath = s_pRsrcMgr ? s_pRsrcMgr->get_data_path() : nullptr;
 	if (pName) {
 		char path[256];
@@ -131,8 +413,9 @@ static GLuint load_shader(const char* pName) {
 		}
 		if (pSrc) {
 			GLenum kind = nxCore::str_ends_with(pName, ".vert") ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER;
+			pSdr->mKind = kind;
 #if OGLSYS_ES
-			const char* pPreStr = nullptr;
+			const char* pPreStr = "";
 			if ((s_glslNoBaseTex || s_glslNoFog || s_glslNoCC) && (kind == GL_FRAGMENT_SHADER)) {
 				if (!nxCore::str_starts_with(pName, "quad")) {
 					if (s_glslNoBaseTex) {
@@ -160,19 +443,7 @@ static GLuint load_shader(const char* pName) {
 					}
 				}
 			}
-			if (pPreStr) {
-				size_t preSize = nxCore::str_len(pPreStr);
-				size_t altSize = preSize + srcSize;
-				char* pAltSrc = (char*)nxCore::mem_alloc(altSize, "glsl:pre+src");
-				if (pAltSrc) {
-					nxCore::mem_copy(pAltSrc, pPreStr, preSize);
-					nxCore::mem_copy(pAltSrc + preSize, pSrc, srcSize);
-					sid = OGLSys::compile_shader_str(pAltSrc, altSize, kind);
-					nxCore::mem_free(pAltSrc);
-				}
-			} else {
-				sid = OGLSys::compile_shader_str(pSrc, srcSize, kind);
-			}
+			const char* pUBOStr = "";
 #else
 			const char* pPreStr;
 #	if defined(OGLSYS_WEB)
@@ -211,16 +482,20 @@ static GLuint load_shader(const char* pName) {
 				}
 			}
 #	endif
+			const char* pUBOStr = (s_uboShaders && ubo_shader_ck(pName)) ? "#extension GL_ARB_uniform_buffer_object : require\n#define GPU_UBO\n" : "";
+#endif
 			size_t preSize = nxCore::str_len(pPreStr);
-			size_t altSize = preSize + srcSize;
+			size_t uboSize = nxCore::str_len(pUBOStr);
+			size_t altSize = preSize + uboSize + srcSize;
 			char* pAltSrc = (char*)nxCore::mem_alloc(altSize, "glsl:pre+src");
 			if (pAltSrc) {
 				nxCore::mem_copy(pAltSrc, pPreStr, preSize);
-				nxCore::mem_copy(pAltSrc + preSize, pSrc, srcSize);
-				sid = OGLSys::compile_shader_str(pAltSrc, altSize, kind);
-				nxCore::mem_free(pAltSrc);
+				nxCore::mem_copy(pAltSrc + preSize, pUBOStr, uboSize);
+				nxCore::mem_copy(pAltSrc + preSize + uboSize, pSrc, srcSize);
+				pSdr->mpSrc = pAltSrc;
+				pSdr->mSrcSize = altSize;
+				pSdr->mHash = data_hash(pAltSrc, altSize);
 			}
-#endif
 			nxCore::bin_unload(pSrc);
 		}
 		if (pPath != path) {
@@ -228,7 +503,6 @@ static GLuint load_shader(const char* pName) {
 			pPath = nullptr;
 		}
 	}
-	return sid;
 }
 
 struct VtxLink {
@@ -242,6 +516,9 @@ struct VtxLink {
 	GLint Jnt;
 	GLint Prm;
 	GLint Id;
+	GLint IW0;
+	GLint IW1;
+	GLint IW2;
 
 	static int num_attrs() {
 		return int(sizeof(VtxLink) / sizeof(GLint));
@@ -297,6 +574,8 @@ struct ParamLink {
 	GLint ShadowSize;
 	GLint ShadowCtrl;
 	GLint ShadowFade;
+	GLint ShadowCascade;
+	GLint ShadowCascadeCtrl;
 	GLint BaseColor;
 	GLint SpecColor;
 	GLint SurfParam;
@@ -355,6 +634,34 @@ static void gl_param(const GLint loc, const xt_float4& v) {
 	glUniform4fv(loc, 1, v);
 }
 
+struct GPUShadowCascades {
+	xt_float4 xform[Draw::SHADOW_CASCADES_MAX];
+};
+
+static void gl_param(const GLint loc, const GPUShadowCascades& csc) {
+	glUniform4fv(loc, Draw::SHADOW_CASCADES_MAX, csc.xform[0]);
+}
+
+static void shadow_size_param(xt_float4& size) {
+	float sw = float(s_shadowW);
+	float sh = float(s_shadowH);
+	size.set(sw, sh, nxCalc::rcp0(sw), nxCalc::rcp0(sh));
+}
+
+static void shadow_cascade_params(const Draw::Context* pCtx, GPUShadowCascades& csc, xt_float4& ctrl) {
+	int n = nxCalc::min(pCtx->shadow.mCascadeNum, s_shadowCascadesMax);
+	nxCore::mem_zero(&csc, sizeof(csc));
+	if (n > 1) {
+		for (int i = 0; i < n; ++i) {
+			csc.xform[i] = pCtx->shadow.mCascadeXform[i];
+		}
+		float ss = float(s_shadowSize);
+		ctrl.set(float(n), ss * nxCalc::rcp0(float(s_shadowW)), ss * nxCalc::rcp0(float(s_shadowH)), pCtx->shadow.mCascadeGuard);
+	} else {
+		ctrl.set(1.0f, 1.0f, 1.0f, 0.0f);
+	}
+}
+
 enum VtxFmt {
 	VtxFmt_none,
 	VtxFmt_rigid0,
@@ -364,18 +671,44 @@ enum VtxFmt {
 	VtxFmt_prim,
 	VtxFmt_quad,
 	VtxFmt_font,
+	VtxFmt_text,
 
 	VtxFmt_rigid0_vl = VtxFmt_rigid0,
 	VtxFmt_rigid1_vl = VtxFmt_rigid1,
+	VtxFmt_rigid0_inst = VtxFmt_rigid0,
+	VtxFmt_rigid1_inst = VtxFmt_rigid1,
 	VtxFmt_skin0_vl = VtxFmt_skin0,
 	VtxFmt_skin1_vl = VtxFmt_skin1
 };
 
 #define DRW_GBIN_SIG XD_FOURCC('g', 'b', 'i', 'n')
+#define DRW_GBIN_VER 2
 #define DRW_GBIN_EXT "gbin"
 
-static void save_gpu_prog_bin(const GLuint pid, const char* pVertName, const char* pFragName) {
-	if (!s_pGLSLBinSavePath) return;
+struct GPUProgBinHead {
+	uint32_t mSig;
+	uint32_t mVer;
+	uint32_t mSize;
+	uint32_t mFmt;
+	uint64_t mDrvHash;
+	uint64_t mSrcHash;
+};
+
+static void init_drv_hash() {
+	const GLenum ids[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+	uint64_t h = 0xCBF29CE484222325ULL;
+	for (size_t i = 0; i < XD_ARY_LEN(ids); ++i) {
+		const char* pStr = (const char*)glGetString(ids[i]);
+		if (pStr) {
+			h = data_hash(pStr, nxCore::str_len(pStr), h);
+		}
+		h = data_hash("\n", 1, h);
+	}
+	s_glslDrvHash = h;
+}
+
+static void save_gpu_prog_bin(const char* pDirPath, const GLuint pid, const char* pVertName, const char* pFragName, const uint64_t srcHash) {
+	if (!pDirPath) return;
 	if (!pid) return;
 	if (!pVertName) return;
 	if (!pFragName) return;
@@ -387,22 +720,25 @@ static void save_gpu_prog_bin(const GLuint pid, const char* pVertName, const cha
 		OGLSys::free_prog_bin(pBin);
 		return;
 	}
-	size_t saveSize = sizeof(uint32_t) * 3 + size;
-	uint32_t* pMem = (uint32_t*)nxCore::mem_alloc(saveSize, "GPUProg:save:mem");
+	size_t saveSize = sizeof(GPUProgBinHead) + size;
+	GPUProgBinHead* pMem = (GPUProgBinHead*)nxCore::mem_alloc(saveSize, "GPUProg:save:mem");
 	if (!pMem) {
 		OGLSys::free_prog_bin(pBin);
 		return;
 	}
-	pMem[0] = DRW_GBIN_SIG;
-	pMem[1] = uint32_t(size);
-	pMem[2] = uint32_t(fmt);
-	nxCore::mem_copy(pMem + 3, pBin, size);
+	pMem->mSig = DRW_GBIN_SIG;
+	pMem->mVer = DRW_GBIN_VER;
+	pMem->mSize = uint32_t(size);
+	pMem->mFmt = uint32_t(fmt);
+	pMem->mDrvHash = s_glslDrvHash;
+	pMem->mSrcHash = srcHash;
+	nxCore::mem_copy(pMem + 1, pBin, size);
 	OGLSys::free_prog_bin(pBin);
 	static const char* pExt = DRW_GBIN_EXT;
 	char path[128];
 	char* pPath = path;
 	size_t bufSize = sizeof(path);
-	size_t pathSize = nxCore::str_len(s_pGLSLBinSavePath) + 1
+	size_t pathSize = nxCore::str_len(pDirPath) + 1
 	                + nxCore::str_len(pVertName) + 1
 	                + nxCore::str_len(pFragName) + 1
 	                + nxCore::str_len(pExt) + 1;
@@ -411,7 +747,7 @@ static void save_gpu_prog_bin(const GLuint pid, const char* pVertName, const cha
 		pPath = (char*)nxCore::mem_alloc(pathSize, "GPUProg:save:path");
 	}
 	if (pPath && bufSize > 0) {
-		XD_SPRINTF(XD_SPRINTF_BUF(pPath, bufSize), "%s/%s_%s.%s", s_pGLSLBinSavePath, pVertName, pFragName, pExt);
+		XD_SPRINTF(XD_SPRINTF_BUF(pPath, bufSize), "%s/%s_%s.%s", pDirPath, pVertName, pFragName, pExt);
 		nxCore::bin_save(pPath, pMem, saveSize);
 	}
 	if (pPath != path) {
@@ -420,9 +756,10 @@ static void save_gpu_prog_bin(const GLuint pid, const char* pVertName, const cha
 	nxCore::mem_free(pMem);
 }
 
-static bool load_gpu_prog_bin(const GLuint pid, const char* pVertName, const char* pFragName) {
+/* srcHash == 0: sources unknown (bin-only startup), accept any source version */
+static bool load_gpu_prog_bin(const char* pDirPath, const GLuint pid, const char* pVertName, const char* pFragName, const uint64_t srcHash) {
 	bool res = false;
-	if (!s_pGLSLBinLoadPath) return res;
+	if (!pDirPath) return res;
 	if (!pid) return res;
 	if (!pVertName) return res;
 	if (!pFragName) return res;
@@ -430,7 +767,7 @@ static bool load_gpu_prog_bin(const GLuint pid, const char* pVertName, const cha
 	char path[128];
 	char* pPath = path;
 	size_t bufSize = sizeof(path);
-	size_t pathSize = nxCore::str_len(s_pGLSLBinLoadPath) + 1
+	size_t pathSize = nxCore::str_len(pDirPath) + 1
 	                + nxCore::str_len(pVertName) + 1
 	                + nxCore::str_len(pFragName) + 1
 	                + nxCore::str_len(pExt) + 1;
@@ -439,15 +776,19 @@ static bool load_gpu_prog_bin(const GLuint pid, const char* pVertName, const cha
 		pPath = (char*)nxCore::mem_alloc(pathSize, "GPUProg:load:path");
 	}
 	if (pPath && bufSize > 0) {
-		XD_SPRINTF(XD_SPRINTF_BUF(pPath, bufSize), "%s/%s_%s.%s", s_pGLSLBinLoadPath, pVertName, pFragName, pExt);
+		XD_SPRINTF(XD_SPRINTF_BUF(pPath, bufSize), "%s/%s_%s.%s", pDirPath, pVertName, pFragName, pExt);
 		size_t fsize = 0;
 		void* pBin = nxCore::raw_bin_load(pPath, &fsize);
-		if (pBin && fsize > 0x10) {
-			uint32_t* pHead = (uint32_t*)pBin;
-			if (pHead[0] == DRW_GBIN_SIG) {
-				GLsizei len = (GLsizei)pHead[1];
-				GLenum fmt = (GLenum)pHead[2];
-				res = OGLSys::set_prog_bin(pid, fmt, (const void*)(pHead + 3), len);
+		if (pBin && fsize > sizeof(GPUProgBinHead)) {
+			GPUProgBinHead* pHead = (GPUProgBinHead*)pBin;
+			bool okFlg = pHead->mSig == DRW_GBIN_SIG && pHead->mVer == DRW_GBIN_VER;
+			okFlg = okFlg && pHead->mSize <= fsize - sizeof(GPUProgBinHead);
+			okFlg = okFlg && pHead->mDrvHash == s_glslDrvHash;
+			okFlg = okFlg && (srcHash == 0 || pHead->mSrcHash == srcHash);
+			if (okFlg) {
+				GLsizei len = (GLsizei)pHead->mSize;
+				GLenum fmt = (GLenum)pHead->mFmt;
+				res = OGLSys::set_prog_bin(pid, fmt, (const void*)(pHead + 1), len);
 			}
 		}
 		if (pBin) {
@@ -473,6 +814,16 @@ struct GPUProg {
 	GLuint mVAO;
 	GLint mExtLoc;
 	size_t mExtNum;
+	GPUProg* mpInst;
+	GLint mFrameBlk;
+	GLint mMtlBlk;
+	GPUShader* mpVertSdr;
+	GPUShader* mpFragSdr;
+	bool mLazy;
+	bool mUsed;
+	bool mInManifest;
+	bool mPending;
+	bool mSkip;
 
 	template<typename T> struct CachedParam {
 		T mVal;
@@ -503,11 +854,15 @@ struct GPUProg {
 					if (updateFlg) {
 						gl_param(loc, val);
 						mVal = val;
+						state_call();
+					} else {
+						state_skip();
 					}
 				} else {
 					gl_param(loc, val);
 					mVal = val;
 					mFlg = true;
+					state_call();
 				}
 			}
 #else
@@ -518,6 +873,32 @@ struct GPUProg {
 		}
 	};
 
+	struct HashedParam {
+		uint64_t mHash;
+		GLsizei mNum;
+		bool mFlg;
+
+		void reset() {
+			mFlg = false;
+		}
+
+		void set(const GLint loc, const GLsizei nvec, const GLfloat* pVals) {
+			if (loc < 0) return;
+#if DRW_CACHE_SKIN
+			uint64_t h = param_hash(pVals, nvec * 4 * sizeof(GLfloat));
+			if (mFlg && mNum == nvec && mHash == h) {
+				state_skip();
+				return;
+			}
+			mHash = h;
+			mNum = nvec;
+			mFlg = true;
+#endif
+			glUniform4fv(loc, nvec, pVals);
+			state_call();
+		}
+	};
+
 	struct Cache {
 		CachedParam<xt_mtx> mViewProj;
 		CachedParam<xt_xmtx> mWorld;
@@ -559,6 +940,8 @@ struct GPUProg {
 		CachedParam<xt_float4> mShadowSize;
 		CachedParam<xt_float4> mShadowCtrl;
 		CachedParam<xt_float4> mShadowFade;
+		CachedParam<GPUShadowCascades> mShadowCascade;
+		CachedParam<xt_float4> mShadowCascadeCtrl;
 
 		CachedParam<xt_float3> mInvWhite;
 		CachedParam<xt_float3> mLClrGain;
@@ -569,8 +952,12 @@ struct GPUProg {
 		CachedParam<xt_float4> mPrimCtrl;
 		CachedParam<xt_float4> mPrimColor;
 
+		HashedParam mSkinMtx;
+		HashedParam mSkinMap;
 
 		void reset() {
+			mSkinMtx.reset();
+			mSkinMap.reset();
 			mViewProj.reset();
 			mWorld.reset();
 			mShadowMtx.reset();
@@ -601,6 +988,8 @@ struct GPUProg {
 			mShadowSize.reset();
 			mShadowCtrl.reset();
 			mShadowFade.reset();
+			mShadowCascade.reset();
+			mShadowCascadeCtrl.reset();
 			mInvWhite.reset();
 			mLClrGain.reset();
 			mLClrBias.reset();
@@ -619,6 +1008,8 @@ struct GPUProg {
 		mCache.reset();
 		mExtLoc = -1;
 		mExtNum = 0;
+		mFrameBlk = -1;
+		mMtlBlk = -1;
 		if (!is_valid()) return;
 
 		VTX_LINK(Pos);
@@ -631,6 +1022,9 @@ struct GPUProg {
 		VTX_LINK(Jnt);
 		VTX_LINK(Prm);
 		VTX_LINK(Id);
+		VTX_LINK(IW0);
+		VTX_LINK(IW1);
+		VTX_LINK(IW2);
 
 		PARAM_LINK(PosBase);
 		PARAM_LINK(PosScale);
@@ -656,6 +1050,8 @@ struct GPUProg {
 		PARAM_LINK(ShadowSize);
 		PARAM_LINK(ShadowCtrl);
 		PARAM_LINK(ShadowFade);
+		PARAM_LINK(ShadowCascade);
+		PARAM_LINK(ShadowCascadeCtrl);
 		PARAM_LINK(BaseColor);
 		PARAM_LINK(SpecColor);
 		PARAM_LINK(SurfParam);
@@ -685,6 +1081,21 @@ struct GPUProg {
 		SMP_LINK(Surf);
 		SMP_LINK(Shadow);
 
+#if DRW_USE_UBO
+		if (s_uboRing) {
+			GLuint frameBlk = glGetUniformBlockIndex(mProgId, "GPUFrame");
+			if (frameBlk != GL_INVALID_INDEX) {
+				glUniformBlockBinding(mProgId, frameBlk, DRW_UBO_FRAME);
+				mFrameBlk = GLint(frameBlk);
+			}
+			GLuint mtlBlk = glGetUniformBlockIndex(mProgId, "GPUMtl");
+			if (mtlBlk != GL_INVALID_INDEX) {
+				glUniformBlockBinding(mProgId, mtlBlk, DRW_UBO_MTL);
+				mMtlBlk = GLint(mtlBlk);
+			}
+		}
+#endif
+
 		const char* pExtArgsName = "gpExtArgs";
 		GLint extLoc = glGetUniformLocation(mProgId, pExtArgsName);
 		if (extLoc >= 0) {
@@ -711,31 +1122,78 @@ struct GPUProg {
 		mVAO = DRW_USE_VAO ? OGLSys::gen_vao() : 0;
 	}
 
-	void init(VtxFmt vfmt, GLuint vertSID, GLuint fragSID, const char* pVertName, const char* pFragName) {
-		mpVertName = pVertName;
-		mpFragName = pFragName;
-		mVertSID = vertSID;
-		mFragSID = fragSID;
-		mVtxFmt = vfmt;
-
-		if (s_pGLSLBinLoadPath) {
-			mProgId = glCreateProgram();
-			if (mProgId) {
-				bool loadRes = load_gpu_prog_bin(mProgId, pVertName, pFragName);
-				if (!loadRes) {
-					glDeleteProgram(mProgId);
-					mProgId = 0;
-				}
+	uint64_t src_hash() const {
+		if (!mpVertSdr || !mpFragSdr) return 0;
+		if (!mpVertSdr->mHash || !mpFragSdr->mHash) return 0;
+		uint64_t h[2] = { mpVertSdr->mHash, mpFragSdr->mHash };
+		return data_hash(h, sizeof(h));
+	}
+
+	bool cache_load() {
+		const char* pPath = s_pGLSLBinLoadPath ? s_pGLSLBinLoadPath : s_pGLSLCachePath;
+		if (!pPath) return false;
+		uint64_t srcHash = src_hash();
+		if (!s_pGLSLBinLoadPath && !srcHash) return false;
+		mProgId = glCreateProgram();
+		if (mProgId) {
+			if (load_gpu_prog_bin(pPath, mProgId, mpVertName, mpFragName, srcHash)) {
+				prepare();
+			} else {
+				glDeleteProgram(mProgId);
+				mProgId = 0;
 			}
+		}
+		return is_valid();
+	}
+
+	void link_begin() {
+		mPending = false;
+		if (is_valid()) return;
+		mVertSID = mpVertSdr ? mpVertSdr->get() : 0;
+		mFragSID = mpFragSdr ? mpFragSdr->get() : 0;
+		if (!mVertSID || !mFragSID) return;
+		mProgId = glCreateProgram();
+		if (mProgId) {
+			glAttachShader(mProgId, mVertSID);
+			glAttachShader(mProgId, mFragSID);
+			OGLSys::link_prog_id_nock(mProgId);
+			mPending = true;
+		}
+	}
+
+	bool link_ready() const {
+		return !mPending || OGLSys::ck_prog_ready(mProgId);
+	}
+
+	bool link_end() {
+		if (!mPending) return is_valid();
+		mPending = false;
+		if (OGLSys::ck_link_status(mProgId)) {
+			prepare();
+			save_bin();
 		} else {
-			mProgId = OGLSys::link_draw_prog(mVertSID, mFragSID);
+			if (mpVertSdr) mpVertSdr->ck_status();
+			if (mpFragSdr) mpFragSdr->ck_status();
+			glDetachShader(mProgId, mVertSID);
+			glDetachShader(mProgId, mFragSID);
+			glDeleteProgram(mProgId);
+			mProgId = 0;
 		}
+		return is_valid();
+	}
 
-		prepare();
-		save_bin();
+	void init() {
+		if (!cache_load()) {
+			link_begin();
+			link_end();
+		}
 	}
 
 	void reset() {
+		mLazy = false;
+		mUsed = false;
+		mInManifest = false;
+		mPending = false;
 		if (!is_valid()) return;
 		glDetachShader(mProgId, mVertSID);
 		glDetachShader(mProgId, mFragSID);
@@ -759,11 +1217,18 @@ struct GPUProg {
 		return mVtxLink.Jnt >= 0;
 	}
 
+	bool is_inst() const {
+		return mVtxLink.IW0 >= 0;
+	}
+
 	void use() const {
 #if DRW_CACHE_PROGS
 		if (s_pNowProg != this) {
 			glUseProgram(mProgId);
 			s_pNowProg = this;
+			state_call();
+		} else {
+			state_skip();
 		}
 #else
 		glUseProgram(mProgId);
@@ -772,7 +1237,11 @@ struct GPUProg {
 
 	void save_bin() {
 		if (!is_valid()) return;
-		save_gpu_prog_bin(mProgId, mpVertName, mpFragName);
+		uint64_t srcHash = src_hash();
+		save_gpu_prog_bin(s_pGLSLBinSavePath, mProgId, mpVertName, mpFragName, srcHash);
+		if (s_pGLSLCachePath && srcHash) {
+			save_gpu_prog_bin(s_pGLSLCachePath, mProgId, mpVertName, mpFragName, srcHash);
+		}
 	}
 
 	void enable_attrs(const int minIdx, const size_t vtxSize = 0) const;
@@ -781,6 +1250,26 @@ struct GPUProg {
 		mVtxLink.disable_all();
 	}
 
+	void enable_inst_attrs() const {
+		const GLint iw[] = { mVtxLink.IW0, mVtxLink.IW1, mVtxLink.IW2 };
+		for (int i = 0; i < 3; ++i) {
+			if (iw[i] >= 0) {
+				glEnableVertexAttribArray(iw[i]);
+				glVertexAttribPointer(iw[i], 4, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(xt_xmtx), (const void*)(i * sizeof(xt_float4)));
+				OGLSys::vtx_attr_divisor(iw[i], 1);
+			}
+		}
+	}
+
+	void reset_inst_divisors() const {
+		const GLint iw[] = { mVtxLink.IW0, mVtxLink.IW1, mVtxLink.IW2 };
+		for (int i = 0; i < 3; ++i) {
+			if (iw[i] >= 0) {
+				OGLSys::vtx_attr_divisor(iw[i], 0);
+			}
+		}
+	}
+
 	void set_view_proj(const xt_mtx& m) {
 		mCache.mViewProj.set(mParamLink.ViewProj, m);
 	}
@@ -912,6 +1401,11 @@ struct GPUProg {
 		mCache.mShadowFade.set(mParamLink.ShadowFade, fade);
 	}
 
+	void set_shadow_cascades(const GPUShadowCascades& csc, const xt_float4& ctrl) {
+		mCache.mShadowCascade.set(mParamLink.ShadowCascade, csc);
+		mCache.mShadowCascadeCtrl.set(mParamLink.ShadowCascadeCtrl, ctrl);
+	}
+
 	void set_inv_white(const xt_float3& iw) {
 		mCache.mInvWhite.set(mParamLink.InvWhite, iw);
 	}
@@ -954,6 +1448,7 @@ void GPUProg::enable_attrs(const int minIdx, const size_t vtxSize) const {
 			case VtxFmt_prim: stride = sizeof(sxPrimVtx); break;
 			case VtxFmt_quad: stride = sizeof(float); break;
 			case VtxFmt_font: stride = sizeof(xt_float2); break;
+			case VtxFmt_text: stride = sizeof(TextVtx); break;
 			default: break;
 		}
 	}
@@ -1090,22 +1585,164 @@ void GPUProg::enable_attrs(const int minIdx, const size_t vtxSize) const {
 			}
 			break;
 
+		case VtxFmt_text:
+			if (mVtxLink.Pos >= 0) {
+				glEnableVertexAttribArray(mVtxLink.Pos);
+				glVertexAttribPointer(mVtxLink.Pos, 2, GL_FLOAT, GL_FALSE, stride, (const void*)(top + offsetof(TextVtx, pos)));
+			}
+			if (mVtxLink.Tex >= 0) {
+				glEnableVertexAttribArray(mVtxLink.Tex);
+				glVertexAttribPointer(mVtxLink.Tex, 2, GL_FLOAT, GL_FALSE, stride, (const void*)(top + offsetof(TextVtx, loc)));
+			}
+			if (mVtxLink.Prm >= 0) {
+				glEnableVertexAttribArray(mVtxLink.Prm);
+				glVertexAttribPointer(mVtxLink.Prm, 4, GL_FLOAT, GL_FALSE, stride, (const void*)(top + offsetof(TextVtx, clip)));
+			}
+			if (mVtxLink.Clr >= 0) {
+				glEnableVertexAttribArray(mVtxLink.Clr);
+				glVertexAttribPointer(mVtxLink.Clr, 4, GL_FLOAT, GL_FALSE, stride, (const void*)(top + offsetof(TextVtx, clr)));
+			}
+			break;
+
 		default:
 			break;
 	}
 }
 
-#define GPU_SHADER(_name, _kind) static GLuint s_sdr_##_name##_##_kind = 0;
+#define GPU_SHADER(_name, _kind) static GPUShader s_sdr_##_name##_##_kind = {};
 #include "ogl/shaders.inc"
 #undef GPU_SHADER
 
 #define GPU_PROG(_vert, _frag) static GPUProg s_prg_##_vert##_##_frag = {};
 #include "ogl/progs.inc"
+#include "ogl/progs_inst.inc"
 #undef GPU_PROG
 
+static GPUProg* s_ppProgs[] = {
+#define GPU_PROG(_vert, _frag) &s_prg_##_vert##_##_frag,
+#include "ogl/progs.inc"
+#include "ogl/progs_inst.inc"
+#undef GPU_PROG
+};
+
 static int s_prgCnt = 0;
 static int s_prgOK = 0;
 
+static void setup_progs() {
+#define GPU_PROG(_vert_name, _frag_name) { GPUProg* pProg = &s_prg_##_vert_name##_##_frag_name; pProg->mVtxFmt = VtxFmt_##_vert_name; pProg->mpVertSdr = &s_sdr_##_vert_name##_vert; pProg->mpFragSdr = &s_sdr_##_frag_name##_frag; pProg->mpVertName = #_vert_name; pProg->mpFragName = #_frag_name; }
+#include "ogl/progs.inc"
+#include "ogl/progs_inst.inc"
+#undef GPU_PROG
+}
+
+static bool prog_sys_ck(const GPUProg* pProg) {
+	return !ubo_shader_ck(pProg->mpVertName);
+}
+
+static GPUProg* find_prog(const char* pVertName, const char* pFragName) {
+	for (size_t i = 0; i < XD_ARY_LEN(s_ppProgs); ++i) {
+		GPUProg* pProg = s_ppProgs[i];
+		if (nxCore::str_eq(pProg->mpVertName, pVertName) && nxCore::str_eq(pProg->mpFragName, pFragName)) {
+			return pProg;
+		}
+	}
+	return nullptr;
+}
+
+/* manifest: "vert frag" per line, programs requested by prog_sel in previous runs */
+static int load_prog_manifest() {
+	int n = -1;
+	if (!s_pGLSLManifestPath) return n;
+	size_t size = 0;
+	char* pText = (char*)nxCore::raw_bin_load(s_pGLSLManifestPath, &size);
+	if (!pText) return n;
+	n = 0;
+	char names[2][64];
+	int iname = 0;
+	size_t len = 0;
+	for (size_t i = 0; i <= size; ++i) {
+		char c = i < size ? pText[i] : '\n';
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+			if (len > 0) {
+				names[iname][len] = 0;
+				len = 0;
+				++iname;
+				if (iname == 2) {
+					GPUProg* pProg = find_prog(names[0], names[1]);
+					if (pProg && !pProg->mInManifest) {
+						pProg->mInManifest = true;
+						++n;
+					}
+					iname = 0;
+				}
+			}
+			if (c == '\n') {
+				iname = 0;
+			}
+		} else if (len < sizeof(names[0]) - 1) {
+			names[iname][len++] = c;
+		}
+	}
+	nxCore::bin_unload(pText);
+	return n;
+}
+
+static void save_prog_manifest() {
+	if (!s_pGLSLManifestPath) return;
+	size_t size = 0;
+	for (size_t i = 0; i < XD_ARY_LEN(s_ppProgs); ++i) {
+		GPUProg* pProg = s_ppProgs[i];
+		if (pProg->mUsed || pProg->mInManifest) {
+			size += nxCore::str_len(pProg->mpVertName) + 1 + nxCore::str_len(pProg->mpFragName) + 1;
+		}
+	}
+	char* pText = size > 0 ? (char*)nxCore::mem_alloc(size, "GPUProg:manifest") : nullptr;
+	if (!pText) return;
+	char* pDst = pText;
+	for (size_t i = 0; i < XD_ARY_LEN(s_ppProgs); ++i) {
+		GPUProg* pProg = s_ppProgs[i];
+		if (pProg->mUsed || pProg->mInManifest) {
+			size_t vlen = nxCore::str_len(pProg->mpVertName);
+			size_t flen = nxCore::str_len(pProg->mpFragName);
+			nxCore::mem_copy(pDst, pProg->mpVertName, vlen);
+			pDst += vlen;
+			*pDst++ = ' ';
+			nxCore::mem_copy(pDst, pProg->mpFragName, flen);
+			pDst += flen;
+			*pDst++ = '\n';
+		}
+	}
+	nxCore::bin_save(s_pGLSLManifestPath, pText, size);
+	nxCore::mem_free(pText);
+}
+
+/* render thread only: batch_record never gets here, so record workers don't touch GL */
+static void prog_touch(GPUProg* pProg) {
+	pProg->mUsed = true;
+	if (pProg->mLazy) {
+		pProg->mLazy = false;
+		double t0 = nxSys::time_micros();
+		pProg->init();
+		s_pNowProg = nullptr;
+		if (pProg->is_valid()) {
+			++s_prgOK;
+		} else {
+			nxCore::dbg_msg("GPUProg init error: %s + %s\n", pProg->mpVertName, pProg->mpFragName);
+		}
+		if (s_glslEcho) {
+			nxCore::dbg_msg("GPUProg lazy link: %s + %s, %.3f millis\n", pProg->mpVertName, pProg->mpFragName, (nxSys::time_micros() - t0) / 1.0e3);
+		}
+	}
+}
+
+static void link_inst_progs() {
+#undef GPU_INST_PROG
+#define GPU_INST_PROG(_vert, _frag) s_prg_##_vert##_##_frag.mpInst = s_prg_##_vert##_inst_##_frag.mSkip ? nullptr : &s_prg_##_vert##_inst_##_frag;
+#include "ogl/progs_inst.inc"
+#undef GPU_INST_PROG
+#define GPU_INST_PROG(_vert, _frag) GPU_PROG(_vert##_inst, _frag)
+}
+
 
 static void prepare_texture(sxTextureData* pTex) {
 	if (!pTex) return;
@@ -1123,6 +1760,7 @@ static void prepare_texture(sxTextureData* pTex) {
 		}
 		def_tex_params(mipmapEnabled, pTex->lod_bias_enabled());
 		glBindTexture(GL_TEXTURE_2D, 0);
+		reset_tex_cache();
 	}
 }
 
@@ -1214,7 +1852,7 @@ static void release_model(sxModelData* pMdl) {
 	pMdl->clear_tex_wk();
 }
 
-static void batch_draw_exec(const sxModelData* pMdl, int ibat, int baseVtx = 0) {
+static void batch_draw_exec(const sxModelData* pMdl, int ibat, int baseVtx = 0, int ninst = 0) {
 	if (!pMdl) return;
 	const sxModelData::Batch* pBat = pMdl->get_batch_ptr(ibat);
 	if (!pBat) return;
@@ -1236,7 +1874,9 @@ static void batch_draw_exec(const sxModelData* pMdl, int ibat, int baseVtx = 0)
 		org = pBat->mIdxOrg * sizeof(uint32_t);
 		typ = GL_UNSIGNED_INT;
 	}
-	if (baseVtx > 0) {
+	if (ninst > 0) {
+		OGLSys::draw_tris_inst(pBat->mTriNum, typ, org, ninst);
+	} else if (baseVtx > 0) {
 		OGLSys::draw_tris_base_vtx(pBat->mTriNum, typ, org, baseVtx);
 	} else {
 		glDrawElements(GL_TRIANGLES, pBat->mTriNum * 3, typ, (const void*)org);
@@ -1260,6 +1900,9 @@ static void set_opaq() {
 	if (s_nowSemi) {
 		gl_opaq();
 		s_nowSemi = false;
+		state_call();
+	} else {
+		state_skip();
 	}
 #else
 	gl_opaq();
@@ -1271,6 +1914,9 @@ static void set_semi() {
 	if (!s_nowSemi) {
 		gl_semi();
 		s_nowSemi = true;
+		state_call();
+	} else {
+		state_skip();
 	}
 #else
 	gl_semi();
@@ -1294,6 +1940,9 @@ static void set_dbl_sided() {
 	if (!s_nowDblSided) {
 		gl_dbl_sided();
 		s_nowDblSided = true;
+		state_call();
+	} else {
+		state_skip();
 	}
 #else
 	gl_dbl_sided();
@@ -1305,6 +1954,9 @@ static void set_face_cull() {
 	if (s_nowDblSided) {
 		gl_face_cull();
 		s_nowDblSided = false;
+		state_call();
+	} else {
+		state_skip();
 	}
 #else
 	gl_face_cull();
@@ -1312,6 +1964,59 @@ static void set_face_cull() {
 	}
 
 
+static int s_nowDepthMask = -1;
+static int s_nowMSAA = -1;
+
+static void set_depth_mask(const bool flg) {
+#if DRW_CACHE_MISC
+	if (s_nowDepthMask == int(flg)) {
+		state_skip();
+		return;
+	}
+	s_nowDepthMask = int(flg);
+#endif
+	glDepthMask(flg ? GL_TRUE : GL_FALSE);
+	state_call();
+}
+
+static void set_msaa(const bool flg) {
+#if DRW_CACHE_MISC
+	if (s_nowMSAA == int(flg)) {
+		state_skip();
+		return;
+	}
+	s_nowMSAA = int(flg);
+#endif
+	OGLSys::enable_msaa(flg);
+	state_call();
+}
+
+static void bind_tex(const int unit, const GLuint htex) {
+#if DRW_CACHE_TEXS
+	if (s_nowTexValid[unit] && s_nowTex[unit] == htex) {
+		state_skip();
+		return;
+	}
+	if (s_nowTexUnit != unit) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		s_nowTexUnit = unit;
+	}
+	s_nowTex[unit] = htex;
+	s_nowTexValid[unit] = true;
+#else
+	glActiveTexture(GL_TEXTURE0 + unit);
+#endif
+	glBindTexture(GL_TEXTURE_2D, htex);
+	state_call();
+}
+
+static void reset_gl_state_cache() {
+	s_nowDepthMask = -1;
+	s_nowMSAA = -1;
+	reset_tex_cache();
+	reset_ubo_cache();
+}
+
 static void reset_fb_render_states() {
 	gl_opaq();
 	s_nowSemi = false;
@@ -1327,11 +2032,14 @@ static void set_def_framebuf(const bool useDepth = true) {
 		glViewport(0, 0, w, h);
 		glScissor(0, 0, w, h);
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-		glDepthMask(GL_TRUE);
+		set_depth_mask(true);
 		glEnable(GL_DEPTH_TEST);
 		glDepthFunc(GL_LEQUAL);
 		reset_fb_render_states();
 		s_frameBufMode = 0;
+		state_call();
+	} else {
+		state_skip();
 	}
 }
 
@@ -1339,23 +2047,49 @@ static void set_shadow_framebuf() {
 	if (s_shadowFBO) {
 		if (s_frameBufMode != 1) {
 			glBindFramebuffer(GL_FRAMEBUFFER, s_shadowFBO);
-			glViewport(0, 0, s_shadowSize, s_shadowSize);
-			glScissor(0, 0, s_shadowSize, s_shadowSize);
+			glViewport(0, 0, s_shadowW, s_shadowH);
+			glScissor(0, 0, s_shadowW, s_shadowH);
+			s_shadowViewport = -1;
 			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 			if (s_shadowDepthBuf && s_shadowCastDepthTest) {
-				glDepthMask(GL_TRUE);
+				set_depth_mask(true);
 				glEnable(GL_DEPTH_TEST);
 				glDepthFunc(GL_LEQUAL);
 			} else {
-				glDepthMask(GL_FALSE);
+				set_depth_mask(false);
 				glDisable(GL_DEPTH_TEST);
 			}
 			reset_fb_render_states();
 			s_frameBufMode = 1;
+			state_call();
+		} else {
+			state_skip();
 		}
 	}
 }
 
+static void set_shadow_viewport(const int tile) {
+	if (s_frameBufMode != 1) return;
+	if (s_shadowViewport != tile) {
+		int x = 0;
+		int y = 0;
+		int w = s_shadowW;
+		int h = s_shadowH;
+		if (tile >= 0) {
+			x = (tile & 1) * s_shadowSize;
+			y = (tile >> 1) * s_shadowSize;
+			w = s_shadowSize;
+			h = s_shadowSize;
+		}
+		glViewport(x, y, w, h);
+		glScissor(x, y, w, h);
+		s_shadowViewport = tile;
+		state_call();
+	} else {
+		state_skip();
+	}
+}
+
 static void set_screen_framebuf() {
 	if (s_frameBufMode != 2) {
 		int w = OGLSys::get_width();
@@ -1364,14 +2098,97 @@ static void set_screen_framebuf() {
 		glViewport(0, 0, w, h);
 		glScissor(0, 0, w, h);
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-		glDepthMask(GL_FALSE);
+		set_depth_mask(false);
 		glDisable(GL_DEPTH_TEST);
 		reset_fb_render_states();
 		s_frameBufMode = 2;
+		state_call();
+	} else {
+		state_skip();
 	}
 }
 
 
+static void init_shadow_fbo(const int w, const int h) {
+	s_shadowW = w;
+	s_shadowH = h;
+	glGenFramebuffers(1, &s_shadowFBO);
+	if (s_shadowFBO) {
+		glGenTextures(1, &s_shadowTex);
+		if (s_shadowTex) {
+			glBindFramebuffer(GL_FRAMEBUFFER, s_shadowFBO);
+			glBindTexture(GL_TEXTURE_2D, s_shadowTex);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, s_shadowTex, 0);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glGenRenderbuffers(1, &s_shadowDepthBuf);
+			if (s_shadowDepthBuf) {
+				glBindRenderbuffer(GL_RENDERBUFFER, s_shadowDepthBuf);
+				glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, w, h);
+				glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, s_shadowDepthBuf);
+			}
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+				glDeleteTextures(1, &s_shadowTex);
+				s_shadowTex = 0;
+				OGLSys::bind_def_framebuf();
+				if (s_shadowDepthBuf) {
+					glDeleteRenderbuffers(1, &s_shadowDepthBuf);
+					s_shadowDepthBuf = 0;
+				}
+				glDeleteFramebuffers(1, &s_shadowFBO);
+				s_shadowFBO = 0;
+			}
+		} else {
+			glDeleteFramebuffers(1, &s_shadowFBO);
+			s_shadowFBO = 0;
+		}
+	}
+}
+
+static void reset_shadow_fbo() {
+	OGLSys::bind_def_framebuf();
+	if (s_shadowDepthBuf) {
+		glDeleteRenderbuffers(1, &s_shadowDepthBuf);
+		s_shadowDepthBuf = 0;
+	}
+	if (s_shadowTex) {
+		glDeleteTextures(1, &s_shadowTex);
+		s_shadowTex = 0;
+	}
+	if (s_shadowFBO) {
+		glDeleteFramebuffers(1, &s_shadowFBO);
+		s_shadowFBO = 0;
+	}
+	s_shadowW = 0;
+	s_shadowH = 0;
+}
+
+/* cascades share one atlas of cascade-sized tiles: 2x1 for two, 2x2 for three or four */
+static int init_shadow_cascades(const int num) {
+	if (!s_shadowFBO || s_shadowSize <= 0) return 1;
+	int n = nxCalc::clamp(num, 1, int(Draw::SHADOW_CASCADES_MAX));
+	if (n == s_shadowCascadesMax) return n;
+	GLint maxSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	if (n > 1 && s_shadowSize * 2 > maxSize) {
+		n = 1;
+	}
+	reset_shadow_fbo();
+	init_shadow_fbo(s_shadowSize * (n > 1 ? 2 : 1), s_shadowSize * (n > 2 ? 2 : 1));
+	if (!s_shadowFBO && n > 1) {
+		n = 1;
+		init_shadow_fbo(s_shadowSize, s_shadowSize);
+	}
+	s_shadowCascadesMax = s_shadowFBO ? n : 1;
+	s_frameBufMode = -1;
+	set_def_framebuf();
+	return s_shadowCascadesMax;
+}
+
 static void init(int shadowSize, cxResourceManager* pRsrcMgr, Draw::Font* pFont) {
 	if (s_drwInitFlg) return;
 
@@ -1399,80 +2216,147 @@ static void init(int shadowSize, cxResourceManager* pRsrcMgr, Draw::Font* pFont)
 	s_useMipmaps = !nxApp::get_bool_opt("mip_disable", false);
 	s_useVtxLighting = nxApp::get_bool_opt("vl", false);
 
+#if DRW_USE_UBO
+	if (OGLSys::ext_ck_ubo() && nxApp::get_bool_opt("ubo", true)) {
+		GLint uboAlign = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlign);
+		s_uboAlign = uboAlign > 0 ? uint32_t(uboAlign) : 256;
+		glGenBuffers(1, &s_uboRing);
+		if (s_uboRing) {
+			ubo_orphan();
+		}
+	}
+#endif
+	s_uboShaders = s_uboRing != 0;
+
+	s_pGLSLCachePath = s_pGLSLBinLoadPath ? nullptr : nxApp::get_opt("glsl_cache");
+	s_pGLSLManifestPath = nxApp::get_opt("glsl_manifest");
+	s_glslAsync = OGLSys::ext_ck_parallel_compile() && nxApp::get_bool_opt("glsl_async", true);
+	if (s_glslAsync) {
+		OGLSys::set_compile_threads(0xFFFFFFFF);
+	}
+	init_drv_hash();
+
 	if (!s_pGLSLBinLoadPath) {
-#define GPU_SHADER(_name, _kind) s_sdr_##_name##_##_kind = load_shader(#_name "." #_kind);
+#define GPU_SHADER(_name, _kind) load_shader(&s_sdr_##_name##_##_kind, #_name "." #_kind);
 #include "ogl/shaders.inc"
 #undef GPU_SHADER
 	}
+	setup_progs();
+	/* rarely used permutations are linked on first use once a manifest tells which ones are needed */
+	int nmanifest = load_prog_manifest();
+	s_glslLazy = nmanifest > 0 && nxApp::get_bool_opt("glsl_lazy", true);
 
-	int prgCnt = 0;
+	int prgCnt = int(XD_ARY_LEN(s_ppProgs));
 	int prgOK = 0;
+	int prgLazy = 0;
+	int prgSkip = 0;
+	for (int i = 0; i < prgCnt; ++i) {
+		GPUProg* pProg = s_ppProgs[i];
+		/* instanced variants are optional: data packages without their vertex shaders just draw without instancing */
+		pProg->mSkip = !s_pGLSLBinLoadPath && !pProg->mpVertSdr->mpSrc && nxCore::str_ends_with(pProg->mpVertName, "_inst");
+		if (pProg->mSkip) {
+			pProg->mLazy = false;
+			++prgSkip;
+			continue;
+		}
+		pProg->mLazy = s_glslLazy && !pProg->mInManifest && !prog_sys_ck(pProg);
+		if (pProg->mLazy) {
+			++prgLazy;
+		}
+	}
 	if (s_glslEcho) {
 		nxCore::dbg_msg("Initializing GPU progs");
 	}
 	double prgT0 = nxSys::time_micros();
 	int linkMode = s_pGLSLBinLoadPath ? 1 : nxApp::get_int_opt("glsl_link_mode", 0);
 	if (linkMode == 1) {
-#		define GPU_PROG(_vert_name, _frag_name) s_prg_##_vert_name##_##_frag_name.init(VtxFmt_##_vert_name, s_sdr_##_vert_name##_vert, s_sdr_##_frag_name##_frag, #_vert_name, #_frag_name); ++prgCnt; if (s_prg_##_vert_name##_##_frag_name.is_valid()) {++prgOK; if (s_glslEcho) { nxCore::dbg_msg("."); } } else { nxCore::dbg_msg("GPUProg init error: %s + %s\n", #_vert_name, #_frag_name); }
-#		include "ogl/progs.inc"
-#		undef GPU_PROG
+		for (int i = 0; i < prgCnt; ++i) {
+			GPUProg* pProg = s_ppProgs[i];
+			if (pProg->mLazy || pProg->mSkip) continue;
+			pProg->init();
+			if (s_glslEcho && pProg->is_valid()) {
+				nxCore::dbg_msg(".");
+			}
+		}
 	} else {
-#		define GPU_PROG(_vert_name, _frag_name) ++prgCnt;
-#		include "ogl/progs.inc"
-#		undef GPU_PROG
-		s_prgCnt = prgCnt;
-		s_prgOK = 0;
-		if (prgCnt > 0) {
-			GPUProg** ppProg = (GPUProg**)nxCore::mem_alloc(sizeof(GPUProg*)*prgCnt, "GPUProgsList");
-			if (ppProg) {
-				int iprg = 0;
-#				define GPU_PROG(_vert_name, _frag_name) ppProg[iprg] = &s_prg_##_vert_name##_##_frag_name; ppProg[iprg]->mVtxFmt = VtxFmt_##_vert_name; ppProg[iprg]->mVertSID = s_sdr_##_vert_name##_vert; ppProg[iprg]->mFragSID = s_sdr_##_frag_name##_frag; ppProg[iprg]->mpVertName = #_vert_name; ppProg[iprg]->mpFragName = #_frag_name; ++iprg;
-#				include "ogl/progs.inc"
-#				undef GPU_PROG
-				for (iprg = 0; iprg < prgCnt; ++iprg) {
-					GPUProg* pProg = ppProg[iprg];
-					pProg->mProgId = glCreateProgram();
-					if (pProg->mProgId) {
-						glAttachShader(pProg->mProgId, pProg->mVertSID);
-						glAttachShader(pProg->mProgId, pProg->mFragSID);
-						OGLSys::link_prog_id_nock(pProg->mProgId);
-						if (s_glslEcho) {
-							nxCore::dbg_msg(".");
-						}
-					}
+		for (int i = 0; i < prgCnt; ++i) {
+			GPUProg* pProg = s_ppProgs[i];
+			if (!pProg->mLazy && !pProg->mSkip) {
+				pProg->cache_load();
+			}
+		}
+		/* issue everything before waiting on anything, manifest programs first */
+		int npending = 0;
+		for (int pass = 0; pass < 2; ++pass) {
+			for (int i = 0; i < prgCnt; ++i) {
+				GPUProg* pProg = s_ppProgs[i];
+				if (pProg->mLazy || pProg->mSkip || pProg->is_valid()) continue;
+				if (pProg->mInManifest != (pass == 0)) continue;
+				pProg->link_begin();
+				if (pProg->mPending) {
+					++npending;
 				}
-				for (iprg = 0; iprg < prgCnt; ++iprg) {
-					GPUProg* pProg = ppProg[iprg];
-					if (pProg->mProgId) {
-						if (OGLSys::ck_link_status(pProg->mProgId)) {
-							pProg->prepare();
-							pProg->save_bin();
-						} else {
-							glDetachShader(pProg->mProgId, pProg->mVertSID);
-							glDetachShader(pProg->mProgId, pProg->mFragSID);
-							glDeleteProgram(pProg->mProgId);
-							pProg->mProgId = 0;
-						}
-					}
-					if (pProg->is_valid()) {
-						++prgOK;
-					} else {
-						nxCore::dbg_msg("GPUProg init error: %s + %s\n", pProg->mpVertName, pProg->mpFragName);
+			}
+		}
+		while (npending > 0) {
+			GPUProg* pWait = nullptr;
+			int nready = 0;
+			for (int i = 0; i < prgCnt; ++i) {
+				GPUProg* pProg = s_ppProgs[i];
+				if (!pProg->mPending) continue;
+				if (pProg->link_ready()) {
+					pProg->link_end();
+					++nready;
+					if (s_glslEcho) {
+						nxCore::dbg_msg(".");
 					}
+				} else if (!pWait) {
+					pWait = pProg;
 				}
-				nxCore::mem_free(ppProg);
 			}
+			if (nready == 0 && pWait) {
+				pWait->link_end();
+				++nready;
+			}
+			npending -= nready;
+		}
+	}
+	for (int i = 0; i < prgCnt; ++i) {
+		GPUProg* pProg = s_ppProgs[i];
+		if (pProg->mLazy || pProg->mSkip) continue;
+		if (pProg->is_valid()) {
+			++prgOK;
+		} else {
+			nxCore::dbg_msg("GPUProg init error: %s + %s\n", pProg->mpVertName, pProg->mpFragName);
 		}
 	}
+	s_pNowProg = nullptr;
 	if (s_glslEcho) {
 		nxCore::dbg_msg("\n");
 	}
 	double prgDT = nxSys::time_micros() - prgT0;
+	prgCnt -= prgSkip;
+	s_prgCnt = prgCnt;
 	s_prgOK = prgOK;
-	nxCore::dbg_msg("GPU progs: %d/%d\n", prgOK, prgCnt);
+	if (prgLazy > 0) {
+		nxCore::dbg_msg("GPU progs: %d/%d (%d deferred)\n", prgOK, prgCnt, prgLazy);
+	} else {
+		nxCore::dbg_msg("GPU progs: %d/%d\n", prgOK, prgCnt);
+	}
 	if (s_glslEcho) {
 		nxCore::dbg_msg("GPU progs init time: %.3f seconds\n", prgDT / 1.0e6);
 	}
+	link_inst_progs();
+
+	if (DRW_USE_INST && OGLSys::ext_ck_instancing()) {
+		glGenBuffers(1, &s_instVBO);
+		if (s_instVBO) {
+			glBindBuffer(GL_ARRAY_BUFFER, s_instVBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(s_instXforms), nullptr, GL_STREAM_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+	}
 
 	glGenBuffers(1, &s_quadVBO);
 	glGenBuffers(1, &s_quadIBO);
@@ -1489,41 +2373,8 @@ static void init(int shadowSize, cxResourceManager* pRsrcMgr, Draw::Font* pFont)
 
 	if (shadowSize > 0) {
 		s_shadowSize = shadowSize;
-		glGenFramebuffers(1, &s_shadowFBO);
-		if (s_shadowFBO) {
-			glGenTextures(1, &s_shadowTex);
-			if (s_shadowTex) {
-				glBindFramebuffer(GL_FRAMEBUFFER, s_shadowFBO);
-				glBindTexture(GL_TEXTURE_2D, s_shadowTex);
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, s_shadowSize, s_shadowSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, s_shadowTex, 0);
-				glBindTexture(GL_TEXTURE_2D, 0);
-				glGenRenderbuffers(1, &s_shadowDepthBuf);
-				if (s_shadowDepthBuf) {
-					glBindRenderbuffer(GL_RENDERBUFFER, s_shadowDepthBuf);
-					glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, s_shadowSize, s_shadowSize);
-					glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, s_shadowDepthBuf);
-				}
-				if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-					glDeleteTextures(1, &s_shadowTex);
-					s_shadowTex = 0;
-					OGLSys::bind_def_framebuf();
-					if (s_shadowDepthBuf) {
-						glDeleteRenderbuffers(1, &s_shadowDepthBuf);
-						s_shadowDepthBuf = 0;
-					}
-					glDeleteFramebuffers(1, &s_shadowFBO);
-					s_shadowFBO = 0;
-				}
-			} else {
-				glDeleteFramebuffers(1, &s_shadowFBO);
-				s_shadowFBO = 0;
-			}
-		}
+		s_shadowCascadesMax = 1;
+		init_shadow_fbo(shadowSize, shadowSize);
 	}
 	s_shadowCastDepthTest = true;
 	s_frameBufMode = -1;
@@ -1541,9 +2392,23 @@ static void init(int shadowSize, cxResourceManager* pRsrcMgr, Draw::Font* pFont)
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * pFont->numTris * 3, pFont->pTris, GL_STATIC_DRAW);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 		}
+		if (s_prg_text_text.is_valid() && nxApp::get_bool_opt("text_batch", true)) {
+			s_pTextVtx = (TextVtx*)nxCore::mem_alloc(DRW_TEXT_MAX_VTX * sizeof(TextVtx), "Draw:TextVtx");
+			if (s_pTextVtx) {
+				s_textStrm.init(GL_ARRAY_BUFFER, DRW_TEXT_MAX_VTX * sizeof(TextVtx));
+				if (s_textStrm.is_valid()) {
+					s_textVtxMax = DRW_TEXT_MAX_VTX;
+				} else {
+					nxCore::mem_free(s_pTextVtx);
+					s_pTextVtx = nullptr;
+				}
+			}
+		}
+		s_textVtxNum = 0;
 	}
 
 	s_pNowProg = nullptr;
+	reset_gl_state_cache();
 
 	s_drwInitFlg = true;
 }
@@ -1551,30 +2416,22 @@ static void init(int shadowSize, cxResourceManager* pRsrcMgr, Draw::Font* pFont)
 static void reset() {
 	if (!s_drwInitFlg) return;
 
-	OGLSys::bind_def_framebuf();
+	reset_shadow_fbo();
+	s_shadowSize = 0;
+	s_shadowCascadesMax = 1;
 
-	if (s_shadowDepthBuf) {
-		glDeleteRenderbuffers(1, &s_shadowDepthBuf);
-		s_shadowDepthBuf = 0;
-	}
-	if (s_shadowTex) {
-		glDeleteTextures(1, &s_shadowTex);
-		s_shadowTex = 0;
-	}
-	if (s_shadowFBO) {
-		glDeleteFramebuffers(1, &s_shadowFBO);
-		s_shadowFBO = 0;
-	}
-
-	if (s_primVBO) {
-		glDeleteBuffers(1, &s_primVBO);
-		s_primVBO = 0;
+	s_primVtxStrm.reset();
+	s_primIdxStrm.reset();
+	if (s_pPrimVtx) {
+		nxCore::mem_free(s_pPrimVtx);
+		s_pPrimVtx = nullptr;
 		s_maxPrimVtx = 0;
 	}
 
-	if (s_primIBO) {
-		glDeleteBuffers(1, &s_primIBO);
-		s_primIBO = 0;
+	if (s_pPrimIdx) {
+		nxCore::mem_free(s_pPrimIdx);
+		s_pPrimIdx = nullptr;
+		s_pPrimIdxTmp = nullptr;
 		s_maxPrimIdx = 0;
 	}
 
@@ -1596,17 +2453,44 @@ static void reset() {
 		s_fontVBO = 0;
 	}
 
+	s_textStrm.reset();
+	if (s_pTextVtx) {
+		nxCore::mem_free(s_pTextVtx);
+		s_pTextVtx = nullptr;
+	}
+	s_textVtxNum = 0;
+	s_textVtxMax = 0;
+
+	if (s_instVBO) {
+		glDeleteBuffers(1, &s_instVBO);
+		s_instVBO = 0;
+	}
+
+	if (s_uboRing) {
+		glDeleteBuffers(1, &s_uboRing);
+		s_uboRing = 0;
+	}
+	s_uboShaders = false;
+
 	s_pFont = nullptr;
 
+	save_prog_manifest();
+	s_pGLSLManifestPath = nullptr;
+	s_pGLSLCachePath = nullptr;
+	s_glslLazy = false;
+	s_glslAsync = false;
+
 #define GPU_PROG(_vert_name, _frag_name) s_prg_##_vert_name##_##_frag_name.reset();
 #include "ogl/progs.inc"
+#include "ogl/progs_inst.inc"
 #undef GPU_PROG
 
-#define GPU_SHADER(_name, _kind) glDeleteShader(s_sdr_##_name##_##_kind); s_sdr_##_name##_##_kind = 0;
+#define GPU_SHADER(_name, _kind) s_sdr_##_name##_##_kind.reset();
 #include "ogl/shaders.inc"
 #undef GPU_SHADER
 
 	s_pNowProg = nullptr;
+	reset_gl_state_cache();
 
 	s_drwInitFlg = false;
 }
@@ -1638,6 +2522,11 @@ static void clear_shadow() {
 }
 
 static void begin(const cxColor& clearColor) {
+	s_frameStateCalls = s_stateCalls;
+	s_frameStateSkips = s_stateSkips;
+	s_stateCalls = 0;
+	s_stateSkips = 0;
+	reset_gl_state_cache();
 	s_frameBufMode = -1;
 	set_shadow_framebuf();
 	clear_shadow();
@@ -1651,10 +2540,14 @@ static void begin(const cxColor& clearColor) {
 }
 
 static void end() {
+	text_flush();
+	s_textStrm.frame_end();
+	s_primVtxStrm.frame_end();
+	s_primIdxStrm.frame_end();
 	OGLSys::swap();
 }
 
-static GPUProg* prog_sel(const cxModelWork* pWk, const int ibat, const sxModelData::Material* pMtl, const Draw::Mode mode, const Draw::Context* pCtx) {
+static GPUProg* prog_sel(const cxModelWork* pWk, const int ibat, const sxModelData::Material* pMtl, const Draw::Mode mode, const Draw::Context* pCtx, const Draw::BatchPacket* pRec = nullptr) {
 	GPUProg* pProg = nullptr;
 	sxModelData* pMdl = pWk->mpData;
 	if (mode == Draw::DRWMODE_SHADOW_CAST) {
@@ -1690,7 +2583,7 @@ static GPUProg* prog_sel(const cxModelWork* pWk, const int ibat, const sxModelDa
 			}
 		}
 	} else {
-		bool recvFlg = pMtl->mFlags.shadowRecv && (s_shadowFBO != 0) && (s_shadowCastCnt > 0) && (pCtx->shadow.get_density() > 0.0f);
+		bool recvFlg = pMtl->mFlags.shadowRecv && (s_shadowFBO != 0) && (pRec || s_shadowCastCnt > 0) && (pCtx->shadow.get_density() > 0.0f);
 		bool specFlg = pCtx->glb.useSpec && pCtx->spec.mEnabled && pMtl->mFlags.baseMapSpecAlpha;
 		if (recvFlg) {
 			if (pWk->mBoundsValid && pWk->mpBatBBoxes) {
@@ -1701,7 +2594,10 @@ static GPUProg* prog_sel(const cxModelWork* pWk, const int ibat, const sxModelDa
 		if (!s_useVtxLighting && pCtx->glb.useBump && OGLSys::ext_ck_derivatives()) {
 			if (pMtl->mBumpScale > 0.0f) {
 				int tid = pMtl->mBumpTexId;
-				if (tid >= 0) {
+				if (pRec) {
+					/* record workers don't read the handle cache the render thread fills */
+					bumpFlg = pRec->pBumpTex != nullptr;
+				} else if (tid >= 0) {
 					sxModelData::TexInfo* pTexInfo = pMdl->get_tex_info(tid);
 					GLuint* pTexHandle = pTexInfo->get_wk<GLuint>();
 					if (*pTexHandle == 0) {
@@ -1980,6 +2876,9 @@ static GPUProg* prog_sel(const cxModelWork* pWk, const int ibat, const sxModelDa
 			}
 		}
 	}
+	if (pProg && !pRec) {
+		prog_touch(pProg);
+	}
 	return pProg;
 }
 
@@ -2035,21 +2934,8 @@ static GLuint get_surf_tex_handle(cxModelWork* pWk, const sxModelData::Material*
 
 #define HAS_PARAM(_name) (pProg->mParamLink._name >= 0)
 
-static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const Draw::Context* pCtx) {
-	float ftmp[NFLT_JMTX > NFLT_JMAP ? NFLT_JMTX : NFLT_JMAP];
-
-	if (!pCtx) return;
-
-	if (!pWk) return;
+static const sxModelData::Material* get_batch_mtl(const cxModelWork* pWk, const int ibat) {
 	sxModelData* pMdl = pWk->mpData;
-	if (!pMdl) return;
-	if (!pMdl->ck_batch_id(ibat)) return;
-
-	Draw::MdlParam* pParam = (Draw::MdlParam*)pWk->mpParamMem;
-
-	bool isShadowCast = (mode == Draw::DRWMODE_SHADOW_CAST);
-	bool isDiscard = (mode == Draw::DRWMODE_DISCARD);
-
 	const sxModelData::Batch* pBat = pMdl->get_batch_ptr(ibat);
 	const sxModelData::Material* pMtl = pMdl->get_material(pBat->mMtlId);
 	if (pWk->mVariation != 0) {
@@ -2060,55 +2946,227 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 			}
 		}
 	}
-	if (!pMtl) return;
+	return pMtl;
+}
 
-	if (!isShadowCast && pParam && pParam->pExtIfc) {
-		if (pParam->pExtIfc->draw_batch) {
-			prepare_model(pMdl);
-			set_def_framebuf();
-			OGLSys::enable_msaa(true);
-			if (isDiscard && !pMtl->mFlags.forceBlend) {
-				set_opaq();
-			} else {
-				if (pMtl->mFlags.alpha) {
-					set_semi();
-				} else {
-					set_opaq();
-				}
-			}
-			if (pMtl->mFlags.dblSided) {
-				set_dbl_sided();
+static sxTextureData* find_batch_tex(const cxModelWork* pWk, const int tid) {
+	if (!s_pRsrcMgr || tid < 0) return nullptr;
+	return pWk->find_texture(s_pRsrcMgr, pWk->mpData->get_tex_name(tid));
+}
+
+static uint32_t ptr_key(const void* p, const int nbits) {
+	return (uint32_t(uintptr_t(p) >> 4) * 0x9E3779B1U) >> (32 - nbits);
+}
+
+/*
+  record: called from record workers, textures come from the resource manager and programs are left for replay to link;
+  otherwise the cached handles are used at replay, as batch() always did
+*/
+static bool batch_resolve(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const Draw::Context* pCtx, Draw::BatchPacket* pPkt, const bool record) {
+	if (!pCtx || !pWk || !pPkt) return false;
+	sxModelData* pMdl = pWk->mpData;
+	if (!pMdl) return false;
+	if (!pMdl->ck_batch_id(ibat)) return false;
+	const sxModelData::Material* pMtl = get_batch_mtl(pWk, ibat);
+	if (!pMtl) return false;
+	Draw::MdlParam* pParam = (Draw::MdlParam*)pWk->mpParamMem;
+	bool isShadowCast = (mode == Draw::DRWMODE_SHADOW_CAST);
+	bool isDiscard = (mode == Draw::DRWMODE_DISCARD);
+	pPkt->pWk = pWk;
+	pPkt->pMtl = pMtl;
+	pPkt->pExtIfc = nullptr;
+	pPkt->prog = 0;
+	pPkt->pBaseTex = nullptr;
+	pPkt->pBumpTex = nullptr;
+	pPkt->pSurfTex = nullptr;
+	pPkt->ibat = ibat;
+	pPkt->mode = mode;
+	bool extFlg = !isShadowCast && pParam && pParam->pExtIfc && pParam->pExtIfc->draw_batch;
+	if (record) {
+		pPkt->pBaseTex = find_batch_tex(pWk, pMtl->mBaseTexId);
+		if (!isShadowCast && (extFlg || pMtl->mBumpScale > 0.0f)) {
+			pPkt->pBumpTex = find_batch_tex(pWk, pMtl->mBumpTexId);
+		}
+		if (extFlg) {
+			pPkt->pSurfTex = find_batch_tex(pWk, pMtl->mSurfTexId);
+		}
+	}
+	uint32_t progKey = 0xFFF;
+	if (extFlg) {
+		pPkt->pExtIfc = pParam->pExtIfc;
+	} else {
+		GPUProg* pProg = prog_sel(pWk, ibat, pMtl, mode, pCtx, record ? pPkt : nullptr);
+		if (!pProg) return false;
+		pPkt->prog = (uintptr_t)pProg;
+		progKey = ptr_key(pProg, 11);
+	}
+
+	float swght = pMtl->mShadowWght;
+	if (pParam) {
+		swght += pParam->shadowWeightBias;
+	}
+	if (swght > 0.0f) {
+		swght = nxCalc::max(swght + pCtx->shadow.mWghtBias, 1.0f);
+	}
+	float soffs = pMtl->mShadowOffs + pCtx->shadow.mOffsBias;
+	if (pParam) {
+		soffs += pParam->shadowOffsBias;
+	}
+	float sdens = pMtl->mShadowDensity * pCtx->shadow.get_density();
+	if (pParam) {
+		sdens *= nxCalc::saturate(pParam->shadowDensScl);
+	}
+	pPkt->shadowCtrl.set(soffs, swght, sdens, 0.0f);
+
+	pPkt->baseColor = pMtl->mBaseColor;
+	if (pParam) {
+		for (int i = 0; i < 3; ++i) {
+			pPkt->baseColor[i] *= pParam->baseColorScl[i];
+		}
+	}
+
+	float alphaLim = isShadowCast ? pMtl->mShadowAlphaLim : pMtl->mAlphaLim;
+	if (isDiscard) {
+		if (alphaLim <= 0.0f) {
+			alphaLim = pMtl->mShadowAlphaLim;
+		}
+	}
+	pPkt->alphaLim = alphaLim;
+
+	pPkt->key = (progKey << 20) | ptr_key(pPkt->pBaseTex, 20);
+	return true;
+}
+
+static GLuint get_pkt_base_tex_handle(const Draw::BatchPacket* pPkt) {
+	GLuint htex = pPkt->pBaseTex ? get_tex_handle(pPkt->pBaseTex) : get_base_tex_handle(pPkt->pWk, pPkt->pMtl);
+	if (!htex) {
+		htex = OGLSys::get_white_tex();
+	}
+	return htex;
+}
+
+static bool batch_record(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const Draw::Context* pCtx, Draw::BatchPacket* pPkt) {
+	return batch_resolve(pWk, ibat, mode, pCtx, pPkt, true);
+}
+
+static void bind_frame_blk(const Draw::Context* pCtx, const bool isShadowCast) {
+	GPUFrameBlk blk;
+	nxCore::mem_zero(&blk, sizeof(blk));
+	blk.viewProj = isShadowCast ? pCtx->shadow.get_cast_view_proj() : pCtx->view.mViewProjMtx;
+	blk.shadowMtx = pCtx->shadow.mMtx;
+	ubo_f3(blk.viewPos, pCtx->view.mPos);
+	ubo_f3(blk.hemiUp, pCtx->hemi.mUp);
+	ubo_f3(blk.hemiUpper, pCtx->hemi.mUpper);
+	ubo_f3(blk.hemiLower, pCtx->hemi.mLower);
+	blk.hemiParam.set(pCtx->hemi.mExp, pCtx->hemi.mGain, 0.0f, 0.0f);
+	ubo_f3(blk.specLightDir, pCtx->spec.mDir);
+	nxCore::mem_copy(blk.specLightColor, pCtx->spec.mClr, sizeof(xt_float3));
+	blk.specLightColor.w = pCtx->spec.mShadowing;
+	blk.vtxHemiUp = blk.hemiUp;
+	blk.vtxHemiUpper = blk.hemiUpper;
+	blk.vtxHemiLower = blk.hemiLower;
+	blk.vtxHemiParam = blk.hemiParam;
+	shadow_size_param(blk.shadowSize);
+	GPUShadowCascades csc;
+	shadow_cascade_params(pCtx, csc, blk.shadowCascadeCtrl);
+	nxCore::mem_copy(blk.shadowCascade, csc.xform, sizeof(csc.xform));
+	blk.shadowFade.set(pCtx->shadow.mFadeStart, nxCalc::rcp0(pCtx->shadow.mFadeEnd - pCtx->shadow.mFadeStart), 0.0f, 0.0f);
+	blk.fogColor = pCtx->fog.mColor;
+	blk.fogParam = pCtx->fog.mParam;
+	ubo_f3(blk.invWhite, pCtx->cc.mToneMap.get_inv_white());
+	ubo_f3(blk.lclrGain, pCtx->cc.mToneMap.mLinGain);
+	ubo_f3(blk.lclrBias, pCtx->cc.mToneMap.mLinBias);
+	ubo_f3(blk.exposure, pCtx->cc.mExposure);
+	ubo_f3(blk.invGamma, pCtx->cc.get_inv_gamma());
+	int ipass = isShadowCast ? 1 : 0;
+	if (!s_frameBlkValid[ipass] || ::memcmp(&blk, &s_frameBlk[ipass], sizeof(blk)) != 0) {
+		s_frameBlk[ipass] = blk;
+		s_frameBlkOffs[ipass] = ubo_put(&blk, sizeof(blk));
+		s_frameBlkValid[ipass] = true;
+	}
+	ubo_bind(DRW_UBO_FRAME, s_frameBlkOffs[ipass], sizeof(blk));
+}
+
+static void batch_replay_impl(const Draw::BatchPacket* pPkt, const Draw::Context* pCtx, const int ninst) {
+	float ftmp[NFLT_JMTX > NFLT_JMAP ? NFLT_JMTX : NFLT_JMAP];
+
+	if (!pCtx || !pPkt) return;
+
+	text_flush();
+
+	cxModelWork* pWk = pPkt->pWk;
+	sxModelData* pMdl = pWk->mpData;
+	int ibat = pPkt->ibat;
+	Draw::Mode mode = pPkt->mode;
+
+	bool isShadowCast = (mode == Draw::DRWMODE_SHADOW_CAST);
+	bool isDiscard = (mode == Draw::DRWMODE_DISCARD);
+
+	const sxModelData::Batch* pBat = pMdl->get_batch_ptr(ibat);
+	const sxModelData::Material* pMtl = pPkt->pMtl;
+
+	if (pPkt->pExtIfc) {
+		prepare_model(pMdl);
+		set_def_framebuf();
+		set_msaa(true);
+		if (isDiscard && !pMtl->mFlags.forceBlend) {
+			set_opaq();
+		} else {
+			if (pMtl->mFlags.alpha) {
+				set_semi();
 			} else {
-				set_face_cull();
+				set_opaq();
 			}
-			Draw::MtlContext mtlCtx;
-			mtlCtx.pMtl = pMtl;
-			mtlCtx.baseTex = (uintptr_t)get_base_tex_handle(pWk, pMtl);
-			mtlCtx.bumpTex = (uintptr_t)get_bump_tex_handle(pWk, pMtl);
-			mtlCtx.surfTex = (uintptr_t)get_surf_tex_handle(pWk, pMtl);
-			mtlCtx.shadowTex = (uintptr_t)s_shadowTex;
-			pParam->pExtIfc->draw_batch(pWk, ibat, mode, pCtx, mtlCtx);
-			return;
 		}
+		if (pMtl->mFlags.dblSided) {
+			set_dbl_sided();
+		} else {
+			set_face_cull();
+		}
+		Draw::MtlContext mtlCtx;
+		mtlCtx.pMtl = pMtl;
+		mtlCtx.baseTex = (uintptr_t)get_pkt_base_tex_handle(pPkt);
+		mtlCtx.bumpTex = (uintptr_t)(pPkt->pBumpTex ? get_tex_handle(pPkt->pBumpTex) : get_bump_tex_handle(pWk, pMtl));
+		mtlCtx.surfTex = (uintptr_t)(pPkt->pSurfTex ? get_tex_handle(pPkt->pSurfTex) : get_surf_tex_handle(pWk, pMtl));
+		mtlCtx.shadowTex = (uintptr_t)s_shadowTex;
+		pPkt->pExtIfc->draw_batch(pWk, ibat, mode, pCtx, mtlCtx);
+		/* external batches bind their own programs and textures */
+		s_pNowProg = nullptr;
+		reset_gl_state_cache();
+		return;
 	}
 
-	GPUProg* pProg = prog_sel(pWk, ibat, pMtl, mode, pCtx);
+	GPUProg* pProg = (GPUProg*)pPkt->prog;
+	if (pProg && ninst > 0) {
+		pProg = pProg->mpInst;
+	}
 	if (!pProg) return;
+	prog_touch(pProg);
 	if (!pProg->is_valid()) return;
 
 	if (isShadowCast) {
 		set_shadow_framebuf();
-		OGLSys::enable_msaa(false);
+		set_shadow_viewport(pCtx->shadow.mCascadeNum > 1 ? pCtx->shadow.mCascade : -1);
+		set_msaa(false);
 	} else {
 		set_def_framebuf();
-		OGLSys::enable_msaa(true);
+		set_msaa(true);
 	}
 
 	prepare_model(pMdl);
 
 	pProg->use();
 
-	pProg->set_view_proj(isShadowCast ? pCtx->shadow.mViewProjMtx : pCtx->view.mViewProjMtx);
+	if (pProg->mFrameBlk >= 0) {
+		bind_frame_blk(pCtx, isShadowCast);
+	}
+	GPUMtlBlk mtlBlk;
+	bool useMtlBlk = pProg->mMtlBlk >= 0;
+	if (useMtlBlk) {
+		nxCore::mem_zero(&mtlBlk, sizeof(mtlBlk));
+	}
+
+	pProg->set_view_proj(isShadowCast ? pCtx->shadow.get_cast_view_proj() : pCtx->view.mViewProjMtx);
 	pProg->set_view_pos(pCtx->view.mPos);
 
 	if (HAS_PARAM(World)) {
@@ -2127,7 +3185,7 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 		for (int i = 0; i < pBat->mJntNum; ++i) {
 			pSkin[i] = pWk->mpSkinXforms[pJntLst[i]];
 		}
-		glUniform4fv(pProg->mParamLink.SkinMtx, JMTX_SIZE, (const GLfloat*)pSkin);
+		pProg->mCache.mSkinMtx.set(pProg->mParamLink.SkinMtx, JMTX_SIZE, (const GLfloat*)pSkin);
 	}
 
 	if (HAS_PARAM(SkinMap)) {
@@ -2144,9 +3202,9 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 #if DRW_LIMIT_JMAP
 			int njmax = pJntLst[njnt - 1] + 1;
 			int nv = (njmax >> 2) + ((njmax & 3) != 0 ? 1 : 0);
-			glUniform4fv(pProg->mParamLink.SkinMap, nv, ftmp);
+			pProg->mCache.mSkinMap.set(pProg->mParamLink.SkinMap, nv, ftmp);
 #else
-			glUniform4fv(pProg->mParamLink.SkinMap, JMAP_SIZE, ftmp);
+			pProg->mCache.mSkinMap.set(pProg->mParamLink.SkinMap, JMAP_SIZE, ftmp);
 #endif
 		}
 	}
@@ -2190,35 +3248,21 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 	pProg->set_shadow_mtx(pCtx->shadow.mMtx);
 
 	if (HAS_PARAM(ShadowSize)) {
-		float ss = float(s_shadowSize);
 		xt_float4 shadowSize;
-		shadowSize.set(ss, ss, nxCalc::rcp0(ss), nxCalc::rcp0(ss));
+		shadow_size_param(shadowSize);
 		pProg->set_shadow_size(shadowSize);
 	}
 
-	if (HAS_PARAM(ShadowCtrl)) {
-		xt_float4 shadowCtrl;
-
-		float swght = pMtl->mShadowWght;
-		if (pParam) {
-			swght += pParam->shadowWeightBias;
-		}
-		if (swght > 0.0f) {
-			swght = nxCalc::max(swght + pCtx->shadow.mWghtBias, 1.0f);
-		}
-
-		float soffs = pMtl->mShadowOffs + pCtx->shadow.mOffsBias;
-		if (pParam) {
-			soffs += pParam->shadowOffsBias;
-		}
-
-		float sdens = pMtl->mShadowDensity * pCtx->shadow.get_density();
-		if (pParam) {
-			sdens *= nxCalc::saturate(pParam->shadowDensScl);
-		}
+	if (HAS_PARAM(ShadowCascadeCtrl)) {
+		GPUShadowCascades csc;
+		xt_float4 cscCtrl;
+		shadow_cascade_params(pCtx, csc, cscCtrl);
+		pProg->set_shadow_cascades(csc, cscCtrl);
+	}
 
-		shadowCtrl.set(soffs, swght, sdens, 0.0f);
-		pProg->set_shadow_ctrl(shadowCtrl);
+	if (HAS_PARAM(ShadowCtrl) || useMtlBlk) {
+		pProg->set_shadow_ctrl(pPkt->shadowCtrl);
+		mtlBlk.shadowCtrl = pPkt->shadowCtrl;
 	}
 
 	if (HAS_PARAM(ShadowFade)) {
@@ -2227,42 +3271,45 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 		pProg->set_shadow_fade(shadowFade);
 	}
 
-	if (HAS_PARAM(BaseColor)) {
-		xt_float3 baseClr = pMtl->mBaseColor;
-		if (pParam) {
-			for (int i = 0; i < 3; ++i) {
-				baseClr[i] *= pParam->baseColorScl[i];
-			}
-		}
-		pProg->set_base_color(baseClr);
+	if (HAS_PARAM(BaseColor) || useMtlBlk) {
+		pProg->set_base_color(pPkt->baseColor);
+		ubo_f3(mtlBlk.baseColor, pPkt->baseColor);
 	}
 
 	pProg->set_spec_color(pMtl->mSpecColor);
+	if (useMtlBlk) {
+		ubo_f3(mtlBlk.specColor, pMtl->mSpecColor);
+	}
 
-	if (HAS_PARAM(SurfParam)) {
+	if (HAS_PARAM(SurfParam) || useMtlBlk) {
 		xt_float4 sprm;
 		sprm.set(pMtl->mRoughness, pMtl->mFresnel, 0.0f, 0.0f);
 		pProg->set_surf_param(sprm);
+		mtlBlk.surfParam = sprm;
 	}
 
-	if (HAS_PARAM(BumpParam)) {
+	if (HAS_PARAM(BumpParam) || useMtlBlk) {
 		xt_float4 bprm;
 		float sclT = pMtl->mFlags.flipTangent ? -1.0f : 1.0f;
 		float sclB = -(pMtl->mFlags.flipBitangent ? -1.0f : 1.0f);
 		bprm.set(pMtl->mBumpScale, sclT, sclB, 0.0f);
 		pProg->set_bump_param(bprm);
+		mtlBlk.bumpParam = bprm;
 	}
 
-	if (HAS_PARAM(AlphaCtrl)) {
-		float alphaLim = isShadowCast ? pMtl->mShadowAlphaLim : pMtl->mAlphaLim;
-		if (isDiscard) {
-			if (alphaLim <= 0.0f) {
-				alphaLim = pMtl->mShadowAlphaLim;
-			}
-		}
+	if (HAS_PARAM(AlphaCtrl) || useMtlBlk) {
 		xt_float3 alphaCtrl;
-		alphaCtrl.set(alphaLim, 0.0f, 0.0f);
+		alphaCtrl.set(pPkt->alphaLim, 0.0f, 0.0f);
 		pProg->set_alpha_ctrl(alphaCtrl);
+		ubo_f3(mtlBlk.alphaCtrl, alphaCtrl);
+	}
+
+	if (useMtlBlk) {
+		ubo_bind(DRW_UBO_MTL, ubo_put(&mtlBlk, sizeof(mtlBlk)), sizeof(mtlBlk));
+		/* the put above may have orphaned the ring under the frame range bound earlier, write it again */
+		if (pProg->mFrameBlk >= 0 && !s_frameBlkValid[isShadowCast ? 1 : 0]) {
+			bind_frame_blk(pCtx, isShadowCast);
+		}
 	}
 
 	pProg->set_fog_color(pCtx->fog.mColor);
@@ -2275,12 +3322,16 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 	pProg->set_inv_gamma(pCtx->cc.get_inv_gamma());
 
 	if (pProg->mSmpLink.Base >= 0) {
-		GLuint htex = get_base_tex_handle(pWk, pMtl);
-		glActiveTexture(GL_TEXTURE0 + Draw::TEXUNIT_Base);
-		glBindTexture(GL_TEXTURE_2D, htex);
+		GLuint htex = get_pkt_base_tex_handle(pPkt);
+		bind_tex(Draw::TEXUNIT_Base, htex);
 	}
 
-	if (pProg->mSmpLink.Bump >= 0 && s_pRsrcMgr) {
+	if (pProg->mSmpLink.Bump >= 0 && pPkt->pBumpTex) {
+		GLuint htex = get_tex_handle(pPkt->pBumpTex);
+		if (htex) {
+			bind_tex(Draw::TEXUNIT_Bump, htex);
+		}
+	} else if (pProg->mSmpLink.Bump >= 0 && s_pRsrcMgr) {
 		int tid = pMtl->mBumpTexId;
 		if (tid >= 0) {
 			sxModelData::TexInfo* pTexInfo = pMdl->get_tex_info(tid);
@@ -2291,15 +3342,13 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 				*pTexHandle = get_tex_handle(pTex);
 			}
 			if (*pTexHandle) {
-				glActiveTexture(GL_TEXTURE0 + Draw::TEXUNIT_Bump);
-				glBindTexture(GL_TEXTURE_2D, *pTexHandle);
+				bind_tex(Draw::TEXUNIT_Bump, *pTexHandle);
 			}
 		}
 	}
 
 	if (pProg->mSmpLink.Shadow >= 0) {
-		glActiveTexture(GL_TEXTURE0 + Draw::TEXUNIT_Shadow);
-		glBindTexture(GL_TEXTURE_2D, s_shadowTex);
+		bind_tex(Draw::TEXUNIT_Shadow, s_shadowTex);
 	}
 
 	if (isShadowCast || (isDiscard && !pMtl->mFlags.forceBlend)) {
@@ -2321,16 +3370,33 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 	GLuint* pBufIds = pMdl->get_gpu_wk<GLuint>();
 	GLuint bufVB = pBufIds[0];
 	if (!bufVB) return;
+	if (ninst > 0) {
+		if (!s_instVBO) return;
+		glBindBuffer(GL_ARRAY_BUFFER, s_instVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(s_instXforms), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, ninst * sizeof(xt_xmtx), s_instXforms);
+	}
 	if (pProg->mVAO) {
 		OGLSys::bind_vao(pProg->mVAO);
 		glBindBuffer(GL_ARRAY_BUFFER, bufVB);
 		pProg->enable_attrs(pBat->mMinIdx, pMdl->get_vtx_size());
-		batch_draw_exec(pMdl, ibat);
+		if (ninst > 0) {
+			glBindBuffer(GL_ARRAY_BUFFER, s_instVBO);
+			pProg->enable_inst_attrs();
+		}
+		batch_draw_exec(pMdl, ibat, 0, ninst);
 		OGLSys::bind_vao(0);
 	} else {
 		glBindBuffer(GL_ARRAY_BUFFER, bufVB);
 		pProg->enable_attrs(pBat->mMinIdx, pMdl->get_vtx_size());
-		batch_draw_exec(pMdl, ibat);
+		if (ninst > 0) {
+			glBindBuffer(GL_ARRAY_BUFFER, s_instVBO);
+			pProg->enable_inst_attrs();
+		}
+		batch_draw_exec(pMdl, ibat, 0, ninst);
+		if (ninst > 0) {
+			pProg->reset_inst_divisors();
+		}
 		pProg->disable_attrs();
 	}
 
@@ -2341,9 +3407,69 @@ static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const
 	}
 }
 
+static void batch(cxModelWork* pWk, const int ibat, const Draw::Mode mode, const Draw::Context* pCtx) {
+	Draw::BatchPacket pkt;
+	if (batch_resolve(pWk, ibat, mode, pCtx, &pkt, false)) {
+		batch_replay_impl(&pkt, pCtx, 0);
+	}
+}
+
+static void batch_replay(const Draw::BatchPacket* pPkt, const Draw::Context* pCtx) {
+	batch_replay_impl(pPkt, pCtx, 0);
+}
+
+static bool inst_compatible(const Draw::BatchPacket* pPkt0, const Draw::BatchPacket* pPkt) {
+	if (!pPkt || pPkt->pWk->mpData != pPkt0->pWk->mpData) return false;
+	if (pPkt->ibat != pPkt0->ibat || pPkt->mode != pPkt0->mode) return false;
+	if (pPkt->pMtl != pPkt0->pMtl || pPkt->prog != pPkt0->prog || pPkt->pExtIfc != pPkt0->pExtIfc) return false;
+	if (pPkt->pBaseTex != pPkt0->pBaseTex || pPkt->pBumpTex != pPkt0->pBumpTex) return false;
+	if (pPkt->alphaLim != pPkt0->alphaLim) return false;
+	return nxCore::mem_eq(&pPkt->shadowCtrl, &pPkt0->shadowCtrl, sizeof(xt_float4)) && nxCore::mem_eq(&pPkt->baseColor, &pPkt0->baseColor, sizeof(xt_float3));
+}
+
+static GPUProg* inst_prog_sel(const Draw::BatchPacket* const* ppPkts, const int npkt) {
+	if (npkt < 2 || !s_instVBO) return nullptr;
+	const Draw::BatchPacket* pPkt0 = ppPkts[0];
+	if (!pPkt0 || pPkt0->pExtIfc) return nullptr;
+	if (pPkt0->pWk->mpData->has_skin()) return nullptr;
+	GPUProg* pProg = (GPUProg*)pPkt0->prog;
+	if (!pProg || !pProg->mpInst) return nullptr;
+	prog_touch(pProg->mpInst);
+	if (!pProg->mpInst->is_valid()) return nullptr;
+	/* shadow receive was picked per work from its batch bounds, so every packet has to carry the same program */
+	for (int i = 1; i < npkt; ++i) {
+		if (!inst_compatible(pPkt0, ppPkts[i])) return nullptr;
+	}
+	return pProg->mpInst;
+}
+
+static bool batch_inst(const Draw::BatchPacket* const* ppPkts, const int npkt, const Draw::Context* pCtx) {
+	if (!ppPkts || npkt < 1) return false;
+	if (!inst_prog_sel(ppPkts, npkt)) {
+		for (int i = 0; i < npkt; ++i) {
+			batch_replay(ppPkts[i], pCtx);
+		}
+		return false;
+	}
+	for (int org = 0; org < npkt; org += DRW_INST_MAX) {
+		int n = nxCalc::min(npkt - org, DRW_INST_MAX);
+		for (int i = 0; i < n; ++i) {
+			cxModelWork* pWk = ppPkts[org + i]->pWk;
+			if (pWk->mpWorldXform) {
+				s_instXforms[i] = *pWk->mpWorldXform;
+			} else {
+				s_instXforms[i].identity();
+			}
+		}
+		batch_replay_impl(ppPkts[org], pCtx, n);
+	}
+	return true;
+}
+
 void quad(const Draw::Quad* pQuad) {
 	if (!pQuad) return;
 	if (pQuad->color.a <= 0.0f) return;
+	text_flush();
 	GPUProg* pProg = &s_prg_quad_quad;
 	if (!pProg->is_valid()) return;
 	GLuint htex = get_tex_handle(pQuad->pTex);
@@ -2353,7 +3479,7 @@ void quad(const Draw::Quad* pQuad) {
 	set_screen_framebuf();
 	set_semi();
 	set_face_cull();
-	OGLSys::enable_msaa(false);
+	set_msaa(false);
 	pProg->use();
 	xt_float4 pos[2];
 	const float* pPosSrc = pQuad->pos[0];
@@ -2416,8 +3542,7 @@ void quad(const Draw::Quad* pQuad) {
 		invGamma.set(nxCalc::rcp0(pQuad->gamma.x), nxCalc::rcp0(pQuad->gamma.y), nxCalc::rcp0(pQuad->gamma.z));
 		pProg->set_inv_gamma(invGamma);
 	}
-	glActiveTexture(GL_TEXTURE0 + Draw::TEXUNIT_Base);
-	glBindTexture(GL_TEXTURE_2D, htex);
+	bind_tex(Draw::TEXUNIT_Base, htex);
 	if (pProg->mVAO) {
 		OGLSys::bind_vao(pProg->mVAO);
 	}
@@ -2432,6 +3557,97 @@ void quad(const Draw::Quad* pQuad) {
 	}
 }
 
+/*
+  Glyphs are expanded on the CPU into screen-space triangles carrying their own color
+  and clip rect, so a whole frame of text goes out as one draw unless something else
+  is drawn in between (quads, prims and batches flush pending text to keep ordering).
+*/
+static void text_flush() {
+	if (s_textVtxNum == 0) return;
+	uint32_t nvtx = s_textVtxNum;
+	s_textVtxNum = 0;
+	GPUProg* pProg = &s_prg_text_text;
+	uint32_t offs = 0;
+	if (!s_textStrm.put(s_pTextVtx, nvtx * sizeof(TextVtx), sizeof(TextVtx), &offs)) return;
+	set_screen_framebuf();
+	set_semi();
+	set_face_cull();
+	set_msaa(true);
+	pProg->use();
+	if (pProg->mVAO) {
+		OGLSys::bind_vao(pProg->mVAO);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, s_textStrm.mBufHandle);
+	pProg->enable_attrs(int(offs / sizeof(TextVtx)));
+	glDrawArrays(GL_TRIANGLES, 0, nvtx);
+	if (pProg->mVAO) {
+		OGLSys::bind_vao(0);
+	} else {
+		pProg->disable_attrs();
+	}
+}
+
+static bool sym_bounds(const Draw::Symbol* pSym, const Draw::Font::SymInfo* pInfo, xt_float2* pMin, xt_float2* pMax) {
+	const Draw::Font* pFont = s_pFont;
+	const uint16_t* pIdx = &pFont->pTris[pInfo->idxOrg];
+	int nidx = pInfo->numTris * 3;
+	float ox = pSym->ox*2.0f - 1.0f;
+	float oy = pSym->oy*2.0f - 1.0f;
+	pMin->set(ox, oy);
+	pMax->set(ox, oy);
+	if (nidx <= 0) return false;
+	float sx = pSym->sx * 2.0f;
+	float sy = pSym->sy * 2.0f;
+	for (int i = 0; i < nidx; ++i) {
+		const xt_float2& pnt = pFont->pPnts[pIdx[i]];
+		float x = pnt.x*sx + ox;
+		float y = pnt.y*sy + oy;
+		if (i == 0) {
+			pMin->set(x, y);
+			pMax->set(x, y);
+		} else {
+			pMin->x = nxCalc::min(pMin->x, x);
+			pMin->y = nxCalc::min(pMin->y, y);
+			pMax->x = nxCalc::max(pMax->x, x);
+			pMax->y = nxCalc::max(pMax->y, y);
+		}
+	}
+	return true;
+}
+
+static bool sym_text_batch(const Draw::Symbol* pSym, const Draw::Font::SymInfo* pInfo) {
+	if (!s_pTextVtx) return false;
+	if (!s_prg_text_text.is_valid()) return false;
+	const Draw::Font* pFont = s_pFont;
+	uint32_t nvtx = uint32_t(pInfo->numTris * 3);
+	if (nvtx > s_textVtxMax) return false;
+	if (s_textVtxNum + nvtx > s_textVtxMax) {
+		text_flush();
+	}
+	xt_float4 clip;
+	clip.set(pSym->clip.x*2.0f - 1.0f, pSym->clip.y*2.0f - 1.0f, pSym->clip.z*2.0f - 1.0f, pSym->clip.w*2.0f - 1.0f);
+	xt_float4 clr;
+	clr.set(pSym->clr.r, pSym->clr.g, pSym->clr.b, pSym->clr.a);
+	float ox = pSym->ox*2.0f - 1.0f;
+	float oy = pSym->oy*2.0f - 1.0f;
+	float sx = pSym->sx * 2.0f;
+	float sy = pSym->sy * 2.0f;
+	const uint16_t* pIdx = &pFont->pTris[pInfo->idxOrg];
+	TextVtx* pVtx = &s_pTextVtx[s_textVtxNum];
+	for (uint32_t i = 0; i < nvtx; ++i) {
+		const xt_float2& pnt = pFont->pPnts[pIdx[i]];
+		float x = pnt.x*sx + ox;
+		float y = pnt.y*sy + oy;
+		pVtx->loc.set(x, y);
+		pVtx->pos.set(x*pSym->rot[0].x + y*pSym->rot[1].x, x*pSym->rot[0].y + y*pSym->rot[1].y);
+		pVtx->clip = clip;
+		pVtx->clr = clr;
+		++pVtx;
+	}
+	s_textVtxNum += nvtx;
+	return true;
+}
+
 void symbol(const Draw::Symbol* pSym) {
 	Draw::Font* pFont = s_pFont;
 	if (!pFont) return;
@@ -2440,9 +3656,15 @@ void symbol(const Draw::Symbol* pSym) {
 	if (!(s_fontVBO && s_fontIBO)) return;
 	int sym = pSym->sym;
 	if (uint32_t(sym) >= uint32_t(pFont->numSyms)) return;
+	Draw::Font::SymInfo* pInfo = &pFont->pSyms[sym];
+	xt_float2 bbMin;
+	xt_float2 bbMax;
+	if (!sym_bounds(pSym, pInfo, &bbMin, &bbMax)) return;
+	if (bbMax.x < pSym->clip.x*2.0f - 1.0f || bbMin.x > pSym->clip.z*2.0f - 1.0f) return;
+	if (bbMax.y < pSym->clip.y*2.0f - 1.0f || bbMin.y > pSym->clip.w*2.0f - 1.0f) return;
+	if (sym_text_batch(pSym, pInfo)) return;
 	GPUProg* pProg = &s_prg_font_font;
 	if (!pProg->is_valid()) return;
-	Draw::Font::SymInfo* pInfo = &pFont->pSyms[sym];
 	set_screen_framebuf();
 	if (clr.a < 1.0f) {
 		set_semi();
@@ -2450,7 +3672,7 @@ void symbol(const Draw::Symbol* pSym) {
 		set_opaq();
 	}
 	set_face_cull();
-	OGLSys::enable_msaa(true);
+	set_msaa(true);
 	pProg->use();
 	if (HAS_PARAM(FontColor)) {
 		xt_float4 fontClr;
@@ -2493,25 +3715,36 @@ static bool ck_prim_idx_range(const uint32_t org, const uint32_t num) {
 	return !(org >= s_maxPrimIdx || org + num > s_maxPrimIdx);
 }
 
+/*
+  Prim geometry is kept in client memory and each draw streams the range it references
+  into a frame ring (persistently mapped + fenced where supported, orphaned otherwise),
+  so rewriting the same prim slots several times per frame never waits on the GPU.
+*/
 void init_prims(const uint32_t maxVtx, const uint32_t maxIdx) {
 	if (!s_drwInitFlg) return;
-	if (s_primVBO) return;
+	if (s_pPrimVtx) return;
 	if (maxVtx < 3) return;
-	glGenBuffers(1, &s_primVBO);
-	if (s_primVBO) {
-		glBindBuffer(GL_ARRAY_BUFFER, s_primVBO);
-		glBufferData(GL_ARRAY_BUFFER, maxVtx * sizeof(sxPrimVtx), nullptr, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		s_maxPrimVtx = maxVtx;
+	s_pPrimVtx = (sxPrimVtx*)nxCore::mem_alloc(maxVtx * sizeof(sxPrimVtx), "Draw:PrimVtx");
+	if (!s_pPrimVtx) return;
+	s_primVtxStrm.init(GL_ARRAY_BUFFER, maxVtx * sizeof(sxPrimVtx));
+	if (!s_primVtxStrm.is_valid()) {
+		nxCore::mem_free(s_pPrimVtx);
+		s_pPrimVtx = nullptr;
+		return;
+	}
+	s_maxPrimVtx = maxVtx;
 
-		s_maxPrimIdx = 0;
-		if (maxIdx >= 3) {
-			glGenBuffers(1, &s_primIBO);
-			if (s_primIBO) {
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_primIBO);
-				glBufferData(GL_ELEMENT_ARRAY_BUFFER, maxIdx * sizeof(uint16_t), nullptr, GL_DYNAMIC_DRAW);
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	s_maxPrimIdx = 0;
+	if (maxIdx >= 3) {
+		s_pPrimIdx = (uint16_t*)nxCore::mem_alloc(maxIdx * sizeof(uint16_t) * 2, "Draw:PrimIdx");
+		if (s_pPrimIdx) {
+			s_primIdxStrm.init(GL_ELEMENT_ARRAY_BUFFER, maxIdx * sizeof(uint16_t));
+			if (s_primIdxStrm.is_valid()) {
+				s_pPrimIdxTmp = s_pPrimIdx + maxIdx;
 				s_maxPrimIdx = maxIdx;
+			} else {
+				nxCore::mem_free(s_pPrimIdx);
+				s_pPrimIdx = nullptr;
 			}
 		}
 	}
@@ -2519,32 +3752,16 @@ void init_prims(const uint32_t maxVtx, const uint32_t maxIdx) {
 
 static void prim_geom_vtx(const uint32_t org, const uint32_t num, const sxPrimVtx* pSrc) {
 	if (!pSrc) return;
-	if (!s_primVBO) return;
+	if (!s_pPrimVtx) return;
 	if (!ck_prim_vtx_range(org, num)) return;
-	glBindBuffer(GL_ARRAY_BUFFER, s_primVBO);
-	GLintptr offs = org * sizeof(sxPrimVtx);
-	GLsizeiptr len = num * sizeof(sxPrimVtx);
-#if 1
-	glBufferSubData(GL_ARRAY_BUFFER, offs, len, pSrc);
-#else
-	void* pDst = glMapBufferRange(GL_ARRAY_BUFFER, offs, len, GL_MAP_WRITE_BIT);
-	if (pDst) {
-		nxCore::mem_copy(pDst, pSrc, (size_t)len);
-	}
-	glUnmapBuffer(GL_ARRAY_BUFFER);
-#endif
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	nxCore::mem_copy(&s_pPrimVtx[org], pSrc, num * sizeof(sxPrimVtx));
 }
 
 static void prim_geom_idx(const uint32_t org, const uint32_t num, const uint16_t* pSrc) {
 	if (!pSrc) return;
-	if (!s_primIBO) return;
+	if (!s_pPrimIdx) return;
 	if (!ck_prim_idx_range(org, num)) return;
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_primIBO);
-	GLintptr offs = org * sizeof(uint16_t);
-	GLsizeiptr len = num * sizeof(uint16_t);
-	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offs, len, pSrc);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	nxCore::mem_copy(&s_pPrimIdx[org], pSrc, num * sizeof(uint16_t));
 }
 
 void prim_geom(const Draw::PrimGeom* pGeom) {
@@ -2556,29 +3773,47 @@ void prim_geom(const Draw::PrimGeom* pGeom) {
 void prim(const Draw::Prim* pPrim, const Draw::Context* pCtx) {
 	if (!pPrim) return;
 	if (!pCtx) return;
-	if (!s_primVBO) return;
+	if (!s_pPrimVtx) return;
+	text_flush();
 	GPUProg* pProg = &s_prg_prim_prim;
 	if (!pProg->is_valid()) return;
 	uint32_t vorg = 0;
 	uint32_t vnum = 0;
 	uint32_t iorg = 0;
 	uint32_t inum = 0;
+	uint32_t voffs = 0;
+	uint32_t ioffs = 0;
 	if (pPrim->indexed) {
-		if (!s_primIBO) return;
+		if (!s_pPrimIdx) return;
 		iorg = pPrim->org;
 		inum = pPrim->num;
 		if (!ck_prim_idx_range(iorg, inum)) return;
+		const uint16_t* pIdx = &s_pPrimIdx[iorg];
+		uint32_t imin = pIdx[0];
+		uint32_t imax = pIdx[0];
+		for (uint32_t i = 1; i < inum; ++i) {
+			imin = nxCalc::min(imin, uint32_t(pIdx[i]));
+			imax = nxCalc::max(imax, uint32_t(pIdx[i]));
+		}
+		vorg = imin;
+		vnum = imax - imin + 1;
+		if (!ck_prim_vtx_range(vorg, vnum)) return;
+		for (uint32_t i = 0; i < inum; ++i) {
+			s_pPrimIdxTmp[i] = uint16_t(pIdx[i] - imin);
+		}
+		if (!s_primIdxStrm.put(s_pPrimIdxTmp, inum * sizeof(uint16_t), sizeof(uint32_t), &ioffs)) return;
 	} else {
 		vorg = pPrim->org;
 		vnum = pPrim->num;
 		if (!ck_prim_vtx_range(vorg, vnum)) return;
 	}
+	if (!s_primVtxStrm.put(&s_pPrimVtx[vorg], vnum * sizeof(sxPrimVtx), sizeof(sxPrimVtx), &voffs)) return;
 	GLuint htex = get_tex_handle(pPrim->pTex);
 	if (!htex) {
 		htex = OGLSys::get_white_tex();
 	}
 	set_def_framebuf();
-	OGLSys::enable_msaa(true);
+	set_msaa(true);
 	if (pPrim->alphaBlend) {
 		set_semi();
 	} else {
@@ -2589,11 +3824,7 @@ void prim(const Draw::Prim* pPrim, const Draw::Context* pCtx) {
 	} else {
 		set_face_cull();
 	}
-	if (pPrim->depthWrite) {
-		glDepthMask(GL_TRUE);
-	} else {
-		glDepthMask(GL_FALSE);
-	}
+	set_depth_mask(pPrim->depthWrite);
 	pProg->use();
 
 	pProg->set_view_proj(pCtx->view.mViewProjMtx);
@@ -2646,20 +3877,19 @@ void prim(const Draw::Prim* pPrim, const Draw::Context* pCtx) {
 	pProg->set_inv_gamma(pCtx->cc.get_inv_gamma());
 
 	if (pProg->mSmpLink.Base >= 0) {
-		glActiveTexture(GL_TEXTURE0 + Draw::TEXUNIT_Base);
-		glBindTexture(GL_TEXTURE_2D, htex);
+		bind_tex(Draw::TEXUNIT_Base, htex);
 	}
 
 	if (pProg->mVAO) {
 		OGLSys::bind_vao(pProg->mVAO);
 	}
-	glBindBuffer(GL_ARRAY_BUFFER, s_primVBO);
-	pProg->enable_attrs(0);
+	glBindBuffer(GL_ARRAY_BUFFER, s_primVtxStrm.mBufHandle);
+	pProg->enable_attrs(int(voffs / sizeof(sxPrimVtx)));
 	if (inum > 0) {
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_primIBO);
-		glDrawElements(GL_TRIANGLES, inum, GL_UNSIGNED_SHORT, (const void*)(iorg * sizeof(uint16_t)));
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_primIdxStrm.mBufHandle);
+		glDrawElements(GL_TRIANGLES, inum, GL_UNSIGNED_SHORT, (const void*)intptr_t(ioffs));
 	} else {
-		glDrawArrays(GL_TRIANGLES, vorg, vnum);
+		glDrawArrays(GL_TRIANGLES, 0, vnum);
 	}
 	if (pProg->mVAO) {
 		OGLSys::bind_vao(0);
@@ -2667,7 +3897,7 @@ void prim(const Draw::Prim* pPrim, const Draw::Context* pCtx) {
 		pProg->disable_attrs();
 	}
 
-	glDepthMask(GL_TRUE);
+	set_depth_mask(true);
 }
 
 
@@ -2683,11 +3913,15 @@ struct DrwInit {
 		s_ifc.get_screen_width = get_screen_width;
 		s_ifc.get_screen_height = get_screen_height;
 		s_ifc.get_shadow_bias_mtx = get_shadow_bias_mtx;
+		s_ifc.init_shadow_cascades = init_shadow_cascades;
 		s_ifc.init_prims = init_prims;
 		s_ifc.prim_geom = prim_geom;
 		s_ifc.begin = begin;
 		s_ifc.end = end;
 		s_ifc.batch = batch;
+		s_ifc.batch_record = batch_record;
+		s_ifc.batch_replay = batch_replay;
+		s_ifc.batch_inst = batch_inst;
 		s_ifc.prim = prim;
 		s_ifc.quad = quad;
 		s_ifc.symbol = symbol;
@@ -2709,6 +3943,15 @@ XD_NOINLINE void drwogl_read_fb(void* pDst) {
 	}
 }
 
+XD_NOINLINE void drwogl_state_stats(int32_t* pCalls, int32_t* pSkips) {
+	if (pCalls) {
+		*pCalls = s_frameStateCalls;
+	}
+	if (pSkips) {
+		*pSkips = s_frameStateSkips;
+	}
+}
+
 XD_NOINLINE void drwogl_polmode_dot() {
 	void* pfn = OGLSys::get_proc_addr("glPolygonMode");
 	if (pfn) {
@@ -0,0 +1,197 @@
+// g++ -pthread -I ../.. ../../crosscore.cpp ../../scene.cpp perf_capsweep.cpp -o perf_capsweep -O3 -flto
+// ./perf_capsweep -pillars:300 -chars:200 -steps:500
+
+#include "crosscore.hpp"
+#include "draw.hpp"
+#include "scene.hpp"
+
+static bool g_silent = false;
+
+static void dbgmsg_impl(const char* pMsg) {
+	if (g_silent) return;
+	::fprintf(stderr, "%s", pMsg);
+	::fflush(stderr);
+}
+
+static void init_sys() {
+	sxSysIfc sysIfc;
+	nxCore::mem_zero(&sysIfc, sizeof(sysIfc));
+	sysIfc.fn_dbgmsg = dbgmsg_impl;
+	nxSys::init(&sysIfc);
+}
+
+static void reset_sys() {
+}
+
+static int g_npillars = 300;
+static int g_nchars = 200;
+static int g_nsteps = 500;
+static float g_ext = 40.0f;
+static float g_radius = 0.3f;
+static float g_step = 0.1f;
+
+static cxAABB* s_pPillars = nullptr;
+static sxCollisionData* s_pCol = nullptr;
+
+static void make_pillars() {
+	int n = g_npillars;
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 1);
+	s_pPillars = (cxAABB*)nxCore::mem_alloc(n * sizeof(cxAABB), "perf:pillars");
+	for (int i = 0; i < n; ++i) {
+		float cx = nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, -g_ext*0.5f, g_ext*0.5f);
+		float cz = nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, -g_ext*0.5f, g_ext*0.5f);
+		float sx = nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, 0.25f, 0.75f);
+		float sz = nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, 0.25f, 0.75f);
+		s_pPillars[i].set(cxVec(cx - sx, 0.0f, cz - sz), cxVec(cx + sx, 3.0f, cz + sz));
+	}
+}
+
+static void make_col() {
+	static const int quads[6][4] = {
+		{ 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }
+	};
+	int nbox = g_npillars;
+	int npnt = nbox * 8;
+	int npol = nbox * 6 * 2;
+	int nnodes = npol*2 - 1;
+	size_t size = XD_ALIGN(sizeof(sxCollisionData), 0x10);
+	size_t pntOffs = size;
+	size += npnt * sizeof(cxVec);
+	size_t orgOffs = size;
+	size += npol * sizeof(int32_t);
+	size_t idxOffs = size;
+	size += npol * 3 * sizeof(int32_t);
+	size_t bboxOffs = size;
+	size += npol * sizeof(cxAABB);
+	size_t nodeBBoxOffs = size;
+	size += nnodes * sizeof(cxAABB);
+	size_t nodeInfoOffs = size;
+	size += nnodes * sizeof(sxCollisionData::BVHNodeInfo);
+	sxCollisionData* pCol = (sxCollisionData*)nxCore::mem_alloc(size, "perf:xcol");
+	nxCore::mem_zero(pCol, size);
+	pCol->mKind = sxCollisionData::KIND;
+	pCol->mFlags = 1;
+	pCol->mFileSize = uint32_t(size);
+	pCol->mHeadSize = uint32_t(sizeof(sxCollisionData));
+	pCol->mNameId = -1;
+	pCol->mPathId = -1;
+	pCol->mPntNum = uint32_t(npnt);
+	pCol->mPolNum = uint32_t(npol);
+	pCol->mTriNum = uint32_t(npol);
+	pCol->mGrpNum = 1;
+	pCol->mMaxVtxPerPol = 3;
+	pCol->mPntOffs = uint32_t(pntOffs);
+	pCol->mPolIdxOrgOffs = uint32_t(orgOffs);
+	pCol->mPolIdxOffs = uint32_t(idxOffs);
+	pCol->mPolBBoxOffs = uint32_t(bboxOffs);
+	pCol->mBVHBBoxOffs = uint32_t(nodeBBoxOffs);
+	pCol->mBVHInfoOffs = uint32_t(nodeInfoOffs);
+	cxVec* pPnts = (cxVec*)XD_INCR_PTR(pCol, pntOffs);
+	int32_t* pOrgs = (int32_t*)XD_INCR_PTR(pCol, orgOffs);
+	int32_t* pIdx = (int32_t*)XD_INCR_PTR(pCol, idxOffs);
+	cxAABB* pBBoxes = (cxAABB*)XD_INCR_PTR(pCol, bboxOffs);
+	int ipol = 0;
+	for (int ibox = 0; ibox < nbox; ++ibox) {
+		cxVec bmin = s_pPillars[ibox].get_min_pos();
+		cxVec bmax = s_pPillars[ibox].get_max_pos();
+		int org = ibox * 8;
+		for (int i = 0; i < 8; ++i) {
+			pPnts[org + i].set((i & 1) ? bmax.x : bmin.x, (i & 2) ? bmax.y : bmin.y, (i & 4) ? bmax.z : bmin.z);
+		}
+		for (int i = 0; i < 6; ++i) {
+			int tris[2][3] = { { quads[i][0], quads[i][1], quads[i][2] }, { quads[i][0], quads[i][2], quads[i][3] } };
+			for (int j = 0; j < 2; ++j) {
+				pOrgs[ipol] = ipol * 3;
+				for (int k = 0; k < 3; ++k) {
+					pIdx[ipol*3 + k] = org + tris[j][k];
+				}
+				pBBoxes[ipol].set(pPnts[pIdx[ipol*3]]);
+				pBBoxes[ipol].add_pnt(pPnts[pIdx[ipol*3 + 1]]);
+				pBBoxes[ipol].add_pnt(pPnts[pIdx[ipol*3 + 2]]);
+				if (ipol == 0) {
+					pCol->mBBox = pBBoxes[ipol];
+				} else {
+					pCol->mBBox.merge(pBBoxes[ipol]);
+				}
+				++ipol;
+			}
+		}
+	}
+	int32_t* pIdxWk = (int32_t*)nxCore::mem_alloc(npol * sizeof(int32_t), "perf:xcol:wk");
+	nxGeom::build_aabb_tree(pBBoxes, npol, (cxAABB*)XD_INCR_PTR(pCol, nodeBBoxOffs), (int32_t*)XD_INCR_PTR(pCol, nodeInfoOffs), pIdxWk, true);
+	nxCore::mem_free(pIdxWk);
+	s_pCol = pCol;
+}
+
+static bool ck_penetration(const cxVec& pos) {
+	float lim = g_radius * 0.5f;
+	for (int i = 0; i < g_npillars; ++i) {
+		cxVec bmin = s_pPillars[i].get_min_pos();
+		cxVec bmax = s_pPillars[i].get_max_pos();
+		float dx = nxCalc::max(bmin.x - pos.x, 0.0f, pos.x - bmax.x);
+		float dz = nxCalc::max(bmin.z - pos.z, 0.0f, pos.z - bmax.z);
+		if (dx*dx + dz*dz < lim*lim) return true;
+	}
+	return false;
+}
+
+/* characters walk from the same seeded start states for both schemes, turning on every wall contact */
+static void test_walk(const char* pName, const bool sweep) {
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 2);
+	double tadj = 0.0;
+	int nadj = 0;
+	int npen = 0;
+	for (int ichr = 0; ichr < g_nchars; ++ichr) {
+		cxVec pos(0.0f, 1.0f, 0.0f);
+		do {
+			pos.x = nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, -g_ext*0.5f, g_ext*0.5f);
+			pos.z = nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, -g_ext*0.5f, g_ext*0.5f);
+		} while (ck_penetration(pos));
+		float ang = nxCore::rng_f01(&rng) * XD_PI * 2.0f;
+		bool pen = false;
+		for (int istep = 0; istep < g_nsteps; ++istep) {
+			cxVec npos = pos + cxVec(::mth_cosf(ang), 0.0f, ::mth_sinf(ang)) * g_step;
+			cxVec apos = npos;
+			double t0 = nxSys::time_micros();
+			bool adj = sweep ? Scene::wall_adj_sweep(s_pCol, npos, pos, g_radius, &apos) : Scene::wall_adj(nullptr, s_pCol, npos, pos, g_radius, &apos);
+			tadj += nxSys::time_micros() - t0;
+			++nadj;
+			if (adj) {
+				ang += nxCalc::fit(nxCore::rng_f01(&rng), 0.0f, 1.0f, -1.0f, 1.0f);
+			}
+			pos = apos;
+			if (!pen && ck_penetration(pos)) {
+				pen = true;
+			}
+		}
+		if (pen) {
+			++npen;
+		}
+	}
+	nxCore::dbg_msg("%s: %f micros per call, %d/%d characters penetrated walls\n", pName, tadj / double(nadj), npen, g_nchars);
+}
+
+int main(int argc, char* argv[]) {
+	nxApp::init_params(argc, argv);
+	init_sys();
+
+	g_silent = nxApp::get_bool_opt("silent", false);
+	g_npillars = nxCalc::max(nxApp::get_int_opt("pillars", 300), 1);
+	g_nchars = nxCalc::max(nxApp::get_int_opt("chars", 200), 1);
+	g_nsteps = nxCalc::max(nxApp::get_int_opt("steps", 500), 1);
+
+	make_pillars();
+	make_col();
+
+	nxCore::dbg_msg("%d characters x %d steps among %d pillars...\n", g_nchars, g_nsteps, g_npillars);
+	test_walk("iterative", false);
+	test_walk("sweep", true);
+
+	nxCore::mem_free(s_pCol);
+	nxCore::mem_free(s_pPillars);
+	nxApp::reset();
+	reset_sys();
+	return 0;
+}
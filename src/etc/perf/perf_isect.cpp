@@ -12,6 +12,7 @@ static float g_height = 1.0f;
 static int g_nprims = 10;
 static int g_nrays = 10;
 static int g_dump = 0;
+static int g_bvh = 0;
 static bool g_silent = false;
 
 static cxVec* s_pGeoPts = nullptr;
@@ -210,6 +211,121 @@ XD_NOINLINE static void calc_hits() {
 	nxCore::dbg_msg("dt: %f millis\n", dt * 1e-3f);
 }
 
+static sxCollisionData* make_quads_col() {
+	int npnt = g_nprims * 2;
+	int npol = g_nprims;
+	int nnodes = npol*2 - 1;
+	size_t size = XD_ALIGN(sizeof(sxCollisionData), 0x10);
+	size_t pntOffs = size;
+	size += npnt * sizeof(cxVec);
+	size_t orgOffs = size;
+	size += npol * sizeof(int32_t);
+	size_t idxOffs = size;
+	size += npol * 4 * sizeof(int32_t);
+	size_t triOrgOffs = size;
+	size += npol * sizeof(int32_t);
+	size_t triIdxOffs = size;
+	size += XD_ALIGN(6, 4);
+	size_t bboxOffs = size;
+	size += npol * sizeof(cxAABB);
+	size_t nodeBBoxOffs = size;
+	size += nnodes * sizeof(cxAABB);
+	size_t nodeInfoOffs = size;
+	size += nnodes * sizeof(sxCollisionData::BVHNodeInfo);
+	sxCollisionData* pCol = (sxCollisionData*)nxCore::mem_alloc(size, "col:quads");
+	nxCore::mem_zero(pCol, size);
+	pCol->mKind = sxCollisionData::KIND;
+	pCol->mFlags = 1;
+	pCol->mFileSize = uint32_t(size);
+	pCol->mHeadSize = uint32_t(sizeof(sxCollisionData));
+	pCol->mNameId = -1;
+	pCol->mPathId = -1;
+	pCol->mPntNum = uint32_t(npnt);
+	pCol->mPolNum = uint32_t(npol);
+	pCol->mTriNum = uint32_t(npol * 2);
+	pCol->mGrpNum = 1;
+	pCol->mMaxVtxPerPol = 4;
+	pCol->mPntOffs = uint32_t(pntOffs);
+	pCol->mPolIdxOrgOffs = uint32_t(orgOffs);
+	pCol->mPolIdxOffs = uint32_t(idxOffs);
+	pCol->mPolTriOrgOffs = uint32_t(triOrgOffs);
+	pCol->mPolTriIdxOffs = uint32_t(triIdxOffs);
+	pCol->mPolBBoxOffs = uint32_t(bboxOffs);
+	pCol->mBVHBBoxOffs = uint32_t(nodeBBoxOffs);
+	pCol->mBVHInfoOffs = uint32_t(nodeInfoOffs);
+	nxCore::mem_copy(XD_INCR_PTR(pCol, pntOffs), s_pGeoPts, npnt * sizeof(cxVec));
+	nxCore::mem_copy(XD_INCR_PTR(pCol, idxOffs), s_pGeoIdx, npol * 4 * sizeof(int32_t));
+	int32_t* pOrgs = (int32_t*)XD_INCR_PTR(pCol, orgOffs);
+	int32_t* pTriOrgs = (int32_t*)XD_INCR_PTR(pCol, triOrgOffs);
+	uint8_t* pTriIdx = (uint8_t*)XD_INCR_PTR(pCol, triIdxOffs);
+	static const uint8_t quadTris[6] = { 0, 1, 2, 0, 2, 3 };
+	nxCore::mem_copy(pTriIdx, quadTris, sizeof(quadTris));
+	cxAABB* pBBoxes = (cxAABB*)XD_INCR_PTR(pCol, bboxOffs);
+	for (int i = 0; i < npol; ++i) {
+		pOrgs[i] = i * 4;
+		pTriOrgs[i] = 0;
+		pBBoxes[i].set(s_pGeoPts[s_pGeoIdx[i*4]]);
+		for (int j = 1; j < 4; ++j) {
+			pBBoxes[i].add_pnt(s_pGeoPts[s_pGeoIdx[i*4 + j]]);
+		}
+		if (i == 0) {
+			pCol->mBBox = pBBoxes[i];
+		} else {
+			pCol->mBBox.merge(pBBoxes[i]);
+		}
+	}
+	int32_t* pIdxWk = (int32_t*)nxCore::mem_alloc(npol * sizeof(int32_t), "col:wk");
+	nxGeom::build_aabb_tree(pBBoxes, npol, (cxAABB*)XD_INCR_PTR(pCol, nodeBBoxOffs), (int32_t*)XD_INCR_PTR(pCol, nodeInfoOffs), pIdxWk, true);
+	nxCore::mem_free(pIdxWk);
+	return pCol;
+}
+
+static bool col_hit_func(const sxCollisionData& col, const sxCollisionData::Tri& tri, const cxVec& pos, const float dist, void* pWk) {
+	++(*(int*)pWk);
+	return true;
+}
+
+static bool col_range_func(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	++(*(int*)pWk);
+	return true;
+}
+
+XD_NOINLINE static void calc_col_hits(sxCollisionData* pCol, const char* pName) {
+	if (!pCol) return;
+	int nhits = 0;
+	double t0 = nxSys::time_micros();
+	for (int iray = 0; iray < g_nrays; ++iray) {
+		cxLineSeg seg(s_pRayPts[iray*2], s_pRayPts[iray*2 + 1]);
+		pCol->hit_check(col_hit_func, seg, &nhits);
+	}
+	double t1 = nxSys::time_micros();
+	int ntris = 0;
+	for (int iray = 0; iray < g_nrays; ++iray) {
+		cxVec pos = s_pRayPts[iray*2 + 1];
+		pos.y = 0.0f;
+		pos = pos.get_normalized() * g_radius;
+		pos.y = s_pRayPts[iray*2 + 1].y;
+		cxAABB bbox(pos - cxVec(g_radius*0.01f), pos + cxVec(g_radius*0.01f));
+		pCol->for_tris_in_range(col_range_func, bbox, &ntris, false);
+	}
+	double t2 = nxSys::time_micros();
+	nxCore::dbg_msg("%s: hit_check %f millis (%d hits), for_tris_in_range %f millis (%d tris)\n", pName, (t1 - t0) * 1e-3, nhits, (t2 - t1) * 1e-3, ntris);
+}
+
+XD_NOINLINE static void calc_bvh_hits() {
+	if (!g_bvh) return;
+	if (g_nprims < 3) return;
+	sxCollisionData* pCol = make_quads_col();
+	calc_col_hits(pCol, "BVH2");
+	sxCollisionData* pCol4 = pCol->make_wide_BVH(4);
+	calc_col_hits(pCol4, "BVH4");
+	sxCollisionData* pCol8 = pCol->make_wide_BVH(8);
+	calc_col_hits(pCol8, "BVH8");
+	nxCore::mem_free(pCol8);
+	nxCore::mem_free(pCol4);
+	nxCore::mem_free(pCol);
+}
+
 static void dump_hits(FILE* pOut = stdout) {
 	if (g_dump != 3) return;
 	::fprintf(pOut, "PGEOMETRY V5\n");
@@ -235,6 +351,7 @@ int main(int argc, char* argv[]) {
 	g_nprims = nxApp::get_int_opt("nprims", 100);
 	g_nrays = nxApp::get_int_opt("nrays", g_nprims * 100);
 	g_dump = nxApp::get_int_opt("dump", 0);
+	g_bvh = nxApp::get_int_opt("bvh", 0);
 	g_silent = nxApp::get_bool_opt("silent", false);
 
 	build_quads();
@@ -246,6 +363,7 @@ int main(int argc, char* argv[]) {
 	init_hits();
 	calc_hits();
 	dump_hits();
+	calc_bvh_hits();
 
 	nxApp::reset();
 	//nxCore::mem_dbg();
@@ -142,8 +142,16 @@ static void alloc_tree_mem() {
 	s_pIdxWk = (int32_t*)nxCore::mem_alloc(nsrc * sizeof(int32_t));
 }
 
-XD_NOINLINE static void make_tree() {
-	nxGeom::build_aabb_tree(s_pSrcBoxes, g_nsrc, s_pNodeBoxes, s_pNodeInfos, s_pIdxWk);
+XD_NOINLINE static void make_tree(const bool sah, cxBrigade* pBgd = nullptr) {
+	nxGeom::build_aabb_tree(s_pSrcBoxes, g_nsrc, s_pNodeBoxes, s_pNodeInfos, s_pIdxWk, sah, pBgd);
+}
+
+static void test_tree(const char* pName, const bool sah, cxBrigade* pBgd = nullptr) {
+	double t0 = nxSys::time_micros();
+	make_tree(sah, pBgd);
+	double dt = nxSys::time_micros() - t0;
+	float cost = nxGeom::aabb_tree_sah_cost(s_pNodeBoxes, s_pNodeInfos, g_nsrc*2 - 1);
+	nxCore::dbg_msg("%s: %f millis, SAH cost %f\n", pName, dt * 1e-3f, cost);
 }
 
 static void dump_tree(FILE* pOut = stdout) {
@@ -187,6 +195,8 @@ int main(int argc, char* argv[]) {
 	g_silent = nxApp::get_bool_opt("silent", false);
 	g_dump = nxApp::get_int_opt("dump", 0);
 	g_nsrc = nxCalc::max(nxApp::get_int_opt("n", 10), 10);
+	int nwrk = nxApp::get_int_opt("wrk", 0);
+	cxBrigade* pBgd = nwrk > 1 ? cxBrigade::create(nwrk) : nullptr;
 
 	make_geo();
 	dump_geo();
@@ -196,10 +206,15 @@ int main(int argc, char* argv[]) {
 
 	nxCore::dbg_msg("Building tree for %d boxes...\n", g_nsrc);
 	alloc_tree_mem();
-	double t0 = nxSys::time_micros();
-	make_tree();
-	double dt = nxSys::time_micros() - t0;
-	nxCore::dbg_msg("dt: %f millis\n", dt * 1e-3f);
+	test_tree("median", false);
+	if (pBgd) {
+		test_tree("SAH (parallel)", true, pBgd);
+		cxBrigade::destroy(pBgd);
+	}
+	test_tree("SAH", true);
+	if (!nxApp::get_bool_opt("sah", false)) {
+		make_tree(false);
+	}
 	dump_tree();
 
 
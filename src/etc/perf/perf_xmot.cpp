@@ -0,0 +1,192 @@
+// g++ -pthread -I ../.. ../../crosscore.cpp perf_xmot.cpp -o perf_xmot -O3 -flto
+
+#include "crosscore.hpp"
+
+static bool g_silent = false;
+static int g_nnodes = 60;
+static int g_nfrm = 600;
+static int g_nreps = 10;
+static float g_tolQ = 1.0e-4f;
+static float g_tolT = 1.0e-4f;
+
+static void dbgmsg_impl(const char* pMsg) {
+	if (g_silent) return;
+	::fprintf(stderr, "%s", pMsg);
+	::fflush(stderr);
+}
+
+static void init_sys() {
+	sxSysIfc sysIfc;
+	nxCore::mem_zero(&sysIfc, sizeof(sysIfc));
+	sysIfc.fn_dbgmsg = dbgmsg_impl;
+	nxSys::init(&sysIfc);
+}
+
+static void reset_sys() {
+}
+
+static cxVec smp_curve(const int inode, const int ich, const int ifrm, const float amp) {
+	cxVec v;
+	for (int i = 0; i < 3; ++i) {
+		float t = float(ifrm) / 30.0f;
+		float ph = float(inode * 7 + ich * 3 + i) * 0.37f;
+		float val = ::mth_sinf(t * 1.3f + ph) * 0.6f;
+		val += ::mth_sinf(t * 3.1f + ph * 2.0f) * 0.25f;
+		val += ::mth_cosf(t * 7.7f + ph * 3.0f) * 0.05f;
+		v.set_at(i, val * amp);
+	}
+	return v;
+}
+
+static size_t trk_size(const int nfrm) {
+	return sizeof(cxAABB) + sizeof(uint32_t) + nfrm * 3 * sizeof(uint16_t);
+}
+
+static void make_trk(sxMotionData::Track* pTrk, const int inode, const int ich, const int nfrm, const float amp) {
+	cxAABB bbox;
+	bbox.set(smp_curve(inode, ich, 0, amp));
+	for (int i = 1; i < nfrm; ++i) {
+		bbox.add_pnt(smp_curve(inode, ich, i, amp));
+	}
+	pTrk->mBBox = bbox;
+	pTrk->mAttr = 7;
+	cxVec bbmin = bbox.get_min_pos();
+	cxVec bbsize = bbox.get_size_vec();
+	for (int i = 0; i < nfrm; ++i) {
+		cxVec v = smp_curve(inode, ich, i, amp);
+		for (int j = 0; j < 3; ++j) {
+			float rel = nxCalc::div0(v.get_at(j) - bbmin.get_at(j), bbsize.get_at(j));
+			pTrk->mData[i*3 + j] = uint16_t(::mth_roundf(nxCalc::saturate(rel) * float(0xFFFF)));
+		}
+	}
+}
+
+static sxMotionData* make_clip() {
+	int nnodes = g_nnodes;
+	int nfrm = g_nfrm;
+	size_t size = XD_ALIGN(sizeof(sxMotionData), 0x10);
+	size_t nodesOffs = size;
+	size += nnodes * sizeof(sxMotionData::Node);
+	size_t trksOffs = size;
+	for (int i = 0; i < nnodes; ++i) {
+		size += XD_ALIGN(trk_size(nfrm), 4);
+		if ((i & 3) == 0) {
+			size += XD_ALIGN(trk_size(nfrm), 4);
+		}
+	}
+	sxMotionData* pMot = (sxMotionData*)nxCore::mem_alloc(size, "xmot:synth");
+	nxCore::mem_zero(pMot, size);
+	pMot->mKind = sxMotionData::KIND;
+	pMot->mFileSize = uint32_t(size);
+	pMot->mHeadSize = uint32_t(sizeof(sxMotionData));
+	pMot->mNameId = -1;
+	pMot->mPathId = -1;
+	pMot->mFPS = 30.0f;
+	pMot->mFrameNum = uint32_t(nfrm);
+	pMot->mNodeNum = uint32_t(nnodes);
+	pMot->mNodeOffs = uint32_t(nodesOffs);
+	sxMotionData::Node* pNodes = (sxMotionData::Node*)XD_INCR_PTR(pMot, nodesOffs);
+	size_t offs = trksOffs;
+	for (int i = 0; i < nnodes; ++i) {
+		pNodes[i].mNameId = -1;
+		pNodes[i].mTrkOffsQ = uint32_t(offs);
+		make_trk((sxMotionData::Track*)XD_INCR_PTR(pMot, offs), i, 0, nfrm, 0.5f);
+		offs += XD_ALIGN(trk_size(nfrm), 4);
+		if ((i & 3) == 0) {
+			pNodes[i].mTrkOffsT = uint32_t(offs);
+			make_trk((sxMotionData::Track*)XD_INCR_PTR(pMot, offs), i, 1, nfrm, 2.0f);
+			offs += XD_ALIGN(trk_size(nfrm), 4);
+		}
+	}
+	return pMot;
+}
+
+static float s_evalSum = 0.0f;
+
+XD_NOINLINE static double eval_clip(const sxMotionData* pMot) {
+	double t0 = nxSys::time_micros();
+	float sum = 0.0f;
+	float maxFrame = float(pMot->mFrameNum - 1);
+	for (int irep = 0; irep < g_nreps; ++irep) {
+		for (float frm = 0.0f; frm < maxFrame; frm += 0.5f) {
+			for (uint32_t i = 0; i < pMot->mNodeNum; ++i) {
+				cxQuat q = pMot->eval_quat(i, frm);
+				cxVec t = pMot->eval_pos(i, frm);
+				sum += q.w + t.x;
+			}
+		}
+	}
+	s_evalSum += sum;
+	return nxSys::time_micros() - t0;
+}
+
+static void calc_err(const sxMotionData* pMot, const sxMotionData* pRdc, float* pErrQ, float* pErrT) {
+	float errQ = 0.0f;
+	float errT = 0.0f;
+	float maxFrame = float(pMot->mFrameNum - 1);
+	for (float frm = 0.0f; frm < maxFrame; frm += 0.25f) {
+		for (uint32_t i = 0; i < pMot->mNodeNum; ++i) {
+			cxQuat q0 = pMot->eval_quat(i, frm);
+			cxQuat q1 = pRdc->eval_quat(i, frm);
+			cxQuat dq = q0.get_inverted() * q1;
+			float ang = 2.0f * ::mth_atan2f(cxVec(dq.x, dq.y, dq.z).mag(), ::mth_fabsf(dq.w));
+			errQ = nxCalc::max(errQ, XD_RAD2DEG(ang));
+			cxVec t0 = pMot->eval_pos(i, frm);
+			cxVec t1 = pRdc->eval_pos(i, frm);
+			errT = nxCalc::max(errT, nxVec::dist(t0, t1));
+		}
+	}
+	*pErrQ = errQ;
+	*pErrT = errT;
+}
+
+int main(int argc, char* argv[]) {
+	nxApp::init_params(argc, argv);
+	init_sys();
+
+	g_nnodes = nxCalc::max(nxApp::get_int_opt("nodes", 60), 1);
+	g_nfrm = nxCalc::clamp(nxApp::get_int_opt("frames", 600), 2, 0xFFFF);
+	g_nreps = nxCalc::max(nxApp::get_int_opt("reps", 10), 1);
+	g_tolQ = nxApp::get_float_opt("tolq", 1.0e-4f);
+	g_tolT = nxApp::get_float_opt("tolt", 1.0e-4f);
+	g_silent = nxApp::get_bool_opt("silent", false);
+
+	sxMotionData* pMot = nullptr;
+	const char* pInPath = nxApp::get_opt("in");
+	if (pInPath) {
+		pMot = nxData::load_as<sxMotionData>(pInPath);
+		if (!pMot) {
+			nxCore::dbg_msg("can't load \"%s\"\n", pInPath);
+		}
+	} else {
+		pMot = make_clip();
+	}
+
+	if (pMot) {
+		sxMotionData* pRdc = pMot->reduce(g_tolQ, g_tolT);
+		if (pRdc) {
+			size_t trkSize = pMot->get_tracks_size();
+			size_t rdcSize = pRdc->get_tracks_size();
+			nxCore::dbg_msg("%d nodes, %d frames\n", pMot->mNodeNum, pMot->mFrameNum);
+			nxCore::dbg_msg("tracks: %d -> %d bytes (%.1f%%)\n", int(trkSize), int(rdcSize), double(rdcSize) * 100.0 / double(trkSize));
+			nxCore::dbg_msg("file: %d -> %d bytes\n", int(pMot->mFileSize), int(pRdc->mFileSize));
+			float errQ = 0.0f;
+			float errT = 0.0f;
+			calc_err(pMot, pRdc, &errQ, &errT);
+			nxCore::dbg_msg("max error: %f degrees, %f units\n", errQ, errT);
+			double dtSrc = eval_clip(pMot);
+			double dtRdc = eval_clip(pRdc);
+			nxCore::dbg_msg("eval: %f millis (quantized frames), %f millis (reduced keys)\n", dtSrc * 1e-3, dtRdc * 1e-3);
+			const char* pOutPath = nxApp::get_opt("out");
+			if (pOutPath) {
+				nxCore::bin_save(pOutPath, pRdc, pRdc->mFileSize);
+			}
+			nxCore::mem_free(pRdc);
+		}
+		nxData::unload(pMot);
+	}
+
+	nxApp::reset();
+	reset_sys();
+	return s_evalSum == 0.12345f ? 1 : 0;
+}
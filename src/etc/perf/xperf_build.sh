@@ -14,3 +14,5 @@ $CXX_CMD perf_nnmul_dyn.cpp -o perf_nnmul_dyn $*
 $CXX_CMD perf_isect.cpp -o perf_isect $*
 $CXX_CMD perf_mkbvh.cpp -o perf_mkbvh $*
 $CXX_CMD perf_shpano.cpp -o perf_shpano $*
+$CXX_CMD perf_xmot.cpp -o perf_xmot $*
+$CXX_CMD ../../scene.cpp perf_capsweep.cpp -o perf_capsweep $*
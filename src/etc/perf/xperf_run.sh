@@ -21,3 +21,11 @@ echo -------- make AABB-tree
 echo
 echo -------- SH pano
 ./perf_shpano -w:1024 -h:512
+
+echo
+echo -------- motion eval: quantized frames vs reduced keys
+./perf_xmot -tolq:0.0005 -tolt:0.0005
+
+echo
+echo -------- wall adjustment: iterative vs sweep
+./perf_capsweep -pillars:300 -chars:200 -steps:500
@@ -0,0 +1,75 @@
+// g++ -pthread -I ../.. ../../crosscore.cpp xcol_qbvh.cpp -o xcol_qbvh -O3 -flto
+
+#include "crosscore.hpp"
+
+static void dbgmsg_impl(const char* pMsg) {
+	::fprintf(stderr, "%s", pMsg);
+	::fflush(stderr);
+}
+
+static void init_sys() {
+	sxSysIfc sysIfc;
+	nxCore::mem_zero(&sysIfc, sizeof(sysIfc));
+	sysIfc.fn_dbgmsg = dbgmsg_impl;
+	nxSys::init(&sysIfc);
+}
+
+static void reset_sys() {
+}
+
+int main(int argc, char* argv[]) {
+	nxApp::init_params(argc, argv);
+	init_sys();
+
+	int bits = nxApp::get_int_opt("bits", 16) > 8 ? 16 : 8;
+
+	const char* pInPath = nxApp::get_opt("in");
+	if (!pInPath) {
+		pInPath = nxApp::get_args_count() > 0 ? nxApp::get_arg(0) : nullptr;
+	}
+	const char* pOutPath = nxApp::get_opt("out");
+	if (!pOutPath) {
+		pOutPath = nxApp::get_args_count() > 1 ? nxApp::get_arg(1) : nullptr;
+	}
+	if (!pInPath || !pOutPath) {
+		nxCore::dbg_msg("xcol_qbvh -in:<src.xcol|src.xgeo> -out:<dst> [-bits:<8|16>]\n");
+		reset_sys();
+		return 1;
+	}
+
+	int res = 1;
+	sxData* pData = nxData::load(pInPath);
+	if (pData) {
+		sxData* pDst = nullptr;
+		const sxQBVH* pQBVH = nullptr;
+		if (pData->is<sxCollisionData>()) {
+			sxCollisionData* pCol = pData->as<sxCollisionData>()->make_QBVH(bits);
+			if (pCol) {
+				pQBVH = pCol->get_QBVH();
+				pDst = pCol;
+			}
+		} else if (pData->is<sxGeometryData>()) {
+			sxGeometryData* pGeo = pData->as<sxGeometryData>()->make_QBVH(bits);
+			if (pGeo) {
+				pQBVH = pGeo->get_QBVH();
+				pDst = pGeo;
+			}
+		}
+		if (pDst) {
+			nxCore::dbg_msg("%s: %d nodes, max depth %d, %d-bit boxes\n", pInPath, int(pQBVH->mNodesNum), int(pQBVH->mMaxDepth), int(pQBVH->mBits));
+			nxCore::bin_save(pOutPath, pDst, pDst->mFileSize);
+			nxCore::dbg_msg("-> %s (%d -> %d bytes)\n", pOutPath, int(pData->mFileSize), int(pDst->mFileSize));
+			nxCore::mem_free(pDst);
+			res = 0;
+		} else {
+			nxCore::dbg_msg("can't convert \"%s\"\n", pInPath);
+		}
+		nxData::unload(pData);
+	} else {
+		nxCore::dbg_msg("can't load \"%s\"\n", pInPath);
+	}
+
+	nxApp::reset();
+	reset_sys();
+	return res;
+}
@@ -0,0 +1,63 @@
+// g++ -pthread -I ../.. ../../crosscore.cpp xmot_reduce.cpp -o xmot_reduce -O3 -flto
+
+#include "crosscore.hpp"
+
+static void dbgmsg_impl(const char* pMsg) {
+	::fprintf(stderr, "%s", pMsg);
+	::fflush(stderr);
+}
+
+static void init_sys() {
+	sxSysIfc sysIfc;
+	nxCore::mem_zero(&sysIfc, sizeof(sysIfc));
+	sysIfc.fn_dbgmsg = dbgmsg_impl;
+	nxSys::init(&sysIfc);
+}
+
+static void reset_sys() {
+}
+
+int main(int argc, char* argv[]) {
+	nxApp::init_params(argc, argv);
+	init_sys();
+
+	float tolQ = nxApp::get_float_opt("tolq", 1.0e-4f);
+	float tolT = nxApp::get_float_opt("tolt", 1.0e-4f);
+
+	const char* pInPath = nxApp::get_opt("in");
+	if (!pInPath) {
+		pInPath = nxApp::get_args_count() > 0 ? nxApp::get_arg(0) : nullptr;
+	}
+	const char* pOutPath = nxApp::get_opt("out");
+	if (!pOutPath) {
+		pOutPath = nxApp::get_args_count() > 1 ? nxApp::get_arg(1) : nullptr;
+	}
+	if (!pInPath || !pOutPath) {
+		nxCore::dbg_msg("xmot_reduce -in:<src.xmot> -out:<dst.xmot> [-tolq:<log-quat tolerance>] [-tolt:<position tolerance>]\n");
+		reset_sys();
+		return 1;
+	}
+
+	int res = 1;
+	sxMotionData* pMot = nxData::load_as<sxMotionData>(pInPath);
+	if (pMot) {
+		sxMotionData* pRdc = pMot->reduce(tolQ, tolT);
+		if (pRdc) {
+			nxCore::dbg_msg("%s: %d nodes, %d frames\n", pInPath, pMot->mNodeNum, pMot->mFrameNum);
+			nxCore::dbg_msg("tracks: %d -> %d bytes\n", int(pMot->get_tracks_size()), int(pRdc->get_tracks_size()));
+			nxCore::bin_save(pOutPath, pRdc, pRdc->mFileSize);
+			nxCore::dbg_msg("-> %s (%d bytes)\n", pOutPath, int(pRdc->mFileSize));
+			nxCore::mem_free(pRdc);
+			res = 0;
+		} else {
+			nxCore::dbg_msg("can't reduce \"%s\"\n", pInPath);
+		}
+		nxData::unload(pMot);
+	} else {
+		nxCore::dbg_msg("can't load \"%s\"\n", pInPath);
+	}
+
+	nxApp::reset();
+	reset_sys();
+	return res;
+}
@@ -269,9 +269,15 @@ static void init_scn(const char* pAppPath) {
 	}
 	scnCfg.pAppPath = pAppPath;
 	scnCfg.shadowMapSize = nxApp::get_int_opt("smap", 1024 * defSmapScl);
+	scnCfg.shadowCascades = nxApp::get_int_opt("smap_cascades", scnCfg.shadowCascades);
 	scnCfg.numWorkers = nxApp::get_int_opt("nwrk", XD_MAIN_DEF_NWRK);
 	scnCfg.useBump = nxApp::get_bool_opt("bump", c_defBump);
 	scnCfg.useSpec = nxApp::get_bool_opt("spec", c_defSpec);
+	scnCfg.motCacheSlots = nxApp::get_int_opt("mot_cache", scnCfg.motCacheSlots);
+	scnCfg.animLODMaxInterval = nxApp::get_int_opt("anim_lod", scnCfg.animLODMaxInterval);
+	scnCfg.animLODDist = nxApp::get_float_opt("anim_lod_dist", scnCfg.animLODDist);
+	scnCfg.animLODStepDist = nxApp::get_float_opt("anim_lod_step", scnCfg.animLODStepDist);
+	scnCfg.animLODMaskDist = nxApp::get_float_opt("anim_lod_mask_dist", scnCfg.animLODMaskDist);
 	nxCore::dbg_msg("#workers: %d\n", scnCfg.numWorkers);
 	nxCore::dbg_msg("shadow size: %d\n", scnCfg.shadowMapSize);
 	Scene::init(scnCfg);
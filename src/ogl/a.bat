@@ -20,7 +20,7 @@ goto :EOF
 :vert
 	call :make_vtx_descr %1
 	set dst=%DST_DIR%\%2
-	set src=prologue_vert.h+gpu_defs.h+gpu_params_vert.h+%VTX_TMP%+frag.h+f_vtxout.glsl+f_octa.glsl+%3
+	set src=prologue_vert.h+gpu_defs.h+gpu_blocks.h+gpu_params_vert.h+%VTX_TMP%+frag.h+f_vtxout.glsl+f_octa.glsl+%3
 	echo %2
 	echo GPU_SHADER(%~n2, vert) >> %SHADERS%
 	copy /BY %src% %dst% > nul
@@ -33,7 +33,7 @@ goto :EOF
 	if not x%3==x (
 		set top=%3
 	)
-	set src=%top%+gpu_defs.h+gpu_params_frag.h+frag.h+texs.h+f_tex.glsl+f_pixout.glsl+%2
+	set src=%top%+gpu_defs.h+gpu_blocks.h+gpu_params_frag.h+frag.h+texs.h+f_tex.glsl+f_pixout.glsl+%2
 	echo %1
 	echo GPU_SHADER(%~n1, frag) >> %SHADERS%
 	copy /BY %src% %dst% > nul
@@ -60,6 +60,12 @@ call :vert vtx_skin1 skin1_vl.vert f_skin.glsl+f_hemi.glsl+skin1_vl.vert
 call :vert vtx_rigid1 rigid1_vl.vert f_hemi.glsl+rigid1_vl.vert
 
 
+rem instanced rigid
+
+call :vert vtx_rigid0_inst rigid0_inst.vert rigid0_inst.vert
+call :vert vtx_rigid1_inst rigid1_inst.vert rigid1_inst.vert
+
+
 
 rem hemi light
 
@@ -169,3 +175,7 @@ call :frag quad.frag quad.frag
 rem font
 call :vert vtx_font font.vert font.vert
 call :frag font.frag font.frag
+
+rem batched text
+call :vert vtx_text text.vert text.vert
+call :frag text.frag text.frag
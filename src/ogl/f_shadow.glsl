@@ -180,8 +180,43 @@ FULL float calcShadowValR(FULL vec4 spos) {
 	return (z.x + z.y) * 0.5;
 }
 
+bool ckShadowCascade(FULL vec2 loc) {
+	FULL float lo = gpShadowCascadeCtrl.w;
+	return all(greaterThanEqual(loc, vec2(lo))) && all(lessThanEqual(loc, vec2(1.0 - lo)));
+}
+
+// first cascade whose footprint holds the point, so casters skipped as covered by a nearer one are never looked up
+FULL vec4 calcShadowCascadePos(FULL vec4 spos) {
+	FULL vec2 uv = spos.xy / spos.w;
+	FULL vec2 tsize = gpShadowCascadeCtrl.yz;
+	FULL float n = gpShadowCascadeCtrl.x;
+	FULL vec2 loc = uv * gpShadowCascade[0].xy + gpShadowCascade[0].zw;
+	FULL vec2 org = vec2(0.0);
+	bool found = ckShadowCascade(loc);
+	if (!found) {
+		loc = uv * gpShadowCascade[1].xy + gpShadowCascade[1].zw;
+		org = vec2(tsize.x, 0.0);
+		found = ckShadowCascade(loc);
+	}
+	if (!found && n > 2.5) {
+		loc = uv * gpShadowCascade[2].xy + gpShadowCascade[2].zw;
+		org = vec2(0.0, tsize.y);
+		found = ckShadowCascade(loc);
+	}
+	if (!found && n > 3.5) {
+		loc = uv * gpShadowCascade[3].xy + gpShadowCascade[3].zw;
+		org = tsize;
+		found = ckShadowCascade(loc);
+	}
+	return found ? vec4((org + loc*tsize) * spos.w, spos.z, spos.w) : vec4(0.0, 0.0, -spos.w, spos.w);
+}
+
 FULL vec4 calcShadowPos(FULL vec3 wpos) {
-	return gpShadowMtx * vec4(wpos, 1.0);
+	FULL vec4 spos = gpShadowMtx * vec4(wpos, 1.0);
+	if (gpShadowCascadeCtrl.x > 1.5) {
+		spos = calcShadowCascadePos(spos);
+	}
+	return spos;
 }
 
 FULL float calcShadowVal() {
@@ -0,0 +1,37 @@
+#ifdef GPU_UBO
+layout(std140) uniform GPUFrame {
+	mat4 gpViewProj;
+	mat4 gpShadowMtx;
+	vec3 gpViewPos;
+	vec3 gpHemiUp;
+	vec3 gpHemiUpper;
+	vec3 gpHemiLower;
+	vec3 gpHemiParam; // exp, gain
+	vec3 gpSpecLightDir;
+	vec4 gpSpecLightColor; // a: shadowing (1 == full)
+	vec3 gpVtxHemiUp;
+	vec3 gpVtxHemiUpper;
+	vec3 gpVtxHemiLower;
+	vec3 gpVtxHemiParam; // exp, gain
+	vec4 gpShadowSize; // w, h, 1/w, 1/h
+	vec4 gpShadowFade; // start, falloff
+	vec4 gpFogColor; // rgb, density
+	vec4 gpFogParam; // start, falloff, curveP1, curveP2
+	vec3 gpInvWhite;
+	vec3 gpLClrGain;
+	vec3 gpLClrBias;
+	vec3 gpExposure;
+	vec3 gpInvGamma;
+	vec4 gpShadowCascade[4]; // xy: scale, zw: offs; gpShadowMtx xy -> cascade uv
+	vec4 gpShadowCascadeCtrl; // num, tile w, tile h, guard
+};
+
+layout(std140) uniform GPUMtl {
+	vec3 gpBaseColor;
+	vec3 gpSpecColor;
+	vec4 gpSurfParam; // roughness, fresnel
+	vec4 gpBumpParam; // scale, flipT, flipB
+	vec3 gpAlphaCtrl; // lim
+	vec4 gpShadowCtrl; // offs, wght, density
+};
+#endif
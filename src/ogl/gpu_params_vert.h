@@ -7,12 +7,14 @@ uniform vec4 gpSkinMap[JMAP_SIZE];
 
 uniform vec4 gpWorld[3];
 
+#ifndef GPU_UBO
 uniform mat4 gpViewProj;
 
 uniform vec3 gpVtxHemiUp;
 uniform vec3 gpVtxHemiUpper;
 uniform vec3 gpVtxHemiLower;
 uniform vec3 gpVtxHemiParam; // exp, gain
+#endif
 
 uniform vec4 gpTexXform; // offs.xy
 
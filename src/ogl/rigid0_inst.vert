@@ -0,0 +1,9 @@
+void main() {
+	HALF vec3 vnrm = octaDec(vtxOct);
+	FULL vec4 wm[3];
+	wm[0] = vtxIW0;
+	wm[1] = vtxIW1;
+	wm[2] = vtxIW2;
+	calcVtxOut(wm, vtxPos, vnrm, vtxTex, vtxClr, 1.0, 1.0, pixPos, pixNrm, pixTex, pixClr);
+	calcGLPos(pixPos);
+}
@@ -0,0 +1,4 @@
+void main() {
+	if (any(lessThan(pixTex, pixCPos.xy)) || any(greaterThan(pixTex, pixCPos.zw))) discard;
+	gl_FragColor = pixClr;
+}
@@ -0,0 +1,6 @@
+void main() {
+	pixTex = vtxTex;
+	pixCPos = vtxPrm;
+	pixClr = vtxClr;
+	gl_Position = vec4(vtxPos.x, vtxPos.y, 0.0, 1.0);
+}
@@ -257,6 +257,13 @@ typedef void* (GL_APIENTRYP OGLSYS_PFNGLMAPBUFFERRANGEPROC)(GLenum, GLintptr, GL
 typedef GLboolean (GL_APIENTRYP OGLSYS_PFNGLUNMAPBUFFERPROC)(GLenum);
 typedef void (GL_APIENTRYP OGLSYS_PFNGLUNIFORMBLOCKBINDINGPROC)(GLuint, GLuint, GLuint);
 typedef void (GL_APIENTRYP OGLSYS_PFNGLBINDBUFFERBASEPROC)(GLenum, GLuint, GLuint);
+typedef void (GL_APIENTRYP OGLSYS_PFNGLDRAWELEMENTSINSTANCEDPROC)(GLenum, GLsizei, GLenum, const void*, GLsizei);
+typedef void (GL_APIENTRYP OGLSYS_PFNGLVERTEXATTRIBDIVISORPROC)(GLuint, GLuint);
+typedef void (GL_APIENTRYP OGLSYS_PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint);
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#	define GL_COMPLETION_STATUS_KHR 0x91B1
 #endif
 
 #if defined(OGLSYS_DRM_ES)
@@ -407,6 +414,9 @@ static struct OGLSysGlb {
 		OGLSYS_PFNGLUNMAPBUFFERPROC pfnUnmapBuffer;
 		OGLSYS_PFNGLUNIFORMBLOCKBINDINGPROC pfnUniformBlockBinding;
 		OGLSYS_PFNGLBINDBUFFERBASEPROC pfnBindBufferBase;
+		OGLSYS_PFNGLDRAWELEMENTSINSTANCEDPROC pfnDrawElementsInstanced;
+		OGLSYS_PFNGLVERTEXATTRIBDIVISORPROC pfnVertexAttribDivisor;
+		OGLSYS_PFNGLMAXSHADERCOMPILERTHREADSKHRPROC pfnMaxShaderCompilerThreads;
 #endif
 		bool bindlessTex;
 		bool ASTC_LDR;
@@ -423,6 +433,9 @@ static struct OGLSysGlb {
 		bool nvUBUM;
 		bool nvBindlessMDI;
 		bool nvCmdLst;
+		bool ubo;
+		bool bufStorage;
+		bool parallelCompile;
 	} mExts;
 
 	OGLSys::InputHandler mInpHandler;
@@ -1857,6 +1870,13 @@ void OGLSysGlb::init_ogl() {
 	mExts.pfnUnmapBuffer = (OGLSYS_PFNGLUNMAPBUFFERPROC)eglGetProcAddress("glUnmapBuffer");
 	mExts.pfnUniformBlockBinding = (OGLSYS_PFNGLUNIFORMBLOCKBINDINGPROC)eglGetProcAddress("glUniformBlockBinding");
 	mExts.pfnBindBufferBase = (OGLSYS_PFNGLBINDBUFFERBASEPROC)eglGetProcAddress("glBindBufferBase");
+	mExts.pfnDrawElementsInstanced = (OGLSYS_PFNGLDRAWELEMENTSINSTANCEDPROC)eglGetProcAddress("glDrawElementsInstanced");
+	mExts.pfnVertexAttribDivisor = (OGLSYS_PFNGLVERTEXATTRIBDIVISORPROC)eglGetProcAddress("glVertexAttribDivisor");
+	if (!mExts.pfnDrawElementsInstanced || !mExts.pfnVertexAttribDivisor) {
+		mExts.pfnDrawElementsInstanced = (OGLSYS_PFNGLDRAWELEMENTSINSTANCEDPROC)eglGetProcAddress("glDrawElementsInstancedEXT");
+		mExts.pfnVertexAttribDivisor = (OGLSYS_PFNGLVERTEXATTRIBDIVISORPROC)eglGetProcAddress("glVertexAttribDivisorEXT");
+	}
+	mExts.pfnMaxShaderCompilerThreads = (OGLSYS_PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)eglGetProcAddress("glMaxShaderCompilerThreadsKHR");
 #endif
 
 #if defined(OGLSYS_VIVANTE_FB)
@@ -1980,6 +2000,12 @@ void OGLSysGlb::handle_ogl_ext(const GLubyte* pStr, const int lenStr) {
 			mExts.nvBindlessMDI = true;
 		} else if (oglsys_str_eq(buf, "GL_NV_command_list")) {
 			mExts.nvCmdLst = true;
+		} else if (oglsys_str_eq(buf, "GL_ARB_uniform_buffer_object")) {
+			mExts.ubo = true;
+		} else if (oglsys_str_eq(buf, "GL_ARB_buffer_storage")) {
+			mExts.bufStorage = true;
+		} else if (oglsys_str_eq(buf, "GL_KHR_parallel_shader_compile") || oglsys_str_eq(buf, "GL_ARB_parallel_shader_compile")) {
+			mExts.parallelCompile = true;
 		}
 	}
 }
@@ -2267,6 +2293,129 @@ void OGLSysParamsBuf::bind() {
 #endif
 }
 
+#if OGLSYS_ES || defined(OGLSYS_APPLE) || defined(OGLSYS_WEB)
+#	define OGLSYS_STRM_PERSISTENT 0
+#else
+#	define OGLSYS_STRM_PERSISTENT 1
+#endif
+
+void OGLSysStreamBuf::init(const GLenum target, const uint32_t segSize) {
+	mTarget = target;
+	mBufHandle = 0;
+	mSegSize = (segSize + 0xFF) & ~0xFFU;
+	mSize = mSegSize * NUM_SEGS;
+	mTop = 0;
+	mSeg = 0;
+	mpMap = nullptr;
+	for (int i = 0; i < NUM_SEGS; ++i) {
+		mpFences[i] = nullptr;
+	}
+	mWaitCnt = 0;
+	if (segSize == 0) return;
+	glGenBuffers(1, &mBufHandle);
+	if (!mBufHandle) return;
+	glBindBuffer(target, mBufHandle);
+#if OGLSYS_STRM_PERSISTENT
+	if (OGLSys::ext_ck_buffer_storage()) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(target, mSize, nullptr, flags);
+		mpMap = glMapBufferRange(target, 0, mSize, flags);
+		if (!mpMap) {
+			/* storage is immutable once allocated, start over with a regular buffer */
+			glBindBuffer(target, 0);
+			glDeleteBuffers(1, &mBufHandle);
+			mBufHandle = 0;
+			glGenBuffers(1, &mBufHandle);
+			if (!mBufHandle) return;
+			glBindBuffer(target, mBufHandle);
+		}
+	}
+#endif
+	if (!mpMap) {
+		glBufferData(target, mSize, nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(target, 0);
+}
+
+void OGLSysStreamBuf::reset() {
+#if OGLSYS_STRM_PERSISTENT
+	for (int i = 0; i < NUM_SEGS; ++i) {
+		if (mpFences[i]) {
+			glDeleteSync((GLsync)mpFences[i]);
+			mpFences[i] = nullptr;
+		}
+	}
+	if (mpMap && mBufHandle) {
+		glBindBuffer(mTarget, mBufHandle);
+		glUnmapBuffer(mTarget);
+		glBindBuffer(mTarget, 0);
+	}
+#endif
+	mpMap = nullptr;
+	if (mBufHandle) {
+		glDeleteBuffers(1, &mBufHandle);
+		mBufHandle = 0;
+	}
+	mTop = 0;
+	mSeg = 0;
+}
+
+bool OGLSysStreamBuf::put(const void* pData, const uint32_t size, const uint32_t align, uint32_t* pOffs) {
+	if (!mBufHandle || !pData || size == 0) return false;
+	uint32_t a = align > 0 ? align : 1;
+	uint32_t offs = ((mTop + a - 1) / a) * a;
+	if (mpMap) {
+		if (size > mSegSize) return false;
+		if (offs + size > (mSeg + 1) * mSegSize) {
+			next_seg();
+			offs = mTop;
+		}
+		oglsys_mem_cpy((uint8_t*)mpMap + offs, pData, size);
+	} else {
+		if (size > mSize) return false;
+		glBindBuffer(mTarget, mBufHandle);
+		if (offs + size > mSize) {
+			/* orphan: the driver keeps the old storage alive for in-flight draws */
+			glBufferData(mTarget, mSize, nullptr, GL_STREAM_DRAW);
+			offs = 0;
+		}
+		glBufferSubData(mTarget, offs, size, pData);
+		glBindBuffer(mTarget, 0);
+	}
+	mTop = offs + size;
+	if (pOffs) {
+		*pOffs = offs;
+	}
+	return true;
+}
+
+void OGLSysStreamBuf::next_seg() {
+	if (!mpMap) return;
+#if OGLSYS_STRM_PERSISTENT
+	mpFences[mSeg] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	mSeg = (mSeg + 1) % NUM_SEGS;
+	GLsync fence = (GLsync)mpFences[mSeg];
+	if (fence) {
+		GLenum res = glClientWaitSync(fence, 0, 0);
+		if (res == GL_TIMEOUT_EXPIRED) {
+			++mWaitCnt;
+			do {
+				res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (res == GL_TIMEOUT_EXPIRED);
+		}
+		glDeleteSync(fence);
+		mpFences[mSeg] = nullptr;
+	}
+#endif
+	mTop = mSeg * mSegSize;
+}
+
+void OGLSysStreamBuf::frame_end() {
+	if (mpMap && mTop > mSeg * mSegSize) {
+		next_seg();
+	}
+}
+
 static void create_const_tex(GLuint* pHandle, uint32_t rgba) {
 	if (!pHandle) return;
 	if (*pHandle) return;
@@ -2897,6 +3046,15 @@ namespace OGLSys {
 	}
 
 	GLuint compile_shader_str(const char* pSrc, size_t srcSize, GLenum kind) {
+		GLuint sid = compile_shader_str_nock(pSrc, srcSize, kind);
+		if (sid && !ck_compile_status(sid)) {
+			glDeleteShader(sid);
+			sid = 0;
+		}
+		return sid;
+	}
+
+	GLuint compile_shader_str_nock(const char* pSrc, size_t srcSize, GLenum kind) {
 		GLuint sid = 0;
 		if (valid() && pSrc && srcSize > 0) {
 			sid = glCreateShader(kind);
@@ -2904,26 +3062,33 @@ namespace OGLSys {
 				GLint len[1] = { (GLint)srcSize };
 				glShaderSource(sid, 1, (const GLchar* const*)&pSrc, len);
 				glCompileShader(sid);
-				GLint status = 0;
-				glGetShaderiv(sid, GL_COMPILE_STATUS, &status);
-				if (!status) {
-					GLint infoLen = 0;
-					glGetShaderiv(sid, GL_INFO_LOG_LENGTH, &infoLen);
-					if (infoLen > 0) {
-						char* pInfo = (char*)GLG.mem_alloc(infoLen, "OGLSys:ShaderInfo");
-						if (pInfo) {
-							glGetShaderInfoLog(sid, infoLen, &infoLen, pInfo);
-							glg_dbg_info(pInfo, infoLen);
-							GLG.mem_free(pInfo);
-							pInfo = nullptr;
-						}
+			}
+		}
+		return sid;
+	}
+
+	bool ck_compile_status(const GLuint sid) {
+		bool res = false;
+		if (sid) {
+			GLint status = 0;
+			glGetShaderiv(sid, GL_COMPILE_STATUS, &status);
+			if (status) {
+				res = true;
+			} else {
+				GLint infoLen = 0;
+				glGetShaderiv(sid, GL_INFO_LOG_LENGTH, &infoLen);
+				if (infoLen > 0) {
+					char* pInfo = (char*)GLG.mem_alloc(infoLen, "OGLSys:ShaderInfo");
+					if (pInfo) {
+						glGetShaderInfoLog(sid, infoLen, &infoLen, pInfo);
+						glg_dbg_info(pInfo, infoLen);
+						GLG.mem_free(pInfo);
+						pInfo = nullptr;
 					}
-					glDeleteShader(sid);
-					sid = 0;
 				}
 			}
 		}
-		return sid;
+		return res;
 	}
 
 	GLuint compile_shader_file(const char* pSrcPath, GLenum kind) {
@@ -3022,6 +3187,34 @@ namespace OGLSys {
 		return res;
 	}
 
+	bool ck_prog_ready(const GLuint pid) {
+		bool res = true;
+		if (pid && GLG.mExts.parallelCompile) {
+			GLint status = GL_TRUE;
+			glGetProgramiv(pid, GL_COMPLETION_STATUS_KHR, &status);
+			res = status != GL_FALSE;
+		}
+		return res;
+	}
+
+	void set_compile_threads(const uint32_t num) {
+#if OGLSYS_ES
+		if (GLG.mExts.pfnMaxShaderCompilerThreads != nullptr) {
+			GLG.mExts.pfnMaxShaderCompilerThreads(num);
+		}
+#elif defined(OGLSYS_APPLE)
+		/* no-op */
+#elif defined(OGLSYS_WEB)
+		/* no-op */
+#else
+		if (glMaxShaderCompilerThreadsKHR != nullptr) {
+			glMaxShaderCompilerThreadsKHR(num);
+		} else if (glMaxShaderCompilerThreadsARB != nullptr) {
+			glMaxShaderCompilerThreadsARB(num);
+		}
+#endif
+	}
+
 	bool link_prog_id(const GLuint pid) {
 		bool res = false;
 		if (pid) {
@@ -3312,6 +3505,38 @@ namespace OGLSys {
 #endif
 	}
 
+	void draw_tris_inst(const int ntris, const GLenum idxType, const intptr_t ibOrg, const int ninst) {
+#if OGLSYS_ES
+		if (GLG.mExts.pfnDrawElementsInstanced != nullptr) {
+			GLG.mExts.pfnDrawElementsInstanced(GL_TRIANGLES, ntris * 3, idxType, (const void*)ibOrg, ninst);
+		}
+#elif defined(OGLSYS_APPLE)
+		/* no-op */
+#elif defined(OGLSYS_WEB)
+		/* no-op */
+#else
+		if (glDrawElementsInstanced != nullptr) {
+			glDrawElementsInstanced(GL_TRIANGLES, ntris * 3, idxType, (const void*)ibOrg, ninst);
+		}
+#endif
+	}
+
+	void vtx_attr_divisor(const GLuint iattr, const GLuint div) {
+#if OGLSYS_ES
+		if (GLG.mExts.pfnVertexAttribDivisor != nullptr) {
+			GLG.mExts.pfnVertexAttribDivisor(iattr, div);
+		}
+#elif defined(OGLSYS_APPLE)
+		/* no-op */
+#elif defined(OGLSYS_WEB)
+		/* no-op */
+#else
+		if (glVertexAttribDivisor != nullptr) {
+			glVertexAttribDivisor(iattr, div);
+		}
+#endif
+	}
+
 
 	GLuint get_black_tex() {
 		if (s_initFlg && !GLG.mWithoutCtx && GLG.valid_ogl()) {
@@ -3474,6 +3699,22 @@ namespace OGLSys {
 		return res;
 	}
 
+	bool ext_ck_instancing() {
+		bool res = false;
+#if OGLSYS_ES
+		if (GLG.mExts.pfnDrawElementsInstanced != nullptr && GLG.mExts.pfnVertexAttribDivisor != nullptr) {
+			res = true;
+		}
+#elif defined(OGLSYS_APPLE)
+#elif defined(OGLSYS_WEB)
+#else
+		if (glDrawElementsInstanced != nullptr && glVertexAttribDivisor != nullptr) {
+			res = true;
+		}
+#endif
+		return res;
+	}
+
 	bool ext_ck_mdi() {
 		return GLG.mExts.mdi;
 	}
@@ -3494,6 +3735,44 @@ namespace OGLSys {
 		return GLG.mExts.nvCmdLst;
 	}
 
+	bool ext_ck_buffer_storage() {
+		bool res = false;
+#if OGLSYS_ES
+#elif defined(OGLSYS_APPLE)
+#elif defined(OGLSYS_WEB)
+#else
+		if (GLG.mExts.bufStorage && glBufferStorage != nullptr && glMapBufferRange != nullptr && glFenceSync != nullptr && glClientWaitSync != nullptr && glDeleteSync != nullptr) {
+			res = true;
+		}
+#endif
+		return res;
+	}
+
+	bool ext_ck_parallel_compile() {
+		bool res = false;
+#if OGLSYS_ES
+		res = GLG.mExts.parallelCompile;
+#elif defined(OGLSYS_APPLE)
+#elif defined(OGLSYS_WEB)
+#else
+		res = GLG.mExts.parallelCompile;
+#endif
+		return res;
+	}
+
+	bool ext_ck_ubo() {
+		bool res = false;
+#if OGLSYS_ES
+#elif defined(OGLSYS_APPLE)
+#elif defined(OGLSYS_WEB)
+#else
+		if (GLG.mExts.ubo && glBindBufferRange != nullptr && glGetUniformBlockIndex != nullptr) {
+			res = true;
+		}
+#endif
+		return res;
+	}
+
 
 	bool get_key_state(const char code) {
 		bool* pState = nullptr;
@@ -292,6 +292,28 @@ struct OGLSysParamsBuf {
 	void bind();
 };
 
+struct OGLSysStreamBuf {
+	enum { NUM_SEGS = 3 };
+
+	GLenum mTarget;
+	GLuint mBufHandle;
+	uint32_t mSegSize;
+	uint32_t mSize;
+	uint32_t mTop;
+	int mSeg;
+	void* mpMap;
+	void* mpFences[NUM_SEGS];
+	uint32_t mWaitCnt;
+
+	void init(const GLenum target, const uint32_t segSize);
+	void reset();
+	bool is_valid() const { return mBufHandle != 0; }
+	bool is_persistent() const { return mpMap != nullptr; }
+	bool put(const void* pData, const uint32_t size, const uint32_t align, uint32_t* pOffs);
+	void next_seg();
+	void frame_end();
+};
+
 namespace OGLSys {
 
 	typedef void (*InputHandler)(const OGLSysInput& inp, void* pWk);
@@ -330,11 +352,15 @@ namespace OGLSys {
 	void* get_proc_addr(const char* pName);
 
 	GLuint compile_shader_str(const char* pSrc, size_t srcSize, GLenum kind);
+	GLuint compile_shader_str_nock(const char* pSrc, size_t srcSize, GLenum kind);
+	bool ck_compile_status(const GLuint sid);
 	GLuint compile_shader_file(const char* pSrcPath, GLenum kind);
 	GLuint link_draw_prog(GLuint sidVert, GLuint sidFrag);
 	GLuint link_prog(const GLuint* pSIDs, const int nSIDs);
 	void link_prog_id_nock(const GLuint pid);
 	bool ck_link_status(const GLuint pid);
+	bool ck_prog_ready(const GLuint pid);
+	void set_compile_threads(const uint32_t num);
 	bool link_prog_id(const GLuint pid);
 	void* get_prog_bin(GLuint pid, size_t* pSize, GLenum* pFmt);
 	void free_prog_bin(void* pBin);
@@ -353,6 +379,8 @@ namespace OGLSys {
 	void del_vao(const GLuint vao);
 
 	void draw_tris_base_vtx(const int ntris, const GLenum idxType, const intptr_t ibOrg, const int baseVtx);
+	void draw_tris_inst(const int ntris, const GLenum idxType, const intptr_t ibOrg, const int ninst);
+	void vtx_attr_divisor(const GLuint iattr, const GLuint div);
 
 	GLuint get_black_tex();
 	GLuint get_white_tex();
@@ -371,11 +399,15 @@ namespace OGLSys {
 	bool ext_ck_spv();
 	bool ext_ck_vao();
 	bool ext_ck_vtx_base();
+	bool ext_ck_instancing();
 	bool ext_ck_mdi();
 	bool ext_ck_nv_vbum();
 	bool ext_ck_nv_ubum();
 	bool ext_ck_nv_bindless_mdi();
 	bool ext_ck_nv_cmd_list();
+	bool ext_ck_ubo();
+	bool ext_ck_buffer_storage();
+	bool ext_ck_parallel_compile();
 
 	bool get_key_state(const char code);
 	bool get_key_state(const char* pName);
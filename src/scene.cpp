@@ -38,6 +38,93 @@ static bool s_scnInitFlg = false;
 
 static bool s_splitMoveFlg = false;
 
+static cxMotionEvalCache* s_pMotCache = nullptr;
+static float s_motCacheQuantDist = -1.0f;
+static float s_motCacheQuantStep = 0.0f;
+
+static int s_animLODMaxInterval = 1;
+static float s_animLODDist = 0.0f;
+static float s_animLODStepDist = 0.0f;
+static float s_animLODMaskDist = -1.0f;
+static int s_animLODPhaseCnt = 0;
+static int32_t s_animLODSkipCnt = 0;
+
+static int32_t s_colCacheHits = 0;
+static int32_t s_colCacheMisses = 0;
+
+#define SCN_COL_GENS_MAX 16
+
+struct ColGen {
+	const sxCollisionData* pCol;
+	uint32_t gen;
+};
+
+static ColGen s_colGens[SCN_COL_GENS_MAX];
+static int s_numColGens = 0;
+static uint32_t s_colGenOvf = 0; /* shared by collision data that didn't fit in s_colGens */
+
+#define SCN_OCCLUDERS_MAX 16
+#define SCN_OCCLUDER_COL_NAME "occl"
+
+static cxOcclusionBuffer* s_pOcclBuf = nullptr;
+static const sxCollisionData* s_pOccluders[SCN_OCCLUDERS_MAX];
+static int s_numOccluders = 0;
+static bool s_occlFlg = true;
+static bool s_occlActive = false;
+static int32_t s_occlCullCnt = 0;
+
+struct DrwQueItem {
+	uint64_t key;
+	ScnObj* pObj;
+	int32_t ipkt; /* packet slot, or one of the DRWQUE_ callbacks */
+	uint32_t state;
+	int32_t csc;
+};
+
+#define DRWQUE_PRE_OPAQ (-1)
+#define DRWQUE_POST_OPAQ (-2)
+
+struct DrwRecSlice {
+	int32_t org;
+	int32_t num;
+};
+
+static DrwQueItem* s_pDrwQue = nullptr;
+static Draw::BatchPacket* s_pDrwPkts = nullptr;
+static int32_t s_drwQueCap = 0;
+static DrwRecSlice* s_pDrwRecSlices = nullptr;
+static int32_t s_drwRecSliceCap = 0;
+static int32_t s_drwRecSliceNum = 0; /* per region: casts, then colour */
+static int32_t s_drwRecCastCap = 0; /* colour region origin */
+static Draw::Context s_drwRecCtx[2];
+static bool s_drwRecDiscard = false;
+static bool s_drwSortFlg = true;
+static int32_t s_drwItemCnt = 0;
+static int32_t s_drwStateChgCnt = 0;
+static int32_t s_drwStateChgUnsortedCnt = 0;
+
+#define SCN_DRW_INST_MAX 256
+
+static const Draw::BatchPacket* s_drwInstPkts[SCN_DRW_INST_MAX];
+static bool s_drwInstFlg = true;
+static int32_t s_drwInstGrpCnt = 0;
+static int32_t s_drwInstItemCnt = 0;
+
+static void obj_bat_draw(ScnObj* pObj, const int ibat, const Draw::Mode mode, const int icsc = 0);
+static bool obj_bat_ck(ScnObj* pObj, const int ibat, const Draw::Mode mode, const int icsc = 0);
+static float obj_drw_ctx_set(ScnObj* pObj, const Draw::Mode mode, const int icsc);
+static void obj_pkt_draw(ScnObj* pObj, const Draw::BatchPacket* pPkt, const int icsc);
+
+#define SCN_MAX_ANIM_LOD_MASKS 16
+
+struct AnimLODMask {
+	const sxModelData* pMdl;
+	uint32_t* pBits;
+};
+
+static AnimLODMask s_animLODMasks[SCN_MAX_ANIM_LOD_MASKS];
+static int s_numAnimLODMasks = 0;
+
 static Draw::Context s_drwCtx;
 static Draw::Context s_drwCtxStk[4];
 static int s_drwCtxSP = 0;
@@ -57,6 +144,16 @@ static float s_smapViewSize = 30.0f;
 static float s_smapViewDist = 50.0f;
 static float s_smapMargin = 30.0f;
 static bool s_useShadowCastCull = true;
+static xt_float4 s_shadowCullPlanes[4];
+static int s_smapSize = 0;
+static int s_shadowCascadesMax = 1;
+static int s_shadowCascades = 1;
+static float s_shadowCascadeDist = 0.0f;
+static float s_shadowCascadeLambda = 0.75f;
+static cxMtx s_shadowCascadeView;
+static xt_float4 s_shadowCascadeRects[Draw::SHADOW_CASCADES_MAX]; /* light view: center xy, half size, guarded half size */
+static float s_shadowCascadeNear = 0.0f;
+static float s_shadowCascadeFar = 0.0f;
 
 static float s_refScrW = -1.0f;
 static float s_refScrH = -1.0f;
@@ -66,6 +163,8 @@ static float s_fontW = -1.0f;
 static float s_fontH = -1.0f;
 static float s_fontSymSpacing = 0.05f;
 static float s_fontSpaceWidth = 0.25f;
+static xt_float4 s_textClip;
+static bool s_textClipFlg = false;
 
 static Draw::Font s_font = {};
 
@@ -89,8 +188,17 @@ void ScnCfg::set_defaults() {
 	pDataDir = "../data";
 	shadowMapSize = 2048;
 #endif
+	shadowCascades = 1;
+	occlusionWidth = 256;
+	occlusionHeight = 128;
+	occlusionTris = 8192;
 	numWorkers = 4;
 	localHeapSize = 0;
+	motCacheSlots = 256;
+	animLODMaxInterval = 1;
+	animLODDist = 20.0f;
+	animLODStepDist = 15.0f;
+	animLODMaskDist = -1.0f;
 	useSpec = true;
 	useBump = true;
 }
@@ -267,6 +375,179 @@ static void init_font(sxGeometryData* pFontGeo) {
 }
 
 
+struct ObjGridEntry {
+	ScnObj* pObj;
+	float x;
+	float y;
+	float z;
+	float r;
+	int32_t cx;
+	int32_t cy;
+	int32_t cz;
+	uint32_t bucket;
+};
+
+/* objects' adjustment spheres (prev world pos + mObjAdjYOffs, mObjAdjRadius) hashed into a uniform grid,
+   rebuilt before exec and read-only while exec jobs run */
+static struct ObjGrid {
+	ObjGridEntry* mpEntries;
+	ObjGridEntry* mpSortWk;
+	uint32_t* mpBucketOrg;
+	int mCapacity;
+	int mNumEntries;
+	uint32_t mNumBuckets;
+	uint32_t mBucketCapacity;
+	float mCellSize;
+	float mInvCellSize;
+	float mMaxRadius;
+	float mCellSizeReq;
+	bool mValid;
+
+	static uint32_t hash(const int32_t cx, const int32_t cy, const int32_t cz) {
+		return (uint32_t(cx) * 73856093U) ^ (uint32_t(cy) * 19349663U) ^ (uint32_t(cz) * 83492791U);
+	}
+
+	int32_t cell(const float v) const {
+		return int32_t(::mth_floorf(v * mInvCellSize));
+	}
+
+	static void calc_obj_sph(ScnObj* pObj, ObjGridEntry* pEntry) {
+		cxVec pos = pObj->get_prev_world_pos();
+		pEntry->pObj = pObj;
+		pEntry->x = pos.x;
+		pEntry->y = pos.y + pObj->mObjAdjYOffs;
+		pEntry->z = pos.z;
+		pEntry->r = nxCalc::max(pObj->mObjAdjRadius, 0.0f);
+	}
+
+	void reset() {
+		if (mpEntries) {
+			nxCore::mem_free(mpEntries);
+		}
+		if (mpSortWk) {
+			nxCore::mem_free(mpSortWk);
+		}
+		if (mpBucketOrg) {
+			nxCore::mem_free(mpBucketOrg);
+		}
+		float cellSizeReq = mCellSizeReq;
+		nxCore::mem_zero(this, sizeof(*this));
+		mCellSizeReq = cellSizeReq;
+	}
+
+	void build() {
+		mValid = false;
+		mNumEntries = 0;
+		int nobj = get_num_objs();
+		if (nobj < 1) return;
+		if (nobj > mCapacity) {
+			if (mpEntries) {
+				nxCore::mem_free(mpEntries);
+			}
+			if (mpSortWk) {
+				nxCore::mem_free(mpSortWk);
+			}
+			mCapacity = nobj + (nobj >> 1);
+			mpEntries = (ObjGridEntry*)nxCore::mem_alloc(mCapacity * sizeof(ObjGridEntry), "Scn:ObjGrid");
+			mpSortWk = (ObjGridEntry*)nxCore::mem_alloc(mCapacity * sizeof(ObjGridEntry), "Scn:ObjGridWk");
+		}
+		uint32_t nbuckets = 16;
+		while (nbuckets < uint32_t(nobj) * 2) {
+			nbuckets <<= 1;
+		}
+		if (nbuckets > mBucketCapacity) {
+			if (mpBucketOrg) {
+				nxCore::mem_free(mpBucketOrg);
+			}
+			mBucketCapacity = nbuckets;
+			mpBucketOrg = (uint32_t*)nxCore::mem_alloc((mBucketCapacity + 1) * sizeof(uint32_t), "Scn:ObjGridBkt");
+		}
+		if (!mpEntries || !mpSortWk || !mpBucketOrg) {
+			reset();
+			return;
+		}
+		mNumBuckets = nbuckets;
+		int n = 0;
+		float rmax = 0.0f;
+		for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
+			ScnObj* pObj = itr.item();
+			if (pObj && n < nobj) {
+				calc_obj_sph(pObj, &mpSortWk[n]);
+				rmax = nxCalc::max(rmax, mpSortWk[n].r);
+				++n;
+			}
+		}
+		mMaxRadius = rmax;
+		mCellSize = mCellSizeReq > 0.0f ? mCellSizeReq : nxCalc::max(rmax * 2.0f, 0.25f);
+		mInvCellSize = 1.0f / mCellSize;
+		nxCore::mem_zero(mpBucketOrg, (mNumBuckets + 1) * sizeof(uint32_t));
+		uint32_t bmask = mNumBuckets - 1;
+		for (int i = 0; i < n; ++i) {
+			ObjGridEntry* pEntry = &mpSortWk[i];
+			pEntry->cx = cell(pEntry->x);
+			pEntry->cy = cell(pEntry->y);
+			pEntry->cz = cell(pEntry->z);
+			pEntry->bucket = hash(pEntry->cx, pEntry->cy, pEntry->cz) & bmask;
+			++mpBucketOrg[pEntry->bucket + 1];
+		}
+		for (uint32_t i = 0; i < mNumBuckets; ++i) {
+			mpBucketOrg[i + 1] += mpBucketOrg[i];
+		}
+		for (int i = 0; i < n; ++i) {
+			uint32_t idx = mpBucketOrg[mpSortWk[i].bucket]++;
+			mpEntries[idx] = mpSortWk[i];
+		}
+		for (uint32_t i = mNumBuckets; i > 0; --i) {
+			mpBucketOrg[i] = mpBucketOrg[i - 1];
+		}
+		mpBucketOrg[0] = 0;
+		mNumEntries = n;
+		mValid = true;
+	}
+
+	template<typename CK_T> int query(const cxVec& qmin, const cxVec& qmax, CK_T& ck, bool (*func)(ScnObj*, void*), void* pWkMem) const {
+		int cnt = 0;
+		cxVec rv(mMaxRadius);
+		cxVec bmin = qmin - rv;
+		cxVec bmax = qmax + rv;
+		int32_t cx0 = cell(bmin.x);
+		int32_t cy0 = cell(bmin.y);
+		int32_t cz0 = cell(bmin.z);
+		int32_t cx1 = cell(bmax.x);
+		int32_t cy1 = cell(bmax.y);
+		int32_t cz1 = cell(bmax.z);
+		double ncells = double(cx1 - cx0 + 1) * double(cy1 - cy0 + 1) * double(cz1 - cz0 + 1);
+		if (ncells > double(mNumEntries)) {
+			for (int i = 0; i < mNumEntries; ++i) {
+				const ObjGridEntry* pEntry = &mpEntries[i];
+				if (ck(pEntry)) {
+					++cnt;
+					if (!func(pEntry->pObj, pWkMem)) return cnt;
+				}
+			}
+			return cnt;
+		}
+		uint32_t bmask = mNumBuckets - 1;
+		for (int32_t cz = cz0; cz <= cz1; ++cz) {
+			for (int32_t cy = cy0; cy <= cy1; ++cy) {
+				for (int32_t cx = cx0; cx <= cx1; ++cx) {
+					uint32_t bkt = hash(cx, cy, cz) & bmask;
+					uint32_t org = mpBucketOrg[bkt];
+					uint32_t end = mpBucketOrg[bkt + 1];
+					for (uint32_t i = org; i < end; ++i) {
+						const ObjGridEntry* pEntry = &mpEntries[i];
+						if (pEntry->cx == cx && pEntry->cy == cy && pEntry->cz == cz && ck(pEntry)) {
+							++cnt;
+							if (!func(pEntry->pObj, pWkMem)) return cnt;
+						}
+					}
+				}
+			}
+		}
+		return cnt;
+	}
+} s_objGrid = {};
+
 void init(const ScnCfg& cfg) {
 	if (s_scnInitFlg) return;
 
@@ -304,7 +585,7 @@ void init(const ScnCfg& cfg) {
 #endif
 	}
 	if (s_pBgd) {
-		s_numBgdJobCnts = (/*cpy_prev*/1 + SCN_NUM_EXEC_PRIO + /*vis*/1) * s_pBgd->get_workers_num();
+		s_numBgdJobCnts = (/*cpy_prev*/1 + SCN_NUM_EXEC_PRIO + /*vis*/1 + /*drw_rec*/1) * s_pBgd->get_workers_num();
 		size_t jcntsMemSize = s_numBgdJobCnts*sizeof(int);
 		s_pBgdJobCnts = (int*)nxCore::mem_alloc(jcntsMemSize, "Scn:job_cnts");
 		if (s_pBgdJobCnts) {
@@ -368,6 +649,12 @@ void init(const ScnCfg& cfg) {
 	}
 
 	s_smapDisabled = (cfg.shadowMapSize <= 0);
+	s_smapSize = cfg.shadowMapSize;
+	s_shadowCascadesMax = 1;
+	if (s_pDraw && s_pDraw->init_shadow_cascades && !s_smapDisabled && cfg.shadowCascades > 1) {
+		s_shadowCascadesMax = nxCalc::clamp(s_pDraw->init_shadow_cascades(cfg.shadowCascades), 1, int(Draw::SHADOW_CASCADES_MAX));
+	}
+	s_shadowCascades = s_shadowCascadesMax;
 
 	set_quad_gamma(2.2f);
 
@@ -381,6 +668,35 @@ void init(const ScnCfg& cfg) {
 
 	s_splitMoveFlg = false;
 
+	s_pMotCache = cxMotionEvalCache::create(cfg.motCacheSlots, XD_MOTEVAL_CACHE_MAX_NODES, s_pBgd != nullptr);
+	s_motCacheQuantDist = -1.0f;
+	s_motCacheQuantStep = 0.0f;
+
+	s_animLODMaxInterval = nxCalc::max(cfg.animLODMaxInterval, 1);
+	s_animLODDist = cfg.animLODDist;
+	s_animLODStepDist = nxCalc::max(cfg.animLODStepDist, 1.0e-3f);
+	s_animLODMaskDist = cfg.animLODMaskDist;
+	s_animLODPhaseCnt = 0;
+	s_animLODSkipCnt = 0;
+	s_numAnimLODMasks = 0;
+	s_colCacheHits = 0;
+	s_colCacheMisses = 0;
+	s_numColGens = 0;
+	s_colGenOvf = 0;
+	s_drwSortFlg = true;
+	s_drwItemCnt = 0;
+	s_drwStateChgCnt = 0;
+	s_drwStateChgUnsortedCnt = 0;
+	s_drwInstFlg = true;
+	s_drwInstGrpCnt = 0;
+	s_drwInstItemCnt = 0;
+
+	s_pOcclBuf = cxOcclusionBuffer::create(cfg.occlusionWidth, cfg.occlusionHeight, cfg.occlusionTris);
+	s_numOccluders = 0;
+	s_occlFlg = true;
+	s_occlActive = false;
+	s_occlCullCnt = 0;
+
 	s_scnInitFlg = true;
 }
 
@@ -447,6 +763,32 @@ void reset() {
 		s_pDraw->reset();
 	}
 
+	cxMotionEvalCache::destroy(s_pMotCache);
+	s_pMotCache = nullptr;
+	cxOcclusionBuffer::destroy(s_pOcclBuf);
+	s_pOcclBuf = nullptr;
+	s_numOccluders = 0;
+	clear_anim_lod_masks();
+	s_numColGens = 0;
+
+	if (s_pDrwQue) {
+		nxCore::mem_free(s_pDrwQue);
+		s_pDrwQue = nullptr;
+	}
+	if (s_pDrwPkts) {
+		nxCore::mem_free(s_pDrwPkts);
+		s_pDrwPkts = nullptr;
+	}
+	s_drwQueCap = 0;
+	if (s_pDrwRecSlices) {
+		nxCore::mem_free(s_pDrwRecSlices);
+		s_pDrwRecSlices = nullptr;
+	}
+	s_drwRecSliceCap = 0;
+	s_drwRecSliceNum = 0;
+	s_drwRecCastCap = 0;
+
+	s_objGrid.reset();
 	ObjList::destroy(s_pObjList);
 	s_pObjList = nullptr;
 	ObjMap::destroy(s_pObjMap);
@@ -537,16 +879,69 @@ void release_all_gfx() {
 	}
 }
 
+static void purge_pkg_anim_lod_masks(Pkg* pPkg) {
+	if (!s_pRsrcMgr || !pPkg) return;
+	int i = 0;
+	while (i < s_numAnimLODMasks) {
+		AnimLODMask* pMask = &s_animLODMasks[i];
+		if (s_pRsrcMgr->find_pkg_for_data((sxData*)pMask->pMdl) == pPkg) {
+			nxCore::mem_free(pMask->pBits);
+			*pMask = s_animLODMasks[--s_numAnimLODMasks];
+			s_animLODMasks[s_numAnimLODMasks].pMdl = nullptr;
+			s_animLODMasks[s_numAnimLODMasks].pBits = nullptr;
+		} else {
+			++i;
+		}
+	}
+}
+
+static void purge_pkg_occluders(Pkg* pPkg) {
+	if (!s_pRsrcMgr || !pPkg) return;
+	int n = 0;
+	for (int i = 0; i < s_numOccluders; ++i) {
+		const sxCollisionData* pCol = s_pOccluders[i];
+		if (s_pRsrcMgr->find_pkg_for_data((sxData*)pCol) != pPkg) {
+			s_pOccluders[n++] = pCol;
+		}
+	}
+	if (n != s_numOccluders) {
+		s_numOccluders = n;
+		s_occlActive = false;
+	}
+}
+
+static void purge_pkg_col_gens(Pkg* pPkg) {
+	if (!s_pRsrcMgr || !pPkg) return;
+	int n = 0;
+	for (int i = 0; i < s_numColGens; ++i) {
+		if (s_pRsrcMgr->find_pkg_for_data((sxData*)s_colGens[i].pCol) != pPkg) {
+			s_colGens[n++] = s_colGens[i];
+		}
+	}
+	s_numColGens = n;
+}
+
 void unload_pkg(Pkg* pPkg) {
+	purge_pkg_anim_lod_masks(pPkg);
+	purge_pkg_occluders(pPkg);
+	purge_pkg_col_gens(pPkg);
 	if (s_pRsrcMgr) {
 		s_pRsrcMgr->unload_pkg(pPkg);
 	}
+	if (s_pMotCache) {
+		s_pMotCache->invalidate();
+	}
 }
 
 void unload_all_pkgs() {
+	clear_occluders();
+	clear_anim_lod_masks();
 	if (s_pRsrcMgr) {
 		s_pRsrcMgr->unload_all();
 	}
+	if (s_pMotCache) {
+		s_pMotCache->invalidate();
+	}
 }
 
 void release_texture(sxTextureData* pTex) {
@@ -751,6 +1146,11 @@ void frame_begin(const cxColor& clearColor) {
 	if (s_pDraw) {
 		s_pDraw->begin(clearColor);
 	}
+	s_drwItemCnt = 0;
+	s_drwStateChgCnt = 0;
+	s_drwStateChgUnsortedCnt = 0;
+	s_drwInstGrpCnt = 0;
+	s_drwInstItemCnt = 0;
 	purge_local_heaps();
 	purge_global_heap();
 
@@ -809,6 +1209,10 @@ int get_visibility_job_lvl() {
 	return 1 + SCN_NUM_EXEC_PRIO;
 }
 
+int get_draw_record_job_lvl() {
+	return 2 + SCN_NUM_EXEC_PRIO;
+}
+
 int get_wrk_jobs_done_cnt(const int lvl, const int wrkId) {
 	int cnt = 0;
 	if (lvl >= 0 && s_pBgd && s_pBgd->ck_worker_id(wrkId) && s_pBgdJobCnts) {
@@ -905,6 +1309,162 @@ bool is_split_move_enabled() {
 	return s_splitMoveFlg;
 }
 
+void enable_draw_sort(const bool flg) {
+	s_drwSortFlg = flg;
+}
+
+bool is_draw_sort_enabled() {
+	return s_drwSortFlg;
+}
+
+void enable_draw_inst(const bool flg) {
+	s_drwInstFlg = flg;
+}
+
+bool is_draw_inst_enabled() {
+	return s_drwInstFlg;
+}
+
+void enable_occlusion_cull(const bool flg) {
+	s_occlFlg = flg;
+}
+
+bool is_occlusion_cull_enabled() {
+	return s_occlFlg;
+}
+
+bool add_occluder(const sxCollisionData* pCol) {
+	if (!pCol || !s_pOcclBuf) return false;
+	for (int i = 0; i < s_numOccluders; ++i) {
+		if (s_pOccluders[i] == pCol) return true;
+	}
+	if (s_numOccluders >= SCN_OCCLUDERS_MAX) return false;
+	s_pOccluders[s_numOccluders++] = pCol;
+	return true;
+}
+
+bool add_pkg_occluder(Pkg* pPkg) {
+	return add_occluder(find_collision_in_pkg(pPkg, SCN_OCCLUDER_COL_NAME));
+}
+
+void clear_occluders() {
+	s_numOccluders = 0;
+	s_occlActive = false;
+}
+
+cxOcclusionBuffer* get_occlusion_buffer() {
+	return s_pOcclBuf;
+}
+
+
+cxMotionEvalCache* get_mot_cache() {
+	return s_pMotCache;
+}
+
+void set_mot_cache_quant(const float dist, const float frameStep) {
+	s_motCacheQuantDist = dist;
+	s_motCacheQuantStep = frameStep;
+}
+
+ScnStats get_stats() {
+	ScnStats stats;
+	stats.reset();
+	if (s_pMotCache) {
+		cxMotionEvalCache::Stats motCacheStats = s_pMotCache->get_stats();
+		stats.motCacheHits = motCacheStats.hits;
+		stats.motCacheMisses = motCacheStats.misses;
+	}
+	stats.animLODSkips = s_animLODSkipCnt;
+	stats.colCacheHits = s_colCacheHits;
+	stats.colCacheMisses = s_colCacheMisses;
+	stats.drawItems = s_drwItemCnt;
+	stats.drawStateChanges = s_drwStateChgCnt;
+	stats.drawStateChangesAvoided = s_drwStateChgUnsortedCnt - s_drwStateChgCnt;
+	stats.drawInstGroups = s_drwInstGrpCnt;
+	stats.drawInstItems = s_drwInstItemCnt;
+	if (s_occlActive) {
+		stats.occlTris = s_pOcclBuf->get_tris_num();
+	}
+	stats.occlCulled = s_occlCullCnt;
+	return stats;
+}
+
+bool set_anim_lod_mask(const sxModelData* pMdl, const char** ppNodeNames, const int numNodes) {
+	if (!pMdl || !pMdl->has_skel()) return false;
+	int nskel = pMdl->mSklNum;
+	AnimLODMask* pMask = nullptr;
+	for (int i = 0; i < s_numAnimLODMasks; ++i) {
+		if (s_animLODMasks[i].pMdl == pMdl) {
+			pMask = &s_animLODMasks[i];
+			break;
+		}
+	}
+	if (!pMask) {
+		if (s_numAnimLODMasks >= SCN_MAX_ANIM_LOD_MASKS) {
+			nxCore::dbg_msg("Scn:AnimLOD - too many masks (max %d)\n", SCN_MAX_ANIM_LOD_MASKS);
+			return false;
+		}
+		size_t bitsSize = XD_BIT_ARY_SIZE(uint32_t, nskel) * sizeof(uint32_t);
+		uint32_t* pBits = (uint32_t*)nxCore::mem_alloc(bitsSize, "ScnAnimLODMask");
+		if (!pBits) return false;
+		pMask = &s_animLODMasks[s_numAnimLODMasks++];
+		pMask->pMdl = pMdl;
+		pMask->pBits = pBits;
+	}
+	nxCore::mem_zero(pMask->pBits, XD_BIT_ARY_SIZE(uint32_t, nskel) * sizeof(uint32_t));
+	if (ppNodeNames) {
+		for (int i = 0; i < numNodes; ++i) {
+			const char* pName = ppNodeNames[i];
+			if (!pName) continue;
+			size_t nameLen = nxCore::str_len(pName);
+			if (nameLen > 1 && pName[nameLen - 1] == '*') {
+				/* "f_*" style prefix pattern */
+				char prefix[64];
+				size_t prefixLen = nxCalc::min(nameLen - 1, sizeof(prefix) - 1);
+				nxCore::mem_copy(prefix, pName, prefixLen);
+				prefix[prefixLen] = 0;
+				for (int iskl = 0; iskl < nskel; ++iskl) {
+					if (nxCore::str_starts_with(pMdl->get_skel_name(iskl), prefix)) {
+						XD_BIT_ARY_ST(uint32_t, pMask->pBits, iskl);
+					}
+				}
+			} else {
+				int iskl = pMdl->find_skel_node_id(pName);
+				if (pMdl->ck_skel_id(iskl)) {
+					XD_BIT_ARY_ST(uint32_t, pMask->pBits, iskl);
+				}
+			}
+		}
+	}
+	/* descendants of masked nodes are masked as well (skeleton nodes are ordered parents first) */
+	const int32_t* pParents = pMdl->get_skel_parents_ptr();
+	for (int i = 0; i < nskel; ++i) {
+		int iparent = pParents[i];
+		if (iparent >= 0 && iparent < nskel && XD_BIT_ARY_CK(uint32_t, pMask->pBits, iparent)) {
+			XD_BIT_ARY_ST(uint32_t, pMask->pBits, i);
+		}
+	}
+	return true;
+}
+
+const uint32_t* get_anim_lod_mask(const sxModelData* pMdl) {
+	for (int i = 0; i < s_numAnimLODMasks; ++i) {
+		if (s_animLODMasks[i].pMdl == pMdl) {
+			return s_animLODMasks[i].pBits;
+		}
+	}
+	return nullptr;
+}
+
+void clear_anim_lod_masks() {
+	for (int i = 0; i < s_numAnimLODMasks; ++i) {
+		nxCore::mem_free(s_animLODMasks[i].pBits);
+		s_animLODMasks[i].pBits = nullptr;
+		s_animLODMasks[i].pMdl = nullptr;
+	}
+	s_numAnimLODMasks = 0;
+}
+
 
 void alloc_global_heap(const size_t globalHeapSize) {
 	free_global_heap();
@@ -1252,6 +1812,7 @@ void set_shadow_density_bias(const float bias) {
 void set_shadow_fade(const float start, const float end) {
 	s_drwCtx.shadow.mFadeStart = start;
 	s_drwCtx.shadow.mFadeEnd = end;
+	s_shadowUpdateFlg = true;
 }
 
 void set_shadow_proj_params(const float size, const float margin, const float dist) {
@@ -1275,6 +1836,17 @@ cxVec get_shadow_dir() {
 	return s_drwCtx.shadow.mDir;
 }
 
+void set_shadow_cascades(const int num, const float dist, const float lambda) {
+	s_shadowCascades = nxCalc::clamp(num, 1, s_shadowCascadesMax);
+	s_shadowCascadeDist = dist;
+	s_shadowCascadeLambda = nxCalc::saturate(lambda);
+	s_shadowUpdateFlg = true;
+}
+
+int get_shadow_cascades() {
+	return s_shadowCascades;
+}
+
 static void update_shadow_uni() {
 	if (!s_shadowUpdateFlg) {
 		return;
@@ -1435,28 +2007,154 @@ static void update_shadow_persp() {
 	pCtx->shadow.mViewProjMtx = vm * fm;
 }
 
+/* per-slice bounding spheres, so a cascade's footprint doesn't swim as the camera turns */
+static void update_shadow_csm(const cxMtx& sdwBias) {
+	Draw::Context* pCtx = &s_drwCtx;
+	int ncsc = s_shadowCascades;
+	cxMtx mtxProj = Scene::get_proj_mtx();
+	cxMtx mtxInvView = Scene::get_inv_view_mtx();
+	float tw = nxCalc::rcp0(::mth_sqrtf(nxCalc::sq(mtxProj.m[0][0]) + nxCalc::sq(mtxProj.m[0][1])));
+	float th = nxCalc::rcp0(::mth_sqrtf(nxCalc::sq(mtxProj.m[1][0]) + nxCalc::sq(mtxProj.m[1][1])));
+	float k2 = nxCalc::sq(tw) + nxCalc::sq(th);
+	cxVec vpos = mtxInvView.get_translation();
+	cxVec vdir = mtxInvView.get_row_vec(2).neg_val().get_normalized();
+	cxVec dir = pCtx->shadow.mDir.get_normalized();
+	cxVec up(0.0f, 1.0f, 0.0f);
+	if (::mth_fabsf(dir.y) > 0.99f) {
+		up.set(0.0f, 0.0f, 1.0f);
+	}
+	cxMtx view;
+	view.mk_view(cxVec(0.0f), dir, up);
+	float dnear = nxCalc::max(pCtx->view.mNear, 1e-3f);
+	float dfar = s_shadowCascadeDist;
+	if (dfar <= 0.0f) {
+		dfar = pCtx->shadow.mFadeEnd > 0.0f ? pCtx->shadow.mFadeEnd : s_smapViewDist;
+	}
+	dfar = nxCalc::max(dfar, dnear * 2.0f);
+	float guard = nxCalc::min(2.0f * nxCalc::rcp0(float(s_smapSize)), 0.25f);
+	float lzmin = FLT_MAX;
+	float lzmax = -FLT_MAX;
+	float xmin = FLT_MAX;
+	float xmax = -FLT_MAX;
+	float ymin = FLT_MAX;
+	float ymax = -FLT_MAX;
+	float d0 = dnear;
+	for (int i = 0; i < ncsc; ++i) {
+		float t = float(i + 1) / float(ncsc);
+		float dlog = dnear * ::mth_powf(dfar / dnear, t);
+		float dlin = nxCalc::lerp(dnear, dfar, t);
+		float d1 = nxCalc::lerp(dlin, dlog, s_shadowCascadeLambda);
+		float c = (d0 + d1) * 0.5f * (1.0f + k2);
+		float r = 0.0f;
+		if (c < d1) {
+			r = ::mth_sqrtf(nxCalc::sq(d1 - c) + k2*nxCalc::sq(d1));
+		} else {
+			c = d1;
+			r = ::mth_sqrtf(k2) * d1;
+		}
+		r = ::mth_ceilf(r * 16.0f) / 16.0f;
+		cxVec lc = view.calc_pnt(vpos + vdir*c);
+		float texel = nxCalc::div0(2.0f * r, float(s_smapSize));
+		if (texel > 0.0f) {
+			lc.x = ::mth_floorf(lc.x / texel) * texel;
+			lc.y = ::mth_floorf(lc.y / texel) * texel;
+		}
+		s_shadowCascadeRects[i].set(lc.x, lc.y, r, r * (1.0f - 2.0f*guard));
+		lzmin = nxCalc::min(lzmin, lc.z - r);
+		lzmax = nxCalc::max(lzmax, lc.z + r);
+		xmin = nxCalc::min(xmin, lc.x - r);
+		xmax = nxCalc::max(xmax, lc.x + r);
+		ymin = nxCalc::min(ymin, lc.y - r);
+		ymax = nxCalc::max(ymax, lc.y + r);
+		d0 = d1;
+	}
+	float znear = lzmax + s_smapMargin;
+	float zfar = lzmin;
+	s_shadowCascadeView = view;
+	s_shadowCascadeNear = znear;
+	s_shadowCascadeFar = zfar;
+
+	/* base projection covers every cascade, the shader maps from it into each tile */
+	float ox = (xmin + xmax) * 0.5f;
+	float oy = (ymin + ymax) * 0.5f;
+	float oh = nxCalc::max(xmax - xmin, ymax - ymin) * 0.5f;
+	float zs = nxCalc::rcp0(znear - zfar);
+	cxMtx proj = nxMtx::identity();
+	proj.m[0][0] = nxCalc::rcp0(oh);
+	proj.m[1][1] = proj.m[0][0];
+	proj.m[3][0] = -ox * proj.m[0][0];
+	proj.m[3][1] = -oy * proj.m[1][1];
+	proj.m[2][2] = -zs;
+	proj.m[3][2] = znear * zs;
+	pCtx->shadow.mViewProjMtx = view * proj;
+	for (int i = 0; i < ncsc; ++i) {
+		xt_float4 rect = s_shadowCascadeRects[i];
+		float k = nxCalc::div0(oh, rect.z);
+		float tx = nxCalc::div0(ox - rect.x, rect.z);
+		float ty = nxCalc::div0(oy - rect.y, rect.z);
+		proj.m[0][0] = nxCalc::rcp0(rect.z);
+		proj.m[1][1] = proj.m[0][0];
+		proj.m[3][0] = -rect.x * proj.m[0][0];
+		proj.m[3][1] = -rect.y * proj.m[1][1];
+		pCtx->shadow.mCascadeViewProj[i] = view * proj;
+		pCtx->shadow.mCascadeXform[i].set(
+			k, k,
+			sdwBias.m[3][0]*(1.0f - k) + sdwBias.m[0][0]*tx,
+			sdwBias.m[3][1]*(1.0f - k) + sdwBias.m[1][1]*ty
+		);
+	}
+	pCtx->shadow.mCascadeGuard = guard;
+	pCtx->shadow.mCascadeNum = ncsc;
+}
+
+/* cascades a caster sphere lands in, dropping the ones behind a nearer cascade that already holds it whole */
+static uint32_t shadow_cascade_cast_mask(const cxAABB& box) {
+	cxVec lc = s_shadowCascadeView.calc_pnt(box.get_center());
+	float r = box.get_size_vec().mag() * 0.5f;
+	if (lc.z + r < s_shadowCascadeFar || lc.z - r > s_shadowCascadeNear) return 0;
+	uint32_t mask = 0;
+	for (int i = 0; i < s_shadowCascades; ++i) {
+		xt_float4 rect = s_shadowCascadeRects[i];
+		float dx = ::mth_fabsf(lc.x - rect.x);
+		float dy = ::mth_fabsf(lc.y - rect.y);
+		if (dx > rect.z + r || dy > rect.z + r) continue;
+		mask |= 1U << i;
+		if (dx + r <= rect.w && dy + r <= rect.w) break;
+	}
+	return mask;
+}
+
+static cxMtx shadow_bias_mtx() {
+	if (s_pDraw && s_pDraw->get_shadow_bias_mtx) {
+		return s_pDraw->get_shadow_bias_mtx();
+	}
+	static const float defSdwBias[4 * 4] = {
+		0.5f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.5f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.5f, 0.5f, 0.0f, 1.0f
+	};
+	return nxMtx::from_mem(defSdwBias);
+}
+
 static void update_shadow() {
-	if (s_shadowUniform) {
+	if (s_shadowCascades > 1) {
+		if (s_shadowUpdateFlg) {
+			update_shadow_csm(shadow_bias_mtx());
+		}
+	} else if (s_shadowUniform) {
 		update_shadow_uni();
 	} else {
 		update_shadow_persp();
 	}
 	if (s_shadowUpdateFlg) {
+		if (s_shadowCascades < 2) {
+			s_drwCtx.shadow.mCascadeNum = 1;
+		}
 		if (s_pDraw) {
-			cxMtx sdwBias;
-			if (s_pDraw->get_shadow_bias_mtx) {
-				sdwBias = s_pDraw->get_shadow_bias_mtx();
-			} else {
-				static const float defSdwBias[4 * 4] = {
-					0.5f, 0.0f, 0.0f, 0.0f,
-					0.0f, 0.5f, 0.0f, 0.0f,
-					0.0f, 0.0f, 1.0f, 0.0f,
-					0.5f, 0.5f, 0.0f, 1.0f
-				};
-				sdwBias = nxMtx::from_mem(defSdwBias);
-			}
-			s_drwCtx.shadow.mMtx = s_drwCtx.shadow.mViewProjMtx * sdwBias;
+			s_drwCtx.shadow.mMtx = s_drwCtx.shadow.mViewProjMtx * shadow_bias_mtx();
 		}
+		nxGeom::clip_xy_planes(s_drwCtx.shadow.mViewProjMtx, s_shadowCullPlanes, 2.0f);
 	}
 	s_shadowUpdateFlg = false;
 }
@@ -1466,6 +2164,11 @@ cxMtx get_shadow_view_proj_mtx() {
 	return s_drwCtx.shadow.mViewProjMtx;
 }
 
+const xt_float4* get_shadow_cull_planes() {
+	update_shadow();
+	return s_shadowCullPlanes;
+}
+
 void set_hemi_upper(const float r, const float g, const float b) {
 	s_drwCtx.hemi.mUpper.set(r, g, b);
 }
@@ -1599,6 +2302,7 @@ ScnObj* add_obj(sxModelData* pMdl, const char* pName) {
 		}
 		if (!pObj) {
 			pObj = s_pObjList->new_item();
+			s_objGrid.mValid = false;
 			if (pObj) {
 				nxCore::mem_zero((void*)pObj, sizeof(ScnObj));
 				char name[32];
@@ -1608,13 +2312,15 @@ ScnObj* add_obj(sxModelData* pMdl, const char* pName) {
 					pObjName = name;
 				}
 				int nbat = pMdl->mBatNum;
-				size_t extMemSize = XD_BIT_ARY_SIZE(uint8_t, nbat);
+				size_t extMemSize = XD_BIT_ARY_SIZE(uint32_t, nbat) * sizeof(uint32_t) * s_shadowCascadesMax;
 				size_t paramMemSize = sizeof(Draw::MdlParam);
 				pObj->mpName = nxCore::str_dup(pObjName);
 				pObj->mpMdlWk = cxModelWork::create(pMdl, paramMemSize, extMemSize);
 				pObj->mpMotWk = cxMotionWork::create(pMdl);
 				pObj->mJob.mFunc = obj_exec_job;
 				pObj->mJob.mpData = pObj;
+				pObj->mAnimLODPhase = s_animLODPhaseCnt++;
+				pObj->mAnimLODInterval = 1;
 				if (pMdl->has_skel() && pObj->mpMotWk) {
 					pObj->mpMotWk->disable_node_blending(pObj->mpMotWk->mMoveId);
 				}
@@ -1663,12 +2369,14 @@ void del_obj(ScnObj* pObj) {
 	if (!pObj) return;
 	if (!s_pObjMap) return;
 	if (!s_pObjList) return;
+	s_objGrid.mValid = false;
 	s_pObjMap->remove(pObj->mpName);
 	s_pObjList->remove(pObj);
 }
 
 void del_all_objs() {
 	if (!s_pObjList) return;
+	s_objGrid.mValid = false;
 	if (s_pObjMap) {
 		for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
 			ScnObj* pObj = itr.item();
@@ -1748,6 +2456,75 @@ void for_each_obj(bool (*func)(ScnObj*, void*), void* pWkMem) {
 	}
 }
 
+struct ObjGridSphCk {
+	cxVec c;
+	float r;
+
+	bool operator()(const ObjGridEntry* pEntry) const {
+		return nxGeom::sph_sph_overlap(c, r, cxVec(pEntry->x, pEntry->y, pEntry->z), pEntry->r);
+	}
+};
+
+struct ObjGridBoxCk {
+	cxVec bmin;
+	cxVec bmax;
+
+	bool operator()(const ObjGridEntry* pEntry) const {
+		return nxGeom::sph_aabb_overlap(cxVec(pEntry->x, pEntry->y, pEntry->z), pEntry->r, bmin, bmax);
+	}
+};
+
+template<typename CK_T> static int obj_list_query(CK_T& ck, bool (*func)(ScnObj*, void*), void* pWkMem) {
+	int cnt = 0;
+	for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
+		ScnObj* pObj = itr.item();
+		if (pObj) {
+			ObjGridEntry entry;
+			ObjGrid::calc_obj_sph(pObj, &entry);
+			if (ck(&entry)) {
+				++cnt;
+				if (!func(pObj, pWkMem)) break;
+			}
+		}
+	}
+	return cnt;
+}
+
+void update_obj_grid() {
+	if (!s_pObjList) return;
+	s_objGrid.build();
+}
+
+void set_obj_grid_cell_size(const float size) {
+	s_objGrid.mCellSizeReq = size;
+	s_objGrid.mValid = false;
+}
+
+int for_each_obj_in_sph(const cxVec& center, const float radius, bool (*func)(ScnObj*, void*), void* pWkMem) {
+	if (!s_pObjList) return 0;
+	if (!func) return 0;
+	ObjGridSphCk ck;
+	ck.c = center;
+	ck.r = radius;
+	if (s_objGrid.mValid) {
+		cxVec rv(radius);
+		return s_objGrid.query(center - rv, center + rv, ck, func, pWkMem);
+	}
+	return obj_list_query(ck, func, pWkMem);
+}
+
+int for_each_obj_in_aabb(const cxAABB& box, bool (*func)(ScnObj*, void*), void* pWkMem) {
+	if (!s_pObjList) return 0;
+	if (!func) return 0;
+	ObjGridBoxCk ck;
+	ck.bmin = box.get_min_pos();
+	ck.bmax = box.get_max_pos();
+	if (s_objGrid.mValid) {
+		return s_objGrid.query(ck.bmin, ck.bmax, ck, func, pWkMem);
+	}
+	return obj_list_query(ck, func, pWkMem);
+}
+
 void set_obj_exec_func(const char* pName, ScnObj::ExecFunc exec) {
 	ScnObj* pObj = find_obj(pName);
 	if (pObj) {
@@ -2012,6 +2789,28 @@ float get_font_height() {
 	return 1.0f;
 }
 
+void set_text_clip(const float x, const float y, const float w, const float h) {
+	s_textClip.set(x, y, x + w, y + h);
+	s_textClipFlg = true;
+}
+
+void reset_text_clip() {
+	s_textClipFlg = false;
+}
+
+static void set_sym_clip(Draw::Symbol* pSym) {
+	if (s_textClipFlg) {
+		float refScrW = get_ref_scr_width();
+		float refScrH = get_ref_scr_height();
+		pSym->clip.set(
+			nxCalc::div0(s_textClip.x, refScrW), nxCalc::div0(s_textClip.y, refScrH),
+			nxCalc::div0(s_textClip.z, refScrW), nxCalc::div0(s_textClip.w, refScrH)
+		);
+	} else {
+		pSym->clip.set(-1.0e6f, -1.0e6f, 1.0e6f, 1.0e6f);
+	}
+}
+
 static void set_sym_rot(Draw::Symbol* pSym) {
 	if (is_rot_view()) {
 		cxMtx rm = get_view_mode_mtx();
@@ -2042,6 +2841,7 @@ void symbol(const int sym, const float ox, const float oy, const cxColor clr, co
 	float drwSY = nxCalc::div0(fontH*scrSY, scrH);
 	Draw::Symbol drwSym;
 	set_sym_rot(&drwSym);
+	set_sym_clip(&drwSym);
 	drwSym.sym = sym;
 	if (pOutClr) {
 		drwSym.ox = drwOX - nxCalc::rcp0(scrW);
@@ -2080,6 +2880,7 @@ void symbol_str(const char* pStr, const float ox, const float oy, const cxColor
 	float spcWidth = s_fontSpaceWidth;
 	Draw::Symbol drwSym;
 	set_sym_rot(&drwSym);
+	set_sym_clip(&drwSym);
 	drwSym.oy = drwOY;
 	drwSym.sx = drwSX;
 	drwSym.sy = drwSY;
@@ -2102,14 +2903,41 @@ void symbol_str(const char* pStr, const float ox, const float oy, const cxColor
 }
 
 
-float get_ground_height(sxCollisionData* pCol, const cxVec pos, const float offsTop, const float offsBtm) {
+bool refit_collision(sxCollisionData* pCol, const cxVec* pPnts, const float rebuildCost) {
+	if (!pCol) return false;
+	bool rebuilt = pCol->refit_BVH(pPnts, rebuildCost, s_pBgd);
+	int i = 0;
+	while (i < s_numColGens && s_colGens[i].pCol != pCol) {
+		++i;
+	}
+	if (i < s_numColGens) {
+		++s_colGens[i].gen;
+	} else if (s_numColGens < SCN_COL_GENS_MAX) {
+		s_colGens[i].pCol = pCol;
+		s_colGens[i].gen = s_colGenOvf + 1;
+		++s_numColGens;
+	} else {
+		++s_colGenOvf;
+	}
+	return rebuilt;
+}
+
+uint32_t get_collision_generation(const sxCollisionData* pCol) {
+	for (int i = 0; i < s_numColGens; ++i) {
+		if (s_colGens[i].pCol == pCol) return s_colGens[i].gen;
+	}
+	return s_colGenOvf;
+}
+
+float get_ground_height(sxCollisionData* pCol, const cxVec pos, const float offsTop, const float offsBtm, ScnColCache* pCache) {
 	float h = pos.y;
 	if (pCol) {
 		cxVec posTop = pos;
 		cxVec posBtm = pos;
 		posTop.y += offsTop;
 		posBtm.y -= offsBtm;
-		sxCollisionData::NearestHit gndHit = pCol->nearest_hit(cxLineSeg(posTop, posBtm));
+		cxLineSeg seg(posTop, posBtm);
+		sxCollisionData::NearestHit gndHit = pCache ? pCache->nearest_hit(pCol, seg) : pCol->nearest_hit(seg);
 		if (gndHit.count > 0) {
 			h = gndHit.pos.y;
 		}
@@ -2157,7 +2985,7 @@ static bool wall_adj_pnt_in_tri(const cxVec& pnt, const cxVec vtx[3], const cxVe
 
 #define SCN_GLB_MEM_CMN_LOCK 0
 
-bool wall_adj_base(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim) {
+bool wall_adj_base(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim, ScnColCache* pCache) {
 	if (!pCol) return false;
 	bool res = false;
 	int ntri = pCol->mTriNum;
@@ -2201,7 +3029,11 @@ bool wall_adj_base(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxV
 		float maxRange = radius + nxVec::dist(oldPos, newPos)*2.0f;
 		cxAABB range;
 		range.from_sph(cxSphere(newPos, maxRange));
-		pCol->for_tris_in_range(wall_adj_tri_func, range, &wk);
+		if (pCache) {
+			pCache->for_tris_in_range(pCol, wall_adj_tri_func, range, &wk);
+		} else {
+			pCol->for_tris_in_range(wall_adj_tri_func, range, &wk);
+		}
 		int n = wk.triCount;
 		if (n > 0) {
 			cxVec triVtx[3];
@@ -2392,16 +3224,16 @@ bool wall_adj_base(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxV
 	return res;
 }
 
-bool wall_adj(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim, const float errParam) {
-	bool res = wall_adj_base(pJobCtx, pCol, newPos, oldPos, radius, pAdjPos, wallSlopeLim);
+bool wall_adj(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim, const float errParam, ScnColCache* pCache) {
+	bool res = wall_adj_base(pJobCtx, pCol, newPos, oldPos, radius, pAdjPos, wallSlopeLim, pCache);
 	if (res && pCol && pAdjPos && errParam >= 0.0f) {
 		cxVec adjPos = *pAdjPos;
 		cxLineSeg seg(oldPos, adjPos);
-		sxCollisionData::NearestHit hit = pCol->nearest_hit(seg);
+		sxCollisionData::NearestHit hit = pCache ? pCache->nearest_hit(pCol, seg) : pCol->nearest_hit(seg);
 		if (hit.count > 0) {
 			cxVec errPos = nxVec::lerp(oldPos, hit.pos, nxCalc::min(errParam, 0.99f));
 			seg.set(oldPos, errPos);
-			hit = pCol->nearest_hit(seg);
+			hit = pCache ? pCache->nearest_hit(pCol, seg) : pCol->nearest_hit(seg);
 			if (hit.count > 0) {
 				adjPos = oldPos;
 			} else {
@@ -2413,8 +3245,25 @@ bool wall_adj(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& n
 	return res;
 }
 
-bool wall_touch(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, const float wallSlopeLim) {
-	return wall_adj_base(pJobCtx, pCol, newPos, oldPos, radius, nullptr, wallSlopeLim);
+bool wall_touch(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, const float wallSlopeLim, ScnColCache* pCache) {
+	return wall_adj_base(pJobCtx, pCol, newPos, oldPos, radius, nullptr, wallSlopeLim, pCache);
+}
+
+static bool wall_sweep_filter(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	float slopeLim = *(const float*)pWk;
+	return slopeLim <= 0.0f || ::mth_fabsf(tri.nrm.y) < slopeLim;
+}
+
+bool wall_adj_sweep(sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim, const float capHeight, const int maxSweeps) {
+	if (!pCol) return false;
+	float slopeLim = wallSlopeLim;
+	cxVec hofs(0.0f, capHeight * 0.5f, 0.0f);
+	cxVec adjMov;
+	int nhit = pCol->slide_cap(oldPos - hofs, oldPos + hofs, radius, newPos - oldPos, &adjMov, maxSweeps, 0.005f, wall_sweep_filter, &slopeLim);
+	if (nhit > 0 && pAdjPos) {
+		*pAdjPos = oldPos + adjMov;
+	}
+	return nhit > 0;
 }
 
 bool col_hit_stop(sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos) {
@@ -2529,7 +3378,7 @@ bool sph_cap_adj(const cxVec& newPos, const cxVec& oldPos, float radius, const c
 	return flg;
 }
 
-static void save_job_cnts(const int lvl) {
+static void save_job_cnts(const int lvl, const bool add = false) {
 	if (lvl < 0) return;
 	if (!s_pBgd) return;
 	if (!s_pBgdJobCnts) return;
@@ -2537,7 +3386,7 @@ static void save_job_cnts(const int lvl) {
 	int idx = lvl * nwrk;
 	if (idx >= s_numBgdJobCnts) return;
 	for (int i = 0; i < nwrk; ++i) {
-		s_pBgdJobCnts[idx + i] = s_pBgd->get_jobs_done_count(i);
+		s_pBgdJobCnts[idx + i] = (add ? s_pBgdJobCnts[idx + i] : 0) + s_pBgd->get_jobs_done_count(i);
 	}
 }
 
@@ -2597,7 +3446,12 @@ void exec() {
 	int nobj = get_num_objs();
 	int njob = nobj;
 	if (njob < 1) return;
+	if (s_pMotCache) {
+		s_pMotCache->frame_begin();
+	}
+	s_animLODSkipCnt = 0;
 	prepare_objs_for_exec();
+	update_obj_grid();
 	job_queue_alloc(njob);
 	if (s_pJobQue) {
 		for (int i = 0; i < SCN_NUM_EXEC_PRIO; ++i) {
@@ -2636,6 +3490,18 @@ void exec() {
 	}
 }
 
+static void update_occlusion() {
+	s_occlActive = false;
+	s_occlCullCnt = 0;
+	if (!s_pOcclBuf || !s_occlFlg || s_numOccluders < 1) return;
+	s_pOcclBuf->begin(get_view_proj_mtx(), s_drwCtx.view.mNear);
+	for (int i = 0; i < s_numOccluders; ++i) {
+		s_pOcclBuf->add_collision(*s_pOccluders[i]);
+	}
+	s_pOcclBuf->rasterize(s_pBgd);
+	s_occlActive = true;
+}
+
 void visibility() {
 	if (!s_pObjList) return;
 	int nobj = get_num_objs();
@@ -2643,6 +3509,7 @@ void visibility() {
 	int njob = nobj;
 	update_view();
 	update_shadow();
+	update_occlusion();
 	job_queue_alloc(njob);
 	int numStdWrks = 0;
 	if (s_pBgd) {
@@ -2670,9 +3537,400 @@ void visibility() {
 	}
 }
 
+static bool drw_que_reserve(const int32_t num) {
+	if (num <= s_drwQueCap) return true;
+	int32_t cap = nxCalc::max(s_drwQueCap * 2, nxCalc::max(num, 256));
+	DrwQueItem* pQue = (DrwQueItem*)nxCore::mem_alloc(cap * sizeof(DrwQueItem), "Scn:drw_que");
+	if (!pQue) return false;
+	Draw::BatchPacket* pPkts = (Draw::BatchPacket*)nxCore::mem_alloc(cap * sizeof(Draw::BatchPacket), "Scn:drw_pkts");
+	if (!pPkts) {
+		nxCore::mem_free(pQue);
+		return false;
+	}
+	if (s_pDrwQue) {
+		nxCore::mem_free(s_pDrwQue);
+	}
+	if (s_pDrwPkts) {
+		nxCore::mem_free(s_pDrwPkts);
+	}
+	s_pDrwQue = pQue;
+	s_pDrwPkts = pPkts;
+	s_drwQueCap = cap;
+	return true;
+}
+
+static uint32_t drw_rec_depth(ScnObj* pObj, const int ibat) {
+	cxModelWork* pWk = pObj->mpMdlWk;
+	cxVec c = pWk->mWorldBBox.get_center();
+	if (pWk->mBoundsValid && pWk->mpBatBBoxes) {
+		c = pWk->mpBatBBoxes[ibat].get_center();
+	}
+	float dist = nxVec::dist(c, s_drwRecCtx[0].view.mPos);
+	return nxCore::f32_get_bits(nxCalc::max(dist, 0.0f)) >> 2;
+}
+
+static DrwQueItem* drw_rec_item(DrwRecSlice* pSlice, ScnObj* pObj, const int32_t ipkt) {
+	DrwQueItem* pItem = &s_pDrwQue[pSlice->org + pSlice->num];
+	++pSlice->num;
+	pItem->pObj = pObj;
+	pItem->ipkt = ipkt;
+	pItem->csc = 0;
+	pItem->state = ipkt < 0 ? 0 : s_pDrwPkts[ipkt].key;
+	return pItem;
+}
+
+/* packets stay in the queue slot they were recorded to, sorting and compaction only move the items */
+static DrwQueItem* drw_rec_packet(DrwRecSlice* pSlice, ScnObj* pObj, const int ibat, const Draw::Mode mode, const int icsc = 0) {
+	if (!obj_bat_ck(pObj, ibat, mode, icsc)) return nullptr;
+	cxModelWork* pWk = pObj->mpMdlWk;
+	int32_t ipkt = pSlice->org + pSlice->num;
+	Draw::BatchPacket* pPkt = &s_pDrwPkts[ipkt];
+	if (s_pDraw && s_pDraw->batch_record && s_pDraw->batch_replay) {
+		const Draw::Context* pCtx = &s_drwRecCtx[(mode != Draw::DRWMODE_SHADOW_CAST && pObj->mDisableShadowRecv) ? 1 : 0];
+		if (!s_pDraw->batch_record(pWk, ibat, mode, pCtx, pPkt)) return nullptr;
+	} else {
+		/* replayed through batch(), which resolves everything itself */
+		nxCore::mem_zero((void*)pPkt, sizeof(Draw::BatchPacket));
+		const sxModelData::Batch* pBat = pWk->mpData->get_batch_ptr(ibat);
+		pPkt->pWk = pWk;
+		pPkt->pMtl = pWk->mpData->get_material(pBat->mMtlId);
+		pPkt->ibat = ibat;
+		pPkt->mode = mode;
+		pPkt->key = (uint32_t(uintptr_t(pWk->mpData) >> 4) * 0x9E3779B1U) ^ uint32_t(pBat->mMtlId);
+	}
+	DrwQueItem* pItem = drw_rec_item(pSlice, pObj, ipkt);
+	pItem->csc = icsc;
+	return pItem;
+}
+
+/* pass:3 | state:32 | depth:29 - grouped by state, front-to-back within a state; casts use the cascade as depth */
+static void drw_rec_state_item(DrwRecSlice* pSlice, ScnObj* pObj, const int ibat, const Draw::Mode mode, const uint32_t pass, const int icsc = 0) {
+	DrwQueItem* pItem = drw_rec_packet(pSlice, pObj, ibat, mode, icsc);
+	if (!pItem) return;
+	uint32_t depth = mode == Draw::DRWMODE_SHADOW_CAST ? uint32_t(icsc) : drw_rec_depth(pObj, ibat);
+	pItem->key = (uint64_t(pass) << 61) | (uint64_t(pItem->state) << 29) | uint64_t(depth);
+}
+
+/* pass:3 | ~depth:29 | state:32 - back-to-front, state only breaks ties */
+static void drw_rec_blend_item(DrwRecSlice* pSlice, ScnObj* pObj, const int ibat, const Draw::Mode mode, const uint32_t pass) {
+	DrwQueItem* pItem = drw_rec_packet(pSlice, pObj, ibat, mode);
+	if (!pItem) return;
+	uint32_t depth = (~drw_rec_depth(pObj, ibat)) & ((1U << 29) - 1);
+	pItem->key = (uint64_t(pass) << 61) | (uint64_t(depth) << 32) | uint64_t(pItem->state);
+}
+
+enum DrwPass {
+	DRWPASS_SHADOW_CAST = 0,
+	DRWPASS_OPAQ_OBJ,
+	DRWPASS_OPAQ,
+	DRWPASS_SEMI_DISCARD,
+	DRWPASS_SEMI,
+	DRWPASS_SEMI_BLEND
+};
+
+static void obj_cast_record(ScnObj* pObj, DrwRecSlice* pSlice) {
+	cxModelWork* pWk = pObj->mpMdlWk;
+	if (!pWk || !pWk->mpData) return;
+	if (pObj->mDisableShadowCast) return;
+	sxModelData* pMdl = pWk->mpData;
+	for (int icsc = 0; icsc < s_shadowCascades; ++icsc) {
+		for (uint32_t i = 0; i < pMdl->mBatNum; ++i) {
+			drw_rec_state_item(pSlice, pObj, i, Draw::DRWMODE_SHADOW_CAST, DRWPASS_SHADOW_CAST, icsc);
+		}
+	}
+}
+
+static void obj_draw_record(ScnObj* pObj, DrwRecSlice* pSlice) {
+	cxModelWork* pWk = pObj->mpMdlWk;
+	if (!pWk || !pWk->mpData) return;
+	if (pObj->mDisableDraw) return;
+	sxModelData* pMdl = pWk->mpData;
+	bool discard = s_drwRecDiscard;
+	Draw::Mode semiMode = discard ? Draw::DRWMODE_DISCARD : Draw::DRWMODE_STD;
+	bool opaqCallbacks = pObj->mPreOpaqFunc || pObj->mPostOpaqFunc;
+	/* pass | object:29 | callback or batch:32 - replayed per object in model order, ahead of the sorted opaque batches */
+	uint64_t objKey = (uint64_t(DRWPASS_OPAQ_OBJ) << 61) | (uint64_t(pObj->mJob.mParam) << 32);
+	if (opaqCallbacks) {
+		drw_rec_item(pSlice, pObj, DRWQUE_PRE_OPAQ)->key = objKey;
+	}
+	for (uint32_t i = 0; i < pMdl->mBatNum; ++i) {
+		const sxModelData::Material* pMtl = pMdl->get_batch_material(i);
+		if (!pMtl) continue;
+		if (pMtl->is_alpha()) {
+			if (pMtl->mFlags.forceBlend) {
+				drw_rec_blend_item(pSlice, pObj, i, semiMode, DRWPASS_SEMI_BLEND);
+			} else if (discard) {
+				drw_rec_state_item(pSlice, pObj, i, semiMode, DRWPASS_SEMI_DISCARD);
+			} else {
+				drw_rec_blend_item(pSlice, pObj, i, semiMode, DRWPASS_SEMI);
+			}
+		} else if (opaqCallbacks) {
+			DrwQueItem* pItem = drw_rec_packet(pSlice, pObj, i, Draw::DRWMODE_STD);
+			if (pItem) {
+				pItem->key = objKey | uint64_t(i + 1);
+			}
+		} else {
+			drw_rec_state_item(pSlice, pObj, i, Draw::DRWMODE_STD, DRWPASS_OPAQ);
+		}
+	}
+	if (opaqCallbacks) {
+		drw_rec_item(pSlice, pObj, DRWQUE_POST_OPAQ)->key = objKey | 0xFFFFFFFFULL;
+	}
+}
+
+static void obj_cast_record_job(const sxJobContext* pCtx) {
+	if (!pCtx) return;
+	sxJob* pJob = pCtx->mpJob;
+	if (!pJob) return;
+	ScnObj* pObj = (ScnObj*)pJob->mpData;
+	if (!pObj) return;
+	obj_cast_record(pObj, &s_pDrwRecSlices[pJob->mParam]);
+}
+
+static void obj_draw_record_job(const sxJobContext* pCtx) {
+	if (!pCtx) return;
+	sxJob* pJob = pCtx->mpJob;
+	if (!pJob) return;
+	ScnObj* pObj = (ScnObj*)pJob->mpData;
+	if (!pObj) return;
+	obj_draw_record(pObj, &s_pDrwRecSlices[s_drwRecSliceNum + pJob->mParam]);
+}
+
+/* cast and colour slices for every object, in two regions of the queue */
+static bool draw_record_begin(const bool discard) {
+	s_drwRecSliceNum = 0;
+	s_drwRecCastCap = 0;
+	int nobj = get_num_objs();
+	if (nobj < 1) return false;
+	update_view();
+	update_shadow();
+	for (int i = 0; i < 2; ++i) {
+		Draw::Context* pCtx = &s_drwRecCtx[i];
+		nxCore::mem_copy(pCtx, &s_drwCtx, sizeof(Draw::Context));
+		pCtx->view.mMode = (sxView::Mode)s_viewRot;
+		pCtx->glb.useBump = s_useBump;
+		pCtx->glb.useSpec = s_useSpec;
+	}
+	s_drwRecCtx[1].shadow.mDens = 0.0f;
+	s_drwRecDiscard = discard;
+	if (nobj * 2 > s_drwRecSliceCap) {
+		int32_t cap = nxCalc::max(nobj * 2, s_drwRecSliceCap * 2);
+		DrwRecSlice* pSlices = (DrwRecSlice*)nxCore::mem_alloc(cap * sizeof(DrwRecSlice), "Scn:drw_rec");
+		if (!pSlices) return false;
+		if (s_pDrwRecSlices) {
+			nxCore::mem_free(s_pDrwRecSlices);
+		}
+		s_pDrwRecSlices = pSlices;
+		s_drwRecSliceCap = cap;
+	}
+	/* workers can't allocate, so each object gets worst-case slices of the queue up front */
+	int32_t nslices = 0;
+	int32_t ncast = 0;
+	for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
+		ScnObj* pObj = itr.item();
+		if (pObj && nslices < nobj) {
+			s_pDrwRecSlices[nslices].org = ncast;
+			s_pDrwRecSlices[nslices].num = 0;
+			pObj->mJob.mParam = nslices;
+			sxModelData* pMdl = pObj->get_model_data();
+			if (pMdl && !pObj->mDisableShadowCast) {
+				ncast += int32_t(pMdl->mBatNum) * s_shadowCascades;
+			}
+			++nslices;
+		}
+	}
+	int32_t num = ncast;
+	int32_t islice = 0;
+	for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
+		ScnObj* pObj = itr.item();
+		if (pObj && islice < nslices) {
+			DrwRecSlice* pSlice = &s_pDrwRecSlices[nslices + islice];
+			pSlice->org = num;
+			pSlice->num = 0;
+			sxModelData* pMdl = pObj->get_model_data();
+			if (pMdl) {
+				num += int32_t(pMdl->mBatNum) + 2;
+			}
+			++islice;
+		}
+	}
+	if (num < 1) return false;
+	if (!drw_que_reserve(num)) return false;
+	s_drwRecSliceNum = nslices;
+	s_drwRecCastCap = ncast;
+	job_queue_alloc(nslices);
+	return s_pJobQue != nullptr;
+}
+
+/* async: left running on the brigade, finished by draw_record_wait */
+static bool draw_record_exec(const xt_job_func func, const bool async) {
+	nxTask::queue_purge(s_pJobQue);
+	for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
+		ScnObj* pObj = itr.item();
+		if (pObj) {
+			pObj->mJob.mFunc = func;
+			nxTask::queue_add(s_pJobQue, &pObj->mJob);
+		}
+	}
+	if (async && s_pBgd) {
+		s_pBgd->exec(s_pJobQue);
+		return true;
+	}
+	nxTask::queue_exec(s_pJobQue, s_pBgd);
+	save_job_cnts(get_draw_record_job_lvl(), func != obj_cast_record_job);
+	return false;
+}
+
+static void draw_record_wait() {
+	s_pBgd->wait();
+	save_job_cnts(get_draw_record_job_lvl(), true);
+}
+
+/* slices only move down and may overlap their destination, copy forward */
+static int32_t drw_que_compact(const int32_t sliceOrg, const int32_t dst) {
+	int32_t num = 0;
+	for (int32_t i = 0; i < s_drwRecSliceNum; ++i) {
+		DrwRecSlice* pSlice = &s_pDrwRecSlices[sliceOrg + i];
+		if (pSlice->num > 0 && pSlice->org != dst + num) {
+			for (int32_t j = 0; j < pSlice->num; ++j) {
+				s_pDrwQue[dst + num + j] = s_pDrwQue[pSlice->org + j];
+			}
+		}
+		num += pSlice->num;
+	}
+	return num;
+}
+
+static int drw_que_cmp(const void* pA, const void* pB, void* pCtx) {
+	uint64_t k1 = ((const DrwQueItem*)pA)->key;
+	uint64_t k2 = ((const DrwQueItem*)pB)->key;
+	return k1 < k2 ? -1 : k1 > k2 ? 1 : 0;
+}
+
+static int32_t drw_que_state_chgs(const DrwQueItem* pQue, const int32_t num) {
+	uint32_t lastState[8];
+	uint32_t passMask = 0;
+	int32_t n = 0;
+	for (int32_t i = 0; i < num; ++i) {
+		const DrwQueItem* pItem = &pQue[i];
+		uint32_t pass = uint32_t(pItem->key >> 61);
+		if (passMask & (1U << pass)) {
+			if (pItem->state != lastState[pass]) {
+				++n;
+			}
+		}
+		lastState[pass] = pItem->state;
+		passMask |= 1U << pass;
+	}
+	return n;
+}
+
+static bool drw_que_inst_ok(const DrwQueItem* pItem) {
+	if (pItem->ipkt < 0) return false;
+	uint32_t pass = uint32_t(pItem->key >> 61);
+	if (pass != DRWPASS_SHADOW_CAST && pass != DRWPASS_OPAQ && pass != DRWPASS_SEMI_DISCARD) return false;
+	ScnObj* pObj = pItem->pObj;
+	if (pass != DRWPASS_SHADOW_CAST && (pObj->mBatchPreDrawFunc || pObj->mBatchPostDrawFunc)) return false;
+	return !s_pDrwPkts[pItem->ipkt].pWk->mpData->has_skin();
+}
+
+/* items after idx that can share one instanced draw with it: only the world transform differs */
+static int32_t drw_que_inst_run(const DrwQueItem* pQue, const int32_t num, const int32_t idx) {
+	if (!s_drwInstFlg || !s_pDraw || !s_pDraw->batch_inst || !s_pDraw->batch_replay) return 1;
+	const DrwQueItem* pItem0 = &pQue[idx];
+	if (!drw_que_inst_ok(pItem0)) return 1;
+	const Draw::BatchPacket* pPkt0 = &s_pDrwPkts[pItem0->ipkt];
+	bool castFlg = pPkt0->mode == Draw::DRWMODE_SHADOW_CAST;
+	int32_t n = 1;
+	while (idx + n < num && n < SCN_DRW_INST_MAX) {
+		const DrwQueItem* pItem = &pQue[idx + n];
+		if ((pItem->key >> 61) != (pItem0->key >> 61)) break;
+		if (pItem->state != pItem0->state || pItem->csc != pItem0->csc) break;
+		if (!drw_que_inst_ok(pItem)) break;
+		const Draw::BatchPacket* pPkt = &s_pDrwPkts[pItem->ipkt];
+		if (pPkt->ibat != pPkt0->ibat || pPkt->mode != pPkt0->mode || pPkt->prog != pPkt0->prog) break;
+		if (pPkt->pWk->mpData != pPkt0->pWk->mpData || pPkt->pMtl != pPkt0->pMtl) break;
+		if (!castFlg && pItem->pObj->mDisableShadowRecv != pItem0->pObj->mDisableShadowRecv) break;
+		++n;
+	}
+	return n;
+}
+
+static void drw_que_draw_inst(const DrwQueItem* pItems, const int32_t n) {
+	for (int32_t i = 0; i < n; ++i) {
+		s_drwInstPkts[i] = &s_pDrwPkts[pItems[i].ipkt];
+	}
+	update_view();
+	update_shadow();
+	float sdens = obj_drw_ctx_set(pItems[0].pObj, s_drwInstPkts[0]->mode, pItems[0].csc);
+	bool instFlg = s_pDraw->batch_inst(s_drwInstPkts, n, &s_drwCtx);
+	s_drwCtx.shadow.mDens = sdens;
+	if (instFlg) {
+		++s_drwInstGrpCnt;
+		s_drwInstItemCnt += n;
+	}
+}
+
+static void drw_que_replay(const DrwQueItem* pItem) {
+	ScnObj* pObj = pItem->pObj;
+	if (pItem->ipkt < 0) {
+		ScnObj::DrawCallbackFunc func = pItem->ipkt == DRWQUE_PRE_OPAQ ? pObj->mPreOpaqFunc : pObj->mPostOpaqFunc;
+		if (func) {
+			func(pObj);
+		}
+		return;
+	}
+	obj_pkt_draw(pObj, &s_pDrwPkts[pItem->ipkt], pItem->csc);
+}
+
+static void draw_submit(const int32_t org, const int32_t num) {
+	if (num <= 0) return;
+	DrwQueItem* pQue = &s_pDrwQue[org];
+	s_drwStateChgUnsortedCnt += drw_que_state_chgs(pQue, num);
+	nxCore::sort(pQue, num, sizeof(DrwQueItem), drw_que_cmp);
+	s_drwStateChgCnt += drw_que_state_chgs(pQue, num);
+	s_drwItemCnt += num;
+	int32_t i = 0;
+	while (i < num) {
+		int32_t n = drw_que_inst_run(pQue, num, i);
+		if (n > 1) {
+			drw_que_draw_inst(&pQue[i], n);
+		} else {
+			drw_que_replay(&pQue[i]);
+		}
+		i += n;
+	}
+}
+
+/*
+  Casts are recorded first. The colour level is then left running on the brigade
+  while this thread replays the casts, and its packets are replayed once it's done.
+*/
+static void draw_sorted(const bool discard) {
+	if (!draw_record_begin(discard)) return;
+	draw_record_exec(obj_cast_record_job, false);
+	int32_t ncast = drw_que_compact(0, 0);
+	if (ncast < 1) {
+		/* nothing casts this frame: receivers get programs without shadow lookups, as batch() would pick */
+		s_drwRecCtx[0].shadow.mDens = 0.0f;
+	}
+	bool async = draw_record_exec(obj_draw_record_job, true);
+	draw_submit(0, ncast);
+	if (async) {
+		draw_record_wait();
+	}
+	int32_t num = drw_que_compact(s_drwRecSliceNum, s_drwRecCastCap);
+	draw_submit(s_drwRecCastCap, num);
+}
+
 void draw(bool discard) {
 	if (!s_pObjList) return;
 
+	if (s_drwSortFlg) {
+		draw_sorted(discard);
+		return;
+	}
+
 	for (ObjList::Itr itr = s_pObjList->get_itr(); !itr.end(); itr.next()) {
 		ScnObj* pObj = itr.item();
 		if (pObj) {
@@ -2736,23 +3994,31 @@ float speed() {
 } // Scene
 
 
-static void obj_bat_draw(ScnObj* pObj, const int ibat, const Draw::Mode mode) {
+static uint32_t* obj_cast_cull_bits(cxModelWork* pWk, const int icsc) {
+	if (!pWk->mpExtMem) return nullptr;
+	return (uint32_t*)pWk->mpExtMem + icsc*XD_BIT_ARY_SIZE(uint32_t, pWk->get_batches_num());
+}
+
+static bool obj_bat_ck(ScnObj* pObj, const int ibat, const Draw::Mode mode, const int icsc) {
 	cxModelWork* pWk = pObj->mpMdlWk;
-	if (!pWk) return;
-	if (pWk->is_bat_mtl_hidden(ibat)) return;
+	if (!pWk) return false;
+	if (pWk->is_bat_mtl_hidden(ibat)) return false;
 	bool cullFlg = false;
-	bool isShadowcast = mode == Draw::DRWMODE_SHADOW_CAST;
-	if (isShadowcast) {
+	if (mode == Draw::DRWMODE_SHADOW_CAST) {
 		if (pWk->mpExtMem) {
-			uint32_t* pCastCullBits = (uint32_t*)pWk->mpExtMem;
+			uint32_t* pCastCullBits = obj_cast_cull_bits(pWk, icsc);
 			cullFlg = XD_BIT_ARY_CK(uint32_t, pCastCullBits, ibat);
 		}
 	} else {
 		cullFlg = XD_BIT_ARY_CK(uint32_t, pWk->mpCullBits, ibat);
 	}
-	if (cullFlg) {
-		return;
-	}
+	return !cullFlg;
+}
+
+static void obj_bat_draw(ScnObj* pObj, const int ibat, const Draw::Mode mode, const int icsc) {
+	if (!obj_bat_ck(pObj, ibat, mode, icsc)) return;
+	cxModelWork* pWk = pObj->mpMdlWk;
+	bool isShadowcast = mode == Draw::DRWMODE_SHADOW_CAST;
 	if (!isShadowcast) {
 		if (pObj->mBatchPreDrawFunc) {
 			pObj->mBatchPreDrawFunc(pObj, ibat);
@@ -2760,17 +4026,10 @@ static void obj_bat_draw(ScnObj* pObj, const int ibat, const Draw::Mode mode) {
 	}
 	Scene::update_view();
 	Scene::update_shadow();
-	Draw::Context* pCtx = &s_drwCtx;
 	if (s_pDraw) {
-		pCtx->view.mMode = (sxView::Mode)s_viewRot;
-		pCtx->glb.useBump = s_useBump;
-		pCtx->glb.useSpec = s_useSpec;
-		float sdens = pCtx->shadow.mDens;
-		if (!isShadowcast && pObj->mDisableShadowRecv) {
-			pCtx->shadow.mDens = 0.0f;
-		}
-		s_pDraw->batch(pWk, ibat, mode, pCtx);
-		pCtx->shadow.mDens = sdens;
+		float sdens = obj_drw_ctx_set(pObj, mode, icsc);
+		s_pDraw->batch(pWk, ibat, mode, &s_drwCtx);
+		s_drwCtx.shadow.mDens = sdens;
 	}
 	if (!isShadowcast) {
 		if (pObj->mBatchPostDrawFunc) {
@@ -2779,6 +4038,46 @@ static void obj_bat_draw(ScnObj* pObj, const int ibat, const Draw::Mode mode) {
 	}
 }
 
+/* no culling or program selection here, the record workers did both */
+static void obj_pkt_draw(ScnObj* pObj, const Draw::BatchPacket* pPkt, const int icsc) {
+	bool isShadowcast = pPkt->mode == Draw::DRWMODE_SHADOW_CAST;
+	if (!isShadowcast) {
+		if (pObj->mBatchPreDrawFunc) {
+			pObj->mBatchPreDrawFunc(pObj, pPkt->ibat);
+		}
+	}
+	Scene::update_view();
+	Scene::update_shadow();
+	if (s_pDraw) {
+		float sdens = obj_drw_ctx_set(pObj, pPkt->mode, icsc);
+		if (s_pDraw->batch_record && s_pDraw->batch_replay) {
+			s_pDraw->batch_replay(pPkt, &s_drwCtx);
+		} else {
+			s_pDraw->batch(pPkt->pWk, pPkt->ibat, pPkt->mode, &s_drwCtx);
+		}
+		s_drwCtx.shadow.mDens = sdens;
+	}
+	if (!isShadowcast) {
+		if (pObj->mBatchPostDrawFunc) {
+			pObj->mBatchPostDrawFunc(pObj, pPkt->ibat);
+		}
+	}
+}
+
+/* returns the shadow density to restore after the draw */
+static float obj_drw_ctx_set(ScnObj* pObj, const Draw::Mode mode, const int icsc) {
+	Draw::Context* pCtx = &s_drwCtx;
+	pCtx->view.mMode = (sxView::Mode)s_viewRot;
+	pCtx->glb.useBump = s_useBump;
+	pCtx->glb.useSpec = s_useSpec;
+	pCtx->shadow.mCascade = icsc;
+	float sdens = pCtx->shadow.mDens;
+	if (mode != Draw::DRWMODE_SHADOW_CAST && pObj->mDisableShadowRecv) {
+		pCtx->shadow.mDens = 0.0f;
+	}
+	return sdens;
+}
+
 static bool obj_bat_visible(ScnObj* pObj, const int ibat) {
 	cxModelWork* pWk = pObj->mpMdlWk;
 	if (!pWk) return false;
@@ -2903,9 +4202,51 @@ void ScnObj::set_motion_frame(const float frame) {
 	}
 }
 
+static float obj_mot_cache_step(const ScnObj* pObj) {
+	float step = pObj->mMotCacheFrameStep;
+	if (step <= 0.0f && s_motCacheQuantStep > 0.0f && s_motCacheQuantDist >= 0.0f) {
+		float dist = nxVec::dist(pObj->get_world_pos(), Scene::get_view_pos());
+		if (dist > s_motCacheQuantDist) {
+			step = s_motCacheQuantStep;
+		}
+	}
+	return step;
+}
+
+static void obj_mot_cache_setup(const ScnObj* pObj, cxMotionWork* pMotWk) {
+	if (!pMotWk) return;
+	pMotWk->mpEvalCache = pObj->mDisableMotCache ? nullptr : s_pMotCache;
+	pMotWk->mEvalCacheStep = pMotWk->mpEvalCache ? obj_mot_cache_step(pObj) : 0.0f;
+}
+
+static void obj_anim_lod_setup(ScnObj* pObj, cxMotionWork* pMotWk) {
+	int interval = 1;
+	bool maskFlg = false;
+	if (!pObj->mDisableAnimLOD && (s_animLODMaxInterval > 1 || s_animLODMaskDist >= 0.0f)) {
+		cxVec viewPos = Scene::get_view_pos();
+		cxVec objPos = pObj->get_world_pos();
+		if (pObj->mpMdlWk && pObj->mpMdlWk->mBoundsValid) {
+			objPos = pObj->mpMdlWk->mWorldBBox.closest_pnt(viewPos, false);
+		}
+		float dist = nxVec::dist(objPos, viewPos) + pObj->mAnimLODDistOffs;
+		if (dist > s_animLODDist) {
+			interval = 2 + int((dist - s_animLODDist) / s_animLODStepDist);
+			interval = nxCalc::min(interval, s_animLODMaxInterval);
+		}
+		maskFlg = s_animLODMaskDist >= 0.0f && dist > s_animLODMaskDist;
+	}
+	pObj->mAnimLODInterval = interval;
+	pMotWk->mpLODSkipBits = maskFlg ? Scene::get_anim_lod_mask(pObj->get_model_data()) : nullptr;
+}
+
 void ScnObj::exec_motion(const sxMotionData* pMot, const float frameAdd) {
 	if (pMot && mpMotWk) {
-		mpMotWk->apply_motion(pMot, frameAdd);
+		obj_mot_cache_setup(this, mpMotWk);
+		obj_anim_lod_setup(this, mpMotWk);
+		bool keyFlg = mpMotWk->apply_motion_lod(pMot, frameAdd, mAnimLODInterval, mAnimLODPhase);
+		if (!keyFlg) {
+			nxSys::atomic_inc(&s_animLODSkipCnt);
+		}
 	}
 	nxSys::atomic_add(&mMotExecSync, 1);
 }
@@ -3010,6 +4351,7 @@ void ScnObj::set_ext_motion_frame(const int idx, const float frame) {
 void ScnObj::exec_ext_motion(const int idx, const sxMotionData* pMot, const float frameAdd) {
 	if (idx >= 0 && idx < SCN_OBJ_MAX_EXT_MOTS) {
 		if (pMot && mpExtMotWk[idx]) {
+			obj_mot_cache_setup(this, mpExtMotWk[idx]);
 			mpExtMotWk[idx]->apply_motion(pMot, frameAdd);
 			if (mpMotWk) {
 				mpMotWk->copy_local(mpExtMotWk[idx], pMot);
@@ -3030,6 +4372,15 @@ void ScnObj::update_skin() {
 	}
 }
 
+void ScnObj::update_skin_bounds() {
+	if (mpMdlWk && mpMotWk && mpMdlWk->mpSkinXforms) {
+		mpMdlWk->update_skin_bounds(mpMotWk);
+	} else {
+		update_skin();
+		update_bounds();
+	}
+}
+
 void ScnObj::update_bounds() {
 	if (mpMdlWk) {
 		mpMdlWk->update_bounds();
@@ -3037,82 +4388,58 @@ void ScnObj::update_bounds() {
 }
 
 static bool ck_bat_shadow_cast_vis(cxModelWork* pWk, const int ibat) {
-	cxAABB batBB = pWk->mpBatBBoxes[ibat];
-	cxMtx castVP = Scene::get_shadow_view_proj_mtx();
-	cxVec bbmin = batBB.get_min_pos();
-	cxVec bbmax = batBB.get_max_pos();
-	float x0, y0, x1, y1;
-	if (Scene::is_shadow_uniform()) {
-		xt_float4 vmin = castVP.apply(bbmin.get_pnt());
-		xt_float4 vmax = castVP.apply(bbmax.get_pnt());
-		float xmin = nxCalc::div0(vmin.x, vmin.w);
-		float ymin = nxCalc::div0(vmin.y, vmin.w);
-		float xmax = nxCalc::div0(vmax.x, vmax.w);
-		float ymax = nxCalc::div0(vmax.y, vmax.w);
-		x0 = nxCalc::min(xmin, xmax);
-		y0 = nxCalc::min(ymin, ymax);
-		x1 = nxCalc::max(xmin, xmax);
-		y1 = nxCalc::max(ymin, ymax);
-	} else {
-		xt_float4 bbv[8];
-		bbv[0].set(bbmin.x, bbmin.y, bbmin.z, 1.0f);
-		bbv[1].set(bbmin.x, bbmax.y, bbmin.z, 1.0f);
-		bbv[2].set(bbmax.x, bbmax.y, bbmin.z, 1.0f);
-		bbv[3].set(bbmax.x, bbmin.y, bbmin.z, 1.0f);
-		bbv[4].set(bbmin.x, bbmin.y, bbmax.z, 1.0f);
-		bbv[5].set(bbmin.x, bbmax.y, bbmax.z, 1.0f);
-		bbv[6].set(bbmax.x, bbmax.y, bbmax.z, 1.0f);
-		bbv[7].set(bbmax.x, bbmin.y, bbmax.z, 1.0f);
-		for (int i = 0; i < 8; ++i) {
-			bbv[i] = castVP.apply(bbv[i]);
-		}
-		float rw[8];
-		float sx[8];
-		float sy[8];
-		for (int i = 0; i < 8; ++i) {
-			rw[i] = nxCalc::rcp0(bbv[i].w);
-		}
-		for (int i = 0; i < 8; ++i) {
-			sx[i] = bbv[i].x * rw[i];
-		}
-		for (int i = 0; i < 8; ++i) {
-			sy[i] = bbv[i].y * rw[i];
-		}
-		x0 = sx[0];
-		for (int i = 1; i < 8; ++i) { x0 = nxCalc::min(x0, sx[i]); }
-		y0 = sy[0];
-		for (int i = 1; i < 8; ++i) { y0 = nxCalc::min(y0, sy[i]); }
-		x1 = sx[0];
-		for (int i = 1; i < 8; ++i) { x1 = nxCalc::max(x1, sx[i]); }
-		y1 = sy[0];
-		for (int i = 1; i < 8; ++i) { y1 = nxCalc::max(y1, sy[i]); }
-	}
-	x0 *= 0.5f;
-	y0 *= 0.5f;
-	x1 *= 0.5f;
-	y1 *= 0.5f;
-	bool visible = x0 <= 1.0f && x1 >= -1.0f && y0 <= 1.0f && y1 >= -1.0f;
-	return visible;
+	uint32_t bits = 0;
+	return nxGeom::cull_aabbs(Scene::get_shadow_cull_planes(), 4, &pWk->mpBatBBoxes[ibat], 1, &bits) == 0;
+}
+
+static void bat_shadow_cascades_cull(cxModelWork* pWk, const int ibat) {
+	uint32_t mask = Scene::shadow_cascade_cast_mask(pWk->mpBatBBoxes[ibat]);
+	for (int i = 0; i < s_shadowCascades; ++i) {
+		uint32_t* pCastBits = obj_cast_cull_bits(pWk, i);
+		if (mask & (1U << i)) {
+			XD_BIT_ARY_CL(uint32_t, pCastBits, ibat);
+		} else {
+			XD_BIT_ARY_ST(uint32_t, pCastBits, ibat);
+		}
+	}
 }
 
 void ScnObj::update_visibility() {
 	if (mpMdlWk) {
 		mpMdlWk->frustum_cull(Scene::get_view_frustum_ptr());
+		if (s_occlActive && mpMdlWk->mBoundsValid && mpMdlWk->mpCullBits) {
+			int nbat = mpMdlWk->get_batches_num();
+			int ncull = 0;
+			if (s_pOcclBuf->occluded(mpMdlWk->mWorldBBox)) {
+				for (int i = 0; i < nbat; ++i) {
+					if (!XD_BIT_ARY_CK(uint32_t, mpMdlWk->mpCullBits, i)) {
+						XD_BIT_ARY_ST(uint32_t, mpMdlWk->mpCullBits, i);
+						++ncull;
+					}
+				}
+			} else if (nbat > 1) {
+				ncull = s_pOcclBuf->cull(mpMdlWk->mpBatBBoxes, nbat, mpMdlWk->mpCullBits);
+			}
+			if (ncull > 0) {
+				nxSys::atomic_add(&s_occlCullCnt, ncull);
+			}
+		}
 
 		if (mpMdlWk->mpExtMem) {
 			int nbat = mpMdlWk->get_batches_num();
-			size_t bitMemSize = XD_BIT_ARY_SIZE(uint8_t, nbat);
+			size_t bitMemSize = XD_BIT_ARY_SIZE(uint32_t, nbat) * sizeof(uint32_t) * s_shadowCascades;
 			uint32_t* pCastBits = (uint32_t*)mpMdlWk->mpExtMem;
 			if (mDisableShadowCast || s_smapDisabled) {
 				nxCore::mem_fill(pCastBits, 0xFF, bitMemSize);
 			} else {
 				nxCore::mem_fill(pCastBits, 0, bitMemSize);
 				if (s_useShadowCastCull) {
-					for (int i = 0; i < nbat; ++i) {
-						bool vis = ck_bat_shadow_cast_vis(mpMdlWk, i);
-						if (!vis) {
-							XD_BIT_ARY_ST(uint32_t, pCastBits, i);
+					if (s_shadowCascades > 1) {
+						for (int i = 0; i < nbat; ++i) {
+							bat_shadow_cascades_cull(mpMdlWk, i);
 						}
+					} else {
+						nxGeom::cull_aabbs(Scene::get_shadow_cull_planes(), 4, mpMdlWk->mpBatBBoxes, nbat, pCastBits);
 					}
 				}
 			}
@@ -3122,11 +4449,25 @@ void ScnObj::update_visibility() {
 
 void ScnObj::update_batch_visibility(const int ibat) {
 	if (mpMdlWk) {
-		mpMdlWk->calc_batch_visibility(Scene::get_view_frustum_ptr(), ibat);
+		bool vis = mpMdlWk->calc_batch_visibility(Scene::get_view_frustum_ptr(), ibat);
+		if (vis && s_occlActive && mpMdlWk->mpCullBits && s_pOcclBuf->occluded(mpMdlWk->mpBatBBoxes[ibat])) {
+			XD_BIT_ARY_ST(uint32_t, mpMdlWk->mpCullBits, ibat);
+			nxSys::atomic_inc(&s_occlCullCnt);
+		}
 		if (mpMdlWk->mpExtMem) {
 			uint32_t* pCastBits = (uint32_t*)mpMdlWk->mpExtMem;
 			if (mDisableShadowCast) {
-				XD_BIT_ARY_ST(uint32_t, pCastBits, ibat);
+				for (int i = 0; i < s_shadowCascades; ++i) {
+					XD_BIT_ARY_ST(uint32_t, obj_cast_cull_bits(mpMdlWk, i), ibat);
+				}
+			} else if (s_shadowCascades > 1) {
+				if (s_useShadowCastCull) {
+					bat_shadow_cascades_cull(mpMdlWk, ibat);
+				} else {
+					for (int i = 0; i < s_shadowCascades; ++i) {
+						XD_BIT_ARY_CL(uint32_t, obj_cast_cull_bits(mpMdlWk, i), ibat);
+					}
+				}
 			} else {
 				if (s_useShadowCastCull) {
 					bool vis = ck_bat_shadow_cast_vis(mpMdlWk, ibat);
@@ -3174,12 +4515,20 @@ void ScnObj::move_sub() {
 	if (mAfterBlendFunc) {
 		mAfterBlendFunc(this);
 	}
-	update_world();
 	if (mWorldFunc) {
+		update_world();
 		mWorldFunc(this);
+		update_skin_bounds();
+	} else if (mpMotWk && mpMdlWk && mpMdlWk->mpSkinXforms) {
+		if (!mpMotWk->calc_world_hold(mpMdlWk->mpSkinXforms)) {
+			mpMotWk->calc_world(mpMdlWk->mpSkinXforms);
+		}
+		update_bounds();
+	} else {
+		update_world();
+		update_skin();
+		update_bounds();
 	}
-	update_skin();
-	update_bounds();
 }
 
 cxMtx ScnObj::get_skel_local_mtx(const int iskl) const {
@@ -3524,9 +4873,146 @@ void ScnObj::shadow_cast() {
 	if (!pWk) return;
 	sxModelData* pMdl = pWk->mpData;
 	if (!pMdl) return;
-	for (uint32_t i = 0; i < pMdl->mBatNum; ++i) {
-		obj_bat_draw(this, i, Draw::DRWMODE_SHADOW_CAST);
+	for (int icsc = 0; icsc < s_shadowCascades; ++icsc) {
+		for (uint32_t i = 0; i < pMdl->mBatNum; ++i) {
+			obj_bat_draw(this, i, Draw::DRWMODE_SHADOW_CAST, icsc);
+		}
+	}
+}
+
+
+void ScnColCache::init(const float margin) {
+	mpCol = nullptr;
+	mColBBox.init();
+	mColGen = 0;
+	mBBox.init();
+	mpTris = nullptr;
+	mpTriBoxes = nullptr;
+	mTriNum = 0;
+	mTriCap = 0;
+	mHits = 0;
+	mMisses = 0;
+	mStatFrame = uint64_t(-1);
+	mMargin = nxCalc::max(margin, 0.0f);
+}
+
+void ScnColCache::reset() {
+	if (mpTris) {
+		Scene::glb_mem_free(mpTris);
+	}
+	init(mMargin);
+}
+
+bool ScnColCache::ck(const sxCollisionData* pCol, const cxAABB& box) const {
+	if (!pCol || pCol != mpCol) return false;
+	if (Scene::get_collision_generation(pCol) != mColGen) return false;
+	if (!nxCore::mem_eq(&mColBBox, &pCol->mBBox, sizeof(cxAABB))) return false;
+	return mBBox.contains(box.get_min_pos()) && mBBox.contains(box.get_max_pos());
+}
+
+static bool col_cache_fetch_func(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	ScnColCache* pCache = (ScnColCache*)pWk;
+	if (pCache->mTriNum >= pCache->mTriCap) {
+		int cap = nxCalc::max(pCache->mTriCap * 2, 64);
+		size_t size = cap * (sizeof(sxCollisionData::Tri) + sizeof(cxAABB));
+		sxCollisionData::Tri* pTris = (sxCollisionData::Tri*)Scene::glb_mem_alloc(size, XD_FOURCC('C', 'c', 'T', 'r'));
+		if (!pTris) return false;
+		cxAABB* pBoxes = (cxAABB*)(pTris + cap);
+		if (pCache->mpTris) {
+			nxCore::mem_copy(pTris, pCache->mpTris, pCache->mTriNum * sizeof(sxCollisionData::Tri));
+			nxCore::mem_copy(pBoxes, pCache->mpTriBoxes, pCache->mTriNum * sizeof(cxAABB));
+			Scene::glb_mem_free(pCache->mpTris);
+		}
+		pCache->mpTris = pTris;
+		pCache->mpTriBoxes = pBoxes;
+		pCache->mTriCap = cap;
+	}
+	int idx = pCache->mTriNum++;
+	pCache->mpTris[idx] = tri;
+	pCache->mpTriBoxes[idx].set(tri.vtx[0]);
+	pCache->mpTriBoxes[idx].add_pnt(tri.vtx[1]);
+	pCache->mpTriBoxes[idx].add_pnt(tri.vtx[2]);
+	return true;
+}
+
+bool ScnColCache::prepare(const sxCollisionData* pCol, const cxAABB& box) {
+	uint64_t frame = Scene::get_frame_count();
+	if (ck(pCol, box)) {
+		if (mStatFrame != frame) {
+			++mHits;
+			nxSys::atomic_inc(&s_colCacheHits);
+			mStatFrame = frame;
+		}
+		return true;
+	}
+	++mMisses;
+	nxSys::atomic_inc(&s_colCacheMisses);
+	mStatFrame = frame;
+	mpCol = nullptr;
+	mTriNum = 0;
+	if (!pCol) return false;
+	cxVec margin(mMargin);
+	cxAABB fatBox(box.get_min_pos() - margin, box.get_max_pos() + margin);
+	int n = pCol->for_tris_in_range(col_cache_fetch_func, fatBox, this);
+	if (n != mTriNum) return false;
+	mpCol = pCol;
+	mColBBox = pCol->mBBox;
+	mColGen = Scene::get_collision_generation(pCol);
+	mBBox = fatBox;
+	return true;
+}
+
+/* cached triangles keep the BVH order of the fetch, so results match a direct query */
+int ScnColCache::for_tris_in_range(const sxCollisionData* pCol, const sxCollisionData::TriFunc func, const cxAABB& box, void* pWk) {
+	if (!pCol) return 0;
+	if (!prepare(pCol, box)) {
+		return pCol->for_tris_in_range(func, box, pWk);
+	}
+	int cnt = 0;
+	cxVec bbmin = box.get_min_pos();
+	cxVec bbmax = box.get_max_pos();
+	for (int i = 0; i < mTriNum; ++i) {
+		if (!box.overlaps(mpTriBoxes[i])) continue;
+		const sxCollisionData::Tri& tri = mpTris[i];
+		if (nxGeom::tri_aabb_overlap(tri.vtx, bbmin, bbmax)) {
+			++cnt;
+			if (!func(*pCol, tri, pWk)) break;
+		}
+	}
+	return cnt;
+}
+
+sxCollisionData::NearestHit ScnColCache::nearest_hit(const sxCollisionData* pCol, const cxLineSeg& seg) {
+	sxCollisionData::NearestHit hit;
+	hit.pos = seg.get_pos0();
+	hit.nrm.zero();
+	hit.dist = 0.0f;
+	hit.count = 0;
+	if (!pCol) return hit;
+	cxAABB box;
+	box.from_seg(seg);
+	if (!prepare(pCol, box)) {
+		return const_cast<sxCollisionData*>(pCol)->nearest_hit(seg);
+	}
+	cxVec org = seg.get_pos0();
+	cxVec end = seg.get_pos1();
+	for (int i = 0; i < mTriNum; ++i) {
+		if (!box.overlaps(mpTriBoxes[i])) continue;
+		const sxCollisionData::Tri& tri = mpTris[i];
+		cxVec hitPos;
+		cxVec nrm;
+		if (nxGeom::seg_tri_intersect_cw(org, end, tri.vtx[0], tri.vtx[1], tri.vtx[2], &hitPos, &nrm)) {
+			float dist = nxVec::dist(org, hitPos);
+			if (hit.count == 0 || dist < hit.dist) {
+				hit.pos = hitPos;
+				hit.nrm = nrm;
+				hit.dist = dist;
+				end = hitPos;
+			}
+			++hit.count;
+		}
 	}
+	return hit;
 }
 
 
@@ -18,14 +18,68 @@ struct ScnCfg {
 	const char* pAppPath;
 	const char* pDataDir;
 	int shadowMapSize;
+	int shadowCascades;
+	int occlusionWidth;
+	int occlusionHeight;
+	int occlusionTris;
 	int numWorkers;
 	size_t localHeapSize;
+	int motCacheSlots;
+	int animLODMaxInterval;
+	float animLODDist;
+	float animLODStepDist;
+	float animLODMaskDist;
 	bool useSpec;
 	bool useBump;
 
 	void set_defaults();
 };
 
+struct ScnStats {
+	int32_t motCacheHits;
+	int32_t motCacheMisses;
+	int32_t animLODSkips;
+	int32_t colCacheHits;
+	int32_t colCacheMisses;
+	int32_t drawItems;
+	int32_t drawStateChanges;
+	int32_t drawStateChangesAvoided;
+	int32_t drawInstGroups;
+	int32_t drawInstItems;
+	int32_t occlTris;
+	int32_t occlCulled;
+
+	void reset() { nxCore::mem_zero(this, sizeof(*this)); }
+	float get_mot_cache_hit_rate() const { return nxCalc::div0(float(motCacheHits), float(motCacheHits + motCacheMisses)); }
+	float get_col_cache_hit_rate() const { return nxCalc::div0(float(colCacheHits), float(colCacheHits + colCacheMisses)); }
+};
+
+/* triangles around an object, refetched when a query leaves the fattened box or the collision data changes */
+struct ScnColCache {
+	const sxCollisionData* mpCol;
+	cxAABB mColBBox;
+	uint32_t mColGen;
+	cxAABB mBBox;
+	sxCollisionData::Tri* mpTris;
+	cxAABB* mpTriBoxes;
+	int32_t mTriNum;
+	int32_t mTriCap;
+	int32_t mHits;
+	int32_t mMisses;
+	uint64_t mStatFrame; /* a hit is counted once per frame, misses always */
+	float mMargin;
+
+	void init(const float margin = 0.5f);
+	void reset();
+	void invalidate() { mpCol = nullptr; }
+	bool ck(const sxCollisionData* pCol, const cxAABB& box) const;
+	bool prepare(const sxCollisionData* pCol, const cxAABB& box);
+	int for_tris_in_range(const sxCollisionData* pCol, const sxCollisionData::TriFunc func, const cxAABB& box, void* pWk);
+	sxCollisionData::NearestHit nearest_hit(const sxCollisionData* pCol, const cxLineSeg& seg);
+	void reset_stats() { mHits = 0; mMisses = 0; }
+	float get_hit_rate() const { return nxCalc::div0(float(mHits), float(mHits + mMisses)); }
+};
+
 #define SCN_OBJ_SPARE_VARS_NUM 16
 #define SCN_OBJ_SPARE_PTRS_NUM 8
 
@@ -80,6 +134,12 @@ public:
 	bool mDisableShadowRecv;
 	float mObjAdjYOffs;
 	float mObjAdjRadius;
+	float mMotCacheFrameStep;
+	bool mDisableMotCache;
+	float mAnimLODDistOffs;
+	int mAnimLODPhase;
+	int mAnimLODInterval;
+	bool mDisableAnimLOD;
 	int32_t mMotExecSync;
 	bool mSplitMoveReqFlg;
 	int mRoutine[4];
@@ -167,6 +227,7 @@ public:
 
 	void update_world();
 	void update_skin();
+	void update_skin_bounds();
 	void update_bounds();
 	void update_visibility();
 	void update_batch_visibility(const int ibat);
@@ -293,6 +354,7 @@ int get_num_workers();
 int get_num_active_workers();
 int get_num_per_worker_blocks();
 int get_visibility_job_lvl();
+int get_draw_record_job_lvl();
 int get_wrk_jobs_done_cnt(const int lvl, const int wrkId);
 int get_lvl_jobs_done_cnt(const int lvl);
 
@@ -305,6 +367,32 @@ cxHeap* get_job_local_heap(const sxJobContext* pJobCtx);
 void enable_split_move(const bool flg);
 bool is_split_move_enabled();
 
+void enable_draw_sort(const bool flg);
+bool is_draw_sort_enabled();
+
+/* takes effect with draw sorting: adjacent queue items sharing model, batch and state go through Draw::Ifc::batch_inst */
+void enable_draw_inst(const bool flg);
+bool is_draw_inst_enabled();
+
+/* occluders are rasterized into a low-res depth buffer in visibility(), batches hidden behind them are culled with the frustum-culled ones;
+   occluder geometry must be conservative (inside or on the rendered opaque surfaces), so stage collision with invisible blockers or enlarged hulls must not be used,
+   add_pkg_occluder registers the package's dedicated "occl" collision authored for this purpose and returns false if there is none */
+void enable_occlusion_cull(const bool flg);
+bool is_occlusion_cull_enabled();
+bool add_occluder(const sxCollisionData* pCol);
+bool add_pkg_occluder(Pkg* pPkg);
+void clear_occluders();
+cxOcclusionBuffer* get_occlusion_buffer();
+
+cxMotionEvalCache* get_mot_cache();
+void set_mot_cache_quant(const float dist, const float frameStep);
+
+ScnStats get_stats();
+
+bool set_anim_lod_mask(const sxModelData* pMdl, const char** ppNodeNames, const int numNodes);
+const uint32_t* get_anim_lod_mask(const sxModelData* pMdl);
+void clear_anim_lod_masks();
+
 void alloc_global_heap(const size_t globalHeapSize);
 void free_global_heap();
 void purge_global_heap();
@@ -357,7 +445,10 @@ void set_shadow_proj_params(const float size, const float margin, const float di
 void set_shadow_dir(const cxVec& sdir);
 void set_shadow_dir_degrees(const float dx, const float dy);
 cxVec get_shadow_dir();
+void set_shadow_cascades(const int num, const float dist = 0.0f, const float lambda = 0.75f);
+int get_shadow_cascades();
 cxMtx get_shadow_view_proj_mtx();
+const xt_float4* get_shadow_cull_planes();
 
 void set_hemi_upper(const float r, const float g, const float b);
 void set_hemi_lower(const float r, const float g, const float b);
@@ -406,6 +497,10 @@ void for_all_pkg_models(Pkg* pPkg, void (*func)(sxModelData*, void*), void* pFun
 void add_obj_instances(const char* pPkgName, const ScnObj::InstInfo* pInstInfos, const int num, const char* pName = nullptr);
 int get_num_objs();
 void for_each_obj(bool (*func)(ScnObj*, void*), void* pWkMem);
+void update_obj_grid();
+void set_obj_grid_cell_size(const float size);
+int for_each_obj_in_sph(const cxVec& center, const float radius, bool (*func)(ScnObj*, void*), void* pWkMem);
+int for_each_obj_in_aabb(const cxAABB& box, bool (*func)(ScnObj*, void*), void* pWkMem);
 void set_obj_exec_func(const char* pName, ScnObj::ExecFunc exec);
 void set_obj_del_func(const char* pName, ScnObj::DelFunc del);
 cxVec get_obj_world_pos(const char* pName);
@@ -435,11 +530,18 @@ float get_font_width();
 float get_font_height();
 void symbol(const int sym, const float ox, const float oy, const cxColor clr = cxColor(1.0f), const cxColor* pOutClr = nullptr);
 void symbol_str(const char* pStr, const float ox, const float oy, const cxColor clr = cxColor(1.0f));
-
-float get_ground_height(sxCollisionData* pCol, const cxVec pos, const float offsTop = 1.8f, const float offsBtm = 0.5f);
-bool wall_adj_base(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim = 0.7f);
-bool wall_adj(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim = 0.7f, const float errParam = 0.5f);
-bool wall_touch(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, const float wallSlopeLim = 0.7f);
+void set_text_clip(const float x, const float y, const float w, const float h);
+void reset_text_clip();
+
+/* refits through here bump the runtime generation of pCol, which makes ScnColCache refetch; call outside of exec() */
+bool refit_collision(sxCollisionData* pCol, const cxVec* pPnts = nullptr, const float rebuildCost = 0.0f);
+uint32_t get_collision_generation(const sxCollisionData* pCol);
+
+float get_ground_height(sxCollisionData* pCol, const cxVec pos, const float offsTop = 1.8f, const float offsBtm = 0.5f, ScnColCache* pCache = nullptr);
+bool wall_adj_base(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim = 0.7f, ScnColCache* pCache = nullptr);
+bool wall_adj(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim = 0.7f, const float errParam = 0.5f, ScnColCache* pCache = nullptr);
+bool wall_touch(const sxJobContext* pJobCtx, sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, const float wallSlopeLim = 0.7f, ScnColCache* pCache = nullptr);
+bool wall_adj_sweep(sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos, const float wallSlopeLim = 0.7f, const float capHeight = 0.0f, const int maxSweeps = 3);
 bool col_hit_stop(sxCollisionData* pCol, const cxVec& newPos, const cxVec& oldPos, const float radius, cxVec* pAdjPos);
 
 bool sph_sph_adj(const cxVec& newPos, const cxVec& oldPos, float radius, const cxVec& staticPos, const float staticRadius, cxVec* pAdjPos, const float reflectFactor = 0.5f, const float margin = 0.0f);
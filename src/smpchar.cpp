@@ -179,7 +179,9 @@ static bool char_obj_adj_for_each(ScnObj* pObj, void* pCharMem) {
 void SmpChar::obj_adj() {
 	if (!mpObj) return;
 	mObjAdjCount = 0;
-	Scene::for_each_obj(char_obj_adj_for_each, this);
+	cxVec npos = mpObj->get_world_pos();
+	npos.y += mpObj->mObjAdjYOffs;
+	Scene::for_each_obj_in_sph(npos, mpObj->mObjAdjRadius, char_obj_adj_for_each, this);
 	if (mObjAdjCount > 0) {
 		++mObjTouchCount;
 	} else {
@@ -202,13 +204,18 @@ void SmpChar::wall_adj() {
 	npos.y += yoffs;
 	opos.y += yoffs;
 	float radius = mpObj->mObjAdjRadius * 1.1f;
-	bool touchFlg = Scene::wall_touch(mpObj->mpJobCtx, pCol, npos, opos, radius * 1.025f);
+	bool touchFlg = Scene::wall_touch(mpObj->mpJobCtx, pCol, npos, opos, radius * 1.025f, 0.7f, &mColCache);
 	if (touchFlg) {
 		++mWallTouchCount;
 	} else {
 		mWallTouchCount = 0;
 	}
-	bool adjFlg = Scene::wall_adj(mpObj->mpJobCtx, pCol, npos, opos, radius, &apos);
+	bool adjFlg = false;
+	if (SmpCharSys::wall_sweep_enabled()) {
+		adjFlg = Scene::wall_adj_sweep(pCol, npos, opos, radius, &apos);
+	} else {
+		adjFlg = Scene::wall_adj(mpObj->mpJobCtx, pCol, npos, opos, radius, &apos, 0.7f, 0.5f, &mColCache);
+	}
 	if (adjFlg) {
 		mpObj->set_skel_root_local_pos(apos.x, wpos.y, apos.z);
 	}
@@ -220,7 +227,7 @@ void SmpChar::ground_adj() {
 	sxCollisionData* pCol = SmpCharSys::get_collision();
 	if (!pCol) return;
 	cxVec wpos = pObj->get_world_pos();
-	float y = Scene::get_ground_height(pCol, wpos);
+	float y = Scene::get_ground_height(pCol, wpos, 1.8f, 0.5f, &mColCache);
 	pObj->set_skel_root_local_ty(y);
 }
 
@@ -228,6 +235,14 @@ void SmpChar::exec_collision() {
 	if (!mpObj) return;
 	bool objTouchOngoing = mObjTouchCount > 0;
 	bool wallTouchOngoing = mWallTouchCount > 0;
+	sxCollisionData* pCol = SmpCharSys::get_collision();
+	if (pCol) {
+		/* one box for the wall and ground queries below */
+		cxVec wpos = mpObj->get_world_pos();
+		float r = mpObj->mObjAdjRadius * 1.2f + nxVec::dist(wpos, mpObj->get_prev_world_pos()) * 2.0f;
+		float ytop = nxCalc::max(mpObj->mObjAdjYOffs + r, 1.8f);
+		mColCache.prepare(pCol, cxAABB(wpos - cxVec(r, 0.5f, r), wpos + cxVec(r, ytop, r)));
+	}
 	obj_adj();
 	wall_adj();
 	ground_adj();
@@ -278,6 +293,7 @@ static struct Wk {
 	bool mTimeFixUpFlg;
 	bool mFixedFreq;
 	bool mLowQ;
+	bool mWallSweep;
 	cxStopWatch mFramerateStopWatch;
 	float mMedianFPS;
 
@@ -291,6 +307,7 @@ static struct Wk {
 		mCurrentTime = 0.0;
 		mFixedFreq = nxApp::get_bool_opt("fixfreq", false);
 		mLowQ = nxApp::get_bool_opt("lowq", false);
+		mWallSweep = nxApp::get_bool_opt("wall_sweep", false);
 	}
 
 	void reset() {
@@ -380,6 +397,10 @@ float get_fps() {
 	return s_wk.mMedianFPS;
 }
 
+bool wall_sweep_enabled() {
+	return s_wk.mWallSweep;
+}
+
 bool obj_is_char(ScnObj* pObj) {
 	bool res = false;
 	if (pObj) {
@@ -417,6 +438,7 @@ static void char_exec_func(ScnObj* pObj) {
 static void char_del_func(ScnObj* pObj) {
 	SmpChar* pChar = char_from_obj(pObj);
 	if (!pChar) return;
+	pChar->mColCache.reset();
 	nxCore::tMem<SmpChar>::free(pChar);
 	pObj->set_ptr_wk<void>(0, nullptr);
 	pObj->set_ptr_wk<void>(1, nullptr);
@@ -478,6 +500,7 @@ static ScnObj* add_char(const Pkg* pPkg, const SmpChar::Descr& descr, SmpChar::C
 			pChar->set_act_duration_seconds(0.5f);
 			pChar->mMood = 0.5f;
 			pChar->mMoodTimer = get_sys_time_millis();
+			pChar->mColCache.init();
 		}
 	}
 	if (pObj) {
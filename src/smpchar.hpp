@@ -63,6 +63,7 @@ struct SmpChar {
 	double mCtrlDt;
 	double mMoodTimer;
 	float mMood;
+	ScnColCache mColCache;
 
 	bool is_f() const;
 	bool is_m() const;
@@ -140,6 +141,7 @@ namespace SmpCharSys {
 	double get_current_time();
 	float get_motion_speed();
 	float get_fps();
+	bool wall_sweep_enabled();
 
 	bool obj_is_char(ScnObj* pObj);
 	SmpChar* char_from_obj(ScnObj* pObj);
@@ -89,6 +89,11 @@ void SmpRig::exec(sxCollisionData* pCol) {
 	if (pCol && pMotWk) {
 		float scale = pObj->get_motion_uniform_scl();
 		float ankleHeight = mAnkleHeight * scale;
+		LegInfo* legs[2];
+		cxVec legsPos[2];
+		cxLineSeg legsSeg[2];
+		sxCollisionData::NearestHit legsHit[2];
+		int nlegs = 0;
 		for (int i = 0; i < 2; ++i) {
 			LegInfo* pLeg = i ? &mLegL : &mLegR;
 			if (pLeg->inodeEnd >= 0) {
@@ -98,17 +103,24 @@ void SmpRig::exec(sxCollisionData* pCol) {
 				cxVec legDn = legUp;
 				legUp.y += 0.5f;
 				legDn.y -= 0.5f;
-				cxLineSeg seg(legUp, legDn);
-				sxCollisionData::NearestHit hit = pCol->nearest_hit(seg);
-				if (hit.count > 0) {
-					float hy = hit.pos.y + ankleHeight;
-					float ay = legPos.y;
-					if (hy > legPos.y) {
-						ay = hy;
-					}
-					cxVec effPos(legPos.x, ay, legPos.z);
-					pMotWk->adjust_leg(effPos, pLeg->inodeTop, pLeg->inodeRot, pLeg->inodeEnd, -1);
+				legs[nlegs] = pLeg;
+				legsPos[nlegs] = legPos;
+				legsSeg[nlegs].set(legUp, legDn);
+				++nlegs;
+			}
+		}
+		pCol->hit_check_batch(legsSeg, legsHit, nlegs);
+		for (int i = 0; i < nlegs; ++i) {
+			LegInfo* pLeg = legs[i];
+			cxVec legPos = legsPos[i];
+			if (legsHit[i].count > 0) {
+				float hy = legsHit[i].pos.y + ankleHeight;
+				float ay = legPos.y;
+				if (hy > legPos.y) {
+					ay = hy;
 				}
+				cxVec effPos(legPos.x, ay, legPos.z);
+				pMotWk->adjust_leg(effPos, pLeg->inodeTop, pLeg->inodeRot, pLeg->inodeEnd, -1);
 			}
 		}
 	}
@@ -12,3 +12,4 @@ OPTI_OPTS="-O3 -ffast-math -flto"
 CXX_CMD="$CXX -pthread -std=c++11 -I .. ../crosscore.cpp $OPTI_OPTS"
 
 $CXX_CMD tst_nnmul_h.cpp -o tst_nnmul_h $*
+$CXX_CMD tst_geom.cpp -o tst_geom $*
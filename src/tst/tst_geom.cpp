@@ -63,6 +63,721 @@ XD_NOINLINE static void test_tri_bc() {
 }
 
 
+static sxCollisionData* alloc_tst_col(const int npnt, const int npol) {
+	int nnodes = npol*2 - 1;
+	size_t size = XD_ALIGN(sizeof(sxCollisionData), 0x10);
+	size_t pntOffs = size;
+	size += npnt * sizeof(cxVec);
+	size_t orgOffs = size;
+	size += npol * sizeof(int32_t);
+	size_t idxOffs = size;
+	size += npol * 3 * sizeof(int32_t);
+	size_t bboxOffs = size;
+	size += npol * sizeof(cxAABB);
+	size_t nodeBBoxOffs = size;
+	size += nnodes * sizeof(cxAABB);
+	size_t nodeInfoOffs = size;
+	size += nnodes * sizeof(sxCollisionData::BVHNodeInfo);
+	sxCollisionData* pCol = (sxCollisionData*)nxCore::mem_alloc(size, "tst:xcol");
+	nxCore::mem_zero(pCol, size);
+	pCol->mKind = sxCollisionData::KIND;
+	pCol->mFlags = 1;
+	pCol->mFileSize = uint32_t(size);
+	pCol->mHeadSize = uint32_t(sizeof(sxCollisionData));
+	pCol->mNameId = -1;
+	pCol->mPathId = -1;
+	pCol->mPntNum = uint32_t(npnt);
+	pCol->mPolNum = uint32_t(npol);
+	pCol->mTriNum = uint32_t(npol);
+	pCol->mGrpNum = 1;
+	pCol->mMaxVtxPerPol = 3;
+	pCol->mPntOffs = uint32_t(pntOffs);
+	pCol->mPolIdxOrgOffs = uint32_t(orgOffs);
+	pCol->mPolIdxOffs = uint32_t(idxOffs);
+	pCol->mPolBBoxOffs = uint32_t(bboxOffs);
+	pCol->mBVHBBoxOffs = uint32_t(nodeBBoxOffs);
+	pCol->mBVHInfoOffs = uint32_t(nodeInfoOffs);
+	return pCol;
+}
+
+static void finish_tst_col(sxCollisionData* pCol) {
+	int npol = int(pCol->mPolNum);
+	const cxVec* pPnts = (const cxVec*)XD_INCR_PTR(pCol, pCol->mPntOffs);
+	const int32_t* pIdx = (const int32_t*)XD_INCR_PTR(pCol, pCol->mPolIdxOffs);
+	cxAABB* pBBoxes = (cxAABB*)XD_INCR_PTR(pCol, pCol->mPolBBoxOffs);
+	for (int i = 0; i < npol; ++i) {
+		pBBoxes[i].set(pPnts[pIdx[i*3]]);
+		pBBoxes[i].add_pnt(pPnts[pIdx[i*3 + 1]]);
+		pBBoxes[i].add_pnt(pPnts[pIdx[i*3 + 2]]);
+		if (i == 0) {
+			pCol->mBBox = pBBoxes[i];
+		} else {
+			pCol->mBBox.merge(pBBoxes[i]);
+		}
+	}
+	int32_t* pIdxWk = (int32_t*)nxCore::mem_alloc(npol * sizeof(int32_t), "tst:xcol:wk");
+	nxGeom::build_aabb_tree(pBBoxes, npol, (cxAABB*)XD_INCR_PTR(pCol, pCol->mBVHBBoxOffs), (int32_t*)XD_INCR_PTR(pCol, pCol->mBVHInfoOffs), pIdxWk);
+	nxCore::mem_free(pIdxWk);
+}
+
+static sxCollisionData* make_tst_col(const int gn, const int nrnd, sxRNG* pRNG) {
+	int npnt = (gn + 1)*(gn + 1) + nrnd*3;
+	int npol = gn*gn*2 + nrnd;
+	sxCollisionData* pCol = alloc_tst_col(npnt, npol);
+	cxVec* pPnts = (cxVec*)XD_INCR_PTR(pCol, pCol->mPntOffs);
+	int32_t* pOrgs = (int32_t*)XD_INCR_PTR(pCol, pCol->mPolIdxOrgOffs);
+	int32_t* pIdx = (int32_t*)XD_INCR_PTR(pCol, pCol->mPolIdxOffs);
+	float ext = float(gn);
+	int ipnt = 0;
+	for (int z = 0; z <= gn; ++z) {
+		for (int x = 0; x <= gn; ++x) {
+			float fx = float(x) - ext*0.5f;
+			float fz = float(z) - ext*0.5f;
+			pPnts[ipnt++].set(fx, ::mth_sinf(fx*0.3f) * ::mth_cosf(fz*0.2f) * 2.0f, fz);
+		}
+	}
+	int ipol = 0;
+	for (int z = 0; z < gn; ++z) {
+		for (int x = 0; x < gn; ++x) {
+			int i00 = z*(gn + 1) + x;
+			int i01 = i00 + gn + 1;
+			int tris[2][3] = { { i00, i00 + 1, i01 }, { i00 + 1, i01 + 1, i01 } };
+			for (int i = 0; i < 2; ++i) {
+				pOrgs[ipol] = ipol * 3;
+				for (int j = 0; j < 3; ++j) {
+					pIdx[ipol*3 + j] = tris[i][j];
+				}
+				++ipol;
+			}
+		}
+	}
+	for (int i = 0; i < nrnd; ++i) {
+		cxVec c(nxCore::rng_f01(pRNG)*ext - ext*0.5f, nxCore::rng_f01(pRNG)*6.0f - 1.0f, nxCore::rng_f01(pRNG)*ext - ext*0.5f);
+		pOrgs[ipol] = ipol * 3;
+		for (int j = 0; j < 3; ++j) {
+			pPnts[ipnt] = c + cxVec(nxCore::rng_f01(pRNG) - 0.5f, nxCore::rng_f01(pRNG) - 0.5f, nxCore::rng_f01(pRNG) - 0.5f) * 2.0f;
+			pIdx[ipol*3 + j] = ipnt++;
+		}
+		++ipol;
+	}
+	finish_tst_col(pCol);
+	return pCol;
+}
+
+/* 10x10 room with 3 high walls and a low step block at x = 2..3 */
+static sxCollisionData* make_tst_room_col() {
+	static const float boxes[2][6] = {
+		{ -5.0f, 0.0f, -5.0f, 5.0f, 3.0f, 5.0f },
+		{ 2.0f, 0.0f, -1.0f, 3.0f, 0.3f, 1.0f }
+	};
+	static const int quads[6][4] = {
+		{ 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }
+	};
+	sxCollisionData* pCol = alloc_tst_col(2*8, 2*6*2);
+	cxVec* pPnts = (cxVec*)XD_INCR_PTR(pCol, pCol->mPntOffs);
+	int32_t* pOrgs = (int32_t*)XD_INCR_PTR(pCol, pCol->mPolIdxOrgOffs);
+	int32_t* pIdx = (int32_t*)XD_INCR_PTR(pCol, pCol->mPolIdxOffs);
+	int ipol = 0;
+	for (int ibox = 0; ibox < 2; ++ibox) {
+		const float* pBox = boxes[ibox];
+		int org = ibox * 8;
+		for (int i = 0; i < 8; ++i) {
+			pPnts[org + i].set(pBox[(i & 1) ? 3 : 0], pBox[(i & 2) ? 4 : 1], pBox[(i & 4) ? 5 : 2]);
+		}
+		for (int i = 0; i < 6; ++i) {
+			int tris[2][3] = { { quads[i][0], quads[i][1], quads[i][2] }, { quads[i][0], quads[i][2], quads[i][3] } };
+			for (int j = 0; j < 2; ++j) {
+				pOrgs[ipol] = ipol * 3;
+				for (int k = 0; k < 3; ++k) {
+					pIdx[ipol*3 + k] = org + tris[j][k];
+				}
+				++ipol;
+			}
+		}
+	}
+	finish_tst_col(pCol);
+	return pCol;
+}
+
+static bool tst_qbvh_tri_func(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	++(*(int*)pWk);
+	return true;
+}
+
+XD_NOINLINE static void test_qbvh() {
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 33);
+	sxCollisionData* pCol = make_tst_col(32, 200, &rng);
+	cxVec bbmin = pCol->mBBox.get_min_pos();
+	cxVec bbsize = pCol->mBBox.get_size_vec();
+	for (int bits = 8; bits <= 16; bits += 8) {
+		sxCollisionData* pQCol = pCol->make_QBVH(bits);
+		if (!pQCol || !pQCol->get_QBVH()) {
+			nxCore::dbg_msg("!QBVH%d build\n", bits);
+			continue;
+		}
+		int nhit = 0;
+		int nerr = 0;
+		for (int i = 0; i < 2000; ++i) {
+			cxVec p0(bbmin.x + nxCore::rng_f01(&rng)*bbsize.x, bbmin.y + nxCore::rng_f01(&rng)*bbsize.y*2.0f, bbmin.z + nxCore::rng_f01(&rng)*bbsize.z);
+			cxVec p1(p0.x + (nxCore::rng_f01(&rng) - 0.5f)*4.0f, bbmin.y - 1.0f, p0.z + (nxCore::rng_f01(&rng) - 0.5f)*4.0f);
+			cxLineSeg seg(p0, p1);
+			sxCollisionData::NearestHit hit = pCol->nearest_hit(seg);
+			sxCollisionData::NearestHit qhit = pQCol->nearest_hit(seg);
+			if ((hit.count > 0) != (qhit.count > 0)) {
+				++nerr;
+			} else if (hit.count > 0) {
+				++nhit;
+				if (nxVec::dist(hit.pos, qhit.pos) > 1.0e-4f) {
+					++nerr;
+				}
+			}
+			cxAABB bbox(p0 - cxVec(0.5f), p0 + cxVec(0.5f));
+			int ntris = 0;
+			int nqtris = 0;
+			pCol->for_tris_in_range(tst_qbvh_tri_func, bbox, &ntris, false);
+			pQCol->for_tris_in_range(tst_qbvh_tri_func, bbox, &nqtris, false);
+			if (ntris != nqtris) {
+				++nerr;
+			}
+		}
+		if (pQCol->mFileSize >= pCol->mFileSize) {
+			nxCore::dbg_msg("!QBVH%d: %d bytes -> %d bytes\n", bits, int(pCol->mFileSize), int(pQCol->mFileSize));
+			++nerr;
+		}
+		if (nerr) {
+			nxCore::dbg_msg("!QBVH%d: %d mismatches\n", bits, nerr);
+		} else {
+			nxCore::dbg_msg("QBVH%d: %d bytes -> %d bytes, %d hits OK\n", bits, int(pCol->mFileSize), int(pQCol->mFileSize), nhit);
+		}
+		nxCore::mem_free(pQCol);
+	}
+	nxCore::mem_free(pCol);
+}
+
+
+XD_NOINLINE static void test_hit_batch() {
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 35);
+	sxCollisionData* pCol = make_tst_col(32, 200, &rng);
+	cxVec bbmin = pCol->mBBox.get_min_pos();
+	cxVec bbsize = pCol->mBBox.get_size_vec();
+	const int nsegs = 1024;
+	cxLineSeg segs[nsegs];
+	sxCollisionData::NearestHit hits[nsegs];
+	cxVec org = bbmin;
+	for (int i = 0; i < nsegs; ++i) {
+		if ((i & 7) == 0) {
+			org.set(bbmin.x + nxCore::rng_f01(&rng)*bbsize.x, bbmin.y + bbsize.y*2.0f, bbmin.z + nxCore::rng_f01(&rng)*bbsize.z);
+		}
+		cxVec p0 = org + cxVec(nxCore::rng_f01(&rng) - 0.5f, 0.0f, nxCore::rng_f01(&rng) - 0.5f);
+		cxVec p1 = p0 + cxVec(nxCore::rng_f01(&rng) - 0.5f, -bbsize.y*3.0f, nxCore::rng_f01(&rng) - 0.5f);
+		segs[i].set(p0, p1);
+	}
+	int nhit = pCol->hit_check_batch(segs, hits, nsegs);
+	int nerr = 0;
+	for (int i = 0; i < nsegs; ++i) {
+		sxCollisionData::NearestHit hit = pCol->nearest_hit(segs[i]);
+		if ((hit.count > 0) != (hits[i].count > 0)) {
+			++nerr;
+		} else if (hit.count > 0 && nxVec::dist(hit.pos, hits[i].pos) > 1.0e-4f) {
+			++nerr;
+		}
+	}
+	if (nerr) {
+		nxCore::dbg_msg("!hit batch: %d mismatches\n", nerr);
+	} else {
+		nxCore::dbg_msg("hit batch: %d/%d hits OK\n", nhit, nsegs);
+	}
+	nxCore::mem_free(pCol);
+}
+
+
+static int tst_refit_cmp(sxCollisionData* pCol, sxCollisionData* pRef, sxRNG* pRNG) {
+	cxVec bbmin = pRef->mBBox.get_min_pos();
+	cxVec bbsize = pRef->mBBox.get_size_vec();
+	int nerr = 0;
+	for (int i = 0; i < 500; ++i) {
+		cxVec p0(bbmin.x + nxCore::rng_f01(pRNG)*bbsize.x, bbmin.y + bbsize.y*1.5f, bbmin.z + nxCore::rng_f01(pRNG)*bbsize.z);
+		cxVec p1 = p0 + cxVec(nxCore::rng_f01(pRNG) - 0.5f, -bbsize.y*2.0f, nxCore::rng_f01(pRNG) - 0.5f);
+		cxLineSeg seg(p0, p1);
+		sxCollisionData::NearestHit hit = pCol->nearest_hit(seg);
+		sxCollisionData::NearestHit ref = pRef->nearest_hit(seg);
+		if ((hit.count > 0) != (ref.count > 0)) {
+			++nerr;
+		} else if (hit.count > 0 && nxVec::dist(hit.pos, ref.pos) > 1.0e-4f) {
+			++nerr;
+		}
+		cxAABB bbox(p1 - cxVec(1.0f), p1 + cxVec(1.0f));
+		int ntris = 0;
+		int nref = 0;
+		pCol->for_tris_in_range(tst_qbvh_tri_func, bbox, &ntris, false);
+		pRef->for_tris_in_range(tst_qbvh_tri_func, bbox, &nref, false);
+		if (ntris != nref) {
+			++nerr;
+		}
+	}
+	return nerr;
+}
+
+XD_NOINLINE static void test_refit() {
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 38);
+	sxCollisionData* pSrc = make_tst_col(96, 500, &rng);
+	sxCollisionData* pQSrc = pSrc->make_QBVH(16);
+	sxCollisionData* pWSrc = pSrc->make_wide_BVH(8);
+	sxCollisionData* pCols[] = { pSrc, pQSrc, pWSrc };
+	const char* pNames[] = { "BVH", "QBVH", "WBVH" };
+	sxCollisionData* pRef = (sxCollisionData*)nxCore::mem_alloc(pSrc->mFileSize, "tst:xcol:ref");
+	nxCore::mem_copy(pRef, pSrc, pSrc->mFileSize);
+	float baseCost = pSrc->calc_BVH_cost();
+	int npnt = int(pSrc->mPntNum);
+	cxVec* pPnts = (cxVec*)nxCore::mem_alloc(npnt * sizeof(cxVec), "tst:xcol:pnts");
+	const cxVec* pOrgPnts = (const cxVec*)XD_INCR_PTR(pSrc, pSrc->mPntOffs);
+	cxBrigade* pBgd = cxBrigade::create(4);
+	for (int istep = 0; istep < 2; ++istep) {
+		for (int i = 0; i < npnt; ++i) {
+			cxVec p = pOrgPnts[i];
+			if (istep == 0) {
+				p.y += ::mth_sinf(p.x*0.5f + p.z*0.25f) * 1.5f;
+			} else {
+				p.x = -p.x;
+				p.y += float(i % 7) * 2.0f;
+			}
+			pPnts[i] = p;
+		}
+		nxCore::mem_copy((cxVec*)XD_INCR_PTR(pRef, pRef->mPntOffs), pPnts, npnt * sizeof(cxVec));
+		finish_tst_col(pRef);
+		for (int icol = 0; icol < 3; ++icol) {
+			sxCollisionData* pCol = pCols[icol];
+			bool rebuilt = pCol->refit_BVH(pPnts, baseCost * 1.5f, pBgd);
+			int nerr = tst_refit_cmp(pCol, pRef, &rng);
+			if (nerr) {
+				nxCore::dbg_msg("!refit %s #%d: %d mismatches\n", pNames[icol], istep, nerr);
+			} else {
+				nxCore::dbg_msg("refit %s #%d: cost %.2f -> %.2f, %s, OK\n", pNames[icol], istep, baseCost, pCol->calc_BVH_cost(), rebuilt ? "rebuilt" : "refitted");
+			}
+		}
+	}
+	cxBrigade::destroy(pBgd);
+	nxCore::mem_free(pPnts);
+	nxCore::mem_free(pRef);
+	nxCore::mem_free(pWSrc);
+	nxCore::mem_free(pQSrc);
+	nxCore::mem_free(pSrc);
+}
+
+static sxGeometryData* alloc_tst_geo(const int npnt, const int npol) {
+	int nnodes = npol*2 - 1;
+	int idxSize = npnt <= (1 << 8) ? 1 : npnt <= (1 << 16) ? 2 : 3;
+	size_t size = XD_ALIGN(sizeof(sxGeometryData), 0x10);
+	size_t pntOffs = size;
+	size += npnt * sizeof(cxVec);
+	size_t polOffs = size;
+	size += XD_ALIGN(npol * 3 * idxSize, 0x10);
+	size_t bvhOffs = size;
+	size += sizeof(sxGeometryData::BVH) + nnodes * sizeof(sxGeometryData::BVH::Node);
+	sxGeometryData* pGeo = (sxGeometryData*)nxCore::mem_alloc(size, "tst:xgeo");
+	nxCore::mem_zero(pGeo, size);
+	pGeo->mKind = sxGeometryData::KIND;
+	pGeo->mFlags = 1 | 2;
+	pGeo->mFileSize = uint32_t(size);
+	pGeo->mHeadSize = uint32_t(sizeof(sxGeometryData));
+	pGeo->mNameId = -1;
+	pGeo->mPathId = -1;
+	pGeo->mPntNum = uint32_t(npnt);
+	pGeo->mPolNum = uint32_t(npol);
+	pGeo->mMaxVtxPerPol = 3;
+	pGeo->mPntOffs = uint32_t(pntOffs);
+	pGeo->mPolOffs = uint32_t(polOffs);
+	pGeo->mBVHOffs = uint32_t(bvhOffs);
+	pGeo->get_BVH()->mNodesNum = uint32_t(nnodes);
+	return pGeo;
+}
+
+static void set_tst_geo_pol(sxGeometryData* pGeo, const int ipol, const int i0, const int i1, const int i2) {
+	int idxSize = pGeo->get_vtx_idx_size();
+	uint8_t* pIdx = (uint8_t*)XD_INCR_PTR(pGeo, pGeo->mPolOffs) + ipol*3*idxSize;
+	int idx[] = { i0, i1, i2 };
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < idxSize; ++j) {
+			*pIdx++ = uint8_t(idx[i] >> (j*8));
+		}
+	}
+}
+
+/* median-split tree, as a plain exporter would leave it */
+static void finish_tst_geo(sxGeometryData* pGeo) {
+	int npol = pGeo->get_pol_num();
+	int nnodes = npol*2 - 1;
+	void* pTmp = nxCore::mem_alloc(npol * (sizeof(cxAABB) + sizeof(int32_t)) + nnodes * (sizeof(cxAABB) + sizeof(int32_t)*2), "tst:xgeo:wk");
+	cxAABB* pPolBoxes = (cxAABB*)pTmp;
+	cxAABB* pBoxes = pPolBoxes + npol;
+	int32_t* pInfos = (int32_t*)(pBoxes + nnodes);
+	int32_t* pIdxWk = pInfos + nnodes*2;
+	for (int i = 0; i < npol; ++i) {
+		pPolBoxes[i] = pGeo->get_pol(i).calc_bbox();
+	}
+	nxGeom::build_aabb_tree(pPolBoxes, npol, pBoxes, pInfos, pIdxWk);
+	for (int i = 0; i < nnodes; ++i) {
+		sxGeometryData::BVH::Node* pNode = pGeo->get_BVH_node(i);
+		pNode->mBBox = pBoxes[i];
+		pNode->mLeft = pInfos[i*2];
+		pNode->mRight = pInfos[i*2 + 1];
+	}
+	pGeo->mBBox = pBoxes[0];
+	nxCore::mem_free(pTmp);
+}
+
+static sxGeometryData* make_tst_geo(const int gn, const int nrnd, sxRNG* pRNG) {
+	int npnt = (gn + 1)*(gn + 1) + nrnd*3;
+	int npol = gn*gn*2 + nrnd;
+	sxGeometryData* pGeo = alloc_tst_geo(npnt, npol);
+	cxVec* pPnts = pGeo->get_pnt_top();
+	float ext = float(gn);
+	int ipnt = 0;
+	for (int z = 0; z <= gn; ++z) {
+		for (int x = 0; x <= gn; ++x) {
+			pPnts[ipnt++].set(float(x) - ext*0.5f, 0.0f, float(z) - ext*0.5f);
+		}
+	}
+	int ipol = 0;
+	for (int z = 0; z < gn; ++z) {
+		for (int x = 0; x < gn; ++x) {
+			int i00 = z*(gn + 1) + x;
+			int i01 = i00 + gn + 1;
+			set_tst_geo_pol(pGeo, ipol++, i00, i00 + 1, i01);
+			set_tst_geo_pol(pGeo, ipol++, i00 + 1, i01 + 1, i01);
+		}
+	}
+	for (int i = 0; i < nrnd; ++i) {
+		cxVec c(nxCore::rng_f01(pRNG)*ext - ext*0.5f, nxCore::rng_f01(pRNG)*6.0f - 1.0f, nxCore::rng_f01(pRNG)*ext - ext*0.5f);
+		for (int j = 0; j < 3; ++j) {
+			pPnts[ipnt + j] = c + cxVec(nxCore::rng_f01(pRNG) - 0.5f, nxCore::rng_f01(pRNG) - 0.5f, nxCore::rng_f01(pRNG) - 0.5f) * 2.0f;
+		}
+		set_tst_geo_pol(pGeo, ipol++, ipnt, ipnt + 1, ipnt + 2);
+		ipnt += 3;
+	}
+	finish_tst_geo(pGeo);
+	return pGeo;
+}
+
+class TstGeoHitFunc : public sxGeometryData::HitFunc {
+public:
+	float mDist;
+	int mCount;
+
+	TstGeoHitFunc() : mDist(FLT_MAX), mCount(0) {}
+
+	virtual bool operator()(const sxGeometryData::Polygon& pol, const cxVec& hitPos, const cxVec& hitNrm, float hitDist) {
+		mDist = nxCalc::min(mDist, hitDist);
+		++mCount;
+		return true;
+	}
+};
+
+class TstGeoRangeFunc : public sxGeometryData::RangeFunc {
+public:
+	int mCount;
+
+	TstGeoRangeFunc() : mCount(0) {}
+
+	virtual bool operator()(const sxGeometryData::Polygon& pol) {
+		++mCount;
+		return true;
+	}
+};
+
+static int tst_geo_refit_cmp(sxGeometryData* pGeo, sxRNG* pRNG) {
+	cxVec bbmin = pGeo->mBBox.get_min_pos();
+	cxVec bbsize = pGeo->mBBox.get_size_vec();
+	int nerr = 0;
+	for (int i = 0; i < 300; ++i) {
+		cxVec p0(bbmin.x + nxCore::rng_f01(pRNG)*bbsize.x, bbmin.y + bbsize.y*1.5f + 1.0f, bbmin.z + nxCore::rng_f01(pRNG)*bbsize.z);
+		cxVec p1 = p0 + cxVec(nxCore::rng_f01(pRNG) - 0.5f, -bbsize.y*2.0f - 2.0f, nxCore::rng_f01(pRNG) - 0.5f);
+		cxLineSeg seg(p0, p1);
+		TstGeoHitFunc hit;
+		TstGeoHitFunc ref;
+		pGeo->hit_query(seg, hit);
+		pGeo->hit_query_nobvh(seg, ref);
+		if (hit.mCount != ref.mCount || (ref.mCount > 0 && ::mth_fabsf(hit.mDist - ref.mDist) > 1.0e-4f)) {
+			++nerr;
+		}
+		cxAABB bbox(p1 - cxVec(1.0f), p1 + cxVec(1.0f));
+		TstGeoRangeFunc rng;
+		TstGeoRangeFunc rref;
+		pGeo->range_query(bbox, rng);
+		pGeo->range_query_nobvh(bbox, rref);
+		if (rng.mCount != rref.mCount) {
+			++nerr;
+		}
+	}
+	return nerr;
+}
+
+XD_NOINLINE static void test_refit_geo() {
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 381);
+	sxGeometryData* pSrc = make_tst_geo(48, 300, &rng);
+	sxGeometryData* pQSrc = pSrc->make_QBVH(16);
+	sxGeometryData* pWSrc = pSrc->make_wide_BVH(8);
+	sxGeometryData* pGeos[] = { pSrc, pQSrc, pWSrc };
+	const char* pNames[] = { "BVH", "QBVH", "WBVH" };
+	float baseCost = pSrc->calc_BVH_cost();
+	int npnt = pSrc->get_pnt_num();
+	cxVec* pPnts = (cxVec*)nxCore::mem_alloc(npnt * sizeof(cxVec), "tst:xgeo:pnts");
+	cxVec* pOrgPnts = (cxVec*)nxCore::mem_alloc(npnt * sizeof(cxVec), "tst:xgeo:org");
+	nxCore::mem_copy(pOrgPnts, pSrc->get_pnt_top(), npnt * sizeof(cxVec));
+	cxBrigade* pBgd = cxBrigade::create(4);
+	for (int istep = 0; istep < 2; ++istep) {
+		for (int i = 0; i < npnt; ++i) {
+			cxVec p = pOrgPnts[i];
+			if (istep == 0) {
+				p.y += ::mth_sinf(p.x*0.5f + p.z*0.25f) * 1.5f;
+			} else {
+				p.x = -p.x;
+				p.y += float(i % 7) * 2.0f;
+			}
+			pPnts[i] = p;
+		}
+		for (int igeo = 0; igeo < 3; ++igeo) {
+			sxGeometryData* pGeo = pGeos[igeo];
+			bool rebuilt = pGeo->refit_BVH(pPnts, baseCost * 1.5f, pBgd);
+			int nerr = tst_geo_refit_cmp(pGeo, &rng);
+			if (nerr) {
+				nxCore::dbg_msg("!refit geo %s #%d: %d mismatches\n", pNames[igeo], istep, nerr);
+			} else {
+				nxCore::dbg_msg("refit geo %s #%d: cost %.2f -> %.2f, %s, OK\n", pNames[igeo], istep, baseCost, pGeo->calc_BVH_cost(), rebuilt ? "rebuilt" : "refitted");
+			}
+		}
+	}
+	cxBrigade::destroy(pBgd);
+	nxCore::mem_free(pOrgPnts);
+	nxCore::mem_free(pPnts);
+	nxCore::mem_free(pWSrc);
+	nxCore::mem_free(pQSrc);
+	nxCore::mem_free(pSrc);
+
+	/* geometrically growing triangles: the SAH rebuild is several times deeper than the median tree, with a small XD_QBVH_MAX_DEPTH it does not fit and the refit tree is kept */
+	const int ndeep = 120;
+	sxGeometryData* pDeep = alloc_tst_geo(ndeep*3, ndeep);
+	cxVec* pDeepPnts = pDeep->get_pnt_top();
+	for (int i = 0; i < ndeep; ++i) {
+		pDeepPnts[i*3].set(float(i), 0.0f, 0.0f);
+		pDeepPnts[i*3 + 1].set(float(i) + 0.5f, 0.0f, 0.0f);
+		pDeepPnts[i*3 + 2].set(float(i), 0.0f, 0.5f);
+		set_tst_geo_pol(pDeep, i, i*3, i*3 + 1, i*3 + 2);
+	}
+	finish_tst_geo(pDeep);
+	sxGeometryData* pQDeep = pDeep->make_QBVH(16);
+	cxVec* pQDeepPnts = pQDeep->get_pnt_top();
+	float s = 1.0f;
+	for (int i = 0; i < ndeep; ++i) {
+		pQDeepPnts[i*3].set(s, 0.0f, 0.0f);
+		pQDeepPnts[i*3 + 1].set(s*1.5f, 0.0f, 0.0f);
+		pQDeepPnts[i*3 + 2].set(s, 0.0f, s*0.5f);
+		s *= 1.4f;
+	}
+	bool rebuilt = pQDeep->refit_BVH(nullptr, 1.0e-6f);
+	int nerr = tst_geo_refit_cmp(pQDeep, &rng);
+	if (nerr) {
+		nxCore::dbg_msg("!refit geo deep QBVH: %d mismatches\n", nerr);
+	} else {
+		nxCore::dbg_msg("refit geo deep QBVH: depth %d, %s, OK\n", pQDeep->get_QBVH()->mMaxDepth, rebuilt ? "rebuilt" : "refitted");
+	}
+	nxCore::mem_free(pQDeep);
+	nxCore::mem_free(pDeep);
+}
+
+
+XD_NOINLINE static void test_frustum_batch() {
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 40);
+	cxMtx vm;
+	vm.mk_view(cxVec(1.0f, 2.0f, 10.0f), cxVec(0.0f, 1.0f, 0.0f), cxVec(0.0f, 1.0f, 0.0f));
+	cxFrustum fst;
+	fst.init(vm.get_inverted(), XD_DEG2RAD(40.0f), 1.5f, 0.1f, 50.0f);
+	const int nboxes = 1000;
+	cxAABB boxes[nboxes];
+	for (int i = 0; i < nboxes; ++i) {
+		cxVec c(nxCore::rng_f01(&rng)*80.0f - 40.0f, nxCore::rng_f01(&rng)*20.0f - 10.0f, nxCore::rng_f01(&rng)*80.0f - 50.0f);
+		cxVec e(nxCore::rng_f01(&rng)*2.0f, nxCore::rng_f01(&rng)*2.0f, nxCore::rng_f01(&rng)*2.0f);
+		boxes[i].set(c - e, c + e);
+	}
+	XD_BIT_ARY_DECL(uint32_t, bits, nboxes);
+	int ncull = fst.cull(boxes, nboxes, bits);
+	int nerr = 0;
+	for (int i = 0; i < nboxes; ++i) {
+		bool ref = fst.cull(boxes[i]);
+		if (ref != XD_BIT_ARY_CK(uint32_t, bits, i)) {
+			++nerr;
+		}
+	}
+	if (nerr) {
+		nxCore::dbg_msg("!frustum batch: %d mismatches\n", nerr);
+	} else {
+		nxCore::dbg_msg("frustum batch: %d/%d culled OK\n", ncull, nboxes);
+	}
+}
+
+XD_NOINLINE static void test_occlusion() {
+	cxMtx vm;
+	vm.mk_view(cxVec(0.0f, 1.0f, 10.0f), cxVec(0.0f, 1.0f, 0.0f), cxVec(0.0f, 1.0f, 0.0f));
+	cxMtx pm;
+	pm.mk_proj(XD_DEG2RAD(40.0f), 2.0f, 0.1f, 100.0f);
+	cxMtx vp = vm * pm;
+	/* wall: 8x4 quad at z=0, ground: 40x40 quad at y=0 */
+	cxVec pnts[] = {
+		cxVec(-4.0f, -1.0f, 0.0f), cxVec(4.0f, -1.0f, 0.0f), cxVec(4.0f, 3.0f, 0.0f), cxVec(-4.0f, 3.0f, 0.0f),
+		cxVec(-20.0f, 0.0f, 20.0f), cxVec(20.0f, 0.0f, 20.0f), cxVec(20.0f, 0.0f, -20.0f), cxVec(-20.0f, 0.0f, -20.0f)
+	};
+	int32_t idx[] = { 0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6 };
+	cxAABB boxes[6];
+	boxes[0].set(cxVec(-1.0f, 0.5f, -3.0f), cxVec(1.0f, 1.5f, -2.0f)); /* behind the wall */
+	boxes[1].set(cxVec(-1.0f, 0.5f, 2.0f), cxVec(1.0f, 1.5f, 3.0f)); /* in front */
+	boxes[2].set(cxVec(-3.8f, 0.0f, -1.0f), cxVec(3.8f, 2.0f, -0.5f)); /* close behind, fully covered */
+	boxes[3].set(cxVec(6.0f, 0.5f, -3.0f), cxVec(7.0f, 1.5f, -2.0f)); /* beside */
+	boxes[4].set(cxVec(-1.0f, -3.0f, -3.0f), cxVec(1.0f, -2.0f, -2.0f)); /* under the ground */
+	boxes[5].set(cxVec(-1.0f, 2.5f, -3.0f), cxVec(1.0f, 5.5f, -2.0f)); /* sticks out above */
+	bool expect[6] = { true, false, true, false, true, false };
+	int nboxes = XD_ARY_LEN(boxes);
+	cxOcclusionBuffer* pBuf = cxOcclusionBuffer::create(256, 128, 64);
+	cxBrigade* pBgd = cxBrigade::create(4);
+	int nerr = 0;
+	for (int ipass = 0; ipass < 2; ++ipass) {
+		pBuf->begin(vp, 0.1f);
+		pBuf->add_tris(pnts, idx, 4);
+		pBuf->rasterize(ipass ? pBgd : nullptr);
+		XD_BIT_ARY_DECL(uint32_t, bits, 6);
+		nxCore::mem_zero(bits, sizeof(bits));
+		pBuf->cull(boxes, nboxes, bits);
+		for (int i = 0; i < nboxes; ++i) {
+			if (XD_BIT_ARY_CK(uint32_t, bits, i) != expect[i]) {
+				nxCore::dbg_msg("!occlusion: box %d %s\n", i, expect[i] ? "not culled" : "culled");
+				++nerr;
+			}
+		}
+	}
+	/* a triangle crossing the near plane is clipped, not dropped */
+	pBuf->begin(vp, 0.1f);
+	pBuf->add_tri(cxVec(-50.0f, -0.5f, 20.0f), cxVec(50.0f, -0.5f, 20.0f), cxVec(0.0f, -0.5f, -50.0f));
+	if (pBuf->get_tris_num() < 1) {
+		nxCore::dbg_msg("!occlusion: near clip\n");
+		++nerr;
+	}
+	if (!nerr) {
+		nxCore::dbg_msg("occlusion: %d boxes, %d tiles OK\n", nboxes, pBuf->get_tiles_num());
+	}
+	cxBrigade::destroy(pBgd);
+	cxOcclusionBuffer::destroy(pBuf);
+}
+
+static bool tst_wall_filter(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	return ::mth_fabsf(tri.nrm.y) < 0.7f;
+}
+
+struct TstSweepWk {
+	cxVec cp0;
+	cxVec cp1;
+	cxVec mov;
+	float r;
+	float t;
+};
+
+static bool tst_sweep_tri_func(const sxCollisionData& col, const sxCollisionData::Tri& tri, void* pWk) {
+	TstSweepWk* pSweep = (TstSweepWk*)pWk;
+	float t;
+	if (nxGeom::cap_tri_sweep(pSweep->cp0, pSweep->cp1, pSweep->r, pSweep->mov, tri.vtx[0], tri.vtx[1], tri.vtx[2], &t)) {
+		pSweep->t = nxCalc::min(pSweep->t, t);
+	}
+	return true;
+}
+
+XD_NOINLINE static void test_sweep() {
+	int nerr = 0;
+	sxCollisionData* pRoom = make_tst_room_col();
+	const float r = 0.5f;
+	sxCollisionData::SweepHit hit = pRoom->sweep_sph(cxVec(0.0f, 1.0f, -3.0f), cxVec(10.0f, 1.0f, -3.0f), r);
+	if (hit.count < 1 || ::mth_fabsf(hit.t - 0.45f) > 1.0e-3f || hit.nrm.x > -0.999f) {
+		nxCore::dbg_msg("!sweep sph: wall\n");
+		++nerr;
+	}
+	hit = pRoom->sweep_sph(cxVec(-4.0f, 1.0f, -4.4f), cxVec(4.0f, 1.0f, -4.4f), r, tst_wall_filter);
+	if (hit.count != 0) {
+		nxCore::dbg_msg("!sweep sph: parallel\n");
+		++nerr;
+	}
+	hit = pRoom->sweep_sph(cxVec(0.0f, 1.0f, 0.0f), cxVec(3.0f, 1.0f, 0.0f), 0.3f);
+	if (hit.count != 0) {
+		nxCore::dbg_msg("!sweep sph: step\n");
+		++nerr;
+	}
+	hit = pRoom->sweep_cap(cxVec(0.0f, 0.28f, 0.0f), cxVec(0.0f, 1.6f, 0.0f), 0.25f, cxVec(3.0f, 0.0f, 0.0f));
+	if (hit.count < 1 || ::mth_fabsf(hit.t - 1.75f/3.0f) > 1.0e-3f || hit.nrm.x > -0.999f) {
+		nxCore::dbg_msg("!sweep cap: step\n");
+		++nerr;
+	}
+	cxVec apos;
+	pRoom->slide_sph(cxVec(0.0f, 1.0f, -3.0f), cxVec(10.0f, 1.0f, 0.0f), r, &apos, 3, 0.005f, tst_wall_filter);
+	if (apos.x > 4.5f || apos.x < 4.49f || ::mth_fabsf(apos.z) > 1.0e-3f) {
+		nxCore::dbg_msg("!slide sph: wall\n");
+		++nerr;
+	}
+	pRoom->slide_sph(cxVec(0.0f, 1.0f, 0.0f), cxVec(10.0f, 1.0f, 8.0f), r, &apos, 3, 0.005f, tst_wall_filter);
+	if (apos.x > 4.5f || apos.x < 4.49f || apos.z > 4.5f || apos.z < 4.49f) {
+		nxCore::dbg_msg("!slide sph: corner\n");
+		++nerr;
+	}
+	nxCore::mem_free(pRoom);
+
+	/* long grazing moves past a triangle edge: a pass just outside the radius must not stop, a touching one must */
+	cxVec gv0(0.0f, 0.0f, -1.0f);
+	cxVec gv1(0.0f, 0.0f, 1.0f);
+	cxVec gv2(-1.0f, 0.0f, 0.0f);
+	const float gr = 0.01f;
+	float gt = 0.0f;
+	float gdist = 0.0f;
+	if (nxGeom::sph_tri_sweep(cxVec(1000.0f, gr*1.01f, 0.0f), cxVec(-1.0f, gr*1.01f, 0.0f), gr, gv0, gv1, gv2, &gt, nullptr, nullptr, &gdist)) {
+		nxCore::dbg_msg("!sweep sph: graze miss\n");
+		++nerr;
+	}
+	if (!nxGeom::sph_tri_sweep(cxVec(1000.0f, gr*1.0001f, 0.0f), cxVec(-1.0f, gr*1.0001f, 0.0f), gr, gv0, gv1, gv2, &gt, nullptr, nullptr, &gdist) || gdist > gr*1.001f) {
+		nxCore::dbg_msg("!sweep sph: graze touch\n");
+		++nerr;
+	}
+
+	sxRNG rng;
+	nxCore::rng_seed(&rng, 36);
+	sxCollisionData* pCol = make_tst_col(32, 200, &rng);
+	cxVec bbmin = pCol->mBBox.get_min_pos();
+	cxVec bbsize = pCol->mBBox.get_size_vec();
+	int nhit = 0;
+	for (int i = 0; i < 500; ++i) {
+		TstSweepWk wk;
+		wk.cp0.set(bbmin.x + nxCore::rng_f01(&rng)*bbsize.x, bbmin.y + nxCore::rng_f01(&rng)*bbsize.y*1.5f, bbmin.z + nxCore::rng_f01(&rng)*bbsize.z);
+		wk.cp1 = wk.cp0 + cxVec(0.0f, (i & 1) ? 0.0f : 1.0f, 0.0f);
+		wk.mov.set((nxCore::rng_f01(&rng) - 0.5f)*6.0f, (nxCore::rng_f01(&rng) - 0.5f)*3.0f, (nxCore::rng_f01(&rng) - 0.5f)*6.0f);
+		wk.r = 0.1f + nxCore::rng_f01(&rng)*0.5f;
+		wk.t = 2.0f;
+		pCol->for_all_tris(tst_sweep_tri_func, &wk);
+		hit = pCol->sweep_cap(wk.cp0, wk.cp1, wk.r, wk.mov);
+		if ((hit.count > 0) != (wk.t <= 1.0f)) {
+			++nerr;
+		} else if (hit.count > 0) {
+			++nhit;
+			if (::mth_fabsf(hit.t - wk.t) > 1.0e-5f) {
+				++nerr;
+			}
+		}
+	}
+	nxCore::mem_free(pCol);
+	if (nerr) {
+		nxCore::dbg_msg("!sweep: %d errors\n", nerr);
+	} else {
+		nxCore::dbg_msg("sweep: %d/500 hits OK\n", nhit);
+	}
+}
+
 
 int main(int argc, char* argv[]) {
 	nxApp::init_params(argc, argv);
@@ -71,6 +786,13 @@ int main(int argc, char* argv[]) {
 	g_silent = nxApp::get_bool_opt("silent", false);
 
 	test_tri_bc();
+	test_qbvh();
+	test_hit_batch();
+	test_sweep();
+	test_refit();
+	test_refit_geo();
+	test_frustum_batch();
+	test_occlusion();
 
 	nxApp::reset();
 	reset_sys();